@@ -146,6 +146,7 @@ FetchContent_MakeAvailable(zlib-ng)
 set(HTSLIB_ROOT_DIR "${CMAKE_CURRENT_BINARY_DIR}/_deps/htslib")
 set(LIB_HTS "${HTSLIB_ROOT_DIR}/libhts.a")
 set(HTSLIB_CONFIG_PARAMS ${HTSLIB_ROOT_DIR} ${CMAKE_C_COMPILER} ${LANCET_ENABLE_CLOUD_IO} ${CMAKE_INSTALL_PREFIX})
+# src/lancet/hts/bgzf_ostream.cpp declares a private htslib symbol and static_asserts this version.
 lancet_dep_status("Configuring htslib 1.23.1 ...")
 ExternalProject_Add(htslib
 		URL https://github.com/samtools/htslib/releases/download/1.23.1/htslib-1.23.1.tar.bz2
@@ -74,12 +74,14 @@
 #   ref_repeat             → window has k-mer repeats, guaranteed graph cycle
 #   inactive               → window had no mutation evidence
 #   low_coverage           → window coverage below MinAnchorCov (5x)
+#   extreme_coverage       → index-estimated depth far above --max-sample-cov
 #   no_alt_haplotype       → assembly ran but found no variant haplotypes
 #   other_variant_called   → window called other variants, not this one
 STAGE_ORDER = [
     "not_processed",
     "not_processed:ref_all_n", "not_processed:ref_repeat",
     "not_processed:inactive", "not_processed:low_coverage",
+    "not_processed:extreme_coverage",
     "not_processed:no_alt_haplotype", "not_processed:other_variant_called",
     "variant_in_anchor", "no_anchor", "short_anchor",
     "graph_has_cycle", "graph_too_complex",
@@ -97,6 +99,7 @@
     "not_processed:ref_repeat": "Not processed",
     "not_processed:inactive": "Not processed",
     "not_processed:low_coverage": "Not processed",
+    "not_processed:extreme_coverage": "Not processed",
     "not_processed:no_alt_haplotype": "Not processed",
     "not_processed:other_variant_called": "Not processed",
     "variant_in_anchor": "Graph construction",
@@ -123,6 +126,7 @@
     "SKIPPED_REF_REPEAT_SEEN": ("not_processed:ref_repeat",           1),
     "SKIPPED_INACTIVE_REGION": ("not_processed:inactive",             2),
     "SKIPPED_ANCHOR_COVERAGE":    ("not_processed:low_coverage",         3),
+    "SKIPPED_EXTREME_COVERAGE": ("not_processed:extreme_coverage",     3),
     "SKIPPED_NOASM_HAPLOTYPE": ("not_processed:no_alt_haplotype",     4),
     "FOUND_GENOTYPED_VARIANT": ("not_processed:other_variant_called", 5),
 }
@@ -0,0 +1,43 @@
+#ifndef SRC_LANCET_BASE_DNA_ENCODE_H_
+#define SRC_LANCET_BASE_DNA_ENCODE_H_
+
+#include "lancet/base/types.h"
+
+#include <array>
+
+namespace lancet::base {
+
+// ============================================================================
+// Base encoding table
+//
+// Maps each ASCII character to a 2-bit DNA code:
+//   A/a → 0 (binary 00)
+//   C/c → 1 (binary 01)
+//   G/g → 2 (binary 10)
+//   T/t → 3 (binary 11)
+//   Everything else → 4 (sentinel: breaks the k-mer window)
+//
+// This is packed into a k-mer integer by shifting and OR-ing:
+//   Example (k=3): sequence ACG → 00·01·10 = binary 000110 = decimal 6
+// ============================================================================
+constexpr auto MakeDnaEncodeTable() -> std::array<u8, 256> {
+  std::array<u8, 256> tbl{};
+  for (auto& val : tbl) {
+    val = 4;
+  }
+  tbl['A'] = 0;
+  tbl['a'] = 0;
+  tbl['C'] = 1;
+  tbl['c'] = 1;
+  tbl['G'] = 2;
+  tbl['g'] = 2;
+  tbl['T'] = 3;
+  tbl['t'] = 3;
+  return tbl;
+}
+
+inline constexpr std::array<u8, 256> DNA_ENCODE_TABLE = MakeDnaEncodeTable();
+
+}  // namespace lancet::base
+
+#endif  // SRC_LANCET_BASE_DNA_ENCODE_H_
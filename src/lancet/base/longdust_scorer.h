@@ -1,7 +1,7 @@
 #ifndef SRC_LANCET_BASE_LONGDUST_SCORER_H_
 #define SRC_LANCET_BASE_LONGDUST_SCORER_H_
 
-#include "lancet/base/rev_comp.h"
+#include "lancet/base/dna_encode.h"
 #include "lancet/base/types.h"
 
 #include "absl/strings/str_cat.h"
@@ -9,7 +9,7 @@
 #include "spdlog/fmt/bundled/format.h"
 
 #include <algorithm>
-#include <array>
+#include <limits>
 #include <numbers>
 #include <string>
 #include <string_view>
@@ -170,6 +170,14 @@ namespace lancet::base {
 //
 // This matches longdust's ld_dust2 behavior.
 //
+// Both strands always score the same, so only the forward strand is counted.
+// Every k-mer t of x appears in revcomp(x) as revcomp(t), and revcomp is a
+// bijection on k-mers, so the reverse counts are the forward counts under
+// new labels: c_rev(revcomp(t)) = c_fwd(t). Σ log(c!) and ℓ ignore labels,
+// and f(ℓ) depends on ℓ alone (the GC classes are closed under revcomp too):
+//
+//   q(x_revcomp) = q(x_forward)   →   Score(x) = ScoreOneStrand(x)
+//
 // ============================================================================
 //
 // MULTI-SCALE VARIANT ANNOTATION
@@ -364,37 +372,6 @@ inline auto FormatComplexityScores(Container const& scores) -> std::string {
   return result;
 }
 
-// ============================================================================
-// Base encoding table
-//
-// Maps each ASCII character to a 2-bit DNA code:
-//   A/a → 0 (binary 00)
-//   C/c → 1 (binary 01)
-//   G/g → 2 (binary 10)
-//   T/t → 3 (binary 11)
-//   Everything else → 4 (sentinel: breaks the k-mer window)
-//
-// This is packed into a k-mer integer by shifting and OR-ing:
-//   Example (k=3): sequence ACG → 00·01·10 = binary 000110 = decimal 6
-// ============================================================================
-constexpr auto MakeDnaEncodeTable() -> std::array<u8, 256> {
-  std::array<u8, 256> tbl{};
-  for (auto& val : tbl) {
-    val = 4;
-  }
-  tbl['A'] = 0;
-  tbl['a'] = 0;
-  tbl['C'] = 1;
-  tbl['c'] = 1;
-  tbl['G'] = 2;
-  tbl['g'] = 2;
-  tbl['T'] = 3;
-  tbl['t'] = 3;
-  return tbl;
-}
-
-inline constexpr std::array<u8, 256> DNA_ENCODE_TABLE = MakeDnaEncodeTable();
-
 class LongdustQScorer {
  public:
   /// @param kmer_len       k-mer size (default 7: 4^7 = 16,384 possible k-mers)
@@ -410,8 +387,11 @@ class LongdustQScorer {
         mMask((1U << (2 * kmer_len)) - 1),
         mNumKmers(1U << (2 * kmer_len)) {
     PrecomputeF(max_len);
+    PrecomputeLogCounts(max_len);
   }
 
+  class Window;
+
   // ============================================================================
   // Score: both-strand complexity score
   //
@@ -427,12 +407,11 @@ class LongdustQScorer {
   //   Forward k-mers:  {ATATATA, TATATAT} each ~3-4x  →  q_fwd
   //   RevComp k-mers:  {ATATATA, TATATAT} each ~3-4x  →  q_rev
   //   Score = max(q_fwd, q_rev)
+  //
+  // q_fwd and q_rev are always equal (see BOTH-STRAND SCORING above), so the
+  // reverse complement is never built or counted.
   // ============================================================================
-  [[nodiscard]] auto Score(std::string_view seq) const -> f64 {
-    f64 const fwd_score = ScoreOneStrand(seq);
-    f64 const rev_score = ScoreOneStrand(RevComp(seq));
-    return std::max(fwd_score, rev_score);
-  }
+  [[nodiscard]] auto Score(std::string_view seq) const -> f64 { return ScoreOneStrand(seq); }
 
   /// Read-only view over the precomputed f(ℓ) table. Useful for tests that
   /// verify the precomputation matches a reference implementation, or that
@@ -443,7 +422,7 @@ class LongdustQScorer {
   // ============================================================================
   // ScoreOneStrand: single-strand complexity score q(x) = Q(x) / ℓ
   //
-  // Walks through the sequence in four steps:
+  // Walks through the sequence once, in four steps:
   //
   //   Step 1: Count k-mers
   //   ─────────────────────
@@ -460,11 +439,13 @@ class LongdustQScorer {
   //
   //   Step 2: Sum log-factorials
   //   ──────────────────────────
-  //   For each k-mer with count ≥ 2, add log(count!).
+  //   For each k-mer with count ≥ 2, add log(count!). The sum is kept as the
+  //   k-mers are counted: raising a count from c−1 to c adds log(c), read
+  //   from a precomputed table, so no pass over the 4^k counts is needed.
   //
   //     Example (homopolymer, ℓ=10):
   //       Only k-mer AAAAAAA has count=10.
-  //       Σ log(c!) = log(10!) = 15.1
+  //       Σ log(c!) = log(2) + log(3) + ... + log(10) = log(10!) = 15.1
   //
   //     Example (random DNA, ℓ=94):
   //       Each k-mer appears 0 or 1 times.
@@ -479,65 +460,92 @@ class LongdustQScorer {
   //   ─────────────────
   //   q(x) = max(0, Q(x) / ℓ)
   //
+  // The counts live in a per-thread array shared by every scorer, and only
+  // the cells this sequence touched are zeroed again afterwards.
+  //
   // Complexity: O(|seq|) time, O(4^k) space (32KB for k=7, fits L1 cache).
   // ============================================================================
   [[nodiscard]] auto ScoreOneStrand(std::string_view seq) const -> f64 {
-    auto const n_positions = static_cast<i64>(seq.size()) - mK + 1;
-    if (n_positions <= 0) {
+    if (std::cmp_less(seq.size(), mK)) {
       return 0.0;
     }
 
-    // Step 1: Count k-mers in a flat array indexed by the 2k-bit k-mer code
+    // Step 1: Count k-mers in a flat array indexed by the 2k-bit k-mer code.
+    // Cells are all zero between calls; the array only grows (k=4 and k=7 share it).
     thread_local std::vector<u16> counts;
-    counts.assign(mNumKmers, 0);
+    thread_local std::vector<u32> touched;
+    if (counts.size() < mNumKmers) {
+      counts.resize(mNumKmers, 0);
+    }
 
-    u32 kmer = 0;
-    int run = 0;
+    // Step 2: Σ_t log(c_x(t)!), updated per k-mer
+    f64 sum_log_factorial = 0.0;
     usize valid_kmers = 0;
+    ForEachKmer(seq, [&](usize /*start*/, u32 const kmer) {
+      auto const count = ++counts[kmer];
+      if (count == 1) {
+        touched.push_back(kmer);
+      } else {
+        sum_log_factorial += LogCount(count);
+      }
+      valid_kmers++;
+    });
+
+    for (u32 const kmer : touched) {
+      counts[kmer] = 0;
+    }
+    touched.clear();
+
+    // Steps 3 and 4
+    return Normalize(sum_log_factorial, valid_kmers);
+  }
+
+ private:
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  std::vector<f64> mF;         // f(ℓ) table: mF[ℓ] = expected Σ log(c!) under the null model
+  std::vector<f64> mLogCount;  // mLogCount[c] = log(c): what the c-th copy of a k-mer adds
+  f64 mGc;                     // global background GC fraction for bias correction
+  // ── 4B Align ────────────────────────────────────────────────────────────
+  int mK;         // k-mer size (e.g., 7 → 7-mers)
+  u32 mMask;      // bitmask to extract a k-mer from the rolling integer: (1 << 2k) - 1
+  u32 mNumKmers;  // total possible k-mers: 4^k (e.g., 16,384 for k=7)
 
-    for (char const chr : seq) {
-      auto const base = DNA_ENCODE_TABLE[static_cast<u8>(chr)];
+  /// Calls visit(start, code) for every k-mer of `seq` without an N, in order,
+  /// with `start` its 0-based offset in `seq` and `code` its rolling 2k-bit code.
+  template <typename Visitor>
+  void ForEachKmer(std::string_view seq, Visitor&& visit) const {
+    u32 kmer = 0;
+    int run = 0;
+    for (usize idx = 0; idx < seq.size(); ++idx) {
+      auto const base = DNA_ENCODE_TABLE[static_cast<u8>(seq[idx])];
       if (base < 4) {
         kmer = ((kmer << 2) | base) & mMask;
         if (++run >= mK) {
-          counts[kmer]++;
-          valid_kmers++;
+          visit(idx + 1 - static_cast<usize>(mK), kmer);
         }
       } else {
         run = 0;  // N or invalid base resets the k-mer window
       }
     }
+  }
+
+  /// log(count), from the table for counts up to max_len.
+  [[nodiscard]] auto LogCount(u32 const count) const -> f64 {
+    return count < mLogCount.size() ? mLogCount[count] : std::log(static_cast<f64>(count));
+  }
 
+  /// Steps 3 and 4: q = max(0, (Σ log(c!) − f(ℓ)) / ℓ), with ℓ = valid_kmers.
+  [[nodiscard]] auto Normalize(f64 const sum_log_factorial, usize const valid_kmers) const
+      -> f64 {
     if (valid_kmers == 0) {
       return 0.0;
     }
-
-    // Step 2: Σ_t log(c_x(t)!) — only counts ≥ 2 contribute (log(0!)=log(1!)=0)
-    f64 sum_log_factorial = 0.0;
-    for (u32 idx = 0; idx < mNumKmers; ++idx) {
-      if (counts[idx] >= 2) {
-        sum_log_factorial += std::lgamma(static_cast<f64>(counts[idx] + 1));
-      }
-    }
-
-    // Step 3: Q(x) = Σ log(c!) − f(ℓ)
     auto const ell = static_cast<int>(valid_kmers);
     f64 const f_val = (std::cmp_less(ell, mF.size())) ? mF[ell] : ComputeF(ell);
     f64 const q_score = sum_log_factorial - f_val;
-
-    // Step 4: normalize, clamp at 0
     return std::max(0.0, q_score / static_cast<f64>(valid_kmers));
   }
 
- private:
-  // ── 8B Align ────────────────────────────────────────────────────────────
-  std::vector<f64> mF;  // precomputed f(ℓ) table: mF[ℓ] = expected Σ log(c!) under null model
-  f64 mGc;              // global background GC fraction for bias correction
-  // ── 4B Align ────────────────────────────────────────────────────────────
-  int mK;         // k-mer size (e.g., 7 → 7-mers)
-  u32 mMask;      // bitmask to extract a k-mer from the rolling integer: (1 << 2k) - 1
-  u32 mNumKmers;  // total possible k-mers: 4^k (e.g., 16,384 for k=7)
-
   // ============================================================================
   // ComputeFSingle: expected log-factorial per k-mer under Poisson(λ)
   //
@@ -678,6 +686,96 @@ class LongdustQScorer {
       mF[ell] = ComputeF(ell);
     }
   }
+
+  /// Precompute log(c) for all counts 0..max_len (a k-mer count never exceeds ℓ).
+  void PrecomputeLogCounts(int max_len) {
+    mLogCount.resize(max_len + 1, 0.0);
+    for (int count = 2; count <= max_len; ++count) {
+      mLogCount[count] = std::log(static_cast<f64>(count));
+    }
+  }
+};
+
+// ============================================================================
+// LongdustQScorer::Window — Score() of many overlapping windows of one sequence
+//
+// Variant flanks on the same haplotype overlap heavily, so rescoring each one
+// from scratch recounts mostly the same k-mers. A Window encodes the sequence's
+// k-mers once, keeps the counts and Σ log(c!) of the last window scored, and
+// moves to the next window by removing and adding only the k-mers at its
+// edges: removing the c-th copy of a k-mer subtracts log(c).
+//
+//   seq:      ──────────────────────────────────────────────
+//   previous:        [──────────────────)
+//   next:                 [──────────────────)
+//                    └ −  ┘              └ +  ┘
+//
+// Windows that do not overlap the previous one are rebuilt, which costs the
+// same as Score(). Scores equal Score(seq.substr(start, end − start)) up to
+// floating-point summation order. Not thread-safe; one Window per thread.
+// ============================================================================
+class LongdustQScorer::Window {
+ public:
+  /// Keeps references to `scorer` and `seq`; both must outlive the window.
+  Window(LongdustQScorer const& scorer, std::string_view seq)
+      : mScorer(&scorer), mCounts(scorer.mNumKmers, 0) {
+    auto const kmer_len = static_cast<usize>(scorer.mK);
+    mCodes.assign(seq.size() >= kmer_len ? seq.size() - kmer_len + 1 : 0, NO_KMER);
+    scorer.ForEachKmer(seq, [this](usize const start, u32 const kmer) { mCodes[start] = kmer; });
+  }
+
+  /// Same as scorer.Score(seq.substr(start, end - start)), with `end` clamped to the sequence.
+  [[nodiscard]] auto Score(usize const start, usize const end) -> f64 {
+    // k-mers starting in [first, last) lie entirely inside [start, end)
+    auto const kmer_len = static_cast<usize>(mScorer->mK);
+    auto const last = std::min(end, mCodes.size() + kmer_len - 1);
+    auto const first = std::min(start, last);
+    auto const kmers_end = last - first >= kmer_len ? last - kmer_len + 1 : first;
+    MoveTo(first, kmers_end);
+    return mScorer->Normalize(mSumLogFactorial, mNumValid);
+  }
+
+ private:
+  static constexpr u32 NO_KMER = std::numeric_limits<u32>::max();
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  LongdustQScorer const* mScorer;
+  std::vector<u32> mCodes;   // [i] → code of the k-mer starting at i, NO_KMER if it has an N
+  std::vector<u16> mCounts;  // counts of the k-mers starting in [mFirst, mLast)
+  f64 mSumLogFactorial = 0.0;
+  usize mNumValid = 0;
+  usize mFirst = 0;
+  usize mLast = 0;
+
+  void MoveTo(usize const first, usize const last) {
+    if (last <= mFirst || first >= mLast) {
+      while (mFirst < mLast) Remove(mFirst++);
+      // Start from exact zeros so add/remove rounding never accumulates
+      mSumLogFactorial = 0.0;
+      mFirst = mLast = first;
+    }
+
+    while (mFirst < first) Remove(mFirst++);
+    while (mLast > last) Remove(--mLast);
+    while (mFirst > first) Add(--mFirst);
+    while (mLast < last) Add(mLast++);
+  }
+
+  void Add(usize const start) {
+    auto const kmer = mCodes[start];
+    if (kmer == NO_KMER) return;
+    auto const count = ++mCounts[kmer];
+    if (count > 1) mSumLogFactorial += mScorer->LogCount(count);
+    mNumValid++;
+  }
+
+  void Remove(usize const start) {
+    auto const kmer = mCodes[start];
+    if (kmer == NO_KMER) return;
+    auto const count = mCounts[kmer]--;
+    if (count > 1) mSumLogFactorial -= mScorer->LogCount(count);
+    mNumValid--;
+  }
 };
 
 }  // namespace lancet::base
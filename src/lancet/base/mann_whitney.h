@@ -107,7 +107,9 @@
 #include "absl/types/span.h"
 
 #include <algorithm>
+#include <array>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 #include <cmath>
@@ -123,8 +125,13 @@ namespace lancet::base {
 //
 // Template parameter T must be an arithmetic type (u8, i32, f64, etc.).
 // Values are promoted to f64 internally for rank computation.
+//
+// Sort-based reference path: O(N log N) time, O(N) scratch. Used for
+// continuous values (e.g. folded read positions). Byte-valued inputs go
+// through MannWhitneyEffectSizeFromCounts via MannWhitneyEffectSize<u8>.
 template <typename T>
-[[nodiscard]] auto MannWhitneyEffectSize(absl::Span<T const> ref_vals, absl::Span<T const> alt_vals)
+[[nodiscard]] auto MannWhitneyEffectSizeBySort(absl::Span<T const> ref_vals,
+                                               absl::Span<T const> alt_vals)
     -> std::optional<f64> {
   // Empty group = test CANNOT be run. Return nullopt → NaN in VCF (".").
   // This is semantically different from "test ran, found no bias" (→ 0.0).
@@ -224,6 +231,101 @@ template <typename T>
   return z_score / std::sqrt(n_total);
 }
 
+// ============================================================================
+// Histogram form — exact U from per-value counts in O(bins)
+// ============================================================================
+//
+// Base qualities and mapping qualities are Phred-scaled bytes, so every
+// observation falls into one of 256 bins. Walking the bins in ascending
+// order visits exactly the tie groups the sort-based path discovers:
+//
+//   bin v:  ref_counts[v] = r,  alt_counts[v] = a,  t = r + a
+//   ranks occupied:  [pos + 1, pos + t]   →  mid-rank = (pos + 1 + pos + t) / 2
+//   R_alt += a × mid-rank,   tie term += t³ − t,   pos += t
+//
+// Mid-ranks are multiples of 0.5 and every partial sum stays far below 2^53,
+// so `a × mid-rank` equals `a` repeated additions of `mid-rank` bit-for-bit:
+// the result is identical to MannWhitneyEffectSizeBySort, not an approximation.
+// Memory is the caller's two histograms regardless of depth.
+// ============================================================================
+
+/// Dense histogram over the full u8 domain: hist[v] = number of observations equal to v.
+using U8Histogram = std::array<u64, 256>;
+
+/// Add every value in `vals` to `hist`.
+inline void AccumulateHistogram(absl::Span<u8 const> vals, U8Histogram& hist) {
+  for (auto const val : vals) ++hist[val];
+}
+
+/// Mann-Whitney effect size from per-bin counts. Both spans must have the same
+/// length and index bins in ascending value order. Same return contract as
+/// MannWhitneyEffectSizeBySort.
+[[nodiscard]] inline auto MannWhitneyEffectSizeFromCounts(absl::Span<u64 const> ref_counts,
+                                                          absl::Span<u64 const> alt_counts)
+    -> std::optional<f64> {
+  u64 num_ref = 0;
+  u64 num_alt = 0;
+  for (usize bin = 0; bin < ref_counts.size(); ++bin) {
+    num_ref += ref_counts[bin];
+    num_alt += alt_counts[bin];
+  }
+
+  if (num_ref == 0 || num_alt == 0) {
+    return std::nullopt;
+  }
+
+  auto const n_ref = static_cast<f64>(num_ref);
+  auto const n_alt = static_cast<f64>(num_alt);
+  auto const total = num_ref + num_alt;
+
+  f64 alt_rank_sum = 0.0;
+  f64 tie_correction = 0.0;
+  u64 rank_pos = 0;  // number of observations in all lower bins
+
+  for (usize bin = 0; bin < ref_counts.size(); ++bin) {
+    auto const group = ref_counts[bin] + alt_counts[bin];
+    if (group == 0) continue;
+
+    auto const mid_rank = static_cast<f64>(rank_pos + 1 + rank_pos + group) / 2.0;
+    auto const tie_size = static_cast<f64>(group);
+    tie_correction += ((tie_size * tie_size * tie_size) - tie_size);
+    alt_rank_sum += static_cast<f64>(alt_counts[bin]) * mid_rank;
+    rank_pos += group;
+  }
+
+  auto const u_stat = alt_rank_sum - ((n_alt * (n_alt + 1.0)) / 2.0);
+  auto const mean_u = (n_ref * n_alt) / 2.0;
+  auto const n_total = static_cast<f64>(total);
+  auto const var_u =
+      (n_ref * n_alt / 12.0) * ((n_total + 1.0) - (tie_correction / (n_total * (n_total - 1.0))));
+
+  if (var_u <= 0.0) {
+    return 0.0;
+  }
+
+  auto const z_score = (u_stat - mean_u) / std::sqrt(var_u);
+  return z_score / std::sqrt(n_total);
+}
+
+// Computes the Mann-Whitney U effect size (Z/√N) comparing two independent
+// samples. u8 inputs (BQ, MAPQ) are counted into two fixed 256-bin histograms
+// and ranked in O(N + 256) with no allocation; all other types use the
+// sort-based path.
+template <typename T>
+[[nodiscard]] auto MannWhitneyEffectSize(absl::Span<T const> ref_vals, absl::Span<T const> alt_vals)
+    -> std::optional<f64> {
+  if constexpr (std::is_same_v<T, u8>) {
+    U8Histogram ref_hist{};
+    U8Histogram alt_hist{};
+    AccumulateHistogram(ref_vals, ref_hist);
+    AccumulateHistogram(alt_vals, alt_hist);
+    return MannWhitneyEffectSizeFromCounts(absl::MakeConstSpan(ref_hist),
+                                           absl::MakeConstSpan(alt_hist));
+  } else {
+    return MannWhitneyEffectSizeBySort<T>(ref_vals, alt_vals);
+  }
+}
+
 }  // namespace lancet::base
 
 #endif  // SRC_LANCET_BASE_MANN_WHITNEY_H_
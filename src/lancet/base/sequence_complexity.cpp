@@ -40,6 +40,23 @@ auto SequenceComplexityScorer::ExtractFlank(std::string_view haplotype, usize co
   return haplotype.substr(static_cast<usize>(start), static_cast<usize>(end - start));
 }
 
+// ============================================================================
+// FlankSquashedLQ — ±LQ_FLANK LongdustQ, slid along the region's
+// HaplotypeProfile when one is attached.
+// ============================================================================
+
+auto SequenceComplexityScorer::FlankSquashedLQ(HapRegion const& region) const -> f64 {
+  auto const window = ExtractFlank(region.mHaplotype, region.mPos, region.mLen, LQ_FLANK);
+  if (region.mProfile == nullptr || window.empty()) {
+    return std::log1p(std::max(0.0, mFlankScorer.Score(window)));
+  }
+
+  auto& lq_window = region.mProfile->mFlankLQWindow;
+  if (!lq_window.has_value()) lq_window.emplace(mFlankScorer, region.mHaplotype);
+  auto const start = static_cast<usize>(window.data() - region.mHaplotype.data());
+  return std::log1p(std::max(0.0, lq_window->Score(start, start + window.size())));
+}
+
 // ============================================================================
 // MaxHomopolymerRun — longest run of identical bases
 // ============================================================================
@@ -364,12 +381,25 @@ void SequenceComplexityScorer::AccumulateTRFeatures(VariantTRFeatures& features,
 
 // ============================================================================
 // Score — main entry point. Delegates to ScoreContext, ScoreDeltas, ScoreTrMotif.
+// ScoreRefContext + ScoreWithContext split the REF-only part out so it can be
+// shared by every ALT haplotype of a variant.
 // ============================================================================
 
 auto SequenceComplexityScorer::Score(HapRegion const& ref, HapRegion const& alt) const
     -> SequenceComplexity {
+  return ScoreWithContext(ScoreRefContext(ref), ref, alt);
+}
+
+auto SequenceComplexityScorer::ScoreRefContext(HapRegion const& ref) const -> SequenceComplexity {
   SequenceComplexity cplx;
   ScoreContext(cplx, ref);
+  return cplx;
+}
+
+auto SequenceComplexityScorer::ScoreWithContext(SequenceComplexity const& ref_context,
+                                                HapRegion const& ref, HapRegion const& alt) const
+    -> SequenceComplexity {
+  SequenceComplexity cplx = ref_context;
   ScoreDeltas(cplx, ref, alt);
   ScoreTrMotif(cplx, alt);
   return cplx;
@@ -388,11 +418,19 @@ void SequenceComplexityScorer::ScoreContext(SequenceComplexity& cplx, HapRegion
   cplx.mContextEntropy = LocalShannonEntropy(ctx_window);
 
   // LongdustQ (k=4) at ±50bp — log1p-squashed to compress heavy tails
-  auto const lq_window = ExtractFlank(ref.mHaplotype, ref.mPos, ref.mLen, LQ_FLANK);
-  cplx.mContextFlankLQ = std::log1p(std::max(0.0, mFlankScorer.Score(lq_window)));
-
-  // LongdustQ (k=7) on full haplotype — log1p-squashed
-  cplx.mContextHaplotypeLQ = std::log1p(std::max(0.0, mHaplotypeScorer.Score(ref.mHaplotype)));
+  cplx.mContextFlankLQ = FlankSquashedLQ(ref);
+
+  // LongdustQ (k=7) on full haplotype — log1p-squashed, once per profiled haplotype
+  auto const score_haplotype = [this, &ref] {
+    return std::log1p(std::max(0.0, mHaplotypeScorer.Score(ref.mHaplotype)));
+  };
+  if (ref.mProfile == nullptr) {
+    cplx.mContextHaplotypeLQ = score_haplotype();
+    return;
+  }
+  auto& cached_lq = ref.mProfile->mSquashedHaplotypeLQ;
+  if (!cached_lq.has_value()) cached_lq = score_haplotype();
+  cplx.mContextHaplotypeLQ = *cached_lq;
 }
 
 // ============================================================================
@@ -418,9 +456,7 @@ void SequenceComplexityScorer::ScoreDeltas(SequenceComplexity& cplx, HapRegion c
   cplx.mDeltaEntropy = LocalShannonEntropy(alt_ent_window) - LocalShannonEntropy(ref_ent_window);
 
   // LongdustQ delta at ±50bp (log-space)
-  auto const alt_lq_window = ExtractFlank(alt.mHaplotype, alt.mPos, alt.mLen, LQ_FLANK);
-  auto const alt_lq = std::log1p(std::max(0.0, mFlankScorer.Score(alt_lq_window)));
-  cplx.mDeltaFlankLQ = alt_lq - cplx.mContextFlankLQ;
+  cplx.mDeltaFlankLQ = FlankSquashedLQ(alt) - cplx.mContextFlankLQ;
 }
 
 // ============================================================================
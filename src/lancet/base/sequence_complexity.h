@@ -4,12 +4,44 @@
 #include "lancet/base/longdust_scorer.h"
 #include "lancet/base/types.h"
 
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace lancet::base {
 
+// ============================================================================
+// HaplotypeProfile — per-haplotype LongdustQ caches shared across variants
+//
+// Every variant in a component scores windows of the same few haplotypes.
+// The full-haplotype k=7 LongdustQ score does not depend on the variant, so
+// it is computed once per haplotype instead of once per variant, and the
+// ±50bp k=4 LongdustQ windows slide along the haplotype instead of
+// recounting every flank's k-mers. Both are filled lazily by the scorer, so
+// a haplotype only pays for the features its variants actually query.
+//
+// The ±5/10/20bp homopolymer and entropy windows are short enough that a
+// direct scan is cheaper than any per-haplotype table, so they are not
+// profiled.
+// ============================================================================
+class HaplotypeProfile {
+ public:
+  explicit HaplotypeProfile(std::string_view haplotype) : mHaplotype(haplotype) {}
+
+  [[nodiscard]] auto Haplotype() const noexcept -> std::string_view { return mHaplotype; }
+
+ private:
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  std::string_view mHaplotype;
+  /// log1p-squashed full-haplotype LongdustQ; filled by the first ScoreContext.
+  mutable std::optional<f64> mSquashedHaplotypeLQ;
+  /// Flank LongdustQ (k=4) over this haplotype; created by the first flank query.
+  mutable std::optional<LongdustQScorer::Window> mFlankLQWindow;
+
+  friend class SequenceComplexityScorer;  // fills the LongdustQ caches
+};
+
 /// Haplotype region: a (haplotype, position, length) triple used by
 /// SequenceComplexityScorer to identify variant coordinates within
 /// assembled haplotype strings.
@@ -18,6 +50,10 @@ struct HapRegion {
   std::string_view mHaplotype;  // 16B — full assembled haplotype sequence
   usize mPos = 0;               //  8B — 0-based variant start position
   usize mLen = 0;               //  8B — variant allele length
+  /// Optional profile of mHaplotype. When set, LongdustQ scores are cached
+  /// and slid along it; the scores are identical either way (flank LongdustQ
+  /// up to floating-point summation order).
+  HaplotypeProfile const* mProfile = nullptr;  // 8B
 };
 
 // ============================================================================
@@ -202,6 +238,15 @@ class SequenceComplexityScorer {
   /// @param alt  ALT haplotype region (haplotype string, variant pos, allele length)
   [[nodiscard]] auto Score(HapRegion const& ref, HapRegion const& alt) const -> SequenceComplexity;
 
+  /// REF-only context features of `ref`. They do not depend on the ALT
+  /// haplotype, so callers scoring one variant against several ALT
+  /// haplotypes compute them once and pass them to ScoreWithContext.
+  [[nodiscard]] auto ScoreRefContext(HapRegion const& ref) const -> SequenceComplexity;
+
+  /// Same as Score(ref, alt), reusing `ref_context` = ScoreRefContext(ref).
+  [[nodiscard]] auto ScoreWithContext(SequenceComplexity const& ref_context, HapRegion const& ref,
+                                      HapRegion const& alt) const -> SequenceComplexity;
+
   // ============================================================================
   // Component methods (public for unit testing)
   // ============================================================================
@@ -293,6 +338,10 @@ class SequenceComplexityScorer {
   [[nodiscard]] static auto ExtractFlank(std::string_view haplotype, usize var_pos, usize var_len,
                                          i64 flank_size) -> std::string_view;
 
+  /// log1p-squashed k=4 LongdustQ of the ±LQ_FLANK window around `region`, slid
+  /// along region.mProfile when present.
+  [[nodiscard]] auto FlankSquashedLQ(HapRegion const& region) const -> f64;
+
   /// Run motif detection (both exact + approx) on a flanking window and
   /// take element-wise max into existing VariantTRFeatures.
   static void AccumulateTRFeatures(VariantTRFeatures& features, std::string_view window,
@@ -0,0 +1,269 @@
+#include "lancet/caller/bcf_record_encoder.h"
+
+#include "lancet/base/logging.h"
+#include "lancet/base/types.h"
+#include "lancet/caller/alt_allele.h"
+#include "lancet/caller/sample_format_data.h"
+#include "lancet/caller/variant_call.h"
+
+extern "C" {
+#include "htslib/vcf.h"
+}
+
+#include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <string_view>
+
+#include <cstdlib>
+
+namespace {
+
+// Every bcf_update_* call returns < 0 when htslib rejects the value (tag not in
+// the header, type mismatch, allocation failure); a silently dropped field
+// would make the BCF disagree with the VCF written from the same calls.
+inline void CheckEncoded(int const status, std::string_view const column,
+                         std::string_view const tag) {
+  if (status >= 0) return;
+  LOG_CRITICAL("Failed to encode BCF {}/{}", column, tag)
+  std::exit(EXIT_FAILURE);
+}
+
+// BCF2 sentinel bit patterns: "missing" for an absent value, "vector end" to
+// pad a sample whose Number=R/A/G vector is shorter than the record's width.
+[[nodiscard]] inline auto FloatMissing() -> f32 {
+  return std::bit_cast<f32>(u32{bcf_float_missing});
+}
+[[nodiscard]] inline auto FloatVectorEnd() -> f32 {
+  return std::bit_cast<f32>(u32{bcf_float_vector_end});
+}
+
+}  // namespace
+
+namespace lancet::caller {
+
+BcfRecordEncoder::BcfRecordEncoder(bcf_hdr_t* hdr) : mHeader(hdr) {
+  // SHARED/CTRL/CASE are only declared in case-control mode; BCF cannot carry
+  // undeclared tags, so the state flag is written only when the header has it.
+  for (usize idx = 0; idx < VariantCall::STATE_NAMES.size(); ++idx) {
+    // STATE_NAMES views string literals, so each is NUL-terminated.
+    // NOLINTNEXTLINE(bugprone-suspicious-stringview-data-usage)
+    auto const tag_id = bcf_hdr_id2int(mHeader, BCF_DT_ID, VariantCall::STATE_NAMES[idx].data());
+    mHasStateTag[idx] = tag_id >= 0 && bcf_hdr_idinfo_exists(mHeader, BCF_HL_INFO, tag_id);
+  }
+}
+
+void BcfRecordEncoder::Encode(VariantCall const& call, bcf1_t* rec) {
+  if (mChromRid < 0 || call.ChromName() != mChromName) {
+    mChromName.assign(call.ChromName());
+    mChromRid = bcf_hdr_name2id(mHeader, mChromName.c_str());
+    if (mChromRid < 0) {
+      LOG_CRITICAL("Contig {} is missing from the BCF header", mChromName)
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+  rec->rid = mChromRid;
+  rec->pos = static_cast<hts_pos_t>(call.StartPos1()) - 1;
+  if (call.HasQuality()) {
+    rec->qual = static_cast<f32>(call.Quality());
+  } else {
+    bcf_float_set_missing(rec->qual);
+  }
+
+  // REF views VariantCall::mRefAllele and ALTs are std::strings, so every
+  // allele is NUL-terminated; bcf_update_alleles also sets rlen = len(REF).
+  mAlleles.clear();
+  // NOLINTNEXTLINE(bugprone-suspicious-stringview-data-usage)
+  mAlleles.push_back(call.RefAllele().data());
+  for (auto const& alt : call.AltAlleles()) mAlleles.push_back(alt.c_str());
+  CheckEncoded(
+      bcf_update_alleles(mHeader, rec, mAlleles.data(), static_cast<int>(mAlleles.size())),
+      "REF", "ALT");
+
+  EncodeInfo(call, rec);
+  EncodeFormat(call, rec);
+}
+
+// ============================================================================
+// EncodeInfo: [STATE;][MULTIALLELIC;]TYPE;LENGTH;GRAPH_CX;SEQ_CX
+// ============================================================================
+void BcfRecordEncoder::EncodeInfo(VariantCall const& call, bcf1_t* rec) {
+  auto const state_idx = static_cast<usize>(static_cast<i8>(call.State()) + 1);
+  if (mHasStateTag[state_idx]) {
+    auto const state_name = VariantCall::StateName(call.State());
+    // NOLINTNEXTLINE(bugprone-suspicious-stringview-data-usage)
+    CheckEncoded(bcf_update_info_flag(mHeader, rec, state_name.data(), nullptr, 1), "INFO",
+                 state_name);
+  }
+
+  if (call.IsMultiallelic()) {
+    CheckEncoded(bcf_update_info_flag(mHeader, rec, "MULTIALLELIC", nullptr, 1), "INFO",
+                 "MULTIALLELIC");
+  }
+
+  // TYPE is Number=A, Type=String: BCF stores the comma-joined list as one string.
+  mTypeText.clear();
+  for (auto const category : call.Categories()) {
+    if (!mTypeText.empty()) mTypeText.push_back(',');
+    mTypeText.append(VariantCall::TypeName(category));
+  }
+  CheckEncoded(bcf_update_info_string(mHeader, rec, "TYPE", mTypeText.c_str()), "INFO", "TYPE");
+
+  auto const lengths = call.VariantLengths();
+  mInts.assign(lengths.begin(), lengths.end());
+  CheckEncoded(
+      bcf_update_info_int32(mHeader, rec, "LENGTH", mInts.data(), static_cast<int>(mInts.size())),
+      "INFO", "LENGTH");
+
+  CheckEncoded(
+      bcf_update_info_string(mHeader, rec, "GRAPH_CX", call.GraphCx().FormatVcfValue().c_str()),
+      "INFO", "GRAPH_CX");
+  CheckEncoded(
+      bcf_update_info_string(mHeader, rec, "SEQ_CX", call.SeqCx().FormatVcfValue().c_str()),
+      "INFO", "SEQ_CX");
+}
+
+// ============================================================================
+// EncodeFormat: one bcf_update_format_* call per FORMAT_HEADER tag.
+//
+// BCF stores FORMAT values tag-major (all samples of GT, then all of AD, ...),
+// each sample padded to the record-wide width. A sample without support
+// renders "./." and "." for every field in text, which maps to bcf_gt_missing
+// and a leading *_missing followed by vector-end padding here.
+// ============================================================================
+void BcfRecordEncoder::EncodeFormat(VariantCall const& call, bcf1_t* rec) {
+  using Sample = SampleFormatData;
+  auto const samples = call.SampleGenotypes();
+  auto const num_samples = samples.size();
+  auto const num_alleles = call.NumAltAlleles() + 1;
+  auto const width_r = num_alleles;
+  auto const width_a = std::max<usize>(call.NumAltAlleles(), 1);
+  auto const width_g = (num_alleles * (num_alleles + 1)) / 2;
+
+  auto const pack_ints = [&](usize const width, auto const& values_of) {
+    mInts.assign(num_samples * width, bcf_int32_vector_end);
+    for (usize sidx = 0; sidx < num_samples; ++sidx) {
+      auto* dst = mInts.data() + (sidx * width);
+      if (samples[sidx].IsMissingSupport()) {
+        dst[0] = bcf_int32_missing;
+        continue;
+      }
+      auto const values = values_of(samples[sidx]);
+      if (values.empty()) dst[0] = bcf_int32_missing;
+      auto const count = std::min(width, values.size());
+      for (usize idx = 0; idx < count; ++idx) dst[idx] = static_cast<i32>(values[idx]);
+    }
+  };
+
+  auto const pack_floats = [&](usize const width, auto const& values_of) {
+    mFloats.assign(num_samples * width, FloatVectorEnd());
+    for (usize sidx = 0; sidx < num_samples; ++sidx) {
+      auto* dst = mFloats.data() + (sidx * width);
+      if (samples[sidx].IsMissingSupport()) {
+        dst[0] = FloatMissing();
+        continue;
+      }
+      auto const values = values_of(samples[sidx]);
+      if (values.empty()) dst[0] = FloatMissing();
+      auto const count = std::min(width, values.size());
+      for (usize idx = 0; idx < count; ++idx) dst[idx] = static_cast<f32>(values[idx]);
+    }
+  };
+
+  // Number=1 fields: the scalar as a one-element span, or empty when absent.
+  auto const scalar_u32 = [](u32 (Sample::*getter)() const) {
+    return [getter](Sample const& smp) { return std::array<u32, 1>{(smp.*getter)()}; };
+  };
+  auto const scalar_f32 = [](f32 (Sample::*getter)() const) {
+    return [getter](Sample const& smp) { return std::array<f32, 1>{(smp.*getter)()}; };
+  };
+  auto const optional_f32 = [](Sample::FieldSlot const slot) {
+    return [slot](Sample const& smp) {
+      using OneOrNone = absl::InlinedVector<f32, 1>;
+      auto const value = smp.GetField(slot);
+      return value.has_value() ? OneOrNone{*value} : OneOrNone{};
+    };
+  };
+
+  // GT: diploid, unphased; "./." when genotype indices are unset.
+  mInts.assign(num_samples * 2, bcf_gt_missing);
+  for (usize sidx = 0; sidx < num_samples; ++sidx) {
+    auto const [first, second] = samples[sidx].GenotypeIndices();
+    if (samples[sidx].IsMissingSupport() || (first == -1 && second == -1)) continue;
+    mInts[sidx * 2] = bcf_gt_unphased(first);
+    mInts[(sidx * 2) + 1] = bcf_gt_unphased(second);
+  }
+  CheckEncoded(bcf_update_genotypes(mHeader, rec, mInts.data(), static_cast<int>(mInts.size())),
+               "FORMAT", "GT");
+
+  pack_ints(width_r, [](Sample const& smp) { return smp.AlleleDepths(); });
+  UpdateInts(rec, "AD");
+  pack_ints(width_r, [](Sample const& smp) { return smp.FwdAlleleDepths(); });
+  UpdateInts(rec, "ADF");
+  pack_ints(width_r, [](Sample const& smp) { return smp.RevAlleleDepths(); });
+  UpdateInts(rec, "ADR");
+  pack_ints(1, scalar_u32(&Sample::TotalDepth));
+  UpdateInts(rec, "DP");
+  pack_floats(width_r, [](Sample const& smp) { return smp.RmsMappingQualities(); });
+  UpdateFloats(rec, "RMQ");
+  pack_floats(width_r, [](Sample const& smp) { return smp.NormPosteriorBQs(); });
+  UpdateFloats(rec, "NPBQ");
+  pack_floats(1, scalar_f32(&Sample::StrandBias));
+  UpdateFloats(rec, "SB");
+  pack_floats(1, scalar_f32(&Sample::SoftClipAsym));
+  UpdateFloats(rec, "SCA");
+  pack_floats(1, optional_f32(Sample::FRAG_LEN_DELTA));
+  UpdateFloats(rec, "FLD");
+  pack_floats(1, optional_f32(Sample::READ_POS_COHEN_D));
+  UpdateFloats(rec, "RPCD");
+  pack_floats(1, optional_f32(Sample::BASE_QUAL_COHEN_D));
+  UpdateFloats(rec, "BQCD");
+  pack_floats(1, optional_f32(Sample::MAP_QUAL_COHEN_D));
+  UpdateFloats(rec, "MQCD");
+  pack_floats(1, optional_f32(Sample::ALLELE_MISMATCH_DELTA));
+  UpdateFloats(rec, "ASMD");
+  pack_floats(1, optional_f32(Sample::SITE_DEPTH_FOLD_CHANGE));
+  UpdateFloats(rec, "SDFC");
+  pack_floats(1, scalar_f32(&Sample::PolarRadius));
+  UpdateFloats(rec, "PRAD");
+  pack_floats(1, scalar_f32(&Sample::PolarAngle));
+  UpdateFloats(rec, "PANG");
+
+  // CMLOD: Number=A — index 0 is the REF LOD (0.0 by definition) and is dropped.
+  pack_floats(width_a, [](Sample const& smp) {
+    auto const lods = smp.ContinuousMixtureLods();
+    return lods.size() < 2 ? absl::Span<f64 const>{} : lods.subspan(1);
+  });
+  UpdateFloats(rec, "CMLOD");
+
+  pack_floats(1, optional_f32(Sample::FRAG_START_ENTROPY));
+  UpdateFloats(rec, "FSSE");
+  pack_floats(1, optional_f32(Sample::ALT_HAP_DISCORD_DELTA));
+  UpdateFloats(rec, "AHDD");
+  pack_floats(1, optional_f32(Sample::HAPLOTYPE_SEG_ENTROPY));
+  UpdateFloats(rec, "HSE");
+  pack_floats(1, optional_f32(Sample::PATH_DEPTH_CV));
+  UpdateFloats(rec, "PDCV");
+  pack_ints(width_g, [](Sample const& smp) { return smp.PhredLikelihoods(); });
+  UpdateInts(rec, "PL");
+  pack_ints(1, scalar_u32(&Sample::GenotypeQuality));
+  UpdateInts(rec, "GQ");
+}
+
+void BcfRecordEncoder::UpdateInts(bcf1_t* rec, char const* tag) {
+  auto const status =
+      bcf_update_format_int32(mHeader, rec, tag, mInts.data(), static_cast<int>(mInts.size()));
+  CheckEncoded(status, "FORMAT", tag);
+}
+
+void BcfRecordEncoder::UpdateFloats(bcf1_t* rec, char const* tag) {
+  auto const status =
+      bcf_update_format_float(mHeader, rec, tag, mFloats.data(), static_cast<int>(mFloats.size()));
+  CheckEncoded(status, "FORMAT", tag);
+}
+
+}  // namespace lancet::caller
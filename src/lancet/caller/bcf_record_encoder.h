@@ -0,0 +1,59 @@
+#ifndef SRC_LANCET_CALLER_BCF_RECORD_ENCODER_H_
+#define SRC_LANCET_CALLER_BCF_RECORD_ENCODER_H_
+
+#include "lancet/base/types.h"
+#include "lancet/caller/variant_call.h"
+
+extern "C" {
+#include "htslib/vcf.h"
+}
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace lancet::caller {
+
+// ============================================================================
+// BcfRecordEncoder: VariantCall → bcf1_t without a text round trip.
+//
+// The binary counterpart of VariantCall::AppendVcfRecord /
+// SampleFormatData::AppendVcfString: every INFO and FORMAT tag listed in
+// vcf_formatter.h::FORMAT_HEADER is written from the call's numeric fields with
+// the bcf_update_* API — integers as int32, floats as IEEE f32 (no decimal
+// rounding), absent optionals as bcf_*_missing. The only strings encoded are
+// the ones the header declares as Type=String (TYPE, GRAPH_CX, SEQ_CX).
+//
+// The per-sample scratch arrays are members and reused across records, so a
+// long run encodes without steady-state allocation. One encoder per writer.
+// ============================================================================
+class BcfRecordEncoder {
+ public:
+  explicit BcfRecordEncoder(bcf_hdr_t* hdr);
+
+  /// Fills `rec` (already cleared) with `call`.
+  void Encode(VariantCall const& call, bcf1_t* rec);
+
+ private:
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  bcf_hdr_t* mHeader;
+  std::string mChromName;  // contig of the previous record, to skip name → rid lookups
+  std::string mTypeText;
+  std::vector<char const*> mAlleles;
+  std::vector<i32> mInts;
+  std::vector<f32> mFloats;
+  // ── 4B Align ────────────────────────────────────────────────────────────
+  i32 mChromRid = -1;
+  // ── 1B Align ────────────────────────────────────────────────────────────
+  // SHARED/CTRL/CASE declared in the header (case-control mode only)
+  std::array<bool, VariantCall::STATE_NAMES.size()> mHasStateTag{};
+
+  void EncodeInfo(VariantCall const& call, bcf1_t* rec);
+  void EncodeFormat(VariantCall const& call, bcf1_t* rec);
+  void UpdateInts(bcf1_t* rec, char const* tag);
+  void UpdateFloats(bcf1_t* rec, char const* tag);
+};
+
+}  // namespace lancet::caller
+
+#endif  // SRC_LANCET_CALLER_BCF_RECORD_ENCODER_H_
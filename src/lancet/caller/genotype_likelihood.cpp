@@ -250,6 +250,43 @@ auto ComputeGenotypePLs(absl::Span<int const> allele_counts) -> absl::InlinedVec
   return NormalizeToPLs(genotype_log_lks);
 }
 
+// ============================================================================
+// ComputeReadLikelihoodPLs: Phred-scaled likelihoods from per-read likelihoods.
+//
+// The per-read product model GATK HaplotypeCaller uses: reads are independent
+// given the genotype, and each read is drawn from either chromosome with equal
+// probability. The mixture is evaluated as max + log10(1 + 10^−|Δ|) − log10(2)
+// so no term is exponentiated out of range.
+// ============================================================================
+auto ComputeReadLikelihoodPLs(absl::Span<f64 const> read_allele_log10_liks,
+                              usize const num_alleles) -> absl::InlinedVector<u32, 6> {
+  if (num_alleles == 0) return {};
+
+  auto const num_genotypes = num_alleles * (num_alleles + 1) / 2;
+  auto const num_reads = read_allele_log10_liks.size() / num_alleles;
+  f64 const log10_half = std::log10(0.5);
+
+  std::vector<f64> genotype_log_lks(num_genotypes, 0.0);
+  usize genotype_idx = 0;
+
+  for (usize allele_b = 0; allele_b < num_alleles; ++allele_b) {
+    for (usize allele_a = 0; allele_a <= allele_b; ++allele_a) {
+      f64 log10_lk = 0.0;
+      for (usize read_idx = 0; read_idx < num_reads; ++read_idx) {
+        auto const row = read_allele_log10_liks.subspan(read_idx * num_alleles, num_alleles);
+        f64 const hi = std::max(row[allele_a], row[allele_b]);
+        f64 const lo = std::min(row[allele_a], row[allele_b]);
+        log10_lk += hi + std::log10(1.0 + std::pow(10.0, lo - hi)) + log10_half;
+      }
+      // NormalizeToPLs expects natural-log likelihoods
+      genotype_log_lks[genotype_idx] = log10_lk * std::numbers::ln10;
+      ++genotype_idx;
+    }
+  }
+
+  return NormalizeToPLs(genotype_log_lks);
+}
+
 // ============================================================================
 // ComputeGenotypeQuality: GQ from PLs.
 //
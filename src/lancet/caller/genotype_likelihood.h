@@ -36,6 +36,16 @@ namespace lancet::caller {
 [[nodiscard]] auto ComputeGenotypePLs(absl::Span<int const> allele_counts)
     -> absl::InlinedVector<u32, 6>;
 
+/// Compute Phred-scaled genotype likelihoods from per-read allele likelihoods.
+/// Used by the pair-HMM genotyping backend in place of the count-based DM model.
+///
+/// `read_allele_log10_liks` is row-major: one row of `num_alleles` values
+/// log10 P(read | allele) per read. Each read contributes the diploid mixture
+///   log10 P(read | a1, a2) = log10( P(read | a1) / 2 + P(read | a2) / 2 )
+/// to every genotype, in the same VCF-standard order as ComputeGenotypePLs.
+[[nodiscard]] auto ComputeReadLikelihoodPLs(absl::Span<f64 const> read_allele_log10_liks,
+                                            usize num_alleles) -> absl::InlinedVector<u32, 6>;
+
 /// Genotype Quality: second-smallest PL value, capped at 99.
 /// Standard GATK convention: GQ = min2 - min1. After normalization, min1 = 0.
 /// See: https://gatk.broadinstitute.org/hc/en-us/articles/360035531692
@@ -1,13 +1,17 @@
 #include "lancet/caller/genotyper.h"
 
+#include "lancet/base/assert.h"
 #include "lancet/base/types.h"
 #include "lancet/caller/allele_scoring_types.h"
 #include "lancet/caller/combined_scorer.h"
+#include "lancet/caller/hap_alignment_cache.h"
 #include "lancet/caller/local_scorer.h"
+#include "lancet/caller/pair_hmm.h"
 #include "lancet/caller/raw_variant.h"
 #include "lancet/caller/variant_set.h"
 #include "lancet/caller/variant_support.h"
 #include "lancet/cbdg/read.h"
+#include "lancet/cbdg/read_batch.h"
 #include "lancet/hts/cigar_unit.h"
 #include "lancet/hts/cigar_utils.h"
 
@@ -17,10 +21,14 @@ extern "C" {
 #include "mmpriv.h"
 }
 
+#include "absl/container/inlined_vector.h"
 #include "absl/hash/hash.h"
 #include "absl/types/span.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -68,6 +76,24 @@ auto BuildCigar(mm_reg1_t const* hit, int qlen) -> std::vector<lancet::hts::Ciga
   return cigar;
 }
 
+// Haplotype slice the pair-HMM evaluates for one read: the minimap2 span widened
+// by the read's soft clips plus a fixed pad, so every placement the forward sum
+// could weigh non-negligibly stays inside the band.
+auto PairHmmBand(lancet::caller::Mm2AlnResult const& aln, usize const hap_len, usize const pad)
+    -> std::pair<usize, usize> {
+  auto const clip_len = [](lancet::hts::CigarUnit const& unit) -> usize {
+    return unit.Operation() == lancet::hts::CigarOp::SOFT_CLIP ? unit.Length() : 0;
+  };
+  usize const lead_clip = aln.mCigar.empty() ? 0 : clip_len(aln.mCigar.front());
+  usize const tail_clip = aln.mCigar.empty() ? 0 : clip_len(aln.mCigar.back());
+
+  auto const aln_start = static_cast<usize>(std::max(aln.mRefStart, 0));
+  auto const aln_end = std::min(static_cast<usize>(std::max(aln.mRefEnd, 0)), hap_len);
+  usize const band_start = aln_start > lead_clip + pad ? aln_start - lead_clip - pad : 0;
+  usize const band_end = std::min(hap_len, aln_end + tail_clip + pad);
+  return {band_start, std::max(band_start, band_end)};
+}
+
 }  // namespace
 
 namespace lancet::caller {
@@ -86,7 +112,7 @@ namespace lancet::caller {
 // See scoring_constants.h for the SCORING_* values and
 // docs/guides/variant_discovery_genotyping.md for the design rationale.
 // ============================================================================
-Genotyper::Genotyper() {
+Genotyper::Genotyper(GenotypingBackend const backend) : mBackend(backend) {
   // 0 -> no info, 1 -> error, 2 -> warning, 3 -> debug
   mm_verbose = 1;
 
@@ -221,34 +247,60 @@ Genotyper::Genotyper() {
 //   │  support     │
 //   └──────────────┘
 // ============================================================================
-auto Genotyper::Genotype(Haplotypes hap_seqs, Reads qry_reads, VariantSet const& variant_set)
-    -> Result {
+auto Genotyper::Genotype(Haplotypes hap_seqs, Reads qry_reads, cbdg::ReadBatch const& batch,
+                         VariantSet const& variant_set) -> Result {
+  LANCET_ASSERT(batch.Size() == qry_reads.size())
   ResetData(hap_seqs);
   Result out_vars_table;
 
+  // Per-sample read counts bound how many reads any one allele can collect,
+  // so each sample's evidence columns are sized once instead of regrowing.
+  absl::InlinedVector<usize, 8> reads_per_sample;
   for (auto const& qry_read : qry_reads) {
-    auto allele_assignments = AssignReadToAlleles(qry_read, variant_set);
-    AddToTable(out_vars_table, qry_read, allele_assignments);
+    if (qry_read.SampleIndex() >= reads_per_sample.size()) {
+      reads_per_sample.resize(qry_read.SampleIndex() + 1, 0);
+    }
+    reads_per_sample[qry_read.SampleIndex()]++;
+  }
+
+  // nt4 bases and qname hashes come precomputed from the window's ReadBatch,
+  // so the per-read loop performs no sequence re-encoding or string hashing.
+  for (usize read_idx = 0; read_idx < qry_reads.size(); ++read_idx) {
+    auto const& qry_read = qry_reads[read_idx];
+    HapAlignmentCache::Key const read_key{.mQnameHash = batch.QnameHash(read_idx),
+                                          .mReadSeqHash = batch.SeqHash(read_idx),
+                                          .mReadLength = static_cast<u32>(qry_read.Length())};
+    auto allele_assignments =
+        AssignReadToAlleles(qry_read, batch.EncodedBases(read_idx), read_key, variant_set);
+    AddToTable(out_vars_table, qry_read, batch.QnameHash(read_idx),
+               reads_per_sample[qry_read.SampleIndex()], allele_assignments);
   }
 
   return out_vars_table;
 }
 
 // ============================================================================
-// ResetData: build minimap2 indices for all haplotype sequences.
+// ResetData: prepare per-window haplotype state.
 //
-// Each haplotype gets its own index so we can align reads independently
-// to REF and each ALT haplotype and compare scores.
+// Each haplotype gets its own minimap2 index so we can align reads
+// independently to REF and each ALT haplotype and compare scores. Indices are
+// NOT built here: when every read's alignment against a haplotype is already
+// in mAlnCache (a haplotype re-assembled identically in a neighbouring
+// window), that haplotype's index is never needed. IndexFor() builds each one
+// on the first cache miss instead.
+//
+// The PAIR_HMM backend never builds an index; its ReadPlacer k-mer tables are
+// rebuilt here instead, since they are cheap next to one mm_idx_str.
 // ============================================================================
 void Genotyper::ResetData(Haplotypes hap_seqs) {
+  mHapSeqs = hap_seqs;
   mIndices.clear();
-  mIndices.reserve(hap_seqs.size());
+  mIndices.resize(hap_seqs.size());
 
-  auto const* iopts = mIndexingOpts.get();
+  mHapSeqHashes.clear();
+  mHapSeqHashes.reserve(hap_seqs.size());
   for (auto const& hap_seq : hap_seqs) {
-    char const* raw_seq = hap_seq.c_str();
-    auto* idx_result = mm_idx_str(iopts->w, iopts->k, 0, iopts->bucket_bits, 1, &raw_seq, nullptr);
-    mIndices.emplace_back(Minimap2Index(idx_result));
+    mHapSeqHashes.push_back(absl::HashOf(std::string_view(hap_seq)));
   }
 
   // Pre-encode haplotype sequences for local scoring.
@@ -260,23 +312,40 @@ void Genotyper::ResetData(Haplotypes hap_seqs) {
     mEncodedHaplotypes.push_back(EncodeSequence(hap_seq));
   }
 
-  auto* mopts = mMappingOpts.get();
-  for (auto const& mm2_idx : mIndices) {
-    mm_mapopt_update(mopts, mm2_idx.get());
-  }
+  if (mBackend == GenotypingBackend::PAIR_HMM) mPlacer.Reset(mEncodedHaplotypes);
 }
 
-auto Genotyper::AssignReadToAlleles(cbdg::Read const& qry_read, VariantSet const& variant_set)
-    -> PerVariantAssignment {
-  auto all_alns = AlignToAllHaplotypes(qry_read);
+// ============================================================================
+// IndexFor: build the haplotype's minimap2 index on first use in this window.
+//
+// mm_mapopt_update only derives mid_occ from the first index it ever sees
+// (it is a no-op once mid_occ > 0), so building lazily leaves the mapping
+// options — and therefore every cached alignment — unchanged.
+// ============================================================================
+auto Genotyper::IndexFor(usize const hap_idx) -> mm_idx_t const* {
+  LANCET_ASSERT(hap_idx < mIndices.size())
+  auto& mm2_idx = mIndices[hap_idx];
+  if (mm2_idx != nullptr) return mm2_idx.get();
+
+  auto const* iopts = mIndexingOpts.get();
+  char const* raw_seq = mHapSeqs[hap_idx].c_str();
+  mm2_idx.reset(mm_idx_str(iopts->w, iopts->k, 0, iopts->bucket_bits, 1, &raw_seq, nullptr));
+  mm_mapopt_update(mMappingOpts.get(), mm2_idx.get());
+  return mm2_idx.get();
+}
+
+auto Genotyper::AssignReadToAlleles(cbdg::Read const& qry_read,
+                                    absl::Span<u8 const> qry_seq_encoded,
+                                    HapAlignmentCache::Key const& read_key,
+                                    VariantSet const& variant_set) -> PerVariantAssignment {
+  auto all_alns = AlignToAllHaplotypes(qry_read, qry_seq_encoded, read_key);
   if (all_alns.empty()) return {};
 
   auto const qry_quals = qry_read.QualView();
-  auto const qry_seq_encoded = EncodeSequence(qry_read.SeqView());
   usize const qry_read_length = qry_read.Length();
 
   ReadAlnContext const read_ctx{
-      .mSeqEncoded = absl::MakeConstSpan(qry_seq_encoded),
+      .mSeqEncoded = qry_seq_encoded,
       .mBaseQuals = qry_quals,
       .mReadLength = qry_read_length,
   };
@@ -285,38 +354,72 @@ auto Genotyper::AssignReadToAlleles(cbdg::Read const& qry_read, VariantSet const
   // Calculated exactly once per read.
   u32 const baseline_ref_nm = ComputeHaplotypeEditDistance(
       all_alns, absl::MakeConstSpan(mEncodedHaplotypes[REF_HAP_IDX]),
-      absl::MakeConstSpan(qry_seq_encoded), qry_read_length, REF_HAP_IDX);
+      qry_seq_encoded, qry_read_length, REF_HAP_IDX);
 
   PerVariantAssignment allele_assignments;
+  bool const use_pair_hmm = mBackend == GenotypingBackend::PAIR_HMM;
+  auto const ranking_score = [use_pair_hmm](ReadAlleleAssignment const& assignment) -> f64 {
+    return use_pair_hmm ? assignment.mHapLog10Lik : assignment.CombinedScore();
+  };
 
   // For each haplotype alignment, score all overlapping variants.
   // all_alns is tiny (~2–10 items, one per assembled haplotype).
   for (auto const& aln : all_alns) {
     auto const haplotype = absl::MakeConstSpan(mEncodedHaplotypes[aln.mHapIdx]);
 
+    // One banded forward pass per (read, haplotype), shared by every variant
+    // the read overlaps on it. The band is the read's own footprint, so the
+    // cost scales with read length rather than with the window's haplotypes.
+    f64 hap_log10_lik = 0.0;
+    if (use_pair_hmm) {
+      auto const [band_start, band_end] = PairHmmBand(aln, haplotype.size(), PAIR_HMM_BAND_PAD);
+      auto const band = haplotype.subspan(band_start, band_end - band_start);
+      hap_log10_lik = mPairHmm.Log10Likelihood(qry_seq_encoded, qry_quals, band);
+    }
+
     for (auto const& variant : variant_set) {
       auto const bounds = ExtractHapBounds(variant, aln.mHapIdx);
       if (!bounds || !OverlapsAlignment(aln, *bounds)) continue;
 
       auto scored = ScoreReadAtVariant(aln, haplotype, read_ctx, *bounds);
       scored.mRefNm = baseline_ref_nm;
+      scored.mHapLog10Lik = hap_log10_lik;
 
       // Reuse the hash probe: find once, then compare, update-in-place
       // or emplace_hint — avoids searching the map twice.
       auto iter = allele_assignments.find(&variant);
-      if (iter != allele_assignments.end() &&
-          scored.CombinedScore() <= iter->second.CombinedScore()) {
-        continue;
+      if (iter == allele_assignments.end()) {
+        iter = allele_assignments.emplace_hint(iter, &variant, scored);
+        if (use_pair_hmm) {
+          iter->second.mAlleleLog10Liks.assign(variant.mAlts.size() + 1,
+                                               -std::numeric_limits<f64>::infinity());
+        }
+      } else if (ranking_score(scored) > ranking_score(iter->second)) {
+        auto allele_liks = std::move(iter->second.mAlleleLog10Liks);
+        iter->second = scored;
+        iter->second.mAlleleLog10Liks = std::move(allele_liks);
       }
 
-      if (iter != allele_assignments.end()) {
-        iter->second = scored;
-      } else {
-        allele_assignments.emplace_hint(iter, &variant, scored);
+      // An allele's likelihood is that of its best-explaining haplotype (GATK's
+      // haplotype → allele marginalisation), whichever allele the read ranks first.
+      if (use_pair_hmm) {
+        auto& allele_lik = iter->second.mAlleleLog10Liks[bounds->mAllele];
+        allele_lik = std::max(allele_lik, hap_log10_lik);
       }
     }
   }
 
+  // Alleles whose haplotypes the read never aligned to, and alleles far below
+  // the best one, are floored at best − PAIR_HMM_MAX_LOG10_LIK_GAP so a single
+  // mismapped read cannot veto a genotype on its own.
+  if (use_pair_hmm) {
+    for (auto& [var_ptr, assignment] : allele_assignments) {
+      auto& allele_liks = assignment.mAlleleLog10Liks;
+      f64 const floor_lik = *std::ranges::max_element(allele_liks) - PAIR_HMM_MAX_LOG10_LIK_GAP;
+      for (auto& allele_lik : allele_liks) allele_lik = std::max(allele_lik, floor_lik);
+    }
+  }
+
   return allele_assignments;
 }
 
@@ -372,42 +475,71 @@ auto Genotyper::OverlapsAlignment(Mm2AlnResult const& aln, HapVariantBounds cons
 // haplotype, we must align to all haplotypes to compute correct cross-haplotype
 // noise constraints, relative edit distances against the reference baseline,
 // and global best-match boundaries.
+//
+// Each (read, haplotype sequence) pair is looked up in mAlnCache first;
+// overlapping windows re-genotype the same reads against identical haplotypes,
+// and those pairs skip mm_map entirely. mHapIdx is restamped on every hit
+// because the same haplotype sits at a different index per window.
+//
+// The PAIR_HMM backend never calls mm_map: AlignToHaplotype places the read
+// with ReadPlacer, whose banded DP is all the forward pass needs.
 // ============================================================================
-auto Genotyper::AlignToAllHaplotypes(cbdg::Read const& qry_read) -> std::vector<Mm2AlnResult> {
+auto Genotyper::AlignToAllHaplotypes(cbdg::Read const& qry_read,
+                                     absl::Span<u8 const> qry_seq_encoded,
+                                     HapAlignmentCache::Key const& read_key)
+    -> std::vector<Mm2AlnResult> {
   std::vector<Mm2AlnResult> results;
   results.reserve(mIndices.size());
 
-  int nregs = 0;
-  auto* tbuffer = mThreadBuffer.get();
-  auto const* map_opts = mMappingOpts.get();
-  auto const read_len = static_cast<int>(qry_read.Length());
-
   for (usize idx = 0; idx < mIndices.size(); ++idx) {
-    auto const* hap_mm_idx = mIndices[idx].get();
-    auto* regs = mm_map(hap_mm_idx, read_len, qry_read.SeqPtr(), &nregs, tbuffer, map_opts,
-                        qry_read.QnamePtr());
-
-    if (regs == nullptr || nregs <= 0) {
-      FreeMm2Alignment(regs, nregs);
+    auto key = read_key;
+    key.mHapSeqHash = mHapSeqHashes[idx];
+    key.mHapLength = static_cast<u32>(mHapSeqs[idx].size());
+
+    if (auto const* cached = mAlnCache.Find(key); cached != nullptr) {
+      if (!cached->has_value()) continue;
+      results.push_back(**cached);
+      results.back().mHapIdx = idx;
       continue;
     }
 
-    // Take the top hit only (best_n = 1)
-    mm_reg1_t const* top_hit = &regs[0];
+    auto aligned = AlignToHaplotype(qry_read, qry_seq_encoded, idx);
+    mAlnCache.Insert(key, aligned);
+    if (aligned) results.push_back(*std::move(aligned));
+  }
+
+  return results;
+}
+
+auto Genotyper::AlignToHaplotype(cbdg::Read const& qry_read,
+                                 absl::Span<u8 const> qry_seq_encoded, usize const hap_idx)
+    -> std::optional<Mm2AlnResult> {
+  if (mBackend == GenotypingBackend::PAIR_HMM) return mPlacer.Place(qry_seq_encoded, hap_idx);
 
-    Mm2AlnResult result;
-    result.mScore = top_hit->score;
-    result.mRefStart = top_hit->rs;  // critical: where alignment starts on haplotype
-    result.mRefEnd = top_hit->re;
-    result.mIdentity = mm_event_identity(top_hit);
-    result.mHapIdx = idx;
-    result.mCigar = BuildCigar(top_hit, read_len);
+  int nregs = 0;
+  auto const* hap_mm_idx = IndexFor(hap_idx);
+  auto const read_len = static_cast<int>(qry_read.Length());
+  auto* regs = mm_map(hap_mm_idx, read_len, qry_read.SeqPtr(), &nregs, mThreadBuffer.get(),
+                      mMappingOpts.get(), qry_read.QnamePtr());
 
-    results.push_back(std::move(result));
+  if (regs == nullptr || nregs <= 0) {
     FreeMm2Alignment(regs, nregs);
+    return std::nullopt;
   }
 
-  return results;
+  // Take the top hit only (best_n = 1)
+  mm_reg1_t const* top_hit = &regs[0];
+
+  Mm2AlnResult result;
+  result.mScore = top_hit->score;
+  result.mRefStart = top_hit->rs;  // critical: where alignment starts on haplotype
+  result.mRefEnd = top_hit->re;
+  result.mIdentity = mm_event_identity(top_hit);
+  result.mHapIdx = hap_idx;
+  result.mCigar = BuildCigar(top_hit, read_len);
+
+  FreeMm2Alignment(regs, nregs);
+  return result;
 }
 
 // ============================================================================
@@ -421,25 +553,26 @@ auto Genotyper::AlignToAllHaplotypes(cbdg::Read const& qry_read) -> std::vector<
 // All metrics flow through to VCF FORMAT fields via VariantSupport aggregation.
 // ============================================================================
 void Genotyper::AddToTable(Result& out_vars_table, cbdg::Read const& qry_read,
+                           u64 const qname_hash, usize const sample_reads,
                            PerVariantAssignment const& allele_assignments) {
-  auto const sample_name = qry_read.SampleName();
-  auto const rname_hash = absl::HashOf(qry_read.QnameView());
+  auto const sample_index = qry_read.SampleIndex();
   auto const strand = qry_read.Flag().IsRevStrand() ? Strand::REV : Strand::FWD;
 
   for (auto const& [var_ptr, assignment] : allele_assignments) {
     // Look up (or create) the per-sample evidence aggregator for this variant.
-    // Result is keyed: variant → sample_name → VariantSupport.
+    // Result is keyed: variant → sample_index → VariantSupport.
     // Default insertion occurs at both tier levels:
-    //   rslt[var_ptr]               → inserts an empty SupportArray interface
-    //   .FindOrCreate(sample_name)  → creates a unique_ptr<VariantSupport> on first access.
-    auto& support = out_vars_table[var_ptr].FindOrCreate(sample_name);
+    //   rslt[var_ptr]                → inserts an empty SupportArray interface
+    //   .FindOrCreate(sample_index)  → sizes the dense slot and its columns on first access.
+    auto& support = out_vars_table[var_ptr].FindOrCreate(sample_index, sample_reads);
 
     auto const evidence = VariantSupport::ReadEvidence{
         .mInsertSize = qry_read.InsertSize(),
         .mAlignmentStart = qry_read.StartPos0(),
         .mAlnScore = assignment.CombinedScore(),
         .mFoldedReadPos = assignment.mFoldedReadPos,
-        .mRnameHash = static_cast<u32>(rname_hash),
+        .mAlleleLog10Liks = absl::MakeConstSpan(assignment.mAlleleLog10Liks),
+        .mRnameHash = static_cast<u32>(qname_hash),
         .mRefNm = assignment.mRefNm,
         .mOwnHapNm = assignment.mOwnHapNm,
         .mAssignedHaplotypeId = assignment.mAssignedHaplotypeId,
@@ -3,10 +3,14 @@
 
 #include "lancet/base/types.h"
 #include "lancet/caller/allele_scoring_types.h"
+#include "lancet/caller/hap_alignment_cache.h"
+#include "lancet/caller/pair_hmm.h"
+#include "lancet/caller/read_placer.h"
 #include "lancet/caller/scoring_constants.h"
 #include "lancet/caller/support_array.h"
 #include "lancet/caller/variant_support.h"
 #include "lancet/cbdg/read.h"
+#include "lancet/cbdg/read_batch.h"
 #include "lancet/hts/cigar_unit.h"
 #include "lancet/hts/cigar_utils.h"
 
@@ -15,6 +19,7 @@ extern "C" {
 }
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/types/span.h"
 
 #include <array>
@@ -28,20 +33,6 @@ namespace lancet::caller {
 
 class VariantSet;
 class RawVariant;
-// ============================================================================
-// Alignment result from mm_map for a single read-to-haplotype alignment
-// ============================================================================
-struct Mm2AlnResult {
-  // ── 8B Align ────────────────────────────────────────────────────────────
-  std::vector<hts::CigarUnit> mCigar;  // 24B — CIGAR operations
-  f64 mIdentity = 0.0;                 // 8B  — gap-compressed identity
-  usize mHapIdx = 0;                   // 8B  — index of haplotype this alignment maps to
-  // ── 4B Align ────────────────────────────────────────────────────────────
-  i32 mScore = 0;     // 4B  — DP alignment score
-  i32 mRefStart = 0;  // 4B  — 0-based start on haplotype
-  i32 mRefEnd = 0;    // 4B  — 0-based end on haplotype
-};
-
 // ============================================================================
 // ReadAlleleAssignment: per-read allele assignment result.
 //
@@ -146,7 +137,8 @@ struct Mm2AlnResult {
 //   - bcftools mpileup: uses the minimum base quality in the indel region
 //     as the representative quality for that read.
 //
-// We follow the bcftools convention since we don't have a full PairHMM.
+// The MINIMAP2 backend follows the bcftools convention; the PAIR_HMM backend
+// additionally carries per-allele read likelihoods into the PLs (see below).
 // The collapse to a single value here ensures that downstream PL and PBQ
 // computations correctly treat each read as one independent observation.
 struct ReadAlleleAssignment {
@@ -154,6 +146,9 @@ struct ReadAlleleAssignment {
   f64 mLocalScore = 0.0;     // PBQ-weighted DP score within variant region
   f64 mLocalIdentity = 0.0;  // fraction of exact matches in variant region
   f64 mFoldedReadPos = 0.0;  // Used for RPCD FORMAT field
+  f64 mHapLog10Lik = 0.0;    // banded pair-HMM log10 P(read | haplotype); 0 under MINIMAP2
+  // pair-HMM log10 P(read | allele), one per allele of the variant; empty under MINIMAP2
+  absl::InlinedVector<f64, 4> mAlleleLog10Liks;
 
   // ── 4B Align ────────────────────────────────────────────────────────────
   i32 mGlobalScore = 0;          // mm_map DP − sc_penalty − local_raw_score (M/=/X only, no I/D)
@@ -199,6 +194,24 @@ struct ReadAlleleAssignment {
  *    - Goal: Accurately segregate read support to calculate clean VAFs.
  * ============================================================================
  */
+// ============================================================================
+// GenotypingBackend: evidence used to pick a read's allele at each variant.
+//
+//   MINIMAP2  — CombinedScore(): mm_map DP score with the PBQ-weighted local
+//               rescoring described above (default).
+//   PAIR_HMM  — forward-algorithm log10 P(read | haplotype) from PairHmm,
+//               marginalised over all read placements on the haplotype slice
+//               the read aligned to (widened by PAIR_HMM_BAND_PAD). Each
+//               allele's likelihood is its best haplotype's; those per-read
+//               allele likelihoods replace the DM counts in the PLs.
+//
+// PAIR_HMM places reads with ReadPlacer (k-mer seeded banded DP) instead of
+// mm_map: the forward pass already sums over placements, so only the band and
+// the CIGAR-derived annotations (variant overlap, read position, NM, local BQ)
+// are needed, and no minimap2 index is built for the window.
+// ============================================================================
+enum class GenotypingBackend : u8 { MINIMAP2 = 0, PAIR_HMM = 1 };
+
 // ============================================================================
 // Genotyper: minimap2-based read-to-haplotype alignment for genotyping
 //
@@ -207,17 +220,21 @@ struct ReadAlleleAssignment {
 //
 // Isolation boundary: AssignReadToAlleles() encapsulates the alignment
 // engine. Everything downstream (AddToTable, VariantSupport) is decoupled.
+//
+// One Genotyper lives per worker and outlives its windows; read-to-haplotype
+// alignments are memoized across windows in mAlnCache (hap_alignment_cache.h).
 // ============================================================================
 class Genotyper {
  public:
-  Genotyper();
+  explicit Genotyper(GenotypingBackend backend = GenotypingBackend::MINIMAP2);
 
   using Reads = absl::Span<cbdg::Read const>;
   using Haplotypes = absl::Span<std::string const>;
   using Result = absl::flat_hash_map<RawVariant const*, SupportArray>;
 
-  [[nodiscard]] auto Genotype(Haplotypes hap_seqs, Reads qry_reads, VariantSet const& variant_set)
-      -> Result;
+  /// `batch` must be built from exactly `qry_reads` — per-read encodings are looked up by index.
+  [[nodiscard]] auto Genotype(Haplotypes hap_seqs, Reads qry_reads, cbdg::ReadBatch const& batch,
+                              VariantSet const& variant_set) -> Result;
 
  private:
   // ============================================================================
@@ -237,25 +254,46 @@ class Genotyper {
   using Minimap2Index = std::unique_ptr<mm_idx_t, MmIdxDeleter>;
 
   static constexpr usize REF_HAP_IDX = 0;
+  /// Haplotype bases kept beyond each end of a read's alignment for the pair-HMM.
+  static constexpr usize PAIR_HMM_BAND_PAD = 16;
+  /// Floor on a read's allele likelihoods below its best allele (GATK's mismapping cap).
+  static constexpr f64 PAIR_HMM_MAX_LOG10_LIK_GAP = 4.5;
 
   // ============================================================================
   // Outer Class Variables Block (Sorted by descending size: 24B -> 8B -> 4B)
   // ============================================================================
   // ── 8B Align ────────────────────────────────────────────────────────────
-  std::vector<Minimap2Index> mIndices;  // 24B
+  PairHmm mPairHmm;                     // 576B — f32/f64 scratch reused across reads
+  ReadPlacer mPlacer;                   // PAIR_HMM read placement, rebuilt per window
+  HapAlignmentCache mAlnCache;          // 72B — survives across windows
+  std::vector<Minimap2Index> mIndices;  // 24B — built lazily, null until first cache miss
+  std::vector<u64> mHapSeqHashes;       // 24B — absl::HashOf per haplotype
   // numeric-encoded haplotypes for local scoring
   std::vector<std::vector<u8>> mEncodedHaplotypes;               // 24B
+  Haplotypes mHapSeqs;                                           // 16B — valid during Genotype()
   MappingOpts mMappingOpts = std::make_unique<mm_mapopt_t>();    // 8B
   IndexingOpts mIndexingOpts = std::make_unique<mm_idxopt_t>();  // 8B
   ThreadBuffer mThreadBuffer = ThreadBuffer(mm_tbuf_init());     // 8B
+  // ── 1B Align ────────────────────────────────────────────────────────────
+  GenotypingBackend mBackend = GenotypingBackend::MINIMAP2;
 
   void ResetData(Haplotypes hap_seqs);
+  [[nodiscard]] auto IndexFor(usize hap_idx) -> mm_idx_t const*;
 
   using PerVariantAssignment = absl::flat_hash_map<RawVariant const*, ReadAlleleAssignment>;
-  [[nodiscard]] auto AssignReadToAlleles(cbdg::Read const& qry_read, VariantSet const& variant_set)
-      -> PerVariantAssignment;
+  [[nodiscard]] auto AssignReadToAlleles(cbdg::Read const& qry_read,
+                                         absl::Span<u8 const> qry_seq_encoded,
+                                         HapAlignmentCache::Key const& read_key,
+                                         VariantSet const& variant_set) -> PerVariantAssignment;
 
-  [[nodiscard]] auto AlignToAllHaplotypes(cbdg::Read const& qry_read) -> std::vector<Mm2AlnResult>;
+  /// `read_key` carries the read's half of the cache key; the haplotype half is filled per index.
+  [[nodiscard]] auto AlignToAllHaplotypes(cbdg::Read const& qry_read,
+                                          absl::Span<u8 const> qry_seq_encoded,
+                                          HapAlignmentCache::Key const& read_key)
+      -> std::vector<Mm2AlnResult>;
+  [[nodiscard]] auto AlignToHaplotype(cbdg::Read const& qry_read,
+                                      absl::Span<u8 const> qry_seq_encoded, usize hap_idx)
+      -> std::optional<Mm2AlnResult>;
 
   // ============================================================================
   // ExtractHapBounds: resolve a minimap2 alignment's haplotype index to the
@@ -297,8 +335,8 @@ class Genotyper {
   [[nodiscard]] static auto OverlapsAlignment(Mm2AlnResult const& aln,
                                               HapVariantBounds const& bounds) -> bool;
 
-  static void AddToTable(Result& out_vars_table, cbdg::Read const& qry_read,
-                         PerVariantAssignment const& allele_assignments);
+  static void AddToTable(Result& out_vars_table, cbdg::Read const& qry_read, u64 qname_hash,
+                         usize sample_reads, PerVariantAssignment const& allele_assignments);
 };
 
 }  // namespace lancet::caller
@@ -0,0 +1,46 @@
+#include "lancet/caller/hap_alignment_cache.h"
+
+#include "lancet/base/assert.h"
+#include "lancet/base/types.h"
+
+#include <utility>
+
+namespace lancet::caller {
+
+HapAlignmentCache::HapAlignmentCache(usize const generation_capacity)
+    : mGenerationCapacity(generation_capacity) {
+  LANCET_ASSERT(generation_capacity > 0)
+}
+
+auto HapAlignmentCache::Find(Key const& key) -> Entry const* {
+  if (auto const iter = mCurrent.find(key); iter != mCurrent.end()) return &iter->second;
+
+  auto node = mPrevious.extract(key);
+  if (node.empty()) return nullptr;
+
+  // Promote into the current generation so entries still in use survive the
+  // next rotation. The node is detached before rotating, so it outlives the
+  // old previous generation being dropped.
+  RotateIfFull();
+  auto const result = mCurrent.insert(std::move(node));
+  return &result.position->second;
+}
+
+void HapAlignmentCache::Insert(Key const& key, Entry entry) {
+  RotateIfFull();
+  mCurrent.insert_or_assign(key, std::move(entry));
+}
+
+void HapAlignmentCache::Clear() {
+  mCurrent.clear();
+  mPrevious.clear();
+}
+
+void HapAlignmentCache::RotateIfFull() {
+  if (mCurrent.size() < mGenerationCapacity) return;
+  mPrevious = std::move(mCurrent);
+  mCurrent = Generation();
+  mCurrent.reserve(mGenerationCapacity);
+}
+
+}  // namespace lancet::caller
@@ -0,0 +1,117 @@
+#ifndef SRC_LANCET_CALLER_HAP_ALIGNMENT_CACHE_H_
+#define SRC_LANCET_CALLER_HAP_ALIGNMENT_CACHE_H_
+
+#include "lancet/base/types.h"
+#include "lancet/hts/cigar_unit.h"
+
+#include "absl/container/flat_hash_map.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace lancet::caller {
+
+// ============================================================================
+// Alignment result from mm_map for a single read-to-haplotype alignment
+// ============================================================================
+struct Mm2AlnResult {
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  std::vector<hts::CigarUnit> mCigar;  // 24B — CIGAR operations
+  f64 mIdentity = 0.0;                 // 8B  — gap-compressed identity
+  usize mHapIdx = 0;                   // 8B  — index of haplotype this alignment maps to
+  // ── 4B Align ────────────────────────────────────────────────────────────
+  i32 mScore = 0;     // 4B  — DP alignment score
+  i32 mRefStart = 0;  // 4B  — 0-based start on haplotype
+  i32 mRefEnd = 0;    // 4B  — 0-based end on haplotype
+};
+
+// ============================================================================
+// HapAlignmentCache: per-worker memo of read → haplotype alignments.
+//
+// Windows overlap by 20% and are padded on both sides, so the same reads are
+// re-genotyped against byte-identical haplotypes (the REF slice always, and
+// any ALT path assembled identically) in two or three neighbouring windows.
+// With the mapping options fixed for the worker's lifetime, an mm_map result
+// is a pure function of (read name, read bases, haplotype bases): minimap2
+// breaks ties between equal-scoring hits with a hash of the query name, so
+// two reads with the same bases can still align differently. The alignment
+// is reused verbatim only when all three reappear.
+//
+// Key:   hashes of the qname, the read sequence and the haplotype sequence,
+//        plus both sequence lengths. Window and haplotype index are NOT part
+//        of the key — the same haplotype is a different index in each window,
+//        and mHapIdx is restamped by the caller on every hit.
+//
+// The key stores hashes, not sequences, so that an entry costs the same for
+// a 150 bp read and a 5 kbp haplotype. A false hit needs two different
+// (qname, read) pairs to agree on two independent 64-bit hashes and a
+// length, or two different haplotypes of equal length to agree on one 64-bit
+// hash. Only the entries live in the last two generations can collide: with
+// H haplotypes live at once (a few thousand at most), the second case has
+// probability about H² / 2^65 ≈ 2e-13 per rotation, and the first is smaller
+// still. A whole WGS run stays far below one expected collision.
+// Value: std::nullopt records "read does not map to this haplotype", so
+//        unmapped pairs are not retried either.
+//
+// Eviction is generational instead of LRU: lookups go to the current
+// generation first, then the previous one (promoting the hit). When the
+// current generation reaches capacity it becomes the previous generation
+// and the old previous generation is dropped wholesale. Memory is bounded
+// by 2 × capacity entries with no per-lookup bookkeeping, and entries that
+// stop being touched — reads that slid out of the genotyped windows — age
+// out after at most two rotations.
+//
+// Not thread-safe: each Genotyper (one per worker) owns its own cache.
+// ============================================================================
+class HapAlignmentCache {
+ public:
+  struct Key {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    u64 mQnameHash = 0;
+    u64 mReadSeqHash = 0;
+    u64 mHapSeqHash = 0;
+    // ── 4B Align ──────────────────────────────────────────────────────────
+    u32 mReadLength = 0;
+    u32 mHapLength = 0;
+
+    auto operator==(Key const& other) const -> bool = default;
+
+    template <typename HashState>
+    friend auto AbslHashValue(HashState state, Key const& key) -> HashState {
+      return HashState::combine(std::move(state), key.mQnameHash, key.mReadSeqHash,
+                                key.mHapSeqHash, key.mReadLength, key.mHapLength);
+    }
+  };
+
+  using Entry = std::optional<Mm2AlnResult>;
+
+  /// ~32K read-haplotype pairs per generation: a dense 30x tumor/normal window
+  /// carries ~1-2K reads against 2-10 haplotypes, so two generations retain the
+  /// last several windows genotyped by this worker.
+  static constexpr usize DEFAULT_GENERATION_CAPACITY = 32'768;
+
+  HapAlignmentCache() = default;
+  explicit HapAlignmentCache(usize generation_capacity);
+
+  /// Returns nullptr on miss. The pointer is invalidated by the next Find() or Insert().
+  [[nodiscard]] auto Find(Key const& key) -> Entry const*;
+  void Insert(Key const& key, Entry entry);
+
+  [[nodiscard]] auto Size() const noexcept -> usize { return mCurrent.size() + mPrevious.size(); }
+  void Clear();
+
+ private:
+  using Generation = absl::flat_hash_map<Key, Entry>;
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  Generation mCurrent;   // 32B
+  Generation mPrevious;  // 32B
+  usize mGenerationCapacity = DEFAULT_GENERATION_CAPACITY;
+
+  void RotateIfFull();
+};
+
+}  // namespace lancet::caller
+
+#endif  // SRC_LANCET_CALLER_HAP_ALIGNMENT_CACHE_H_
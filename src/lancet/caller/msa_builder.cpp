@@ -8,12 +8,16 @@
 #include "spoa/alignment_engine.hpp"
 #include "spoa/graph.hpp"
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include <cstddef>
+
 /*
  * NOTE: Both the AlignmentEngine and the spoa::Graph are instantiated once per
  * worker thread within the caller::MsaBuilder object in VariantBuilder. They are
@@ -26,17 +30,106 @@
 
 namespace lancet::caller {
 
+namespace {
+
+// Returns {leading, trailing} base counts shared by every sequence, never overlapping.
+[[nodiscard]] auto SharedFlankLengths(absl::Span<std::string_view const> sequences)
+    -> std::pair<usize, usize> {
+  auto const first = sequences.front();
+  usize min_len = first.size();
+  for (auto const seq : sequences) min_len = std::min(min_len, seq.size());
+
+  usize prefix = 0;
+  auto const prefix_matches = [&](std::string_view seq) -> bool {
+    return seq[prefix] == first[prefix];
+  };
+  while (prefix < min_len && std::ranges::all_of(sequences, prefix_matches)) ++prefix;
+
+  usize suffix = 0;
+  auto const suffix_matches = [&](std::string_view seq) -> bool {
+    return seq[seq.size() - 1 - suffix] == first[first.size() - 1 - suffix];
+  };
+  while (suffix < min_len - prefix && std::ranges::all_of(sequences, suffix_matches)) ++suffix;
+
+  return {prefix, suffix};
+}
+
+// Returns {leading, trailing} reach of tandem repeats that run from the divergent
+// core into the shared flanks: for every sequence and every period, the number of
+// flank bases over which seq[i] == seq[i + period] still holds next to the core.
+// An indel of that period can slide that far into the flank, so it must not be clipped.
+//
+// No indel is longer than the longest core, so periods past that (plus MSA_FLANK_PAD
+// of slack) cannot move one, and a side stops scanning once its reach covers the
+// whole flank. That keeps the scan O(length × core) instead of O(length²).
+[[nodiscard]] auto RepeatReachIntoFlanks(absl::Span<std::string_view const> sequences,
+                                         usize const prefix, usize const suffix)
+    -> std::pair<usize, usize> {
+  usize max_core_len = 0;
+  for (auto const seq : sequences) {
+    max_core_len = std::max(max_core_len, seq.size() - prefix - suffix);
+  }
+  auto const max_period = max_core_len + MSA_FLANK_PAD;
+
+  usize prefix_reach = 0;
+  usize suffix_reach = 0;
+  for (auto const seq : sequences) {
+    for (usize period = 1; period <= max_period && prefix + period <= seq.size(); ++period) {
+      if (prefix_reach == prefix) break;
+      usize run = 0;
+      while (run < prefix && seq[prefix - 1 - run] == seq[prefix - 1 - run + period]) ++run;
+      prefix_reach = std::max(prefix_reach, run);
+    }
+
+    auto const core_end = seq.size() - suffix;
+    for (usize period = 1; period <= max_period && period <= core_end; ++period) {
+      if (suffix_reach == suffix) break;
+      usize run = 0;
+      while (run < suffix && seq[core_end + run] == seq[core_end + run - period]) ++run;
+      suffix_reach = std::max(suffix_reach, run);
+    }
+  }
+
+  return {prefix_reach, suffix_reach};
+}
+
+}  // namespace
+
 void MsaBuilder::UpdateSpoaState(absl::Span<std::string_view const> sequences,
-                                 absl::Span<cbdg::Path::BaseWeights const> weights) {
+                                 absl::Span<cbdg::Path::BaseWeights const> weights,
+                                 MsaFlanks const flanks) {
   mGraph.Clear();
+  mClippedPrefixLen = 0;
+  usize clipped_suffix_len = 0;
+
+  if (flanks == MsaFlanks::CLIPPED && sequences.size() > 1) {
+    auto const [prefix, suffix] = SharedFlankLengths(sequences);
+    auto const [prefix_reach, suffix_reach] = RepeatReachIntoFlanks(sequences, prefix, suffix);
+    auto const kept_prefix = prefix_reach + MSA_FLANK_PAD;
+    auto const kept_suffix = suffix_reach + MSA_FLANK_PAD;
+    mClippedPrefixLen = prefix > kept_prefix ? prefix - kept_prefix : 0;
+    clipped_suffix_len = suffix > kept_suffix ? suffix - kept_suffix : 0;
+  }
+
+  auto const clipped_len = mClippedPrefixLen + clipped_suffix_len;
   for (usize idx = 0; idx < sequences.size(); ++idx) {
     // Views point into Path::mSequence strings owned by ComponentResult on the
     // caller's stack — guaranteed to outlive this call. SPOA's const char*
     // overloads take an explicit uint32_t length, so null-termination is irrelevant.
+    auto const core_seq = sequences[idx].substr(mClippedPrefixLen,
+                                                sequences[idx].size() - clipped_len);
+    auto const seq_len = static_cast<std::uint32_t>(core_seq.size());
+
+    auto const& seq_weights = weights[idx];
+    if (clipped_len > 0) {
+      auto const first = seq_weights.begin() + static_cast<std::ptrdiff_t>(mClippedPrefixLen);
+      mClippedWeights.assign(first, first + static_cast<std::ptrdiff_t>(core_seq.size()));
+    }
+
     // NOLINTBEGIN(bugprone-suspicious-stringview-data-usage)
-    auto const seq_len = static_cast<std::uint32_t>(sequences[idx].size());
-    auto const alignment = mEngine->Align(sequences[idx].data(), seq_len, mGraph);
-    mGraph.AddAlignment(alignment, sequences[idx].data(), seq_len, weights[idx]);
+    auto const alignment = mEngine->Align(core_seq.data(), seq_len, mGraph);
+    mGraph.AddAlignment(alignment, core_seq.data(), seq_len,
+                        clipped_len > 0 ? mClippedWeights : seq_weights);
     // NOLINTEND(bugprone-suspicious-stringview-data-usage)
   }
 }
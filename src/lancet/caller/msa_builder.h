@@ -76,11 +76,40 @@ constexpr i8 MSA_EXTEND1_SCORE = -2;
 constexpr i8 MSA_OPEN2_SCORE = -26;
 constexpr i8 MSA_EXTEND2_SCORE = -1;
 
+/*
+ * ============================================================================
+ * Shared-flank clipping (MsaFlanks::CLIPPED)
+ * ============================================================================
+ * Every haplotype of a component is a de Bruijn walk between the same source
+ * and sink anchors, so all of them open and close with long stretches that
+ * are identical across the whole component — usually most of a 2.5 kbp
+ * window. Aligning those stretches costs O(haplotype length × graph size)
+ * per haplotype yet can only ever produce an all-match diagonal.
+ *
+ * CLIPPED drops the bases shared by every sequence at both ends before POA.
+ * On each side it first keeps every flank base that a tandem repeat touching
+ * the divergent core reaches (in any sequence, for any period up to the
+ * longest core plus MSA_FLANK_PAD), since an indel in that repeat may be
+ * placed anywhere along it. It then keeps MSA_FLANK_PAD more bases beyond
+ * the repeat for the VCF anchor base and the convergence node around the
+ * outermost bubbles. Every placement the full-length
+ * alignment could choose therefore stays inside the aligned core, and with a
+ * match score of 0 the dropped all-match flanks add nothing to any DP cell.
+ * POA then spans only the divergent core plus that margin.
+ *
+ * mClippedPrefixLen records the leading bases dropped from every sequence;
+ * VariantSet adds it back to POS and to the local haplotype offsets.
+ */
+constexpr usize MSA_FLANK_PAD = 32;
+
+enum class MsaFlanks : bool { FULL, CLIPPED };
+
 class MsaBuilder {
  public:
   // ── 8B Align ────────────────────────────────────────────────────────────
   std::unique_ptr<spoa::AlignmentEngine> mEngine;
   spoa::Graph mGraph;
+  usize mClippedPrefixLen = 0;
 
   MsaBuilder()
       : mEngine(spoa::AlignmentEngine::Create(
@@ -89,7 +118,8 @@ class MsaBuilder {
         mGraph(spoa::Graph()) {}
 
   void UpdateSpoaState(absl::Span<std::string_view const> sequences,
-                       absl::Span<cbdg::Path::BaseWeights const> weights);
+                       absl::Span<cbdg::Path::BaseWeights const> weights,
+                       MsaFlanks flanks = MsaFlanks::FULL);
 
   /// Render the SPOA alignment graph as a GFA-1.0 document. Caller decides
   /// where the bytes go (typically enqueued for the background flusher).
@@ -98,6 +128,9 @@ class MsaBuilder {
   /// Render the multiple sequence alignment as a FASTA document. The
   /// `msa_alns` span comes from `mGraph.GenerateMultipleSequenceAlignment`.
   [[nodiscard]] static auto BuildFastaString(absl::Span<std::string const> msa_alns) -> std::string;
+
+ private:
+  cbdg::Path::BaseWeights mClippedWeights;  // reused per-sequence weight slice
 };
 
 }  // namespace lancet::caller
@@ -0,0 +1,351 @@
+#include "lancet/caller/pair_hmm.h"
+
+#include "lancet/base/assert.h"
+#include "lancet/base/types.h"
+
+#include "absl/types/span.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <cmath>
+
+// Platform-specific SIMD intrinsics — CMake guarantees -march=x86-64-v3 on x86
+// (AVX2). Other targets take the scalar diagonal loop.
+#ifdef __AVX2__
+#include <immintrin.h>
+#include <pmmintrin.h>
+#include <xmmintrin.h>
+#endif
+
+namespace {
+
+using lancet::caller::PairHmm;
+
+constexpr i32 NT4_N = 4;
+
+// Every per-row buffer carries this many spare slots past the last row so the
+// 8-wide kernel can run its final, partial block as a full vector.
+constexpr usize SIMD_ROW_PAD = 8;
+
+// Forward sums are pre-scaled so they stay inside the floating-point range;
+// the scale is divided back out (in log10 space) at the end.
+template <typename T>
+constexpr auto InitialScale() -> T;
+template <>
+constexpr auto InitialScale<f32>() -> f32 {
+  return 0x1p120F;
+}
+template <>
+constexpr auto InitialScale<f64>() -> f64 {
+  return 0x1p1020;
+}
+
+// Scaled f32 results below this are treated as underflowed and recomputed in f64.
+constexpr f32 MIN_ACCEPTED_F32 = 1e-28F;
+
+// ============================================================================
+// ScopedFlushDenormals: FTZ + DAZ for the duration of one likelihood call.
+//
+// Cells far off the read's true placement decay towards zero and, without
+// flushing, spend most of the run in subnormal arithmetic (~100× slower per
+// op on x86). Their contribution to the sum is < 1e-38 of the scaled total,
+// so flushing them changes nothing observable. The previous MXCSR is restored
+// on exit so the rest of the worker thread keeps IEEE semantics.
+// ============================================================================
+class ScopedFlushDenormals {
+ public:
+#ifdef __AVX2__
+  ScopedFlushDenormals() : mSavedCsr(_mm_getcsr()) {
+    _mm_setcsr(mSavedCsr | _MM_FLUSH_ZERO_ON | _MM_DENORMALS_ZERO_ON);
+  }
+  ~ScopedFlushDenormals() { _mm_setcsr(mSavedCsr); }
+#else
+  ScopedFlushDenormals() = default;
+  ~ScopedFlushDenormals() = default;
+#endif
+
+  ScopedFlushDenormals(ScopedFlushDenormals const&) = delete;
+  ScopedFlushDenormals(ScopedFlushDenormals&&) = delete;
+  auto operator=(ScopedFlushDenormals const&) -> ScopedFlushDenormals& = delete;
+  auto operator=(ScopedFlushDenormals&&) -> ScopedFlushDenormals& = delete;
+
+#ifdef __AVX2__
+ private:
+  u32 mSavedCsr;
+#endif
+};
+
+[[nodiscard]] inline auto QualToErrorProb(u8 const qual) -> f64 {
+  return std::pow(10.0, -static_cast<f64>(qual) / 10.0);
+}
+
+template <typename T>
+struct Transitions {
+  T mMatchToMatch;
+  T mMatchToIns;
+  T mMatchToDel;
+  T mGapToMatch;
+  T mGapExtend;
+};
+
+template <typename T>
+[[nodiscard]] auto MakeTransitions() -> Transitions<T> {
+  f64 const ins_open = QualToErrorProb(PairHmm::DEFAULT_INDEL_QUAL);
+  f64 const del_open = QualToErrorProb(PairHmm::DEFAULT_INDEL_QUAL);
+  f64 const gap_extend = QualToErrorProb(PairHmm::DEFAULT_GAP_CONTINUATION_QUAL);
+  return {
+      .mMatchToMatch = static_cast<T>(1.0 - (ins_open + del_open)),
+      .mMatchToIns = static_cast<T>(ins_open),
+      .mMatchToDel = static_cast<T>(del_open),
+      .mGapToMatch = static_cast<T>(1.0 - gap_extend),
+      .mGapExtend = static_cast<T>(gap_extend),
+  };
+}
+
+// Views over the three live anti-diagonals: `cur` is being written, `prev`
+// is diagonal d−1 and `prev2` is diagonal d−2. Index = read row i.
+template <typename T>
+struct DiagonalRefs {
+  T* mCurM;
+  T* mCurI;
+  T* mCurD;
+  T const* mPrevM;
+  T const* mPrevI;
+  T const* mPrevD;
+  T const* mPrev2M;
+  T const* mPrev2I;
+  T const* mPrev2D;
+};
+
+// ============================================================================
+// StepCells: fill rows [row, end) of one anti-diagonal.
+//
+//   M[i][j] = prior(i,j) · (MM·M[i−1][j−1] + GM·(I[i−1][j−1] + D[i−1][j−1]))   ← diag d−2, row i−1
+//   I[i][j] = MI·M[i−1][j] + GX·I[i−1][j]                                     ← diag d−1, row i−1
+//   D[i][j] = MD·M[i][j−1] + GX·D[i][j−1]                                     ← diag d−1, row i
+//
+// hap_rev[i + hap_offset] is the haplotype base paired with read row i on
+// this diagonal.
+// ============================================================================
+template <typename T>
+void StepCells(DiagonalRefs<T> const& dgs, Transitions<T> const& trs, i32 const* read_codes,
+               i32 const* hap_rev, i64 const hap_offset, T const* match_prior,
+               T const* mismatch_prior, usize row, usize const end) {
+  // Raw-pointer stencil over the three diagonal buffers; bounds are
+  // established by the caller's [lo, hi] row range.
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  for (; row < end; ++row) {
+    auto const rbase = read_codes[row];
+    auto const hbase = hap_rev[static_cast<i64>(row) + hap_offset];
+    bool const is_match = rbase == hbase || rbase == NT4_N || hbase == NT4_N;
+    T const prior = is_match ? match_prior[row] : mismatch_prior[row];
+
+    dgs.mCurM[row] = prior * (trs.mMatchToMatch * dgs.mPrev2M[row - 1] +
+                              trs.mGapToMatch * (dgs.mPrev2I[row - 1] + dgs.mPrev2D[row - 1]));
+    dgs.mCurI[row] = trs.mMatchToIns * dgs.mPrevM[row - 1] + trs.mGapExtend * dgs.mPrevI[row - 1];
+    dgs.mCurD[row] = trs.mMatchToDel * dgs.mPrevM[row] + trs.mGapExtend * dgs.mPrevD[row];
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+template <typename T>
+void StepDiagonal(DiagonalRefs<T> const& dgs, Transitions<T> const& trs, i32 const* read_codes,
+                  i32 const* hap_rev, i64 const hap_offset, T const* match_prior,
+                  T const* mismatch_prior, usize const row_lo, usize const row_hi) {
+  StepCells(dgs, trs, read_codes, hap_rev, hap_offset, match_prior, mismatch_prior, row_lo,
+            row_hi + 1);
+}
+
+#ifdef __AVX2__
+// ============================================================================
+// AVX2 f32 kernel: 8 consecutive rows of the anti-diagonal per iteration.
+//
+//   _mm256_cmpeq_epi32 ×3 + or  → per-lane "match or N" mask
+//   _mm256_blendv_ps            → select (1 − ε) vs ε/3 without branching
+//
+// Unaligned loads at row−1 read the neighbouring diagonals. The last block
+// may spill up to 7 rows past row_hi: every buffer is padded by SIMD_ROW_PAD,
+// spilled rows are never read back as valid cells, and Forward() re-zeroes
+// the column-0 cell after each diagonal.
+// ============================================================================
+template <>
+void StepDiagonal<f32>(DiagonalRefs<f32> const& dgs, Transitions<f32> const& trs,
+                       i32 const* read_codes, i32 const* hap_rev, i64 const hap_offset,
+                       f32 const* match_prior, f32 const* mismatch_prior, usize const row_lo,
+                       usize const row_hi) {
+  auto const v_mm = _mm256_set1_ps(trs.mMatchToMatch);
+  auto const v_mi = _mm256_set1_ps(trs.mMatchToIns);
+  auto const v_md = _mm256_set1_ps(trs.mMatchToDel);
+  auto const v_gm = _mm256_set1_ps(trs.mGapToMatch);
+  auto const v_gx = _mm256_set1_ps(trs.mGapExtend);
+  auto const v_nn = _mm256_set1_epi32(NT4_N);
+
+  usize const end = row_hi + 1;
+
+  // SIMD load intrinsic _mm256_loadu_si256 requires `__m256i const*` per Intel API contract,
+  // and the stencil walks raw diagonal buffers bounded by [row_lo, row_hi].
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  for (usize row = row_lo; row < end; row += 8) {
+    auto const rbase = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(read_codes + row));
+    auto const hap_idx = static_cast<i64>(row) + hap_offset;
+    auto const hbase = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(hap_rev + hap_idx));
+    auto const is_match = _mm256_or_si256(
+        _mm256_cmpeq_epi32(rbase, hbase),
+        _mm256_or_si256(_mm256_cmpeq_epi32(rbase, v_nn), _mm256_cmpeq_epi32(hbase, v_nn)));
+    auto const prior = _mm256_blendv_ps(_mm256_loadu_ps(mismatch_prior + row),
+                                        _mm256_loadu_ps(match_prior + row),
+                                        _mm256_castsi256_ps(is_match));
+
+    auto const p2_gaps = _mm256_add_ps(_mm256_loadu_ps(dgs.mPrev2I + row - 1),
+                                       _mm256_loadu_ps(dgs.mPrev2D + row - 1));
+    auto const from_diag =
+        _mm256_add_ps(_mm256_mul_ps(v_mm, _mm256_loadu_ps(dgs.mPrev2M + row - 1)),
+                      _mm256_mul_ps(v_gm, p2_gaps));
+    _mm256_storeu_ps(dgs.mCurM + row, _mm256_mul_ps(prior, from_diag));
+
+    auto const ins = _mm256_add_ps(_mm256_mul_ps(v_mi, _mm256_loadu_ps(dgs.mPrevM + row - 1)),
+                                   _mm256_mul_ps(v_gx, _mm256_loadu_ps(dgs.mPrevI + row - 1)));
+    _mm256_storeu_ps(dgs.mCurI + row, ins);
+
+    auto const del = _mm256_add_ps(_mm256_mul_ps(v_md, _mm256_loadu_ps(dgs.mPrevM + row)),
+                                   _mm256_mul_ps(v_gx, _mm256_loadu_ps(dgs.mPrevD + row)));
+    _mm256_storeu_ps(dgs.mCurD + row, del);
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+#endif
+
+}  // namespace
+
+namespace lancet::caller {
+
+// ============================================================================
+// Log10Likelihood: f32 forward pass, f64 retry on underflow.
+// ============================================================================
+auto PairHmm::Log10Likelihood(absl::Span<u8 const> read_nt4, absl::Span<u8 const> read_quals,
+                              absl::Span<u8 const> hap_nt4) -> f64 {
+  LANCET_ASSERT(!read_nt4.empty() && !hap_nt4.empty())
+  LANCET_ASSERT(read_quals.size() >= read_nt4.size())
+
+  auto const read_len = read_nt4.size();
+  auto const hap_len = hap_nt4.size();
+  auto const quals = read_quals.subspan(0, read_len);
+
+  // Row 0 of every per-row array is the virtual "before the read" row.
+  mReadCodes.assign(read_len + 1 + SIMD_ROW_PAD, NT4_N);
+  std::ranges::transform(read_nt4, mReadCodes.begin() + 1,
+                         [](u8 const code) -> i32 { return static_cast<i32>(code); });
+
+  mHapCodesRev.assign(hap_len + SIMD_ROW_PAD, NT4_N);
+  std::ranges::transform(hap_nt4, mHapCodesRev.rend() - static_cast<i64>(hap_len),
+                         [](u8 const code) -> i32 { return static_cast<i32>(code); });
+
+  ScopedFlushDenormals const flush_denormals;
+
+  LoadPriors(mSingle, quals);
+  auto const scaled_f32 = Forward(mSingle, read_len, hap_len);
+  if (std::isfinite(scaled_f32) && scaled_f32 >= MIN_ACCEPTED_F32) {
+    return std::log10(static_cast<f64>(scaled_f32)) - std::log10(f64{InitialScale<f32>()});
+  }
+
+  LoadPriors(mDouble, quals);
+  auto const scaled_f64 = Forward(mDouble, read_len, hap_len);
+  if (scaled_f64 <= 0.0) return std::numeric_limits<f64>::lowest();
+  return std::log10(scaled_f64) - std::log10(InitialScale<f64>());
+}
+
+template <typename T>
+void PairHmm::LoadPriors(Workspace<T>& wsp, absl::Span<u8 const> read_quals) {
+  wsp.mMatchPrior.assign(read_quals.size() + 1 + SIMD_ROW_PAD, T{0});
+  wsp.mMismatchPrior.assign(read_quals.size() + 1 + SIMD_ROW_PAD, T{0});
+  for (usize idx = 0; idx < read_quals.size(); ++idx) {
+    auto const error = QualToErrorProb(std::max(read_quals[idx], MIN_USABLE_BASE_QUAL));
+    wsp.mMatchPrior[idx + 1] = static_cast<T>(1.0 - error);
+    wsp.mMismatchPrior[idx + 1] = static_cast<T>(error / 3.0);
+  }
+}
+
+// ============================================================================
+// Forward: sweep anti-diagonals d = 0 .. read_len + hap_len.
+//
+//   Row 0 (before the read):  D[0][j] = scale for every j — the read may
+//                             start anywhere on the haplotype, each start
+//                             with prior 1. A 1 / hap_len prior would charge
+//                             a longer haplotype (an insertion ALT) for its
+//                             length and bias REF vs ALT; with a band around
+//                             the read only one start carries real mass, so
+//                             the sum stays ≤ ~1 and the f32 scale holds
+//                             (an overflow still falls back to f64 below).
+//   Column 0 (j = 0, i ≥ 1):  all states 0.
+//   Result:                   Σ_j (M[read_len][j] + I[read_len][j]) — the
+//                             read may end anywhere on the haplotype.
+//
+// On diagonal d the interior rows are i ∈ [max(1, d − hap_len), min(read_len, d − 1)].
+// ============================================================================
+template <typename T>
+auto PairHmm::Forward(Workspace<T>& wsp, usize const read_len, usize const hap_len) -> T {
+  auto const rows = read_len + 1 + SIMD_ROW_PAD;
+  for (usize buf = 0; buf < 3; ++buf) {
+    wsp.mMatch[buf].assign(rows, T{0});
+    wsp.mIns[buf].assign(rows, T{0});
+    wsp.mDel[buf].assign(rows, T{0});
+  }
+
+  auto const trs = MakeTransitions<T>();
+  T const row0_del = InitialScale<T>();
+  T total{0};
+
+  for (usize diag = 0; diag <= read_len + hap_len; ++diag) {
+    auto const cur = diag % 3;
+    auto const prev = (diag + 2) % 3;
+    auto const prev2 = (diag + 1) % 3;
+
+    wsp.mMatch[cur][0] = T{0};
+    wsp.mIns[cur][0] = T{0};
+    wsp.mDel[cur][0] = diag <= hap_len ? row0_del : T{0};
+
+    auto const row_lo = diag > hap_len ? std::max<usize>(1, diag - hap_len) : usize{1};
+    auto const row_hi = diag >= 1 ? std::min(read_len, diag - 1) : usize{0};
+
+    if (row_lo <= row_hi) {
+      DiagonalRefs<T> const dgs{
+          .mCurM = wsp.mMatch[cur].data(),
+          .mCurI = wsp.mIns[cur].data(),
+          .mCurD = wsp.mDel[cur].data(),
+          .mPrevM = wsp.mMatch[prev].data(),
+          .mPrevI = wsp.mIns[prev].data(),
+          .mPrevD = wsp.mDel[prev].data(),
+          .mPrev2M = wsp.mMatch[prev2].data(),
+          .mPrev2I = wsp.mIns[prev2].data(),
+          .mPrev2D = wsp.mDel[prev2].data(),
+      };
+
+      // Read row i on diagonal d pairs with haplotype base j − 1 = d − i − 1,
+      // i.e. reversed index hap_len − d + i, which lies in [0, hap_len) for
+      // every row in [row_lo, row_hi] — consecutive rows read consecutive bases.
+      auto const hap_offset = static_cast<i64>(hap_len) - static_cast<i64>(diag);
+      StepDiagonal<T>(dgs, trs, mReadCodes.data(), mHapCodesRev.data(), hap_offset,
+                      wsp.mMatchPrior.data(), wsp.mMismatchPrior.data(), row_lo, row_hi);
+
+      if (row_hi == read_len && diag > read_len) {
+        total += wsp.mMatch[cur][read_len] + wsp.mIns[cur][read_len];
+      }
+    }
+
+    // Column-0 cell (j = 0). Zeroed after the step because the vector kernel
+    // may have spilled into it.
+    if (diag >= 1 && diag <= read_len) {
+      wsp.mMatch[cur][diag] = T{0};
+      wsp.mIns[cur][diag] = T{0};
+      wsp.mDel[cur][diag] = T{0};
+    }
+  }
+
+  return total;
+}
+
+}  // namespace lancet::caller
@@ -70,6 +70,22 @@ struct PerAlleleData {
 
   // Count of soft-clipped reads supporting this allele (for SCA FORMAT tag).
   usize mSoftClipCount = 0;  // 8B
+
+  // Pre-size every per-read column (and the dedup table) for `num_reads` reads,
+  // so AddEvidence appends without geometric regrowth at high depth.
+  void Reserve(usize const num_reads) {
+    mNameHashes.reserve(num_reads);
+    mFwdBaseQuals.reserve(num_reads);
+    mRevBaseQuals.reserve(num_reads);
+    mMapQuals.reserve(num_reads);
+    mAlnScores.reserve(num_reads);
+    mProperPairIsizes.reserve(num_reads);
+    mFoldedReadPositions.reserve(num_reads);
+    mRefNmValues.reserve(num_reads);
+    mOwnHapNmValues.reserve(num_reads);
+    mAlignmentStarts.reserve(num_reads);
+    mHaplotypeIds.reserve(num_reads);
+  }
 };
 
 }  // namespace lancet::caller
@@ -0,0 +1,316 @@
+#include "lancet/caller/read_placer.h"
+
+#include "lancet/base/assert.h"
+#include "lancet/base/types.h"
+#include "lancet/caller/hap_alignment_cache.h"
+#include "lancet/caller/scoring_constants.h"
+#include "lancet/hts/cigar_unit.h"
+
+#include "absl/types/span.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using lancet::caller::ReadPlacer;
+using lancet::hts::CigarOp;
+using lancet::hts::CigarUnit;
+
+constexpr u32 KMER_MASK = (u32{1} << (2 * ReadPlacer::KMER_LEN)) - 1;
+constexpr u8 MAX_ACGT_CODE = 3;
+
+// Far enough below any reachable score that subtracting gap costs for a whole
+// read never wraps around.
+constexpr i32 NEG_INF = std::numeric_limits<i32>::min() / 4;
+constexpr i32 GAP_EXTEND = lancet::caller::SCORING_GAP_EXTEND;
+constexpr i32 GAP_OPEN_EXTEND = lancet::caller::SCORING_GAP_OPEN + GAP_EXTEND;
+
+// A read base hanging off a haplotype end forgoes one match. Any insertion is
+// dearer, so an overhang is always clipped rather than gapped against the end,
+// while a prefix is still aligned through a mismatch or two. The cost is added
+// back to the reported score: downstream scoring applies its own soft-clip
+// penalty (ComputeSoftClipPenalty), as for minimap2 hits.
+constexpr i32 CLIP_BASE_COST = lancet::caller::SCORING_MATCH;
+
+// Traceback bits per cell: the state H came from, and whether each gap state
+// extended a gap already open in the previous cell (else it opened from H).
+constexpr u8 FROM_MATCH = 0;
+constexpr u8 FROM_INS = 1;
+constexpr u8 FROM_DEL = 2;
+constexpr u8 FROM_START = 3;
+constexpr u8 SOURCE_MASK = 3;
+constexpr u8 INS_EXTENDS = 4;
+constexpr u8 DEL_EXTENDS = 8;
+
+/// Calls `visit(start, kmer)` for every 2-bit packed k-mer of `seq` without an N.
+template <typename Visitor>
+void ForEachKmer(absl::Span<u8 const> seq, Visitor&& visit) {
+  u32 kmer = 0;
+  usize num_valid = 0;
+  for (usize pos = 0; pos < seq.size(); ++pos) {
+    if (seq[pos] > MAX_ACGT_CODE) {
+      num_valid = 0;
+      continue;
+    }
+
+    kmer = ((kmer << 2) | seq[pos]) & KMER_MASK;
+    if (++num_valid >= ReadPlacer::KMER_LEN) visit(pos + 1 - ReadPlacer::KMER_LEN, kmer);
+  }
+}
+
+/// Appends `length` bases of `op`, merging with the previous unit when it is the same op.
+void PushOp(std::vector<CigarUnit>& cigar, CigarOp const op, u32 const length) {
+  if (length == 0) return;
+  if (!cigar.empty() && cigar.back().Operation() == op) {
+    cigar.back() = CigarUnit(op, cigar.back().Length() + length);
+    return;
+  }
+  cigar.emplace_back(op, length);
+}
+
+}  // namespace
+
+namespace lancet::caller {
+
+void ReadPlacer::Reset(absl::Span<std::vector<u8> const> encoded_haps) {
+  mHaps = encoded_haps;
+  mKmerTables.resize(encoded_haps.size());
+  for (usize hap_idx = 0; hap_idx < encoded_haps.size(); ++hap_idx) {
+    auto& table = mKmerTables[hap_idx];
+    table.clear();
+    table.reserve(encoded_haps[hap_idx].size());
+    ForEachKmer(encoded_haps[hap_idx], [&table](usize const start, u32 const kmer) {
+      table.emplace_back(kmer, static_cast<i32>(start));
+    });
+    std::ranges::sort(table);
+  }
+}
+
+// ============================================================================
+// Place: seed the diagonals, then align inside the band they span.
+//
+// A diagonal needs two votes, so one chance 11-mer match elsewhere on the
+// haplotype cannot stretch the band; a true seed region one base longer than
+// KMER_LEN already casts two.
+// ============================================================================
+auto ReadPlacer::Place(absl::Span<u8 const> read_nt4, usize const hap_idx)
+    -> std::optional<Mm2AlnResult> {
+  LANCET_ASSERT(hap_idx < mKmerTables.size())
+  auto const& table = mKmerTables[hap_idx];
+
+  mDiagonals.clear();
+  ForEachKmer(read_nt4, [this, &table](usize const start, u32 const kmer) {
+    auto const hits = std::ranges::equal_range(table, kmer, std::less{}, &KmerPos::first);
+    if (hits.empty() || hits.size() > MAX_KMER_OCC) return;
+    for (auto const& [code, hap_pos] : hits) {
+      mDiagonals.push_back(hap_pos - static_cast<i32>(start));
+    }
+  });
+
+  std::ranges::sort(mDiagonals);
+  std::optional<i32> diag_lo;
+  std::optional<i32> diag_hi;
+  for (usize idx = 1; idx < mDiagonals.size(); ++idx) {
+    if (mDiagonals[idx] != mDiagonals[idx - 1]) continue;
+    if (!diag_lo) diag_lo = mDiagonals[idx];
+    diag_hi = mDiagonals[idx];
+  }
+
+  if (!diag_lo) return std::nullopt;
+
+  auto result = AlignInBand(read_nt4, mHaps[hap_idx], *diag_lo - BAND_PAD, *diag_hi + BAND_PAD);
+  result.mHapIdx = hap_idx;
+  return result;
+}
+
+// ============================================================================
+// AlignInBand: affine-gap DP over diagonals [diag_lo, diag_hi].
+//
+// Cell (row, col) aligns read[0, row) ending at haplotype column col; its
+// slot in a DP row is (col − row) − diag_lo, so the match step reads the
+// same slot of the previous row, an insertion the slot to its right, and a
+// deletion the slot to its left in the current row.
+//
+//   start:  row 0, any column         (free haplotype start)
+//           column 0, row r > 0       (r read bases clipped off the hap start)
+//   end:    row read_len, any column  (free haplotype end)
+//           column hap_len, row r     (read_len − r bases clipped off the end)
+// ============================================================================
+auto ReadPlacer::AlignInBand(absl::Span<u8 const> read_nt4, absl::Span<u8 const> hap_nt4,
+                             i32 const diag_lo, i32 const diag_hi) -> Mm2AlnResult {
+  auto const read_len = static_cast<i32>(read_nt4.size());
+  auto const hap_len = static_cast<i32>(hap_nt4.size());
+  auto const width = static_cast<usize>(diag_hi - diag_lo + 1);
+  auto const slot_col = [diag_lo](i32 const row, usize const slot) -> i32 {
+    return row + diag_lo + static_cast<i32>(slot);
+  };
+
+  mPrevH.assign(width, NEG_INF);
+  mPrevIns.assign(width, NEG_INF);
+  mCurH.assign(width, NEG_INF);
+  mCurIns.assign(width, NEG_INF);
+  mTrace.assign((read_nt4.size() + 1) * width, FROM_START);
+
+  i32 best_score = NEG_INF;
+  i32 best_row = 0;
+  i32 best_col = 0;
+  auto const consider_end = [&](i32 const score, i32 const row, i32 const col) {
+    if (score > best_score) {
+      best_score = score;
+      best_row = row;
+      best_col = col;
+    }
+  };
+
+  for (usize slot = 0; slot < width; ++slot) {
+    auto const col = slot_col(0, slot);
+    if (col >= 0 && col <= hap_len) mPrevH[slot] = 0;
+    if (col == hap_len) consider_end(-read_len * CLIP_BASE_COST, 0, col);
+  }
+
+  for (i32 row = 1; row <= read_len; ++row) {
+    auto const read_base = read_nt4[static_cast<usize>(row - 1)];
+    auto* trace = mTrace.data() + (static_cast<usize>(row) * width);
+    i32 left_del = NEG_INF;
+
+    for (usize slot = 0; slot < width; ++slot) {
+      auto const col = slot_col(row, slot);
+      if (col < 0 || col > hap_len) {
+        mCurH[slot] = NEG_INF;
+        mCurIns[slot] = NEG_INF;
+        left_del = NEG_INF;
+        continue;
+      }
+
+      if (col == 0) {
+        mCurH[slot] = -row * CLIP_BASE_COST;
+        mCurIns[slot] = NEG_INF;
+        left_del = NEG_INF;
+        trace[slot] = FROM_START;
+        continue;
+      }
+
+      auto const hap_base = hap_nt4[static_cast<usize>(col - 1)];
+      i32 const match = mPrevH[slot] + SCORING_MATRIX[(hap_base * 5) + read_base];
+
+      u8 bits = 0;
+      i32 ins = NEG_INF;
+      if (slot + 1 < width) {
+        i32 const open = mPrevH[slot + 1] - GAP_OPEN_EXTEND;
+        i32 const extend = mPrevIns[slot + 1] - GAP_EXTEND;
+        ins = std::max(open, extend);
+        if (extend > open) bits |= INS_EXTENDS;
+      }
+
+      i32 del = NEG_INF;
+      if (slot > 0) {
+        i32 const open = mCurH[slot - 1] - GAP_OPEN_EXTEND;
+        i32 const extend = left_del - GAP_EXTEND;
+        del = std::max(open, extend);
+        if (extend > open) bits |= DEL_EXTENDS;
+      }
+
+      // Ties keep the match, so the traceback (right to left) places gaps leftmost
+      i32 best_here = match;
+      u8 source = FROM_MATCH;
+      if (del > best_here) {
+        best_here = del;
+        source = FROM_DEL;
+      }
+      if (ins > best_here) {
+        best_here = ins;
+        source = FROM_INS;
+      }
+
+      mCurH[slot] = best_here;
+      mCurIns[slot] = ins;
+      left_del = del;
+      trace[slot] = bits | source;
+    }
+
+    auto const end_slot = hap_len - row - diag_lo;
+    if (row < read_len && end_slot >= 0 && std::cmp_less(end_slot, width)) {
+      consider_end(mCurH[static_cast<usize>(end_slot)] - ((read_len - row) * CLIP_BASE_COST), row,
+                   hap_len);
+    }
+
+    std::swap(mPrevH, mCurH);
+    std::swap(mPrevIns, mCurIns);
+  }
+
+  for (usize slot = 0; slot < width; ++slot) {
+    auto const col = slot_col(read_len, slot);
+    if (col >= 0 && col <= hap_len) consider_end(mPrevH[slot], read_len, col);
+  }
+
+  // ── Traceback ──────────────────────────────────────────────────────────
+  enum class State : u8 { MATCH_OR_START, INS, DEL };
+  std::vector<CigarUnit> reversed;
+  u32 num_matches = 0;
+  u32 num_aligned = 0;
+  u32 num_gap_opens = 0;
+  i32 row = best_row;
+  i32 col = best_col;
+  auto state = State::MATCH_OR_START;
+
+  while (true) {
+    auto const slot = static_cast<usize>(col - row - diag_lo);
+    auto const bits = mTrace[(static_cast<usize>(row) * width) + slot];
+
+    if (state == State::INS) {
+      PushOp(reversed, CigarOp::INSERTION, 1);
+      if ((bits & INS_EXTENDS) == 0) state = State::MATCH_OR_START;
+      row--;
+      continue;
+    }
+
+    if (state == State::DEL) {
+      PushOp(reversed, CigarOp::DELETION, 1);
+      if ((bits & DEL_EXTENDS) == 0) state = State::MATCH_OR_START;
+      col--;
+      continue;
+    }
+
+    auto const source = bits & SOURCE_MASK;
+    if (source == FROM_START) break;
+    if (source == FROM_INS || source == FROM_DEL) {
+      state = source == FROM_INS ? State::INS : State::DEL;
+      num_gap_opens++;
+      continue;
+    }
+
+    PushOp(reversed, CigarOp::ALIGNMENT_MATCH, 1);
+    num_aligned++;
+    if (read_nt4[static_cast<usize>(row - 1)] == hap_nt4[static_cast<usize>(col - 1)]) {
+      num_matches++;
+    }
+    row--;
+    col--;
+  }
+
+  auto const lead_clip = static_cast<u32>(row);
+  auto const tail_clip = static_cast<u32>(read_len - best_row);
+
+  Mm2AlnResult result;
+  PushOp(result.mCigar, CigarOp::SOFT_CLIP, lead_clip);
+  for (auto itr = reversed.rbegin(); itr != reversed.rend(); ++itr) {
+    PushOp(result.mCigar, itr->Operation(), itr->Length());
+  }
+  PushOp(result.mCigar, CigarOp::SOFT_CLIP, tail_clip);
+
+  // Same definition as minimap2's mm_event_identity: each gap counts as one event
+  auto const num_events = num_aligned + num_gap_opens;
+  result.mIdentity =
+      num_events > 0 ? static_cast<f64>(num_matches) / static_cast<f64>(num_events) : 0.0;
+  result.mScore = best_score + (static_cast<i32>(lead_clip + tail_clip) * CLIP_BASE_COST);
+  result.mRefStart = col;
+  result.mRefEnd = best_col;
+  return result;
+}
+
+}  // namespace lancet::caller
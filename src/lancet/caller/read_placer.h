@@ -0,0 +1,75 @@
+#ifndef SRC_LANCET_CALLER_READ_PLACER_H_
+#define SRC_LANCET_CALLER_READ_PLACER_H_
+
+#include "lancet/base/types.h"
+#include "lancet/caller/hap_alignment_cache.h"
+
+#include "absl/types/span.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace lancet::caller {
+
+// ============================================================================
+// ReadPlacer: read → haplotype placement for the PAIR_HMM backend.
+//
+// The pair-HMM sums over every placement inside its band, so all it needs
+// from an aligner is where that band is, plus a CIGAR for the annotations
+// (variant overlap, read position, NM, local BQ). mm_map's minimizer sketch,
+// chaining and z-drop extension are built for genome-scale mapping and cost
+// more than the forward pass itself on a 150 bp read. ReadPlacer does the
+// minimum instead:
+//
+//   1. Seed:  every k-mer of the read is looked up in a sorted table of the
+//             haplotype's k-mers, built once per window. K-mers that occur
+//             more than MAX_KMER_OCC times are skipped (minimap2's mid_occ).
+//   2. Band:  each hit votes for the diagonal hap_pos − read_pos. Diagonals
+//             with at least two votes are kept and the band spans all of
+//             them, widened by BAND_PAD on both sides, so a read that spans
+//             an indel keeps both flanks' diagonals.
+//   3. Align: one affine-gap DP restricted to that band, global on the read
+//             and free at both haplotype ends, with the same strict scores
+//             as the minimap2 backend (scoring_constants.h). A read that
+//             overhangs a haplotype end is soft-clipped there. Ties prefer
+//             the match state, so gaps are placed leftmost.
+//
+// The result is the same Mm2AlnResult the minimap2 path produces, so the
+// HapAlignmentCache and every downstream scorer take it unchanged.
+// ============================================================================
+class ReadPlacer {
+ public:
+  static constexpr usize KMER_LEN = 11;
+  static constexpr usize MAX_KMER_OCC = 8;
+  static constexpr i32 BAND_PAD = 16;
+
+  /// Rebuilds the k-mer tables for a window's haplotypes (nt4 codes, N = 4). The
+  /// haplotypes must outlive every Place() call until the next Reset().
+  void Reset(absl::Span<std::vector<u8> const> encoded_haps);
+
+  /// Best banded alignment of `read_nt4` to haplotype `hap_idx`, or nullopt when no
+  /// diagonal collects two seed hits.
+  [[nodiscard]] auto Place(absl::Span<u8 const> read_nt4, usize hap_idx)
+      -> std::optional<Mm2AlnResult>;
+
+ private:
+  using KmerPos = std::pair<u32, i32>;  // packed k-mer, 0-based haplotype position
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  absl::Span<std::vector<u8> const> mHaps;
+  std::vector<std::vector<KmerPos>> mKmerTables;  // per haplotype, sorted by k-mer
+  std::vector<i32> mDiagonals;                    // seed votes for the current read
+  std::vector<i32> mPrevH;                        // DP rows, indexed by diagonal − lo
+  std::vector<i32> mPrevIns;
+  std::vector<i32> mCurH;
+  std::vector<i32> mCurIns;
+  std::vector<u8> mTrace;  // (read_len + 1) × band width traceback bits
+
+  [[nodiscard]] auto AlignInBand(absl::Span<u8 const> read_nt4, absl::Span<u8 const> hap_nt4,
+                                 i32 diag_lo, i32 diag_hi) -> Mm2AlnResult;
+};
+
+}  // namespace lancet::caller
+
+#endif  // SRC_LANCET_CALLER_READ_PLACER_H_
@@ -2,27 +2,46 @@
 
 #include "lancet/base/types.h"
 
-#include "absl/strings/str_format.h"
-#include "absl/strings/str_join.h"
 #include "absl/types/span.h"
 #include "spdlog/fmt/bundled/base.h"
+#include "spdlog/fmt/bundled/compile.h"
 #include "spdlog/fmt/bundled/format.h"
 
+#include <iterator>
 #include <optional>
 #include <string>
 #include <string_view>
 
 namespace {
 
+using FormatBuffer = fmt::memory_buffer;
+
+inline void AppendText(FormatBuffer& out, std::string_view text) {
+  out.append(text.data(), text.data() + text.size());
+}
+
+// Comma-joined Number=R / Number=A list, each value rendered with `spec` (a
+// FMT_COMPILE'd format string, so the spec is parsed at compile time).
+template <typename T, typename Spec>
+void AppendJoined(FormatBuffer& out, absl::Span<T const> values, Spec const& spec) {
+  for (usize idx = 0; idx < values.size(); ++idx) {
+    if (idx > 0) out.push_back(',');
+    fmt::format_to(std::back_inserter(out), spec, values[idx]);
+  }
+}
+
 // Format a std::optional<f32> for VCF output, emitting "." for missing values.
 // VCF 4.5 spec: "." = missing value. This is the single point where the
 // optional → dot conversion happens for all FORMAT fields.
 // NOTE: Cannot use IEEE NaN here because -ffast-math (cmake/defaults.cmake)
 // implies -ffinite-math-only, which optimizes away std::isnan().
-[[nodiscard]] inline auto FormatOptional(std::optional<f32> const& value, char const* fmt_spec)
-    -> std::string {
-  if (!value.has_value()) return ".";
-  return fmt::format(fmt::runtime(fmt_spec), value.value());
+template <typename Spec>
+void AppendOptional(FormatBuffer& out, std::optional<f32> const& value, Spec const& spec) {
+  if (!value.has_value()) {
+    out.push_back('.');
+    return;
+  }
+  fmt::format_to(std::back_inserter(out), spec, value.value());
 }
 
 }  // namespace
@@ -30,71 +49,89 @@ namespace {
 namespace lancet::caller {
 
 auto SampleFormatData::RenderVcfString() const -> std::string {
+  FormatBuffer buffer;
+  AppendVcfString(buffer);
+  return fmt::to_string(buffer);
+}
+
+// ============================================================================
+// AppendVcfString: render this sample's FORMAT column straight into `out`.
+//
+// Field order is FORMAT_HEADER (vcf_formatter.h). Every field is appended in
+// place — no per-field std::string temporaries — so a caller that reuses one
+// buffer across records formats a whole VCF line without heap allocation once
+// the buffer has grown to the longest line.
+// ============================================================================
+void SampleFormatData::AppendVcfString(FormatBuffer& out) const {
   if (IsMissingSupport()) {
-    return "./.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.";
+    AppendText(out, "./.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.");
+    return;
   }
 
+  auto sink = std::back_inserter(out);
   auto const [gt_first, gt_second] = GenotypeIndices();
-  auto const gt_str = (gt_first == -1 && gt_second == -1)
-                          ? std::string("./.")
-                          : fmt::format("{}/{}", gt_first, gt_second);
-
-  auto const pls = PhredLikelihoods();
-  auto const pl_str = pls.empty() ? "." : absl::StrJoin(pls, ",");
-
-  auto const format_f32 = [](std::string* out, f32 const val) {
-    absl::StrAppendFormat(out, "%.1F", val);
-  };
-
-  auto const format_f64 = [](std::string* out, f64 const val) {
-    absl::StrAppendFormat(out, "%.4F", val);
-  };
-
-  auto const ad_str = absl::StrJoin(AlleleDepths(), ",");
-  auto const adf_str = absl::StrJoin(FwdAlleleDepths(), ",");
-  auto const adr_str = absl::StrJoin(RevAlleleDepths(), ",");
-  auto const rmq_str = absl::StrJoin(RmsMappingQualities(), ",", format_f32);
-  auto const npbq_str = absl::StrJoin(NormPosteriorBQs(), ",", format_f32);
+  if (gt_first == -1 && gt_second == -1) {
+    AppendText(out, "./.");
+  } else {
+    fmt::format_to(sink, FMT_COMPILE("{}/{}"), gt_first, gt_second);
+  }
 
+  // GT:AD:ADF:ADR:DP:RMQ:NPBQ
+  out.push_back(':');
+  AppendJoined(out, AlleleDepths(), FMT_COMPILE("{}"));
+  out.push_back(':');
+  AppendJoined(out, FwdAlleleDepths(), FMT_COMPILE("{}"));
+  out.push_back(':');
+  AppendJoined(out, RevAlleleDepths(), FMT_COMPILE("{}"));
+  fmt::format_to(sink, FMT_COMPILE(":{}:"), TotalDepth());
+  AppendJoined(out, RmsMappingQualities(), FMT_COMPILE("{:.1F}"));
+  out.push_back(':');
+  AppendJoined(out, NormPosteriorBQs(), FMT_COMPILE("{:.1F}"));
+
+  // SB:SCA:FLD:RPCD:BQCD:MQCD:ASMD:SDFC
+  // Optional-safe formatting via GetField: these metrics can be absent → "." in VCF.
+  fmt::format_to(sink, FMT_COMPILE(":{:.3f}:{:.4f}:"), StrandBias(), SoftClipAsym());
+  AppendOptional(out, GetField(FRAG_LEN_DELTA), FMT_COMPILE("{:.1f}"));
+  out.push_back(':');
+  AppendOptional(out, GetField(READ_POS_COHEN_D), FMT_COMPILE("{:.4f}"));
+  out.push_back(':');
+  AppendOptional(out, GetField(BASE_QUAL_COHEN_D), FMT_COMPILE("{:.4f}"));
+  out.push_back(':');
+  AppendOptional(out, GetField(MAP_QUAL_COHEN_D), FMT_COMPILE("{:.4f}"));
+  out.push_back(':');
+  AppendOptional(out, GetField(ALLELE_MISMATCH_DELTA), FMT_COMPILE("{:.3f}"));
+  out.push_back(':');
+  AppendOptional(out, GetField(SITE_DEPTH_FOLD_CHANGE), FMT_COMPILE("{:.2f}"));
+
+  // PRAD:PANG:CMLOD
   // CMLOD: Number=A — strip index 0 (REF LOD = 0.0 by definition), emit only ALT LODs.
   // Guard: size() < 2 catches both empty and REF-only vectors (defensive, upstream
   // should always produce num_alleles entries after the allele count fix).
+  fmt::format_to(sink, FMT_COMPILE(":{:.4f}:{:.4f}:"), PolarRadius(), PolarAngle());
   auto const cmlods = ContinuousMixtureLods();
-  auto const cmlod_str = [&cmlods, &format_f64]() -> std::string {
-    if (cmlods.size() < 2) return ".";
-    return absl::StrJoin(cmlods.begin() + 1, cmlods.end(), ",", format_f64);
-  }();
-
-  // Optional-safe formatting via GetField: 9 metrics can be absent → "." in VCF.
-  auto const fld_str = FormatOptional(GetField(FRAG_LEN_DELTA), "{:.1f}");
-  auto const rpcd_str = FormatOptional(GetField(READ_POS_COHEN_D), "{:.4f}");
-  auto const bqcd_str = FormatOptional(GetField(BASE_QUAL_COHEN_D), "{:.4f}");
-  auto const mqcd_str = FormatOptional(GetField(MAP_QUAL_COHEN_D), "{:.4f}");
-  auto const asmd_str = FormatOptional(GetField(ALLELE_MISMATCH_DELTA), "{:.3f}");
-  auto const fsse_str = FormatOptional(GetField(FRAG_START_ENTROPY), "{:.4f}");
-  auto const ahdd_str = FormatOptional(GetField(ALT_HAP_DISCORD_DELTA), "{:.3f}");
-  auto const hse_str = FormatOptional(GetField(HAPLOTYPE_SEG_ENTROPY), "{:.4f}");
-  auto const pdcv_str = FormatOptional(GetField(PATH_DEPTH_CV), "{:.4f}");
-  auto const sdfc_str = FormatOptional(GetField(SITE_DEPTH_FOLD_CHANGE), "{:.2f}");
-
-  // clang-format off
-  return fmt::format(
-      "{GT}:{AD}:{ADF}:{ADR}:{DP}:{RMQ}:{NPBQ}:{SB:.3f}:{SCA:.4f}:{FLD}:{RPCD}:"
-      "{BQCD}:{MQCD}:{ASMD}:{SDFC}:{PRAD:.4f}:{PANG:.4f}:{CMLOD}:"
-      "{FSSE}:{AHDD}:{HSE}:{PDCV}:{PL}:{GQ}",
-      fmt::arg("GT",    gt_str),           fmt::arg("AD",    ad_str),
-      fmt::arg("ADF",   adf_str),          fmt::arg("ADR",   adr_str),
-      fmt::arg("DP",    TotalDepth()),      fmt::arg("RMQ",   rmq_str),
-      fmt::arg("NPBQ",  npbq_str),         fmt::arg("SB",    StrandBias()),
-      fmt::arg("SCA",   SoftClipAsym()),    fmt::arg("FLD",   fld_str),
-      fmt::arg("RPCD",  rpcd_str),         fmt::arg("BQCD",  bqcd_str),
-      fmt::arg("MQCD",  mqcd_str),         fmt::arg("ASMD",  asmd_str),
-      fmt::arg("SDFC",  sdfc_str),         fmt::arg("PRAD",  PolarRadius()),
-      fmt::arg("PANG",  PolarAngle()),      fmt::arg("CMLOD", cmlod_str),
-      fmt::arg("FSSE",  fsse_str),         fmt::arg("AHDD",  ahdd_str),
-      fmt::arg("HSE",   hse_str),          fmt::arg("PDCV",  pdcv_str),
-      fmt::arg("PL",    pl_str),           fmt::arg("GQ",    GenotypeQuality()));
-  // clang-format on
+  if (cmlods.size() < 2) {
+    out.push_back('.');
+  } else {
+    AppendJoined(out, cmlods.subspan(1), FMT_COMPILE("{:.4F}"));
+  }
+
+  // FSSE:AHDD:HSE:PDCV:PL:GQ
+  out.push_back(':');
+  AppendOptional(out, GetField(FRAG_START_ENTROPY), FMT_COMPILE("{:.4f}"));
+  out.push_back(':');
+  AppendOptional(out, GetField(ALT_HAP_DISCORD_DELTA), FMT_COMPILE("{:.3f}"));
+  out.push_back(':');
+  AppendOptional(out, GetField(HAPLOTYPE_SEG_ENTROPY), FMT_COMPILE("{:.4f}"));
+  out.push_back(':');
+  AppendOptional(out, GetField(PATH_DEPTH_CV), FMT_COMPILE("{:.4f}"));
+  out.push_back(':');
+  auto const pls = PhredLikelihoods();
+  if (pls.empty()) {
+    out.push_back('.');
+  } else {
+    AppendJoined(out, pls, FMT_COMPILE("{}"));
+  }
+  fmt::format_to(sink, FMT_COMPILE(":{}"), GenotypeQuality());
 }
 
 }  // namespace lancet::caller
@@ -5,6 +5,7 @@
 
 #include "absl/container/inlined_vector.h"
 #include "absl/types/span.h"
+#include "spdlog/fmt/bundled/format.h"
 
 #include <array>
 #include <optional>
@@ -120,6 +121,8 @@ class SampleFormatData {
 
   /// VCF string rendering — implemented in sample_format_data.cpp
   [[nodiscard]] auto RenderVcfString() const -> std::string;
+  /// Appends the same FORMAT column to `out` without intermediate strings.
+  void AppendVcfString(fmt::memory_buffer& out) const;
 
  private:
   // ── 8B Align ────────────────────────────────────────────────────────────
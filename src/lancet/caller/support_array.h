@@ -1,45 +1,42 @@
 #ifndef SRC_LANCET_CALLER_SUPPORT_ARRAY_H_
 #define SRC_LANCET_CALLER_SUPPORT_ARRAY_H_
 
+#include "lancet/base/types.h"
 #include "lancet/caller/variant_support.h"
 
 #include "absl/container/inlined_vector.h"
 
-#include <memory>
-#include <string_view>
-#include <utility>
-
 namespace lancet::caller {
 
 // ============================================================================
 // SupportArray: per-sample variant evidence container.
 //
-// Maps sample names to VariantSupport objects. Used by VariantCall to access
-// per-sample allele evidence when building VCF FORMAT fields and computing
-// genotype likelihoods.
+// Dense slots addressed by SampleInfo::SampleIndex() (== cbdg::Read::SampleIndex(),
+// the sample's VCF FORMAT column). Used by VariantCall to access per-sample
+// allele evidence when building VCF FORMAT fields and computing genotype
+// likelihoods.
+//
+// Each slot holds its VariantSupport by value (a 32B column header), so a
+// (variant, sample) pair costs no separate heap allocation and lookup is a
+// single index instead of a linear scan over sample-name string compares.
+// A slot that never received evidence has NumAlleles() == 0 and reads back
+// as nullptr from Find().
 //
 // InlinedVector<8> avoids heap allocation for the common case of ≤ 8 samples.
 // ============================================================================
 class SupportArray {
  public:
-  struct NamedSupport {
-    // ── 8B Align ────────────────────────────────────────────────────────────
-    std::string_view mSampleName;           // 8B (ptr) + 8B (size) = 16B
-    std::unique_ptr<VariantSupport> mData;  // 8B
-  };
-
-  [[nodiscard]] auto Find(std::string_view sample_name) const -> VariantSupport const*;
-  [[nodiscard]] auto FindOrCreate(std::string_view sample_name) -> VariantSupport&;
-  [[nodiscard]] auto Extract(std::string_view sample_name) -> std::unique_ptr<VariantSupport>;
-  void Insert(std::string_view sample_name, std::unique_ptr<VariantSupport> data) {
-    mItems.emplace_back(sample_name, std::move(data));
-  }
-
-  [[nodiscard]] auto begin() const { return mItems.begin(); }
-  [[nodiscard]] auto end() const { return mItems.end(); }
+  [[nodiscard]] auto Find(usize sample_index) const -> VariantSupport const*;
+
+  /// `reads_hint` pre-sizes the REF allele's columns the first time this sample's
+  /// slot is created; it is ignored for slots that already exist.
+  [[nodiscard]] auto FindOrCreate(usize sample_index, usize reads_hint = 0) -> VariantSupport&;
+
+  [[nodiscard]] auto begin() const { return mSlots.begin(); }
+  [[nodiscard]] auto end() const { return mSlots.end(); }
 
  private:
-  absl::InlinedVector<NamedSupport, 8> mItems;  // 8B aligned
+  absl::InlinedVector<VariantSupport, 8> mSlots;  // 8B aligned
 };
 
 }  // namespace lancet::caller
@@ -2,6 +2,8 @@
 
 #include "lancet/base/types.h"
 #include "lancet/caller/alt_allele.h"
+#include "lancet/caller/raw_variant.h"
+#include "lancet/core/window.h"
 
 #include "absl/container/flat_hash_map.h"
 
@@ -115,4 +117,35 @@ void VariantBubble::NormalizeVcfParsimony() {
   mGenomeStartPos += (initial_ref_len - mRefAllele.length());
 }
 
+auto AssembleRawVariant(VariantBubble bubble, core::Window const& win) -> RawVariant {
+  // Build multiallelic VCF record
+  RawVariant multi_var;
+  multi_var.mChromIndex = win.ChromIndex();
+  multi_var.mChromName = win.ChromName();
+  multi_var.mGenomeChromPos1 = bubble.mGenomeStartPos;
+
+  // Set REF coordinate (REF is always haplotype 0)
+  multi_var.mLocalRefStart0Idx = bubble.mHapStarts[0];
+  multi_var.mRefAllele = std::move(bubble.mRefAllele);
+
+  // Populate disjoint variant structures
+  for (auto& [normalized_alt, haps] : bubble.mAltAllelesToHaps) {
+    AltAllele sub_alt;
+    sub_alt.mSequence = normalized_alt;
+    sub_alt.mType = RawVariant::ClassifyVariant(multi_var.mRefAllele, sub_alt.mSequence);
+    sub_alt.mLength =
+        CalculateVariantLength(multi_var.mRefAllele, sub_alt.mSequence, sub_alt.mType);
+
+    for (usize const hap_id : haps) {
+      sub_alt.mLocalHapStart0Idxs.emplace(hap_id, bubble.mHapStarts[hap_id]);
+    }
+
+    multi_var.mAlts.push_back(std::move(sub_alt));
+  }
+
+  // Sort ALT alleles for deterministic equality comparison and hash stability in btree_set.
+  std::ranges::sort(multi_var.mAlts);
+  return multi_var;
+}
+
 }  // namespace lancet::caller
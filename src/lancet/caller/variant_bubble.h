@@ -3,6 +3,8 @@
 
 #include "lancet/base/types.h"
 #include "lancet/caller/alt_allele.h"
+#include "lancet/caller/raw_variant.h"
+#include "lancet/core/window.h"
 
 #include "absl/container/flat_hash_map.h"
 
@@ -46,6 +48,13 @@ class VariantBubble {
   void NormalizeVcfParsimony();
 };
 
+// ============================================================================
+// AssembleRawVariant: classify each ALT of a normalized bubble and build the
+// multiallelic RawVariant (ALTs sorted for btree_set stability). Shared by the
+// POA sweep (VariantExtractor) and the de Bruijn walk path (WalkBubbleExtractor).
+// ============================================================================
+[[nodiscard]] auto AssembleRawVariant(VariantBubble bubble, core::Window const& win) -> RawVariant;
+
 }  // namespace lancet::caller
 
 #endif  // SRC_LANCET_CALLER_VARIANT_BUBBLE_H_
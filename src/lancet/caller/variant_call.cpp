@@ -15,6 +15,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
 #include "spdlog/fmt/bundled/base.h"
+#include "spdlog/fmt/bundled/compile.h"
 #include "spdlog/fmt/bundled/format.h"
 
 #include <algorithm>
@@ -141,7 +142,7 @@ void VariantCall::BuildFormatFields(SupportArray const& evidence, Samples samps,
 
   mSampleGenotypes.reserve(samps.size());
   for (auto const& sinfo : samps) {
-    auto const* support = evidence.Find(sinfo.SampleName());
+    auto const* support = evidence.Find(sinfo.SampleIndex());
     if (support == nullptr) {
       SampleFormatData missing;
       missing.SetMissingSupport(true);
@@ -290,6 +291,7 @@ void VariantCall::UpdateSiteQuality(core::SampleInfo const& sinfo,
                                     [[maybe_unused]] VariantSupport const* support,
                                     SupportArray const& evidence, Samples samps,
                                     bool case_ctrl_mode, absl::Span<u32 const> pls) {
+  mHasSiteQuality = true;
   if (case_ctrl_mode) {
     auto const somatic_lor = SomaticLogOddsRatio(sinfo, evidence, samps);
     mSiteQuality = std::max(mSiteQuality, somatic_lor);
@@ -318,7 +320,7 @@ auto VariantCall::SomaticLogOddsRatio(core::SampleInfo const& curr, SupportArray
   // SOLOR is only meaningful for focal (case) samples compared against baseline (control).
   if (curr.TagKind() != cbdg::Label::CASE) return 0.0;
 
-  auto const* case_evidence = supports.Find(curr.SampleName());
+  auto const* case_evidence = supports.Find(curr.SampleIndex());
   // Haldane correction (+1) mitigates undefined zero-division smoothly
   f64 const case_alt = case_evidence ? static_cast<f64>(case_evidence->TotalAltCov()) + 1.0 : 1.0;
   f64 const case_ref = case_evidence ? static_cast<f64>(case_evidence->TotalRefCov()) + 1.0 : 1.0;
@@ -328,7 +330,7 @@ auto VariantCall::SomaticLogOddsRatio(core::SampleInfo const& curr, SupportArray
   f64 count_ctrl = 0.0;
 
   for (auto const& sinfo : samps) {
-    auto const* evidence = supports.Find(sinfo.SampleName());
+    auto const* evidence = supports.Find(sinfo.SampleIndex());
     // Accumulate only baseline (control) samples for the denominator.
     if (sinfo.TagKind() != cbdg::Label::CTRL || evidence == nullptr) continue;
 
@@ -394,7 +396,7 @@ void VariantCall::ComputeState(SupportArray const& evidence, Samples samps,
   }
 
   auto const has_alt = [&evidence](core::SampleInfo const& sinfo, cbdg::Label::Tag role) -> bool {
-    auto const* support = evidence.Find(sinfo.SampleName());
+    auto const* support = evidence.Find(sinfo.SampleIndex());
     return sinfo.TagKind() == role && support != nullptr && support->TotalAltCov() > 0;
   };
 
@@ -433,24 +435,15 @@ void VariantCall::ComputeState(SupportArray const& evidence, Samples samps,
 // Note: SCA, FLD, and MQCD are per-sample FORMAT fields, not site-level INFO.
 // ============================================================================
 void VariantCall::BuildInfoField(bool const case_ctrl_mode) {
-  using namespace std::string_view_literals;
-
-  static constexpr std::array<std::string_view, 6> TYPE_MAP = {
-      {"REF"sv, "SNV"sv, "INS"sv, "DEL"sv, "MNP"sv, "CPX"sv}};
-
   std::vector<std::string_view> vcategories(mCategories.size());
-  std::ranges::transform(mCategories, vcategories.begin(),
-                         [](auto categ) { return TYPE_MAP[static_cast<i8>(categ) + 1]; });
+  std::ranges::transform(mCategories, vcategories.begin(), TypeName);
 
   std::string info;
   info.reserve(1024);
 
   if (case_ctrl_mode) {
     // SHARED/CTRL/CASE state prefix — case-control mode only
-    static constexpr std::array<std::string_view, 5> STATE_MAP = {
-        {"NONE"sv, "SHARED"sv, "CTRL"sv, "CASE"sv, "UNKNOWN"sv}};
-
-    absl::StrAppend(&info, STATE_MAP[static_cast<i8>(mState) + 1], ";");
+    absl::StrAppend(&info, StateName(mState), ";");
   }
 
   if (mIsMultiallelic) absl::StrAppend(&info, "MULTIALLELIC;");
@@ -468,21 +461,44 @@ void VariantCall::BuildInfoField(bool const case_ctrl_mode) {
 // AsVcfRecord: emit a VCF record with comma-separated ALTs for multi-allelic.
 // ============================================================================
 auto VariantCall::AsVcfRecord() const -> std::string {
-  auto const alt_field = absl::StrJoin(mAltAlleles, ",");
-  std::vector<std::string> format_strings;
-  format_strings.reserve(mSampleGenotypes.size() + 1);
-  format_strings.emplace_back(FORMAT_HEADER);
+  fmt::memory_buffer buffer;
+  AppendVcfRecord(buffer);
+  return fmt::to_string(buffer);
+}
 
-  for (auto const& sample : mSampleGenotypes) {
-    format_strings.push_back(sample.RenderVcfString());
+// ============================================================================
+// AppendVcfRecord: the whole record (no trailing newline) appended to `out`.
+//
+// CHROM..INFO are copied or formatted in place and every sample's FORMAT
+// column is rendered by SampleFormatData::AppendVcfString into the same
+// buffer, so a reused buffer needs no heap allocation per record or sample.
+// QUAL is "." when no sample had support, since it was never measured.
+// ============================================================================
+void VariantCall::AppendVcfRecord(fmt::memory_buffer& out) const {
+  static constexpr auto APPEND_TEXT = [](fmt::memory_buffer& buf, std::string_view text) {
+    buf.append(text.data(), text.data() + text.size());
+  };
+
+  auto sink = std::back_inserter(out);
+  fmt::format_to(sink, FMT_COMPILE("{}\t{}\t.\t{}\t"), mChromName, mStartPos1, mRefAllele);
+  for (usize idx = 0; idx < mAltAlleles.size(); ++idx) {
+    if (idx > 0) out.push_back(',');
+    APPEND_TEXT(out, mAltAlleles[idx]);
+  }
+
+  if (mHasSiteQuality) {
+    fmt::format_to(sink, FMT_COMPILE("\t{:.2f}\t.\t"), mSiteQuality);
+  } else {
+    APPEND_TEXT(out, "\t.\t.\t");
   }
+  APPEND_TEXT(out, mInfoField);
+  out.push_back('\t');
+  APPEND_TEXT(out, FORMAT_HEADER);
 
-  // clang-format off
-  return fmt::format("{CHROM}\t{POS}\t.\t{REF}\t{ALT}\t{QUAL:.2f}\t.\t{INFO}\t{FORMAT}",
-                     fmt::arg("CHROM", mChromName), fmt::arg("POS", mStartPos1),
-                     fmt::arg("REF", mRefAllele), fmt::arg("ALT", alt_field),
-                     fmt::arg("QUAL", mSiteQuality), fmt::arg("INFO", mInfoField),
-                     fmt::arg("FORMAT", absl::StrJoin(format_strings, "\t")));
-  // clang-format on
+  for (auto const& sample : mSampleGenotypes) {
+    out.push_back('\t');
+    sample.AppendVcfString(out);
+  }
 }
+
 }  // namespace lancet::caller
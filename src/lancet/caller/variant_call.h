@@ -12,8 +12,10 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/types/span.h"
+#include "spdlog/fmt/bundled/format.h"
 
 #include <algorithm>
+#include <array>
 #include <compare>
 #include <numeric>
 #include <optional>
@@ -76,6 +78,20 @@ class VariantCall {
   VariantCall(RawVariant const* var, SupportsByVariant const& all_supports, Samples samps,
               usize window_length);
 
+  /// INFO spellings of AlleleType / AlleleState, indexed by enum value + 1.
+  /// Shared by the text INFO field and caller::BcfRecordEncoder.
+  static constexpr std::array<std::string_view, 6> TYPE_NAMES = {
+      {"REF", "SNV", "INS", "DEL", "MNP", "CPX"}};
+  static constexpr std::array<std::string_view, 5> STATE_NAMES = {
+      {"NONE", "SHARED", "CTRL", "CASE", "UNKNOWN"}};
+
+  [[nodiscard]] static constexpr auto TypeName(AlleleType const type) -> std::string_view {
+    return TYPE_NAMES[static_cast<usize>(static_cast<i8>(type) + 1)];
+  }
+  [[nodiscard]] static constexpr auto StateName(AlleleState const state) -> std::string_view {
+    return STATE_NAMES[static_cast<usize>(static_cast<i8>(state) + 1)];
+  }
+
   [[nodiscard]] auto ChromIndex() const -> usize { return mChromIndex; }
   [[nodiscard]] auto ChromName() const -> std::string_view { return mChromName; }
   [[nodiscard]] auto StartPos1() const -> usize { return mStartPos1; }
@@ -84,9 +100,16 @@ class VariantCall {
   [[nodiscard]] auto NumAltAlleles() const -> usize { return mAltAlleles.size(); }
   [[nodiscard]] auto VariantLengths() const -> absl::Span<i64 const> { return mVariantLengths; }
   [[nodiscard]] auto Quality() const -> f64 { return mSiteQuality; }
+  /// False when no sample has support: QUAL was never measured and is written as ".".
+  [[nodiscard]] auto HasQuality() const -> bool { return mHasSiteQuality; }
   [[nodiscard]] auto State() const -> AlleleState { return mState; }
   [[nodiscard]] auto Categories() const -> absl::Span<AlleleType const> { return mCategories; }
   [[nodiscard]] auto IsMultiallelic() const -> bool { return mIsMultiallelic; }
+  [[nodiscard]] auto GraphCx() const -> GraphMetrics const& { return mGraphCx; }
+  [[nodiscard]] auto SeqCx() const -> base::SequenceComplexity const& { return mSeqCx; }
+  [[nodiscard]] auto SampleGenotypes() const -> absl::Span<SampleFormatData const> {
+    return mSampleGenotypes;
+  }
 
   [[nodiscard]] auto NumSamples() const -> usize { return mSampleGenotypes.size(); }
   [[nodiscard]] auto Identifier() const -> VariantID { return mVariantId; }
@@ -97,6 +120,8 @@ class VariantCall {
   [[nodiscard]] auto HasAltSupport() const -> bool { return mHasAltSupport; }
 
   [[nodiscard]] auto AsVcfRecord() const -> std::string;
+  /// Appends the record (without trailing newline) to `out`; see variant_call.cpp.
+  void AppendVcfRecord(fmt::memory_buffer& out) const;
 
   // ============================================================================
   // VARIANT STORE EXTENSIONS (* ALLELE OVERLAPS)
@@ -138,7 +163,9 @@ class VariantCall {
   //   call, ensuring at most one VCF record per locus.
   //
   // DOWNSTREAM INVARIANT (VariantStore):
-  //   VariantStore uses Identifier() (== mVariantId) as flat_hash_map key.
+  //   VariantStore keys its B-tree by (ChromIndex(), StartPos1(), Identifier()).
+  //   Identifier() (== mVariantId) already implies the CHROM+POS prefix, so it
+  //   alone decides whether two calls collide.
   //   When a duplicate is found (same CHROM+POS+REF), the variant with higher
   //   TotalCoverage() replaces the existing one. This means after dedup, at
   //   most one variant per locus exists, so the TotalCov and mVariantId
@@ -202,6 +229,7 @@ class VariantCall {
   AlleleState mState = AlleleState::NONE;
   bool mIsMultiallelic = false;
   bool mHasAltSupport = false;
+  bool mHasSiteQuality = false;
 
   /// Site Depth Fold Change: sample DP / per-sample window mean coverage.
   /// Returns nullopt if window coverage is zero (renders as "." in VCF).
@@ -20,7 +20,7 @@
 namespace lancet::caller {
 
 VariantExtractor::VariantExtractor(spoa::Graph const& graph, core::Window const& win,
-                                   usize anchor_start)
+                                   usize anchor_start, usize hap_offset)
     : mGraph(graph),
       mWin(win),
       mRefAnchorStart(anchor_start),
@@ -29,7 +29,7 @@ VariantExtractor::VariantExtractor(spoa::Graph const& graph, core::Window const&
   // A graph with fewer than 2 sequences has only the REF — no variants to extract.
   if (mNumSeqs < 2) return;
 
-  mCurrentHapPos.assign(mNumSeqs, 0);
+  mCurrentHapPos.assign(mNumSeqs, hap_offset);
 
   // ===========================================================================
   // RANK LOOKUP INITIALIZATION:  O(N) Inverse Topological Indexing
@@ -202,34 +202,7 @@ auto VariantExtractor::CreateNormalizedBubble(usize genome_start_pos,
 
 // Classify each ALT allele and assemble the final multiallelic RawVariant.
 auto VariantExtractor::AssembleMultiallelicVariant(VariantBubble bubble) -> RawVariant {
-  // Build multiallelic VCF record
-  RawVariant multi_var;
-  multi_var.mChromIndex = mWin.ChromIndex();
-  multi_var.mChromName = mWin.ChromName();
-  multi_var.mGenomeChromPos1 = bubble.mGenomeStartPos;
-
-  // Set REF coordinate
-  multi_var.mLocalRefStart0Idx = bubble.mHapStarts[REF_HAP_IDX];
-  multi_var.mRefAllele = std::move(bubble.mRefAllele);
-
-  // Populate disjoint variant structures
-  for (auto& [normalized_alt, haps] : bubble.mAltAllelesToHaps) {
-    AltAllele sub_alt;
-    sub_alt.mSequence = normalized_alt;
-    sub_alt.mType = RawVariant::ClassifyVariant(multi_var.mRefAllele, sub_alt.mSequence);
-    sub_alt.mLength =
-        CalculateVariantLength(multi_var.mRefAllele, sub_alt.mSequence, sub_alt.mType);
-
-    for (usize const hap_id : haps) {
-      sub_alt.mLocalHapStart0Idxs.emplace(hap_id, bubble.mHapStarts[hap_id]);
-    }
-
-    multi_var.mAlts.push_back(std::move(sub_alt));
-  }
-
-  // Sort ALT alleles for deterministic equality comparison and hash stability in btree_set.
-  std::ranges::sort(multi_var.mAlts);
-  return multi_var;
+  return AssembleRawVariant(std::move(bubble), mWin);
 }
 
 }  // namespace lancet::caller
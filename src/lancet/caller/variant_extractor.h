@@ -72,7 +72,10 @@ constexpr usize REF_HAP_IDX = 0;
 // ================================================================================================
 class VariantExtractor {
  public:
-  VariantExtractor(spoa::Graph const& graph, core::Window const& win, usize anchor_start);
+  // `hap_offset`: leading bases clipped from every haplotype before POA, so the graph's
+  // position 0 is haplotype position `hap_offset` (see MsaFlanks::CLIPPED).
+  VariantExtractor(spoa::Graph const& graph, core::Window const& win, usize anchor_start,
+                   usize hap_offset = 0);
 
   // ===================================================================================================
   // VARIANT EXTRACTOR FLOWCHART
@@ -1,13 +1,46 @@
 #include "lancet/caller/variant_set.h"
 
+#include "lancet/base/types.h"
+#include "lancet/caller/alt_allele.h"
+#include "lancet/caller/raw_variant.h"
+#include "lancet/caller/variant_bubble.h"
 #include "lancet/caller/variant_extractor.h"
+#include "lancet/caller/walk_bubble_extractor.h"
+#include "lancet/cbdg/path.h"
+#include "lancet/core/window.h"
 
+#include "absl/types/span.h"
 #include "spoa/graph.hpp"
 
-#include <vector>
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace lancet::caller {
 
+namespace {
+
+constexpr usize SIMPLE_ALT_HAP_IDX = 1;
+
+// Length of the shared prefix / suffix of `lhs` and `rhs`, capped at `limit`.
+[[nodiscard]] auto CommonPrefixLength(std::string_view lhs, std::string_view rhs, usize limit)
+    -> usize {
+  usize count = 0;
+  while (count < limit && lhs[count] == rhs[count]) ++count;
+  return count;
+}
+
+[[nodiscard]] auto CommonSuffixLength(std::string_view lhs, std::string_view rhs, usize limit)
+    -> usize {
+  usize count = 0;
+  while (count < limit && lhs[lhs.size() - 1 - count] == rhs[rhs.size() - 1 - count]) ++count;
+  return count;
+}
+
+}  // namespace
+
 // ============================================================================
 // Variant Set — Extracted Architecture
 //
@@ -15,6 +48,7 @@ namespace lancet::caller {
 // │ variant_bubble.h/.cpp                                │
 // │   CalculateVariantLength()   — sequence core length  │
 // │   VariantBubble              — VCF parsimony trimmer │
+// │   AssembleRawVariant()       — bubble → RawVariant   │
 // ├──────────────────────────────────────────────────────┤
 // │ variant_extractor.h/.cpp                             │
 // │   VariantExtractor           — DAG bubble FSM        │
@@ -26,15 +60,97 @@ namespace lancet::caller {
 // │   CreateNormalizedBubble()   — allele grouping       │
 // │   AssembleMultiallelicVariant() — VCF record build   │
 // ├──────────────────────────────────────────────────────┤
+// │ walk_bubble_extractor.h/.cpp                         │
+// │   WalkBubbleExtractor        — de Bruijn walk sweep  │
+// ├──────────────────────────────────────────────────────┤
 // │ variant_set.cpp (this file)                          │
-// │   VariantSet(graph, win, start) — constructor        │
+// │   VariantSet(graph, win, start, off) — constructor   │
+// │   FromSimplePair()           — POA-free fast path    │
+// │   FromWalkBubbles()          — POA-free walk path    │
 // └──────────────────────────────────────────────────────┘
 // ============================================================================
-VariantSet::VariantSet(spoa::Graph const& graph, core::Window const& win, usize ref_anchor_start) {
+VariantSet::VariantSet(spoa::Graph const& graph, core::Window const& win, usize ref_anchor_start,
+                       usize hap_offset) {
   if (graph.sequences().size() < 2) return;
 
-  VariantExtractor extractor(graph, win, ref_anchor_start);
+  VariantExtractor extractor(graph, win, ref_anchor_start, hap_offset);
   extractor.SearchAndExtractTo(this->mResultVariants);
 }
 
+// ============================================================================
+// FromSimplePair — reproduces what VariantExtractor emits for the single
+// bubble of a REF/ALT pair with one edit, without building the POA graph.
+//
+// With `prefix` / `suffix` = shared leading / trailing bases and `n` = the
+// shorter haplotype length:
+//
+//   SNV    equal lengths, one mismatch at `prefix`. Bubble = anchor + base;
+//          the left trim drops the anchor, so POS = start + prefix.
+//   INDEL  prefix + suffix ≥ n. The edit starts at e = n − suffix, its
+//          left-most placement (e = prefix unless it slides in a repeat).
+//          Bubble = anchor + indel bases; a 1-base allele blocks both trims,
+//          so POS = start + e − 1 and the anchor stays in REF/ALT.
+//
+// Local offsets are taken before trimming (as mHapStarts are in the
+// extractor), i.e. the anchor index `e − 1` on both haplotypes.
+// ============================================================================
+auto VariantSet::FromSimplePair(absl::Span<std::string_view const> haplotypes,
+                                core::Window const& win, usize ref_anchor_start)
+    -> std::optional<VariantSet> {
+  if (haplotypes.size() != 2) return std::nullopt;
+
+  auto const ref_hap = haplotypes[REF_HAP_IDX];
+  auto const alt_hap = haplotypes[SIMPLE_ALT_HAP_IDX];
+  auto const shorter_len = std::min(ref_hap.size(), alt_hap.size());
+  auto const prefix = CommonPrefixLength(ref_hap, alt_hap, shorter_len);
+  auto const suffix = CommonSuffixLength(ref_hap, alt_hap, shorter_len);
+
+  // Edits touching either end have no left anchor or no right convergence node.
+  if (prefix == 0 || suffix == 0) return std::nullopt;
+
+  bool const is_snv = ref_hap.size() == alt_hap.size() && prefix + suffix + 1 == shorter_len;
+  bool const is_indel = ref_hap.size() != alt_hap.size() && prefix + suffix >= shorter_len;
+  if (!is_snv && !is_indel) return std::nullopt;
+
+  // A repeat indel sliding all the way to the first base has no anchor left.
+  auto const edit_start = is_snv ? prefix : shorter_len - suffix;
+  if (edit_start == 0) return std::nullopt;
+
+  auto const anchor_idx = edit_start - 1;
+  auto const ref_len = is_snv ? 1 : ref_hap.size() - shorter_len + 1;
+  auto const alt_len = is_snv ? 1 : alt_hap.size() - shorter_len + 1;
+  auto const allele_start = is_snv ? edit_start : anchor_idx;
+
+  RawVariant var;
+  var.mChromIndex = win.ChromIndex();
+  var.mChromName = win.ChromName();
+  var.mGenomeChromPos1 = ref_anchor_start + allele_start;
+  var.mLocalRefStart0Idx = anchor_idx;
+  var.mRefAllele = std::string(ref_hap.substr(allele_start, ref_len));
+
+  AltAllele alt;
+  alt.mSequence = std::string(alt_hap.substr(allele_start, alt_len));
+  alt.mType = RawVariant::ClassifyVariant(var.mRefAllele, alt.mSequence);
+  alt.mLength = CalculateVariantLength(var.mRefAllele, alt.mSequence, alt.mType);
+  alt.mLocalHapStart0Idxs.emplace(SIMPLE_ALT_HAP_IDX, anchor_idx);
+  var.mAlts.push_back(std::move(alt));
+
+  VariantSet result;
+  result.mResultVariants.insert(std::move(var));
+  return result;
+}
+
+// ============================================================================
+// FromWalkBubbles — all-or-nothing: a component whose walks cannot all be
+// anchored on REF yields std::nullopt rather than a partial variant set.
+// ============================================================================
+auto VariantSet::FromWalkBubbles(absl::Span<cbdg::Path const> paths, usize const kmer_len,
+                                 core::Window const& win, usize const ref_anchor_start)
+    -> std::optional<VariantSet> {
+  VariantSet result;
+  WalkBubbleExtractor extractor(paths, kmer_len, win, ref_anchor_start);
+  if (!extractor.ExtractTo(result.mResultVariants)) return std::nullopt;
+  return result;
+}
+
 }  // namespace lancet::caller
@@ -3,9 +3,14 @@
 
 #include "lancet/base/types.h"
 #include "lancet/caller/raw_variant.h"
+#include "lancet/cbdg/path.h"
 #include "lancet/core/window.h"
 
 #include "absl/container/btree_set.h"
+#include "absl/types/span.h"
+
+#include <optional>
+#include <string_view>
 
 namespace spoa {
 class Graph;
@@ -13,6 +18,17 @@ class Graph;
 
 namespace lancet::caller {
 
+// ============================================================================
+// VariantExtractionMode: how ALT alleles are read off an assembled component.
+//
+//   MSA   — SPOA partial-order alignment of all haplotypes, then a bubble
+//           sweep of the alignment graph (VariantExtractor).
+//   WALK  — divergent runs of the de Bruijn walks themselves, anchored on
+//           REF-unique nodes (WalkBubbleExtractor). Falls back to MSA when
+//           a walk cannot be anchored.
+// ============================================================================
+enum class VariantExtractionMode : u8 { MSA = 0, WALK = 1 };
+
 // ============================================================================
 // VariantSet: Multiallelic Graph Extraction Engine
 //
@@ -22,7 +38,42 @@ namespace lancet::caller {
 // ============================================================================
 class VariantSet {
  public:
-  VariantSet(spoa::Graph const& graph, core::Window const& win, usize ref_anchor_start);
+  /// `hap_offset` is the number of leading bases clipped from every haplotype before
+  /// POA (MsaBuilder::mClippedPrefixLen); it is added back to the local offsets.
+  VariantSet(spoa::Graph const& graph, core::Window const& win, usize ref_anchor_start,
+             usize hap_offset = 0);
+
+  // ==========================================================================
+  // FromSimplePair: POA-free fast path for trivially aligned components.
+  //
+  // Handles exactly REF + one ALT whose only difference is a single interior
+  // SNV or a single interior indel. With MSA_MATCH_SCORE = 0, any alignment
+  // other than the one gap or mismatch adds more, so the optimal alignments
+  // differ only in where an indel sits inside a repeat. SPOA's traceback runs
+  // right to left taking the diagonal first, which leaves that gap left-most;
+  // this path places it left-most too. The SPOA graph and its bubble sweep
+  // would therefore yield the same RawVariant built here directly, including
+  // POS, the VCF anchor and every local haplotype offset.
+  //
+  // Returns std::nullopt for anything else (multiple ALTs, MNPs, edits touching
+  // either end, a repeat indel that slides to the first base); callers fall
+  // back to SPOA.
+  // ==========================================================================
+  [[nodiscard]] static auto FromSimplePair(absl::Span<std::string_view const> haplotypes,
+                                           core::Window const& win, usize ref_anchor_start)
+      -> std::optional<VariantSet>;
+
+  // ==========================================================================
+  // FromWalkBubbles: POA-free extraction from the assembly walks.
+  //
+  // `paths[0]` must be the REF walk from source to sink and every other path
+  // an ALT walk between the same anchors; adjacent walk nodes overlap by
+  // `kmer_len − 1` bases. Returns std::nullopt when any ALT walk cannot be
+  // anchored on REF (see WalkBubbleExtractor); callers fall back to SPOA.
+  // ==========================================================================
+  [[nodiscard]] static auto FromWalkBubbles(absl::Span<cbdg::Path const> paths, usize kmer_len,
+                                            core::Window const& win, usize ref_anchor_start)
+      -> std::optional<VariantSet>;
 
   using BTree = absl::btree_set<RawVariant>;
 
@@ -55,6 +106,8 @@ class VariantSet {
 
  private:
   absl::btree_set<RawVariant> mResultVariants;
+
+  VariantSet() = default;
 };
 
 }  // namespace lancet::caller
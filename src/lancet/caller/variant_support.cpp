@@ -22,6 +22,19 @@ namespace lancet::caller {
 // AddEvidence
 // ============================================================================
 void VariantSupport::AddEvidence(ReadEvidence const& evidence) {
+  // Mates are deduplicated per allele below, but a fragment contributes a
+  // single likelihood row: the first-seen read of the pair supplies it.
+  if (!evidence.mAlleleLog10Liks.empty()) {
+    bool const seen_read = std::ranges::any_of(mAlleleData, [&evidence](auto const& data) {
+      return data.mNameHashes.contains(evidence.mRnameHash);
+    });
+    if (!seen_read && (mLikRowWidth == 0 || mLikRowWidth == evidence.mAlleleLog10Liks.size())) {
+      mLikRowWidth = evidence.mAlleleLog10Liks.size();
+      mReadAlleleLog10Liks.insert(mReadAlleleLog10Liks.end(), evidence.mAlleleLog10Liks.begin(),
+                                  evidence.mAlleleLog10Liks.end());
+    }
+  }
+
   EnsureAlleleSlot(evidence.mAllele);
   auto& data = mAlleleData[evidence.mAllele];
 
@@ -83,6 +96,8 @@ void VariantSupport::MergeAlleleFrom(VariantSupport const& src, AlleleIndex cons
   if (src_allele >= src.mAlleleData.size()) return;
 
   EnsureAlleleSlot(dst_allele);
+  mReadAlleleLog10Liks.clear();
+  mLikRowWidth = 0;
   auto const& src_data = src.mAlleleData[src_allele];
   auto& dst_data = mAlleleData[dst_allele];
 
@@ -308,36 +323,30 @@ auto VariantSupport::ReadPosCohenD() const -> std::optional<f64> {
 // BaseQualCohenD (BQCD FORMAT field)
 //
 // Coverage-normalized effect size comparing base qualities of REF vs ALT reads.
-// Concatenates forward and reverse strand base qualities per allele.
+// Forward and reverse strand base qualities of each allele are counted into
+// one 256-bin histogram per group (REF, pooled ALT) — no concatenation copies.
 // Detects 8-oxoguanine oxidation artifacts where the miscalled base has
 // characteristically low Phred confidence.
 //
-// Custom shape: fwd+rev concatenation per allele prevents using the simple
+// Custom shape: two fields (fwd + rev) per allele prevents using the simple
 // RefVsAltEffectSize template (which expects a single field per allele).
 //
 // Returns std::nullopt if either group is empty (untestable).
 // Returns 0.0 when test ran but found no bias (genuine zero).
 // ============================================================================
 auto VariantSupport::BaseQualCohenD() const -> std::optional<f64> {
-  // Collect REF base qualities (fwd + rev concatenated)
-  std::vector<u8> ref_bqs;
-  if (REF_ALLELE_IDX < mAlleleData.size()) {
-    auto const& ref = mAlleleData[REF_ALLELE_IDX];
-    ref_bqs.reserve(ref.mFwdBaseQuals.size() + ref.mRevBaseQuals.size());
-    ref_bqs.insert(ref_bqs.end(), ref.mFwdBaseQuals.begin(), ref.mFwdBaseQuals.end());
-    ref_bqs.insert(ref_bqs.end(), ref.mRevBaseQuals.begin(), ref.mRevBaseQuals.end());
+  base::U8Histogram ref_hist{};
+  base::U8Histogram alt_hist{};
+
+  for (usize i = 0; i < mAlleleData.size(); ++i) {
+    auto const& data = mAlleleData[i];
+    auto& hist = i == REF_ALLELE_IDX ? ref_hist : alt_hist;
+    base::AccumulateHistogram(absl::MakeConstSpan(data.mFwdBaseQuals), hist);
+    base::AccumulateHistogram(absl::MakeConstSpan(data.mRevBaseQuals), hist);
   }
 
-  // Pool all ALT base qualities
-  std::vector<u8> alt_bqs;
-  for (usize i = 1; i < mAlleleData.size(); ++i) {
-    auto const& alt = mAlleleData[i];
-    alt_bqs.insert(alt_bqs.end(), alt.mFwdBaseQuals.begin(), alt.mFwdBaseQuals.end());
-    alt_bqs.insert(alt_bqs.end(), alt.mRevBaseQuals.begin(), alt.mRevBaseQuals.end());
-  }
-
-  return base::MannWhitneyEffectSize<u8>(absl::MakeConstSpan(ref_bqs),
-                                         absl::MakeConstSpan(alt_bqs));
+  return base::MannWhitneyEffectSizeFromCounts(absl::MakeConstSpan(ref_hist),
+                                               absl::MakeConstSpan(alt_hist));
 }
 
 // ============================================================================
@@ -409,6 +418,10 @@ auto VariantSupport::ComputePLs(usize const num_alleles) const -> absl::InlinedV
   auto const num_al = static_cast<int>(num_alleles);
   if (num_al == 0) return {};
 
+  if (mLikRowWidth == num_alleles) {
+    return ComputeReadLikelihoodPLs(absl::MakeConstSpan(mReadAlleleLog10Liks), num_alleles);
+  }
+
   // Build allele count vector: count[i] = total reads assigned to allele i.
   // TotalAlleleCov(idx) returns 0 for alleles beyond mAlleleData.size(),
   // so alleles the sample has no reads for correctly get count=0.
@@ -460,7 +473,16 @@ auto VariantSupport::ComputeContinuousMixtureLods(usize const num_alleles) const
 // EnsureAlleleSlot
 // ============================================================================
 void VariantSupport::EnsureAlleleSlot(AlleleIndex const idx) {
-  if (idx >= mAlleleData.size()) mAlleleData.resize(idx + 1);
+  if (idx < mAlleleData.size()) return;
+
+  // Only REF is pre-sized: it usually takes most of the window's reads, while
+  // ALT slots take a small and unpredictable share and grow by push_back.
+  // Reserving the full hint per ALT would multiply memory by the allele count.
+  auto const prev_size = mAlleleData.size();
+  mAlleleData.resize(idx + 1);
+  if (mReadsHint > 0 && prev_size == REF_ALLELE_IDX) {
+    mAlleleData[REF_ALLELE_IDX].Reserve(mReadsHint);
+  }
 }
 
 }  // namespace lancet::caller
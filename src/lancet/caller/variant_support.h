@@ -12,6 +12,7 @@
 #include <functional>
 #include <numeric>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 #include <cmath>
@@ -61,12 +62,18 @@ class VariantSupport {
  public:
   VariantSupport() = default;
 
+  /// `reads_hint` is an upper bound on reads any one allele can receive (the
+  /// sample's read count in the window). The REF slot is pre-sized to it.
+  explicit VariantSupport(usize const reads_hint) : mReadsHint(reads_hint) {}
+
   struct ReadEvidence {
     // ── 8B Align ────────────────────────────────────────────────────────────
     i64 mInsertSize;      // template length from original alignment (for FLD)
     i64 mAlignmentStart;  // fragment genomic start position (for FSSE)
     f64 mAlnScore;        // normalized alignment score to the assigned haplotype
     f64 mFoldedReadPos;   // 0.0=read edge, 0.5=read center (for RPCD)
+    // pair-HMM backend: log10 P(read | allele) per allele (for PL); empty under minimap2
+    absl::Span<f64 const> mAlleleLog10Liks;
 
     // ── 4B Align ────────────────────────────────────────────────────────────
     u32 mRnameHash;            // hash of read name (for dedup)
@@ -276,6 +283,10 @@ class VariantSupport {
   //
   // Returns: vector of K*(K+1)/2 Phred-scaled likelihoods (best genotype PL=0).
   //
+  // Under the pair-HMM genotyping backend every read also carries per-allele
+  // likelihoods; when those cover all K alleles the PLs come from the per-read
+  // product model instead (ComputeReadLikelihoodPLs in genotype_likelihood.h).
+  //
   // See docs/guides/variant_discovery_genotyping.md for the full DM derivation.
   [[nodiscard]] auto ComputePLs(usize num_alleles) const -> absl::InlinedVector<u32, 6>;
 
@@ -324,14 +335,20 @@ class VariantSupport {
   // Copy allele data from `src` allele `src_allele` into `dst_allele` slot
   // in this object. Used for multi-allelic merging: each bi-allelic variant
   // has alleles {0=REF, 1=ALT}. When merging N variants at a locus, we remap
-  // variant[i]'s ALT(1) → merged allele (i+1).
+  // variant[i]'s ALT(1) → merged allele (i+1). Per-read allele likelihoods
+  // cannot be remapped this way, so a merged support falls back to DM PLs.
   void MergeAlleleFrom(VariantSupport const& src, AlleleIndex src_allele, AlleleIndex dst_allele);
 
  private:
+  // ── 8B Align ────────────────────────────────────────────────────────────
   // Dense vector indexed by AlleleIndex: mAlleleData[0]=REF, [1]=ALT1, ...
-  std::vector<PerAlleleData> mAlleleData;
+  std::vector<PerAlleleData> mAlleleData;  // 24B
+  // Pair-HMM backend: one row of mLikRowWidth log10 P(read | allele) per distinct read
+  std::vector<f64> mReadAlleleLog10Liks;  // 24B
+  usize mLikRowWidth = 0;                 // 8B — alleles per row, 0 until the first row
+  usize mReadsHint = 0;                   // 8B — REF column capacity on first use
 
-  // Grow the vector to accommodate a new allele index.
+  // Grow the vector to accommodate a new allele index, pre-sizing the REF slot to mReadsHint.
   void EnsureAlleleSlot(AlleleIndex idx);
 
   // ── Template Helpers (defined in header for instantiation) ─────────────
@@ -350,12 +367,25 @@ class VariantSupport {
 
   /// Compute REF-vs-pooled-ALT effect size using a field accessor.
   /// Pattern A: wraps MannWhitneyEffectSize for Cohen's D metrics.
+  /// u8 fields (BQ, MAPQ) are counted straight into fixed histograms — no ALT
+  /// pooling vector, no sort; other types pool ALT values and rank by sort.
   template <typename ValueType, typename FieldAccessor>
   [[nodiscard]] auto RefVsAltEffectSize(FieldAccessor&& field_getter) const -> std::optional<f64> {
     if (REF_ALLELE_IDX >= mAlleleData.size()) return std::nullopt;
     auto const ref_vals = absl::MakeConstSpan(field_getter(mAlleleData[REF_ALLELE_IDX]));
-    auto const alt_vals = PoolAltValues<ValueType>(std::forward<FieldAccessor>(field_getter));
-    return base::MannWhitneyEffectSize<ValueType>(ref_vals, absl::MakeConstSpan(alt_vals));
+    if constexpr (std::is_same_v<ValueType, u8>) {
+      base::U8Histogram ref_hist{};
+      base::U8Histogram alt_hist{};
+      base::AccumulateHistogram(ref_vals, ref_hist);
+      for (usize aidx = 1; aidx < mAlleleData.size(); ++aidx) {
+        base::AccumulateHistogram(absl::MakeConstSpan(field_getter(mAlleleData[aidx])), alt_hist);
+      }
+      return base::MannWhitneyEffectSizeFromCounts(absl::MakeConstSpan(ref_hist),
+                                                   absl::MakeConstSpan(alt_hist));
+    } else {
+      auto const alt_vals = PoolAltValues<ValueType>(std::forward<FieldAccessor>(field_getter));
+      return base::MannWhitneyEffectSize<ValueType>(ref_vals, absl::MakeConstSpan(alt_vals));
+    }
   }
 
   /// Compute mean(pooled ALT values) − mean(REF values) with an optional offset.
@@ -8,9 +8,9 @@ namespace lancet::caller {
 // ============================================================================
 // FORMAT_HEADER: authoritative single-source-of-truth for VCF FORMAT fields.
 //
-// All FORMAT field rendering (AsVcfRecord, RenderVcfString, missing-support
+// All FORMAT field rendering (AppendVcfRecord, AppendVcfString, missing-support
 // strings) must be kept in sync with this constant. Changes here must be
-// reflected in sample_format_data.cpp's RenderVcfString format template.
+// reflected in sample_format_data.cpp's AppendVcfString field sequence.
 //
 // clang-format off
 // Field ordering rationale (VCF convention: genotype fields first, then
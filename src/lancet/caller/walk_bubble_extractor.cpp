@@ -0,0 +1,376 @@
+#include "lancet/caller/walk_bubble_extractor.h"
+
+#include "lancet/base/types.h"
+#include "lancet/caller/msa_builder.h"
+#include "lancet/caller/raw_variant.h"
+#include "lancet/caller/variant_bubble.h"
+#include "lancet/cbdg/path.h"
+#include "lancet/core/window.h"
+
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using lancet::caller::MSA_EXTEND1_SCORE;
+using lancet::caller::MSA_EXTEND2_SCORE;
+using lancet::caller::MSA_MATCH_SCORE;
+using lancet::caller::MSA_MISMATCH_SCORE;
+using lancet::caller::MSA_OPEN1_SCORE;
+using lancet::caller::MSA_OPEN2_SCORE;
+
+// Cores larger than this (REF × ALT cells) are kept whole instead of being aligned.
+// Only multi-kbp SV bubbles get near it, and POA would not split those either.
+constexpr usize MAX_CORE_ALIGN_CELLS = usize{1} << 20;
+constexpr i32 NEG_INF = std::numeric_limits<i32>::min() / 4;
+
+// One non-matching run of a core alignment: REF[mRefOff, +mRefLen) became ALT[mAltOff, +mAltLen).
+struct CoreEdit {
+  // ── 8B Align ──────────────────────────────────────────────────────────
+  usize mRefOff = 0;
+  usize mRefLen = 0;
+  usize mAltOff = 0;
+  usize mAltLen = 0;
+};
+
+// ============================================================================
+// SplitAtMatches — align REF and ALT cores the way the POA would.
+//
+// Global alignment with MsaBuilder's scores: mismatch −6 and the convex gap
+// min(g1 + (l − 1)·e1, g2 + (l − 1)·e2). The traceback runs right to left and
+// takes the diagonal first, then a deletion, then an insertion, as SPOA's does,
+// so co-optimal gaps land left-most. Every matching column is a node the POA
+// haplotype rejoins REF on, so the core is split there into separate edits.
+// ============================================================================
+auto SplitAtMatches(std::string_view ref_core, std::string_view alt_core)
+    -> std::vector<CoreEdit> {
+  auto const nrows = ref_core.size() + 1;
+  auto const ncols = alt_core.size() + 1;
+  if (ref_core.empty() || alt_core.empty() || nrows * ncols > MAX_CORE_ALIGN_CELLS) {
+    return {CoreEdit{.mRefLen = ref_core.size(), .mAltLen = alt_core.size()}};
+  }
+
+  // States: H (best), two deletion (REF-only) and two insertion (ALT-only) gap models
+  enum State : u8 { H = 0, DEL1, DEL2, INS1, INS2, NUM_STATES };
+  static constexpr std::array<i32, NUM_STATES> OPEN = {0, MSA_OPEN1_SCORE, MSA_OPEN2_SCORE,
+                                                       MSA_OPEN1_SCORE, MSA_OPEN2_SCORE};
+  static constexpr std::array<i32, NUM_STATES> EXTEND = {0, MSA_EXTEND1_SCORE, MSA_EXTEND2_SCORE,
+                                                         MSA_EXTEND1_SCORE, MSA_EXTEND2_SCORE};
+
+  std::array<std::vector<i32>, NUM_STATES> dp;
+  for (auto& mat : dp) mat.assign(nrows * ncols, NEG_INF);
+  auto const at = [ncols](usize row, usize col) { return (row * ncols) + col; };
+  auto const subst = [&](usize row, usize col) -> i32 {
+    return ref_core[row - 1] == alt_core[col - 1] ? MSA_MATCH_SCORE : MSA_MISMATCH_SCORE;
+  };
+
+  dp[H][at(0, 0)] = 0;
+  for (usize row = 0; row < nrows; ++row) {
+    for (usize col = 0; col < ncols; ++col) {
+      if (row == 0 && col == 0) continue;
+      auto const idx = at(row, col);
+      i32 best = NEG_INF;
+      if (row > 0 && col > 0) best = dp[H][at(row - 1, col - 1)] + subst(row, col);
+      for (u8 state = DEL1; state <= DEL2; ++state) {
+        if (row == 0) continue;
+        auto const up = at(row - 1, col);
+        dp[state][idx] = std::max(dp[H][up] + OPEN[state], dp[state][up] + EXTEND[state]);
+        best = std::max(best, dp[state][idx]);
+      }
+      for (u8 state = INS1; state <= INS2; ++state) {
+        if (col == 0) continue;
+        auto const left = at(row, col - 1);
+        dp[state][idx] = std::max(dp[H][left] + OPEN[state], dp[state][left] + EXTEND[state]);
+        best = std::max(best, dp[state][idx]);
+      }
+      dp[H][idx] = best;
+    }
+  }
+
+  // Traceback into per-column codes: '=' match, 'X' mismatch, 'D' REF-only, 'I' ALT-only
+  std::string columns;
+  usize row = nrows - 1;
+  usize col = ncols - 1;
+  u8 state = H;
+  while (row > 0 || col > 0) {
+    auto const idx = at(row, col);
+    if (state == H) {
+      if (row > 0 && col > 0 && dp[H][idx] == dp[H][at(row - 1, col - 1)] + subst(row, col)) {
+        columns.push_back(ref_core[row - 1] == alt_core[col - 1] ? '=' : 'X');
+        --row;
+        --col;
+        continue;
+      }
+      for (u8 cand = DEL1; cand < NUM_STATES; ++cand) {
+        if (dp[cand][idx] == dp[H][idx]) {
+          state = cand;
+          break;
+        }
+      }
+      continue;
+    }
+
+    bool const is_del = state == DEL1 || state == DEL2;
+    auto const prev = is_del ? at(row - 1, col) : at(row, col - 1);
+    columns.push_back(is_del ? 'D' : 'I');
+    bool const extends = dp[state][idx] == dp[state][prev] + EXTEND[state];
+    if (is_del) {
+      --row;
+    } else {
+      --col;
+    }
+    if (!extends) state = H;
+  }
+  std::ranges::reverse(columns);
+
+  std::vector<CoreEdit> edits;
+  usize ref_pos = 0;
+  usize alt_pos = 0;
+  for (usize idx = 0; idx < columns.size(); ++idx) {
+    if (columns[idx] == '=') {
+      ++ref_pos;
+      ++alt_pos;
+      continue;
+    }
+
+    if (idx == 0 || columns[idx - 1] == '=') {
+      edits.push_back({.mRefOff = ref_pos, .mRefLen = 0, .mAltOff = alt_pos, .mAltLen = 0});
+    }
+
+    auto& edit = edits.back();
+    bool const uses_ref = columns[idx] != 'I';
+    bool const uses_alt = columns[idx] != 'D';
+    edit.mRefLen += static_cast<usize>(uses_ref);
+    edit.mAltLen += static_cast<usize>(uses_alt);
+    ref_pos += static_cast<usize>(uses_ref);
+    alt_pos += static_cast<usize>(uses_alt);
+  }
+
+  return edits;
+}
+
+}  // namespace
+
+namespace lancet::caller {
+
+WalkBubbleExtractor::WalkBubbleExtractor(absl::Span<cbdg::Path const> paths, usize kmer_len,
+                                         core::Window const& win, usize ref_anchor_start)
+    : mPaths(paths),
+      mWin(win),
+      mRefSeq(paths.empty() ? std::string_view() : paths.front().Sequence()),
+      mKmerLen(kmer_len),
+      mRefAnchorStart(ref_anchor_start) {}
+
+auto WalkBubbleExtractor::ExtractTo(absl::btree_set<RawVariant>& out_variants) -> bool {
+  if (mPaths.size() < 2) return true;
+  if (mKmerLen == 0 || mRefSeq.size() < mKmerLen) return false;
+
+  BuildRefKmerIndex();
+  for (usize hap_idx = 1; hap_idx < mPaths.size(); ++hap_idx) {
+    if (!CollectDivergences(hap_idx)) return false;
+  }
+
+  std::ranges::sort(mDivergences, {}, [](Divergence const& core) {
+    return std::make_tuple(core.mRefStart, core.mRefEnd, core.mHapIdx);
+  });
+
+  // Sweep cores in REF order. A core that starts at or before the running end of the
+  // current bubble means some haplotype has not reconverged yet — same bubble.
+  mHapLengthDelta.assign(mPaths.size(), 0);
+  auto const all_cores = absl::MakeConstSpan(mDivergences);
+  usize first = 0;
+  while (first < all_cores.size()) {
+    usize last = first + 1;
+    usize ref_end = all_cores[first].mRefEnd;
+    while (last < all_cores.size() && all_cores[last].mRefStart <= ref_end) {
+      ref_end = std::max(ref_end, all_cores[last].mRefEnd);
+      ++last;
+    }
+
+    EmitBubble(all_cores.subspan(first, last - first), all_cores[first].mRefStart, ref_end,
+               out_variants);
+    first = last;
+  }
+
+  return true;
+}
+
+void WalkBubbleExtractor::BuildRefKmerIndex() {
+  auto const num_kmers = mRefSeq.size() - mKmerLen + 1;
+  mRefKmerPos.reserve(num_kmers);
+  for (usize offset = 0; offset < num_kmers; ++offset) {
+    auto const [itr, inserted] =
+        mRefKmerPos.try_emplace(mRefSeq.substr(offset, mKmerLen), static_cast<u32>(offset));
+    if (!inserted) itr->second = NON_UNIQUE_KMER;
+  }
+}
+
+// ============================================================================
+// CollectDivergences — walk one ALT path node by node.
+//
+// Node `i` contributed NodeBaseCounts()[i] bases; every node after the first
+// also re-reads the k − 1 bases it shares with its predecessor, so its full
+// sequence starts k − 1 bases before its contribution.
+// ============================================================================
+auto WalkBubbleExtractor::CollectDivergences(usize const hap_idx) -> bool {
+  auto const alt_seq = mPaths[hap_idx].Sequence();
+  auto const node_bases = mPaths[hap_idx].NodeBaseCounts();
+
+  std::optional<SharedNode> prev;
+  usize alt_end = 0;
+  for (usize node_idx = 0; node_idx < node_bases.size(); ++node_idx) {
+    auto const overlap = node_idx == 0 ? 0 : mKmerLen - 1;
+    if (alt_end < overlap) return false;
+
+    auto const alt_start = alt_end - overlap;
+    alt_end += node_bases[node_idx];
+    if (alt_end > alt_seq.size()) return false;
+
+    auto const node = LocateOnRef(alt_seq.substr(alt_start, alt_end - alt_start), alt_start);
+    if (!node.has_value()) continue;
+
+    // The walk must open on the REF source anchor ...
+    if (!prev.has_value()) {
+      if (node->mRefStart != 0 || node->mAltStart != 0) return false;
+      prev = node;
+      continue;
+    }
+
+    // A node placed behind the previous anchor (e.g. a tandem copy) is part of the bubble.
+    if (node->mRefStart <= prev->mRefStart || node->mAltStart <= prev->mAltStart) continue;
+
+    if (!AddDivergence(*prev, *node, hap_idx)) return false;
+    prev = node;
+  }
+
+  // ... and close on the REF sink anchor.
+  return prev.has_value() && alt_end == alt_seq.size() &&
+         prev->mAltStart + prev->mLength == alt_seq.size() &&
+         prev->mRefStart + prev->mLength == mRefSeq.size();
+}
+
+auto WalkBubbleExtractor::LocateOnRef(std::string_view node_seq, usize const alt_start) const
+    -> std::optional<SharedNode> {
+  if (node_seq.size() < mKmerLen) return std::nullopt;
+
+  auto const itr = mRefKmerPos.find(node_seq.substr(0, mKmerLen));
+  if (itr == mRefKmerPos.end() || itr->second == NON_UNIQUE_KMER) return std::nullopt;
+
+  auto const ref_start = static_cast<usize>(itr->second);
+  if (mRefSeq.substr(ref_start, node_seq.size()) != node_seq) return std::nullopt;
+
+  return SharedNode{.mRefStart = ref_start, .mAltStart = alt_start, .mLength = node_seq.size()};
+}
+
+// ============================================================================
+// AddDivergence — REF[e_r, s_r) vs ALT[e_a, s_a) between two anchors.
+//
+// Consecutive anchors normally overlap by k − 1 bases on both haplotypes. If
+// they overlap more on one side, both stretches are extended back into `prev`
+// by the larger overlap — those bases match REF on both, and get trimmed off
+// again below. At least one base of `prev` must remain as the VCF anchor.
+// ============================================================================
+auto WalkBubbleExtractor::AddDivergence(SharedNode const& prev, SharedNode const& next,
+                                        usize const hap_idx) -> bool {
+  auto const alt_seq = mPaths[hap_idx].Sequence();
+  auto const prev_alt_end = static_cast<i64>(prev.mAltStart + prev.mLength);
+  auto const prev_ref_end = static_cast<i64>(prev.mRefStart + prev.mLength);
+  auto const next_alt_start = static_cast<i64>(next.mAltStart);
+  auto const next_ref_start = static_cast<i64>(next.mRefStart);
+
+  auto const back_off =
+      std::max({i64{0}, prev_alt_end - next_alt_start, prev_ref_end - next_ref_start});
+  if (back_off >= static_cast<i64>(prev.mLength)) return false;
+
+  auto const ref_begin = static_cast<usize>(prev_ref_end - back_off);
+  auto const alt_begin = static_cast<usize>(prev_alt_end - back_off);
+  auto ref_core = mRefSeq.substr(ref_begin, next.mRefStart - ref_begin);
+  auto alt_core = alt_seq.substr(alt_begin, next.mAltStart - alt_begin);
+
+  // Suffix first, then prefix: an indel in a short repeat ends up left-most in the bubble.
+  usize suffix = 0;
+  while (suffix < std::min(ref_core.size(), alt_core.size()) &&
+         ref_core[ref_core.size() - 1 - suffix] == alt_core[alt_core.size() - 1 - suffix]) {
+    ++suffix;
+  }
+  ref_core.remove_suffix(suffix);
+  alt_core.remove_suffix(suffix);
+
+  usize prefix = 0;
+  while (prefix < std::min(ref_core.size(), alt_core.size()) &&
+         ref_core[prefix] == alt_core[prefix]) {
+    ++prefix;
+  }
+  ref_core.remove_prefix(prefix);
+  alt_core.remove_prefix(prefix);
+
+  if (ref_core.empty() && alt_core.empty()) return true;
+
+  auto const core_start = ref_begin + prefix;
+  for (auto const& edit : SplitAtMatches(ref_core, alt_core)) {
+    mDivergences.push_back({.mAltSeq = alt_core.substr(edit.mAltOff, edit.mAltLen),
+                            .mRefStart = core_start + edit.mRefOff,
+                            .mRefEnd = core_start + edit.mRefOff + edit.mRefLen,
+                            .mHapIdx = hap_idx});
+  }
+  return true;
+}
+
+// ============================================================================
+// EmitBubble — splice each haplotype's cores into REF[anchor, ref_end).
+//
+// Coordinates mirror VariantExtractor: the bubble starts one base early at the
+// VCF anchor, and each haplotype's local start is the anchor shifted by the net
+// length change of that haplotype's earlier bubbles.
+// ============================================================================
+void WalkBubbleExtractor::EmitBubble(absl::Span<Divergence const> cores, usize const ref_start,
+                                     usize const ref_end,
+                                     absl::btree_set<RawVariant>& out_variants) {
+  auto const anchor_pos = ref_start - static_cast<usize>(ref_start > 0);
+
+  VariantBubble bubble;
+  bubble.mGenomeStartPos = mRefAnchorStart + anchor_pos;
+  bubble.mRefAllele = std::string(mRefSeq.substr(anchor_pos, ref_end - anchor_pos));
+  bubble.mHapStarts.resize(mPaths.size());
+  for (usize hap_idx = 0; hap_idx < mPaths.size(); ++hap_idx) {
+    bubble.mHapStarts[hap_idx] =
+        static_cast<usize>(static_cast<i64>(anchor_pos) + mHapLengthDelta[hap_idx]);
+  }
+
+  // hap → (allele built so far, REF position the allele has reached)
+  absl::flat_hash_map<usize, std::pair<std::string, usize>> hap_alleles;
+  for (auto const& core : cores) {
+    auto& [allele, ref_cursor] =
+        hap_alleles.try_emplace(core.mHapIdx, std::string(), anchor_pos).first->second;
+    allele.append(mRefSeq.substr(ref_cursor, core.mRefStart - ref_cursor));
+    allele.append(core.mAltSeq);
+    ref_cursor = core.mRefEnd;
+
+    auto const ref_len = static_cast<i64>(core.mRefEnd - core.mRefStart);
+    mHapLengthDelta[core.mHapIdx] += static_cast<i64>(core.mAltSeq.size()) - ref_len;
+  }
+
+  for (auto& [hap_idx, allele_state] : hap_alleles) {
+    auto& [allele, ref_cursor] = allele_state;
+    allele.append(mRefSeq.substr(ref_cursor, ref_end - ref_cursor));
+    if (allele != bubble.mRefAllele) bubble.mAltAllelesToHaps[allele].push_back(hap_idx);
+  }
+
+  bubble.NormalizeVcfParsimony();
+  if (!bubble.mAltAllelesToHaps.empty()) {
+    out_variants.insert(AssembleRawVariant(std::move(bubble), mWin));
+  }
+}
+
+}  // namespace lancet::caller
@@ -0,0 +1,112 @@
+#ifndef SRC_LANCET_CALLER_WALK_BUBBLE_EXTRACTOR_H_
+#define SRC_LANCET_CALLER_WALK_BUBBLE_EXTRACTOR_H_
+
+#include "lancet/base/types.h"
+#include "lancet/caller/raw_variant.h"
+#include "lancet/cbdg/path.h"
+#include "lancet/core/window.h"
+
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace lancet::caller {
+
+// =========================================================================================
+// WALK BUBBLE EXTRACTION — Variants Straight From the de Bruijn Traversal
+// =========================================================================================
+// Every ALT haplotype is a MaxFlow walk of compressed graph nodes. Nodes whose sequence
+// sits at a unique, in-order position of the REF haplotype are the shared anchors; runs
+// of nodes between two anchors are the divergent bubbles. The ALT string needs no
+// re-alignment: the walk already says which bases replaced which stretch of REF.
+//
+//   REF:   [ source ]=====[ ref unitig ]=====[ ref unitig ]=====[ sink ]
+//   ALT:   [ source ]--(alt unitig)--------->[ ref unitig ]=====[ sink ]
+//                    ^ divergent run: REF[e_r, s_r) was replaced by ALT[e_a, s_a)
+//
+// Adjacent walk nodes overlap by k − 1 bases, so each node's full sequence is
+// recovered from Path::NodeBaseCounts() and the k-mer length. The REF stretch and
+// ALT stretch between two anchors are trimmed to their differing core (suffix first,
+// then prefix, so an indel is pushed to the left end of its bubble — the same order
+// VariantBubble::NormalizeVcfParsimony trims in). A core with bases on both sides is
+// then aligned with the MSA scores and split at every matching column: two SNVs three
+// bases apart share one walk bubble, but the POA rejoins REF between them and emits
+// two records, so the walk path must too.
+//
+// Cores from all haplotypes are then swept in REF order and overlapping cores are
+// merged into one multiallelic bubble, exactly where the POA sweep in
+// VariantExtractor would fail to reconverge. Each merged bubble gets the preceding
+// REF base as VCF anchor and runs through the same VariantBubble normalization and
+// AssembleRawVariant as the POA path.
+//
+// Cost: O(total haplotype length) hash lookups and compares per component, instead
+// of the O(haplotype length × graph size) POA alignment per haplotype.
+//
+// ExtractTo() returns false — and emits nothing — when any ALT walk cannot be
+// anchored (its first/last node is not the REF source/sink, or a node overlap does
+// not leave an anchor base). Callers then fall back to the SPOA path.
+// =========================================================================================
+class WalkBubbleExtractor {
+ public:
+  WalkBubbleExtractor(absl::Span<cbdg::Path const> paths, usize kmer_len, core::Window const& win,
+                      usize ref_anchor_start);
+
+  [[nodiscard]] auto ExtractTo(absl::btree_set<RawVariant>& out_variants) -> bool;
+
+ private:
+  // One haplotype's divergent core: REF[mRefStart, mRefEnd) became mAltSeq.
+  struct Divergence {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    std::string_view mAltSeq;
+    usize mRefStart = 0;
+    usize mRefEnd = 0;
+    usize mHapIdx = 0;
+  };
+
+  // A walk node placed on both haplotypes: [mAltStart, mAltStart + mLength) in the ALT
+  // string equals [mRefStart, mRefStart + mLength) in REF.
+  struct SharedNode {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    usize mRefStart = 0;
+    usize mAltStart = 0;
+    usize mLength = 0;
+  };
+
+  static constexpr u32 NON_UNIQUE_KMER = static_cast<u32>(-1);
+
+  // NOLINTBEGIN(cppcoreguidelines-avoid-const-or-ref-data-members)
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  absl::flat_hash_map<std::string_view, u32> mRefKmerPos;  // k-mer → unique REF offset
+  std::vector<Divergence> mDivergences;
+  std::vector<i64> mHapLengthDelta;  // ALT − REF length of each hap's cores swept so far
+  absl::Span<cbdg::Path const> mPaths;
+  core::Window const& mWin;
+  std::string_view mRefSeq;
+  usize mKmerLen;
+  usize mRefAnchorStart;
+  // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+  void BuildRefKmerIndex();
+
+  // Place every anchor node of haplotype `hap_idx` and record the cores between them.
+  [[nodiscard]] auto CollectDivergences(usize hap_idx) -> bool;
+
+  [[nodiscard]] auto LocateOnRef(std::string_view node_seq, usize alt_start) const
+      -> std::optional<SharedNode>;
+
+  // Record the core between two consecutive anchors; false if no anchor base remains.
+  [[nodiscard]] auto AddDivergence(SharedNode const& prev, SharedNode const& next, usize hap_idx)
+      -> bool;
+
+  // Merge `cores` (overlapping, REF-sorted) spanning REF [ref_start, ref_end) into one record.
+  void EmitBubble(absl::Span<Divergence const> cores, usize ref_start, usize ref_end,
+                  absl::btree_set<RawVariant>& out_variants);
+};
+
+}  // namespace lancet::caller
+
+#endif  // SRC_LANCET_CALLER_WALK_BUBBLE_EXTRACTOR_H_
@@ -14,8 +14,9 @@
 namespace lancet::cbdg {
 
 ComponentResult::ComponentResult(std::vector<EnumeratedHaplotype> haplotypes,
-                                 GraphComplexity metrics, u32 const anchor_start_offset)
-    : mMetrics(metrics), mAnchorStartOffset(anchor_start_offset) {
+                                 GraphComplexity metrics, u32 const anchor_start_offset,
+                                 u32 const kmer_len)
+    : mMetrics(metrics), mAnchorStartOffset(anchor_start_offset), mKmerLen(kmer_len) {
   mPaths.reserve(haplotypes.size());
   mWalks.reserve(haplotypes.size());
   for (auto& hap : haplotypes) {
@@ -32,7 +32,7 @@ namespace lancet::cbdg {
 class ComponentResult {
  public:
   ComponentResult(std::vector<EnumeratedHaplotype> haplotypes, GraphComplexity metrics,
-                  u32 anchor_start_offset);
+                  u32 anchor_start_offset, u32 kmer_len);
 
   /// Non-owning views into each path's sequence string. Zero data copy.
   /// Use for SPOA alignment and sequence complexity scoring (both accept string_view).
@@ -46,6 +46,10 @@ class ComponentResult {
   /// sequence base, expanded lazily from Path's run-length-encoded node weights.
   [[nodiscard]] auto HaplotypeWeights() const -> Path::HapWeights;
 
+  /// Assembled paths, REF first. Walk-based variant extraction reads each path's
+  /// per-node layout (Path::NodeBaseCounts) alongside its sequence.
+  [[nodiscard]] auto Paths() const -> absl::Span<Path const> { return absl::MakeConstSpan(mPaths); }
+
   /// Max path depth CV across ALT haplotypes (index 1..N). Returns nullopt
   /// when only the reference path exists (no ALT haplotypes).
   [[nodiscard]] auto MaxAltPathCv() const -> std::optional<f64>;
@@ -60,6 +64,10 @@ class ComponentResult {
   /// anchor node begins. Add to Window::StartPos1() to get genome position.
   [[nodiscard]] auto AnchorStartOffset() const -> u32 { return mAnchorStartOffset; }
 
+  /// k-mer length of the graph the paths were enumerated from; adjacent walk
+  /// nodes overlap by KmerLength() − 1 bases.
+  [[nodiscard]] auto KmerLength() const -> u32 { return mKmerLen; }
+
   /// Graph topology metrics (cyclomatic complexity, branch points, etc.).
   [[nodiscard]] auto Metrics() const -> GraphComplexity const& { return mMetrics; }
 
@@ -78,6 +86,7 @@ class ComponentResult {
 
   // ── 4B Align ────────────────────────────────────────────────────────────
   u32 mAnchorStartOffset = 0;
+  u32 mKmerLen = 0;
 };
 
 }  // namespace lancet::cbdg
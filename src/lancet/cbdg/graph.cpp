@@ -16,7 +16,6 @@
 #include "lancet/cbdg/max_flow.h"
 #include "lancet/cbdg/node.h"
 #include "lancet/cbdg/traversal_index.h"
-#include "lancet/hts/phred_quality.h"
 
 #include "absl/container/chunked_queue.h"
 #include "absl/container/flat_hash_map.h"
@@ -75,8 +74,11 @@ namespace lancet::cbdg {
 ///
 /// https://github.com/GATB/bcalm/blob/v2.2.3/bidirected-graphs-in-bcalm2/bidirected-graphs-in-bcalm2.md
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-auto Graph::BuildComponentResults(RegionPtr region, ReadList reads) -> ComponentResults {
+auto Graph::BuildComponentResults(RegionPtr region, ReadList reads, ReadBatch const& batch)
+    -> ComponentResults {
+  LANCET_ASSERT(batch.Size() == reads.size())
   mReads = reads;
+  mReadBatch = &batch;
   mRegion = std::move(region);
 
   lancet::base::Timer timer;
@@ -223,7 +225,8 @@ auto Graph::BuildComponentResults(RegionPtr region, ReadList reads) -> Component
       BufferFinalSnapshot(component_index, absl::MakeConstSpan(haps));
 
       if (haps.empty()) continue;
-      results.emplace_back(std::move(haps), gcplx, static_cast<u32>(source.mRefOffset));
+      results.emplace_back(std::move(haps), gcplx, static_cast<u32>(source.mRefOffset),
+                           static_cast<u32>(mCurrK));
     }
 
     // If any component triggered a retry, discard partial results and try next k
@@ -267,29 +270,23 @@ void Graph::BuildGraph(absl::flat_hash_set<MateMer>& mate_mers) {
                          [](Node const* node) -> NodeID { return node->Identifier(); });
 
   mate_mers.clear();
-  std::vector<f64> per_base_error_probs;
-  static constexpr usize EXPECTED_READ_LENGTH = 150;
-  per_base_error_probs.reserve(mReads.empty() ? EXPECTED_READ_LENGTH : mReads[0].Length());
-
-  for (auto const& read : mReads) {
+  for (usize read_idx = 0; read_idx < mReads.size(); ++read_idx) {
+    auto const& read = mReads[read_idx];
     if (!read.PassesAlnFilters()) continue;
 
-    // Amortize Phred → error-prob look up to once per read instead of k times per kmer.
-    // Prefix sum enables O(1) expected-error range queries:
-    // expected_errors(i, i+k) = prefix[i+k] − prefix[i].
-    per_base_error_probs.clear();
-    std::ranges::transform(read.QualView(), std::back_inserter(per_base_error_probs),
-                           [](u8 const qual) -> f64 { return hts::PhredToErrorProb(qual); });
-    std::vector<f64> prefix_sum(per_base_error_probs.size() + 1, 0.0);
-    std::partial_sum(per_base_error_probs.cbegin(), per_base_error_probs.cend(),
-                     prefix_sum.begin() + 1);
+    // Phred → error-prob prefix sums are precomputed once per window in ReadBatch,
+    // so every k-attempt reuses them: expected_errors(i, i+k) = prefix[i+k] − prefix[i].
+    auto const prefix_sum = mReadBatch->ErrorPrefixSums(read_idx);
+    auto const qname_hash = mReadBatch->QnameHash(read_idx);
 
     usize offset = 0;
     auto const added_nodes = AddNodes(read.SeqView(), read.SrcLabel());
 
     for (auto* node : added_nodes) {
-      MateMer mm_info{
-          .mQname = read.QnameView(), .mKmerHash = node->Identifier(), .mTagKind = read.TagKind()};
+      MateMer mm_info{.mQname = read.QnameView(),
+                      .mQnameHash = qname_hash,
+                      .mKmerHash = node->Identifier(),
+                      .mTagKind = read.TagKind()};
 
       // Filter out low-quality kmers by expected error count (floor of summed Phred error
       // probabilities). Kmers with ≥1 expected error get no read support,
@@ -15,6 +15,7 @@
 #include "lancet/cbdg/path.h"
 #include "lancet/cbdg/probe_tracker.h"
 #include "lancet/cbdg/read.h"
+#include "lancet/cbdg/read_batch.h"
 #include "lancet/cbdg/traversal_index.h"
 #include "lancet/hts/reference.h"
 
@@ -50,7 +51,9 @@ class Graph {
 
   /// Main entry point: build, prune, and enumerate haplotypes from reads + reference.
   /// Iterates kmer lengths from min to max, returning per-component results on success.
-  [[nodiscard]] auto BuildComponentResults(RegionPtr region, ReadList reads) -> ComponentResults;
+  /// `batch` must be built from exactly `reads` — BuildGraph reads its prefix sums by index.
+  [[nodiscard]] auto BuildComponentResults(RegionPtr region, ReadList reads,
+                                           ReadBatch const& batch) -> ComponentResults;
 
   /// Set the external ProbeTracker for truth variant k-mer tracing. Null
   /// disables tracing (zero overhead in production).
@@ -68,6 +71,7 @@ class Graph {
   usize mCurrK = 0;
   RegionPtr mRegion;
   ReadList mReads;
+  ReadBatch const* mReadBatch = nullptr;
   NodeTable mNodes;
   GraphParams mParams;
 
@@ -99,20 +103,25 @@ class Graph {
 
   // De-duplicate read support: a kmer should receive at most one increment per
   // (read_name, sample_tag, kmer_hash) triple. MateMer keys this dedup set.
+  // The set hashes the read's precomputed ReadBatch qname hash, so probing it
+  // never re-hashes the qname string; equality still compares the full names,
+  // so two reads whose qname hashes collide are never merged.
   struct MateMer {
     // ── 8B Align ────────────────────────────────────────────────────────────
     std::string_view mQname;  // 16B
+    u64 mQnameHash;           // 8B
     u64 mKmerHash;            // 8B
     // ── 1B Align ────────────────────────────────────────────────────────────
     Label::Tag mTagKind;  // 1B
 
     auto operator==(MateMer const& rhs) const -> bool {
-      return mQname == rhs.mQname && mTagKind == rhs.mTagKind && mKmerHash == rhs.mKmerHash;
+      return mQnameHash == rhs.mQnameHash && mTagKind == rhs.mTagKind &&
+             mKmerHash == rhs.mKmerHash && mQname == rhs.mQname;
     }
 
     template <typename H>
     friend auto AbslHashValue(H state, MateMer const& mmer) -> H {
-      return H::combine(std::move(state), mmer.mQname, mmer.mTagKind, mmer.mKmerHash);
+      return H::combine(std::move(state), mmer.mQnameHash, mmer.mTagKind, mmer.mKmerHash);
     }
   };
 
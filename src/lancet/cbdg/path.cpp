@@ -9,7 +9,9 @@
 
 #include <algorithm>
 #include <functional>
+#include <iterator>
 #include <string_view>
+#include <vector>
 
 namespace lancet::cbdg {
 
@@ -40,6 +42,14 @@ auto Path::PerBaseWeights() const -> BaseWeights {
   return per_base;
 }
 
+auto Path::NodeBaseCounts() const -> std::vector<u32> {
+  std::vector<u32> counts;
+  counts.reserve(mNodeWeights.size());
+  std::ranges::transform(mNodeWeights, std::back_inserter(counts),
+                         [](NodeWeightEntry const& entry) -> u32 { return entry.mNumBases; });
+  return counts;
+}
+
 auto Path::MinWeight() const -> u32 {
   if (mNodeWeights.empty()) return 0;
   return std::ranges::min(mNodeWeights, {}, &NodeWeightEntry::mWeight).mWeight;
@@ -44,6 +44,11 @@ class Path {
   /// Returns a vector of size == Sequence().size().
   [[nodiscard]] auto PerBaseWeights() const -> BaseWeights;
 
+  /// Bases each walk node contributed to Sequence(), in walk order. The first node
+  /// contributes its whole sequence; every later node only the bases past its
+  /// (k − 1)-base overlap with the previous node.
+  [[nodiscard]] auto NodeBaseCounts() const -> std::vector<u32>;
+
   /// Weakest-link: minimum node confidence across the entire path.
   /// A path is only as trustworthy as its least-supported node.
   [[nodiscard]] auto MinWeight() const -> u32;
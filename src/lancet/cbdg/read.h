@@ -3,34 +3,61 @@
 
 #include "lancet/base/types.h"
 #include "lancet/cbdg/label.h"
+#include "lancet/cbdg/read_arena.h"
 #include "lancet/hts/alignment.h"
+#include "lancet/hts/cigar_unit.h"
 #include "lancet/hts/sam_flag.h"
 
 #include "absl/types/span.h"
 
+#include <algorithm>
+#include <functional>
 #include <numeric>
-#include <string>
 #include <string_view>
 #include <utility>
-#include <vector>
 
 namespace lancet::cbdg {
 
+// ============================================================================
+// Read — one kept alignment, decoded once and viewed for the rest of the window.
+//
+// Qname, ASCII sequence and Phred qualities are copied into one contiguous
+// slice of a ReadArena (qname and sequence NUL-terminated, for minimap2), and
+// the read keeps only views of it. The read is therefore only valid while the
+// arena it was built into is alive — ReadCollector::Result owns both. The
+// sample is identified by its SampleInfo index rather than a copied name.
+// ============================================================================
 class Read {
  public:
-  explicit Read(hts::Alignment const& aln, std::string sample_name, Label::Tag const tag,
+  explicit Read(hts::Alignment const& aln, ReadArena& arena, Label::Tag const tag,
                 usize const sample_index)
       : mStart0(aln.StartPos0()),
         mInsertSize(aln.InsertSize()),
         mSampleIndex(sample_index),
-        mQname(aln.QnameView()),
-        mSequence(aln.BuildSequence()),
-        mSampleName(std::move(sample_name)),
-        mQuality(aln.BuildQualities()),
         mChromIdx(aln.ChromIndex()),
         mSamFlag(aln.FlagRaw()),
         mMapQual(aln.MapQual()),
         mTag(tag) {
+    auto const qname = aln.QnameView();
+    auto const seq_len = aln.Length();
+    auto* const qname_ptr = arena.Allocate(qname.size() + 1 + seq_len + 1 + seq_len);
+    // Slices of the one arena allocation: [qname \0][sequence \0][qualities]
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto* const seq_ptr = qname_ptr + qname.size() + 1;
+    auto* const qual_ptr = seq_ptr + seq_len + 1;
+    std::ranges::copy(qname, qname_ptr);
+    qname_ptr[qname.size()] = '\0';
+    aln.DecodeSequenceTo(absl::MakeSpan(seq_ptr, seq_len));
+    seq_ptr[seq_len] = '\0';
+    std::ranges::copy(aln.QualView(), qual_ptr);
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    mQname = std::string_view(qname_ptr, qname.size());
+    mSequence = std::string_view(seq_ptr, seq_len);
+    // Byte storage may be viewed as u8: unsigned char aliases any object representation.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    mQuality = absl::MakeConstSpan(reinterpret_cast<u8 const*>(qual_ptr), seq_len);
+
     static constexpr u8 DEFAULT_MIN_READ_MAP_QUAL = 20;
     if (aln.MapQual() < DEFAULT_MIN_READ_MAP_QUAL) {
       mPassesAlnFilters = false;
@@ -39,14 +66,15 @@ class Read {
     // Flag read as soft-clipped if total soft-clip bases >= 6% of read length.
     // Uses the original whole-genome alignment CIGAR, not re-alignment CIGAR.
     static constexpr f64 SOFT_CLIP_FRAC_THRESHOLD = 0.06;
-    static constexpr auto CLIP_LENGTH = [](auto const& unit) -> u32 {
+    static constexpr auto CLIP_LENGTH = [](u32 const raw_unit) -> u32 {
+      hts::CigarUnit const unit(raw_unit);
       return unit.Operation() == hts::CigarOp::SOFT_CLIP ? unit.Length() : 0;
     };
-    auto const cigar = aln.CigarData();
+    auto const cigar = aln.CigarView();
     auto const total_clip =
         std::transform_reduce(cigar.cbegin(), cigar.cend(), u32{0}, std::plus<>{}, CLIP_LENGTH);
     auto const clip_frac =
-        aln.Length() > 0 ? static_cast<f64>(total_clip) / static_cast<f64>(aln.Length()) : 0.0;
+        seq_len > 0 ? static_cast<f64>(total_clip) / static_cast<f64>(seq_len) : 0.0;
     mIsSoftClipped = clip_frac >= SOFT_CLIP_FRAC_THRESHOLD;
   }
 
@@ -59,13 +87,12 @@ class Read {
 
   [[nodiscard]] auto SrcLabel() const noexcept -> Label { return Label(mTag); }
   [[nodiscard]] auto TagKind() const noexcept -> Label::Tag { return mTag; }
-  [[nodiscard]] auto QnamePtr() const noexcept -> char const* { return mQname.c_str(); }
-  [[nodiscard]] auto SeqPtr() const noexcept -> char const* { return mSequence.c_str(); }
+  [[nodiscard]] auto QnamePtr() const noexcept -> char const* { return mQname.data(); }
+  [[nodiscard]] auto SeqPtr() const noexcept -> char const* { return mSequence.data(); }
   [[nodiscard]] auto QnameView() const noexcept -> std::string_view { return mQname; }
   [[nodiscard]] auto SeqView() const noexcept -> std::string_view { return mSequence; }
   [[nodiscard]] auto QualView() const noexcept -> absl::Span<u8 const> { return mQuality; }
   [[nodiscard]] auto Length() const noexcept -> usize { return mSequence.size(); }
-  [[nodiscard]] auto SampleName() const noexcept -> std::string_view { return mSampleName; }
   [[nodiscard]] auto SampleIndex() const noexcept -> usize { return mSampleIndex; }
   [[nodiscard]] auto IsSoftClipped() const noexcept -> bool { return mIsSoftClipped; }
   [[nodiscard]] auto InsertSize() const noexcept -> i64 { return mInsertSize; }
@@ -73,15 +100,14 @@ class Read {
 
   template <typename HashState>
   friend auto AbslHashValue(HashState hash_state, Read const& read) -> HashState {
-    return HashState::combine(std::move(hash_state), read.mSampleName, read.mStart0,
-                              read.mSampleIndex, read.mChromIdx, read.mSamFlag, read.mMapQual,
+    return HashState::combine(std::move(hash_state), read.mStart0, read.mSampleIndex,
+                              read.mChromIdx, read.mSamFlag, read.mMapQual,
                               static_cast<u8>(read.mTag), read.mQname, read.mSequence,
                               read.mQuality);
   }
 
   friend auto operator==(Read const& lhs, Read const& rhs) noexcept -> bool {
-    return lhs.mSampleName == rhs.mSampleName &&
-           lhs.mStart0 == rhs.mStart0 &&
+    return lhs.mStart0 == rhs.mStart0 &&
            lhs.mSampleIndex == rhs.mSampleIndex &&
            lhs.mChromIdx == rhs.mChromIdx &&
            lhs.mSamFlag == rhs.mSamFlag &&
@@ -99,13 +125,12 @@ class Read {
 
  private:
   // ── 8B Align ────────────────────────────────────────────────────────────
-  i64 mStart0 = -1;          // 8B
-  i64 mInsertSize = 0;       // 8B
-  usize mSampleIndex = 0;    // 8B
-  std::string mQname;        // 32B (8B align)
-  std::string mSequence;     // 32B (8B align)
-  std::string mSampleName;   // 32B (8B align)
-  std::vector<u8> mQuality;  // 24B (8B align)
+  i64 mStart0 = -1;               // 8B
+  i64 mInsertSize = 0;            // 8B
+  usize mSampleIndex = 0;         // 8B — SampleInfo::SampleIndex()
+  std::string_view mQname;        // 16B (8B align) — NUL-terminated, in the arena
+  std::string_view mSequence;     // 16B (8B align) — NUL-terminated, in the arena
+  absl::Span<u8 const> mQuality;  // 16B (8B align) — in the arena
   // ── 4B Align ────────────────────────────────────────────────────────────
   i32 mChromIdx = -1;  // 4B
   // ── 2B Align ────────────────────────────────────────────────────────────
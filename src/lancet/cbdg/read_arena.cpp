@@ -0,0 +1,109 @@
+#include "lancet/cbdg/read_arena.h"
+
+#include "lancet/base/types.h"
+
+#include "absl/synchronization/mutex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace lancet::cbdg {
+
+// ============================================================================
+// BlockPool
+// ============================================================================
+auto ReadArena::BlockPool::Acquire() -> Block {
+  {
+    absl::MutexLock const lock(mMutex);
+    if (!mFreeBlocks.empty()) {
+      auto block = std::move(mFreeBlocks.back());
+      mFreeBlocks.pop_back();
+      return block;
+    }
+  }
+  return Block(BLOCK_SIZE);
+}
+
+void ReadArena::BlockPool::Release(std::vector<Block>& blocks) {
+  absl::MutexLock const lock(mMutex);
+  auto const room = MAX_FREE_BLOCKS - std::min(mFreeBlocks.size(), MAX_FREE_BLOCKS);
+  auto const num_kept = std::min(blocks.size(), room);
+  std::move(blocks.begin(), blocks.begin() + static_cast<i64>(num_kept),
+            std::back_inserter(mFreeBlocks));
+  blocks.clear();
+}
+
+// ============================================================================
+// ReadArena
+// ============================================================================
+ReadArena::~ReadArena() { ReleaseBlocks(); }
+
+ReadArena::ReadArena(ReadArena&& other) noexcept
+    : mBlocks(std::move(other.mBlocks)),
+      mOversized(std::move(other.mOversized)),
+      mPool(other.mPool),
+      mCursor(std::exchange(other.mCursor, nullptr)),
+      mRemaining(std::exchange(other.mRemaining, 0)) {
+  other.mBlocks.clear();
+  other.mOversized.clear();
+}
+
+auto ReadArena::operator=(ReadArena&& other) noexcept -> ReadArena& {
+  if (this == &other) return *this;
+  ReleaseBlocks();
+  mBlocks = std::move(other.mBlocks);
+  mOversized = std::move(other.mOversized);
+  mPool = other.mPool;
+  mCursor = std::exchange(other.mCursor, nullptr);
+  mRemaining = std::exchange(other.mRemaining, 0);
+  other.mBlocks.clear();
+  other.mOversized.clear();
+  return *this;
+}
+
+auto ReadArena::Allocate(usize const num_bytes) -> char* {
+  if (num_bytes > BLOCK_SIZE) {
+    mOversized.emplace_back(num_bytes);
+    return mOversized.back().data();
+  }
+
+  if (num_bytes > mRemaining) {
+    mBlocks.push_back(mPool != nullptr ? mPool->Acquire() : Block(BLOCK_SIZE));
+    mCursor = mBlocks.back().data();
+    mRemaining = BLOCK_SIZE;
+  }
+
+  auto* const result = mCursor;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) — bump within current block
+  mCursor += num_bytes;
+  mRemaining -= num_bytes;
+  return result;
+}
+
+// ============================================================================
+// Absorb — the absorbed blocks keep their addresses, so reads that view them
+// stay valid. The absorbed tail block is not bump-allocated from again: this
+// arena keeps filling its own current block, at the cost of at most one
+// partially used block per absorbed arena.
+// ============================================================================
+void ReadArena::Absorb(ReadArena&& other) {
+  std::ranges::move(other.mBlocks, std::back_inserter(mBlocks));
+  std::ranges::move(other.mOversized, std::back_inserter(mOversized));
+  other.mBlocks.clear();
+  other.mOversized.clear();
+  other.mCursor = nullptr;
+  other.mRemaining = 0;
+}
+
+void ReadArena::ReleaseBlocks() {
+  if (mPool != nullptr) mPool->Release(mBlocks);
+  mBlocks.clear();
+  mOversized.clear();
+  mCursor = nullptr;
+  mRemaining = 0;
+}
+
+}  // namespace lancet::cbdg
@@ -0,0 +1,80 @@
+#ifndef SRC_LANCET_CBDG_READ_ARENA_H_
+#define SRC_LANCET_CBDG_READ_ARENA_H_
+
+#include "lancet/base/types.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace lancet::cbdg {
+
+// ============================================================================
+// ReadArena — bump allocator that owns the bytes every cbdg::Read views.
+//
+// A kept read used to own three heap buffers (qname, sequence, qualities) and
+// a copy of its sample name. ReadArena packs each read's bytes into one slice
+// of a large block instead:
+//
+//   block: [ qname\0 | ACGT...\0 | qqqq... ][ qname\0 | ... ] ...   (256 KiB)
+//
+// Blocks are never reallocated or moved, so a read's views stay valid while
+// the arena — or the arena it is Absorb()-ed into — is alive. When an arena is
+// destroyed its blocks go back to the BlockPool it was created with, so the
+// next window refills the same memory instead of going through the allocator.
+// Reads longer than a block get a dedicated allocation that is not pooled.
+// ============================================================================
+class ReadArena {
+ public:
+  static constexpr usize BLOCK_SIZE = usize{256} * 1024;
+
+  /// Moving a std::vector keeps its data pointer, so views survive Absorb().
+  using Block = std::vector<char>;
+
+  /// Thread-safe free list of BLOCK_SIZE blocks shared by a collector's arenas.
+  class BlockPool {
+   public:
+    /// Free blocks kept for reuse; blocks released beyond this are freed.
+    static constexpr usize MAX_FREE_BLOCKS = 64;
+
+    [[nodiscard]] auto Acquire() -> Block;
+    void Release(std::vector<Block>& blocks);
+
+   private:
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    absl::Mutex mMutex;
+    std::vector<Block> mFreeBlocks ABSL_GUARDED_BY(mMutex);
+  };
+
+  ReadArena() = default;
+  explicit ReadArena(std::shared_ptr<BlockPool> pool) : mPool(std::move(pool)) {}
+  ~ReadArena();
+
+  ReadArena(ReadArena const&) = delete;
+  auto operator=(ReadArena const&) -> ReadArena& = delete;
+  ReadArena(ReadArena&& other) noexcept;
+  auto operator=(ReadArena&& other) noexcept -> ReadArena&;
+
+  /// Returns `num_bytes` of writable storage that lives as long as the arena.
+  [[nodiscard]] auto Allocate(usize num_bytes) -> char*;
+
+  /// Takes ownership of every block of `other`, leaving it empty but still usable.
+  void Absorb(ReadArena&& other);
+
+ private:
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  std::vector<Block> mBlocks;        // BLOCK_SIZE each, returned to mPool
+  std::vector<Block> mOversized;     // single reads longer than a block
+  std::shared_ptr<BlockPool> mPool;  // null: blocks are simply freed
+  char* mCursor = nullptr;
+  usize mRemaining = 0;
+
+  void ReleaseBlocks();
+};
+
+}  // namespace lancet::cbdg
+
+#endif  // SRC_LANCET_CBDG_READ_ARENA_H_
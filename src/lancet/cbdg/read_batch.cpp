@@ -0,0 +1,60 @@
+#include "lancet/cbdg/read_batch.h"
+
+#include "lancet/base/dna_encode.h"
+#include "lancet/base/types.h"
+#include "lancet/cbdg/read.h"
+#include "lancet/hts/phred_quality.h"
+
+#include "absl/hash/hash.h"
+#include "absl/types/span.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace lancet::cbdg {
+
+// ============================================================================
+// Constructor: size every buffer exactly once, then fill in a single pass.
+//
+// Total base count is known up front from Read::Length(), so each vector is
+// allocated with its final size and no reallocation happens while encoding.
+// ============================================================================
+ReadBatch::ReadBatch(absl::Span<Read const> reads) {
+  auto const total_bases = std::transform_reduce(
+      reads.cbegin(), reads.cend(), usize{0}, std::plus<>{},
+      [](Read const& read) -> usize { return read.Length(); });
+
+  mBaseOffsets.resize(reads.size() + 1, 0);
+  mErrorPrefixSums.resize(total_bases + reads.size(), 0.0);
+  mQnameHashes.resize(reads.size(), 0);
+  mSeqHashes.resize(reads.size(), 0);
+  mEncodedBases.resize(total_bases, 0);
+
+  usize base_offset = 0;
+  for (usize read_idx = 0; read_idx < reads.size(); ++read_idx) {
+    auto const& read = reads[read_idx];
+    mBaseOffsets[read_idx] = base_offset;
+    mQnameHashes[read_idx] = absl::HashOf(read.QnameView());
+
+    auto const seq = read.SeqView();
+    mSeqHashes[read_idx] = absl::HashOf(seq);
+    std::ranges::transform(seq, mEncodedBases.begin() + static_cast<i64>(base_offset),
+                           [](char const base) -> u8 {
+                             return base::DNA_ENCODE_TABLE[static_cast<u8>(base)];
+                           });
+
+    // Slot [start] stays 0.0 — the leading zero of the length+1 prefix sum.
+    auto const prefix_start = static_cast<i64>(base_offset + read_idx);
+    auto const quals = read.QualView().subspan(0, seq.size());
+    std::transform_inclusive_scan(quals.cbegin(), quals.cend(),
+                                  mErrorPrefixSums.begin() + prefix_start + 1, std::plus<>{},
+                                  [](u8 const qual) -> f64 { return hts::PhredToErrorProb(qual); });
+
+    base_offset += read.Length();
+  }
+
+  mBaseOffsets[reads.size()] = base_offset;
+}
+
+}  // namespace lancet::cbdg
@@ -0,0 +1,89 @@
+#ifndef SRC_LANCET_CBDG_READ_BATCH_H_
+#define SRC_LANCET_CBDG_READ_BATCH_H_
+
+#include "lancet/base/assert.h"
+#include "lancet/base/types.h"
+#include "lancet/cbdg/read.h"
+
+#include "absl/types/span.h"
+
+#include <vector>
+
+namespace lancet::cbdg {
+
+// ============================================================================
+// ReadBatch — per-window, derived read encodings shared by every stage.
+//
+// cbdg::Read keeps the ASCII sequence and Phred qualities exactly as decoded
+// from BAM/CRAM. Graph construction, genotyping and local scoring each need a
+// different derived form of the same bytes, which used to be re-derived per
+// consumer (and per k-value for graph construction). ReadBatch computes each
+// derived form once, right after the read collector finalizes its read order,
+// and stores it in flat buffers addressed by the read's index in that order.
+//
+// clang-format off
+//   reads:            [ r0 (len 4) ][ r1 (len 3) ][ r2 (len 5) ]
+//   mBaseOffsets:     0             4             7             12
+//   mEncodedBases:    [ 0 1 2 3     | 3 3 1       | 2 0 4 1 1   ]   nt4: A=0 C=1 G=2 T=3 N=4
+//   mErrorPrefixSums: [ 0 p p p p   | 0 p p p     | 0 p p p p p ]   read i starts at offset+i
+//   mQnameHashes:     [ h0          | h1          | h2          ]   absl::HashOf(qname)
+//   mSeqHashes:       [ s0          | s1          | s2          ]   absl::HashOf(sequence)
+// clang-format on
+//
+// Consumers:
+//   Graph::BuildGraph          → ErrorPrefixSums (O(1) expected-error per kmer, every k)
+//                              → QnameHash       (mate-mer dedup key)
+//   Genotyper::AssignRead...   → EncodedBases    (local scoring, edit distance)
+//                              → QnameHash       (ReadEvidence name hash)
+//                              → SeqHash         (HapAlignmentCache key)
+//
+// The batch is immutable after construction and only valid for the exact
+// read span it was built from — indices are positions in that span.
+// ============================================================================
+class ReadBatch {
+ public:
+  ReadBatch() = default;
+  explicit ReadBatch(absl::Span<Read const> reads);
+
+  [[nodiscard]] auto Size() const noexcept -> usize { return mQnameHashes.size(); }
+  [[nodiscard]] auto IsEmpty() const noexcept -> bool { return mQnameHashes.empty(); }
+
+  /// nt4-encoded bases (A=0, C=1, G=2, T=3, other=4) for the read at `read_idx`.
+  [[nodiscard]] auto EncodedBases(usize const read_idx) const -> absl::Span<u8 const> {
+    LANCET_ASSERT(read_idx < Size())
+    auto const start = mBaseOffsets[read_idx];
+    return absl::MakeConstSpan(mEncodedBases).subspan(start, mBaseOffsets[read_idx + 1] - start);
+  }
+
+  /// Length+1 prefix sums of Phred error probabilities: sum(p[i..j)) = ps[j] − ps[i].
+  [[nodiscard]] auto ErrorPrefixSums(usize const read_idx) const -> absl::Span<f64 const> {
+    LANCET_ASSERT(read_idx < Size())
+    auto const start = mBaseOffsets[read_idx] + read_idx;
+    auto const length = mBaseOffsets[read_idx + 1] - mBaseOffsets[read_idx] + 1;
+    return absl::MakeConstSpan(mErrorPrefixSums).subspan(start, length);
+  }
+
+  /// absl::HashOf(qname) — identical to the hash used by ReadCollector downsampling.
+  [[nodiscard]] auto QnameHash(usize const read_idx) const -> u64 {
+    LANCET_ASSERT(read_idx < Size())
+    return mQnameHashes[read_idx];
+  }
+
+  /// absl::HashOf(sequence) — content identity of the read bases, independent of the window.
+  [[nodiscard]] auto SeqHash(usize const read_idx) const -> u64 {
+    LANCET_ASSERT(read_idx < Size())
+    return mSeqHashes[read_idx];
+  }
+
+ private:
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  std::vector<usize> mBaseOffsets;    // 24B — Size()+1 base offsets into mEncodedBases
+  std::vector<f64> mErrorPrefixSums;  // 24B — total_bases + Size() entries
+  std::vector<u64> mQnameHashes;      // 24B — one per read
+  std::vector<u64> mSeqHashes;        // 24B — one per read
+  std::vector<u8> mEncodedBases;      // 24B — total_bases entries
+};
+
+}  // namespace lancet::cbdg
+
+#endif  // SRC_LANCET_CBDG_READ_BATCH_H_
@@ -3,6 +3,7 @@
 #include "lancet/base/logging.h"
 #include "lancet/base/types.h"
 #include "lancet/base/version.h"
+#include "lancet/caller/genotyper.h"
 #include "lancet/cbdg/dot_plan.h"
 #include "lancet/cbdg/graph_params.h"
 #include "lancet/cli/cli_params.h"
@@ -213,8 +214,8 @@ void CliInterface::PipelineSubcmd(CLI::App* app, std::shared_ptr<CliParams>& par
   AddOpt(sub, "-r,--reference", rc_params.mRefPath, "Path to the reference FASTA file",
          GRP_REQUIRED, true)
       ->check(CliExistingUriOrFile{});
-  AddOpt(sub, "-o,--out-vcfgz", params->mOutVcfGz, "Output path to the compressed VCF file",
-         GRP_REQUIRED, true)
+  AddOpt(sub, "-o,--out-vcfgz", params->mOutVcfGz,
+         "Output path to the compressed VCF (.vcf.gz) or BCF (.bcf) file", GRP_REQUIRED, true)
       ->check(CliExistingUriOrFile{} | CliNonexistentUriOrPath{});
 
   // ============================================================================
@@ -244,6 +245,9 @@ void CliInterface::PipelineSubcmd(CLI::App* app, std::shared_ptr<CliParams>& par
   AddOpt(sub, "-T,--num-threads", params->mNumWorkerThreads,
          "Number of additional async worker threads", GRP_PARAMETERS)
       ->check(CLI::Range(0, MAX_THREADS));
+  AddOpt(sub, "--compress-threads", params->mNumCompressThreads,
+         "Number of threads compressing the output VCF (1 = inline)", GRP_PARAMETERS)
+      ->check(CLI::Range(1, MAX_THREADS));
   AddOpt(sub, "-k,--min-kmer", graph_params.mMinKmerLen, "Min. kmer length to try for graph nodes",
          GRP_PARAMETERS)
       ->check(CLI::Range(cbdg::DEFAULT_MIN_KMER_LEN, cbdg::MAX_ALLOWED_KMER_LEN - 2));
@@ -273,12 +277,28 @@ void CliInterface::PipelineSubcmd(CLI::App* app, std::shared_ptr<CliParams>& par
           GRP_FLAGS);
   AddFlag(sub, "--no-contig-check", rc_params.mNoCtgCheck, "Skip contig check with reference",
           GRP_FLAGS);
+  AddFlag(sub, "--skip-extreme-depth", rc_params.mSkipExtremeDepth,
+          "Skip windows whose index-estimated depth is far above max. sample coverage", GRP_FLAGS);
+  AddFlag(sub, "--read-prefetch", var_params.mReadPrefetch,
+          "Prefetch the next window's reads on one extra thread per worker", GRP_FLAGS);
+  AddFlag(sub, "--parallel-samples", rc_params.mParallelSamples,
+          "Decode each sample's reads on its own helper thread", GRP_FLAGS);
+  AddFlag(sub, "--linear-scan", rc_params.mLinearScan,
+          "Stream each sample's reads once in genome order instead of per window", GRP_FLAGS);
+  AddFlag(sub, "--io-cache-remote", params->mIoCacheRemote,
+          "Also cache remote inputs in --io-cache-dir; only for objects never overwritten",
+          GRP_FLAGS);
 
   // ============================================================================
   // Optional
   // ============================================================================
   static auto const SNAPSHOT_MAP = std::map<std::string, cbdg::GraphSnapshotMode>{
       {"final", cbdg::GraphSnapshotMode::FINAL}, {"verbose", cbdg::GraphSnapshotMode::VERBOSE}};
+  static auto const BACKEND_MAP = std::map<std::string, caller::GenotypingBackend>{
+      {"minimap2", caller::GenotypingBackend::MINIMAP2},
+      {"pair-hmm", caller::GenotypingBackend::PAIR_HMM}};
+  static auto const EXTRACTION_MAP = std::map<std::string, caller::VariantExtractionMode>{
+      {"msa", caller::VariantExtractionMode::MSA}, {"walk", caller::VariantExtractionMode::WALK}};
 
   AddOpt(sub, "--out-graphs-tgz", var_params.mOutGraphsTgz,
          "Output path for the tar.gz archive of per-window assembly graphs.", GRP_OPTIONAL)
@@ -286,10 +306,26 @@ void CliInterface::PipelineSubcmd(CLI::App* app, std::shared_ptr<CliParams>& par
   AddOpt(sub, "--graph-snapshots", graph_params.mSnapshotMode,
          "Control the verbosity of per-window assembly graph snapshots.", GRP_OPTIONAL)
       ->transform(CLI::CheckedTransformer(SNAPSHOT_MAP, CLI::ignore_case));
+  AddOpt(sub, "--genotyper-backend", var_params.mGenotypingBackend,
+         "Read-to-allele evidence: minimap2 score, or pair-HMM likelihoods that also drive PL.",
+         GRP_OPTIONAL)
+      ->transform(CLI::CheckedTransformer(BACKEND_MAP, CLI::ignore_case));
+  AddOpt(sub, "--variant-extraction", var_params.mVariantExtraction,
+         "ALT allele extraction: SPOA multiple alignment or de Bruijn walk bubbles.",
+         GRP_OPTIONAL)
+      ->transform(CLI::CheckedTransformer(EXTRACTION_MAP, CLI::ignore_case));
   AddOpt(sub, "--genome-gc-bias", var_params.mGcFraction,
          "Global genome GC fraction for LongdustQ score correction. Default 0.41", GRP_OPTIONAL)
       ->check(CLI::Range(0.0, 1.0));
 
+  AddOpt(sub, "--io-cache-dir", params->mIoCacheDir,
+         "Local directory caching BAM/CRAM/FASTA byte ranges read from network filesystem inputs",
+         GRP_OPTIONAL);
+  AddOpt(sub, "--io-cache-max-gb", params->mIoCacheMaxGb,
+         "Size cap for --io-cache-dir in GiB; least recently used chunks are evicted. Default 64",
+         GRP_OPTIONAL)
+      ->check(CLI::PositiveNumber);
+
   auto* probe_variants_opt =
       AddOpt(sub, "--probe-variants", var_params.mProbeVariantsPath,
              "Path to missed_variants.txt for k-mer probe diagnostics", GRP_OPTIONAL)
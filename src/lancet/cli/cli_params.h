@@ -19,9 +19,12 @@ class CliParams {
   std::string mFullCmdLine;
   std::filesystem::path mOutVcfGz;
   std::filesystem::path mBedFile;
+  std::filesystem::path mIoCacheDir;
   std::vector<std::string> mInRegions;
   core::VariantBuilder::Params mVariantBuilder;
   usize mNumWorkerThreads = 2;
+  usize mNumCompressThreads = 2;
+  usize mIoCacheMaxGb = 64;
 
   // ── 4B Align ────────────────────────────────────────────────────────────
   core::WindowBuilder::Params mWindowBuilder;
@@ -29,6 +32,7 @@ class CliParams {
   // ── 1B Align ────────────────────────────────────────────────────────────
   bool mEnableVerboseLogging = false;
   bool mIsCaseCtrlMode = false;
+  bool mIoCacheRemote = false;
 };
 
 }  // namespace lancet::cli
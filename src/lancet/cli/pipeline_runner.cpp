@@ -17,12 +17,16 @@
 #include "lancet/core/active_region_detector.h"
 #include "lancet/core/input_spec_parser.h"
 #include "lancet/core/pipeline_executor.h"
+#include "lancet/core/read_collector.h"
 #include "lancet/core/sample_header_reader.h"
 #include "lancet/core/sample_info.h"
 #include "lancet/core/tar_gz_shard_merger.h"
 #include "lancet/core/variant_builder.h"
+#include "lancet/core/vcf_writer.h"
 #include "lancet/core/window_builder.h"
+#include "lancet/hts/bcf_writer.h"
 #include "lancet/hts/bgzf_ostream.h"
+#include "lancet/hts/block_cache.h"
 #include "lancet/hts/reference.h"
 #include "lancet/hts/uri_utils.h"
 
@@ -66,14 +70,19 @@ PipelineRunner::PipelineRunner(std::shared_ptr<CliParams> params) : mParamsPtr(s
 // ============================================================================
 void PipelineRunner::Run() {
   base::Timer timer;
+  // Route inputs through the block cache before validation opens the first of them
+  if (!mParamsPtr->mIoCacheDir.empty()) {
+    static constexpr u64 GIB = u64{1} << 30;
+    hts::BlockCache::Enable(mParamsPtr->mIoCacheDir, mParamsPtr->mIoCacheMaxGb * GIB,
+                            mParamsPtr->mIoCacheRemote);
+  }
   ValidateAndPopulateParams();
   SetupPerWorkerGraphShards();
   SetupProbeTracking();
 
   hts::BgzfOstream output_vcf;
-  OpenOutputVcf(output_vcf);
-  output_vcf << BuildVcfHeader(*mParamsPtr);
-  output_vcf.flush();
+  hts::BcfWriter output_bcf;
+  auto writer = OpenOutputVcf(output_vcf, output_bcf);
 
   // Initialize the window builder with sorted regions
   core::WindowBuilder window_builder(mParamsPtr->mVariantBuilder.mRdCollParams.mRefPath,
@@ -95,12 +104,14 @@ void PipelineRunner::Run() {
       std::make_shared<core::VariantBuilder::Params const>(mParamsPtr->mVariantBuilder),
       mParamsPtr->mNumWorkerThreads, mParamsPtr->mWindowBuilder.mWindowLength);
 
-  auto const stats = executor.Execute(output_vcf);
+  auto const stats = executor.Execute(*writer);
   if (mParamsPtr->mVariantBuilder.mProbeResultsWriter) {
     mParamsPtr->mVariantBuilder.mProbeResultsWriter->EmitUnprocessedProbes();
   }
 
+  writer.reset();
   output_vcf.Close();
+  output_bcf.Close();
   MergePerWorkerGraphShards();
   core::PipelineExecutor::LogWindowStats(stats);
 
@@ -224,14 +235,17 @@ void PipelineRunner::SetupProbeTracking() {
 }
 
 // ============================================================================
-// OpenOutputVcf — resolve path, validate cloud credentials, open BGZF stream
+// OpenOutputVcf — resolve path, validate cloud credentials, open the output
 //
+// A path ending in `.bcf` selects binary BCF output (CSI index); anything else
+// is BGZF-compressed text VCF (tabix index). Both share the same header text.
 // Local paths are made absolute and parent directories are created.
 // Cloud URIs (gs://, s3://) trigger an immediate zero-byte HTTP PUT via
 // hopen("w") to validate credentials upfront rather than discovering auth
 // failures after a 40-hour pipeline run.
 // ============================================================================
-void PipelineRunner::OpenOutputVcf(hts::BgzfOstream& output_vcf) {
+auto PipelineRunner::OpenOutputVcf(hts::BgzfOstream& output_vcf, hts::BcfWriter& output_bcf)
+    -> std::unique_ptr<core::VcfWriter> {
   // Resolve local paths to absolute and ensure parent directories exist.
   // Cloud URIs (gs://, s3://) bypass local path resolution entirely.
   if (!hts::IsCloudUri(mParamsPtr->mOutVcfGz.string())) {
@@ -256,10 +270,28 @@ void PipelineRunner::OpenOutputVcf(hts::BgzfOstream& output_vcf) {
     }
   }
 
-  if (!output_vcf.Open(mParamsPtr->mOutVcfGz, hts::BgzfFormat::VCF)) {
+  // BGZF blocks are deflated on their own pool so formatting and result draining on
+  // the main thread never wait on compression (see BgzfStreambuf::Open).
+  auto const num_compress_threads = static_cast<int>(mParamsPtr->mNumCompressThreads);
+  auto header = BuildVcfHeader(*mParamsPtr);
+
+  if (mParamsPtr->mOutVcfGz.string().ends_with(".bcf")) {
+    if (!output_bcf.Open(mParamsPtr->mOutVcfGz, std::move(header), num_compress_threads)) {
+      LOG_CRITICAL("Could not open output BCF file: {}", mParamsPtr->mOutVcfGz.string())
+      std::exit(EXIT_FAILURE);
+    }
+    return std::make_unique<core::VcfWriter>(output_bcf);
+  }
+
+  if (!output_vcf.Open(mParamsPtr->mOutVcfGz, hts::BgzfFormat::VCF, num_compress_threads)) {
     LOG_CRITICAL("Could not open output VCF file: {}", mParamsPtr->mOutVcfGz.string())
     std::exit(EXIT_FAILURE);
   }
+
+  output_vcf << header;
+  output_vcf.flush();
+  output_vcf.InitIndex();
+  return std::make_unique<core::VcfWriter>(output_vcf);
 }
 
 // ============================================================================
@@ -293,6 +325,21 @@ void PipelineRunner::ValidateAndPopulateParams() {
   mParamsPtr->mVariantBuilder.mGraphParams.mNumSamples =
       static_cast<u32>(mParamsPtr->mVariantBuilder.mSampleList.size());
 
+  // One depth calibration per sample, fixed before any worker starts, so
+  // SKIPPED_EXTREME_COVERAGE does not depend on thread count or scheduling.
+  if (rdcoll.mSkipExtremeDepth) {
+    std::vector<f64> bases_per_byte;
+    for (auto const& sinfo : mParamsPtr->mVariantBuilder.mSampleList) {
+      auto const ratio = core::ReadCollector::CalibrateIndexDepth(sinfo.Path(), rdcoll.mRefPath);
+      if (ratio.has_value()) {
+        LOG_INFO("Index depth calibration for {}: {:.2f} passing bases per index byte",
+                 sinfo.Path().filename().string(), *ratio)
+      }
+      bases_per_byte.push_back(ratio.value_or(0.0));
+    }
+    mParamsPtr->mVariantBuilder.mRdCollParams.mBasesPerIndexByte = std::move(bases_per_byte);
+  }
+
   if (mParamsPtr->mVariantBuilder.mSkipActiveRegion) return;
 
   auto const missing_md = std::ranges::find_if(all_specs, [&rdcoll](auto const& spec) {
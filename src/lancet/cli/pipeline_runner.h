@@ -2,6 +2,8 @@
 #define SRC_LANCET_CLI_PIPELINE_RUNNER_H_
 
 #include "lancet/cli/cli_params.h"
+#include "lancet/core/vcf_writer.h"
+#include "lancet/hts/bcf_writer.h"
 #include "lancet/hts/bgzf_ostream.h"
 
 #include <memory>
@@ -35,9 +37,11 @@ class PipelineRunner {
   /// Called only when --probe-variants is provided.
   void SetupProbeTracking();
 
-  /// Resolves the output VCF path (local or cloud), validates credentials,
-  /// and opens the BGZF output stream. Exits on failure.
-  void OpenOutputVcf(hts::BgzfOstream& output_vcf);
+  /// Resolves the output path (local or cloud), validates credentials, opens
+  /// either the BGZF VCF stream or — for a `.bcf` path — the BCF writer, writes
+  /// the header and returns the writer stage bound to it. Exits on failure.
+  [[nodiscard]] auto OpenOutputVcf(hts::BgzfOstream& output_vcf, hts::BcfWriter& output_bcf)
+      -> std::unique_ptr<core::VcfWriter>;
 };
 
 }  // namespace lancet::cli
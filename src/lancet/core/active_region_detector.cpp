@@ -2,6 +2,7 @@
 
 #include "lancet/base/types.h"
 #include "lancet/core/read_collector.h"
+#include "lancet/core/sample_fanout.h"
 #include "lancet/core/sample_info.h"
 #include "lancet/hts/alignment.h"
 #include "lancet/hts/cigar_unit.h"
@@ -10,34 +11,118 @@
 #include "lancet/hts/reference.h"
 #include "lancet/hts/sam_flag.h"
 
-#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/hash/hash.h"
 #include "absl/status/statusor.h"
+#include "absl/functional/function_ref.h"
 #include "absl/strings/ascii.h"
 #include "absl/types/span.h"
 
-#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
-#include <cstdlib>
+namespace lancet::core {
 
-using CountMap = absl::flat_hash_map<u32, u32>;
+namespace detail {
 
-namespace lancet::core {
+// ============================================================================
+// VisitMdMismatches — mismatch positions from the MD:Z auxiliary tag
+//
+// PURPOSE: Detects positions where ≥2 reads disagree with the reference,
+// which signals an active region worth assembling. This is a lightweight
+// pre-filter before the full de Bruijn graph assembly.
+//
+// MD:Z FORMAT (SAM spec §1.5):
+//   [0-9]+ (matching run) | [A-Z] (one mismatched REF base) | ^[A-Z]+ (deleted REF bases)
+//   Example: "10A5^AC3"  →  10 matches, mismatch at +10, 5 matches (+11..+15),
+//                           2 deleted bases (+16, +17), 3 matches (+18..+20)
+//
+// Every REF letter consumes one reference base: a mismatch is reported at its
+// position, a deleted base after '^' is only stepped over. The deletion ends at
+// the next digit ("0A0C5" separates adjacent mismatches with zero-length runs).
+//
+// MD says nothing about inserted or soft-clipped read bases, so the quality of a
+// mismatch is found by walking the CIGAR alongside it: mismatches arrive in
+// increasing reference order, so one forward cursor over the CIGAR maps each
+// to its read offset. Mismatches below MIN_BASE_QUAL, or that the CIGAR does not
+// place on an aligned read base (a malformed record), are skipped.
+//
+// Parsed in place: nothing is allocated. Returns true as soon as `visit` does.
+// ============================================================================
+auto VisitMdMismatches(std::string_view md_val, absl::Span<u32 const> cigar,
+                       absl::Span<u8 const> quals, i64 const start0,
+                       absl::FunctionRef<bool(u32)> visit) -> bool {
+  if (start0 < 0) return false;
+
+  static constexpr u8 MIN_BASE_QUAL = 20;
+  static constexpr u32 DECIMAL_BASE = 10;
+  auto genome_pos = static_cast<u32>(start0);
+  u32 match_run = 0;
+  bool in_deletion = false;
+
+  // CIGAR cursor: the unit at `cig_idx` starts at reference `unit_ref` and read `unit_read`.
+  usize cig_idx = 0;
+  auto unit_ref = static_cast<u32>(start0);
+  usize unit_read = 0;
+  auto const read_offset = [&](u32 const ref_pos) -> std::optional<usize> {
+    while (cig_idx < cigar.size()) {
+      hts::CigarUnit const unit(cigar[cig_idx]);
+      auto const ref_len = unit.ConsumesReference() ? unit.Length() : 0;
+      if (ref_len > 0 && ref_pos < unit_ref + ref_len) {
+        if (!unit.ConsumesQuery()) return std::nullopt;
+        return unit_read + (ref_pos - unit_ref);
+      }
+      unit_ref += ref_len;
+      unit_read += unit.ConsumesQuery() ? unit.Length() : 0;
+      ++cig_idx;
+    }
+    return std::nullopt;
+  };
+
+  for (auto const character : md_val) {
+    auto const uchar = static_cast<unsigned char>(character);
+    if (absl::ascii_isdigit(uchar)) {
+      match_run = (match_run * DECIMAL_BASE) + static_cast<u32>(uchar - '0');
+      in_deletion = false;
+      continue;
+    }
+
+    genome_pos += match_run;
+    match_run = 0;
+    if (character == '^') {
+      in_deletion = true;
+      continue;
+    }
+
+    auto const ref_pos = genome_pos++;
+    if (in_deletion || !absl::ascii_isalpha(uchar)) continue;
+
+    auto const base_pos = read_offset(ref_pos);
+    if (!base_pos.has_value() || *base_pos >= quals.size() || quals[*base_pos] < MIN_BASE_QUAL) {
+      continue;
+    }
+    if (visit(ref_pos)) return true;
+  }
+
+  return false;
+}
+
+}  // namespace detail
 
 auto HasMdTag(std::filesystem::path const& aln_path, std::filesystem::path const& ref_path)
     -> bool {
   static constexpr usize NUM_READS_TO_PEEK = 1000;
   static std::vector<std::string> const TAGS{"MD"};
 
-  using hts::Alignment::Fields::AUX_RGAUX;
+  using hts::Alignment::Fields::ACTIVE_REGION_PRESCAN;
   hts::Reference const ref(ref_path);
   usize peeked_read_count = 0;
-  hts::Extractor extractor(aln_path, ref, AUX_RGAUX, TAGS, true);
+  hts::Extractor extractor(aln_path, ref, ACTIVE_REGION_PRESCAN, TAGS, true);
 
   for (auto const& aln : extractor) {
     if (peeked_read_count > NUM_READS_TO_PEEK) break;
@@ -56,98 +141,78 @@ auto HasMdTag(std::filesystem::path const& aln_path, std::filesystem::path const
 namespace {
 
 // ============================================================================
-// ParseMd — extract mismatch positions from the MD:Z auxiliary tag
-//
-// PURPOSE: Detects positions where ≥2 reads disagree with the reference,
-// which signals an active region worth assembling. This is a lightweight
-// pre-filter before the full de Bruijn graph assembly.
+// PositionHits — which genome positions have already been hit by one read
 //
-// MD:Z FORMAT (SAM spec §1.5):
-//   Concatenation of: [0-9]+ (matching run) | [ACGT] (mismatch base) | ^[ACGT]+ (deletion)
-//   Example: "10A5^AC6"  →  10 matches, A→? mismatch, 5 matches, 2bp deletion, 6 matches
-//
-// STATE MACHINE:
-//   ┌──────────┐  digit   ┌──────────────┐
-//   │ scanning ├─────────►│ accumulating │
-//   │          │◄─────────┤ match-run len│
-//   └────┬─────┘  letter  └──────────────┘
-//        │ (mismatch base A/C/G/T)
-//        ▼
-//   record genome_pos in result map; if count reaches 2 → return true
-//
-// Returns true as soon as any genome position has ≥2 mismatches (early exit).
+// Active region detection only asks whether a second read hits the same
+// position, so one bit per position replaces a hit counter. Positions within
+// the window ± MARGIN live in a dense bitset (a 500bp window plus margins is
+// ~50 words, cleared with one fill); the rare event outside it (long soft
+// clips, reads spanning a splice) falls back to a hash set.
 // ============================================================================
-inline auto ParseMd(std::string_view md_val, absl::Span<u8 const> quals, i64 const start,
-                    CountMap* result) -> bool {
-  if (start < 0) return false;
-
-  std::string token;
-  token.reserve(md_val.length());
-  auto genome_pos = static_cast<u32>(start);
+class PositionHits {
+ public:
+  void Reset(i64 const window_start0, u64 const window_len) {
+    mOrigin = window_start0 - MARGIN;
+    auto const num_positions = window_len + static_cast<u64>(2 * MARGIN);
+    mBits.assign((num_positions + BITS_PER_WORD - 1) / BITS_PER_WORD, 0);
+    mOutside.clear();
+  }
 
-  for (auto const& character : md_val) {
-    if (absl::ascii_isdigit(static_cast<unsigned char>(character))) {
-      token += character;
-      continue;
+  /// Marks `genome_pos`; returns true if it was already marked (second hit).
+  [[nodiscard]] auto MarkSeen(u32 const genome_pos) -> bool {
+    auto const offset = static_cast<i64>(genome_pos) - mOrigin;
+    if (offset < 0 || static_cast<u64>(offset) >= mBits.size() * BITS_PER_WORD) {
+      return !mOutside.insert(genome_pos).second;
     }
 
-    auto const step = token.empty() ? 0 : std::strtol(token.c_str(), nullptr, 10);
-    genome_pos += static_cast<u32>(step);
-    token.clear();
-
-    auto const base_pos = static_cast<usize>(genome_pos - start);
-    static constexpr u8 MIN_BASE_QUAL = 20;
-    if (quals.at(base_pos) < MIN_BASE_QUAL) continue;
-
-    auto const base = absl::ascii_toupper(static_cast<unsigned char>(character));
-    if (base == 'A' || base == 'C' || base == 'T' || base == 'G') {
-      if (++(*result)[genome_pos] == 2) return true;
-    }
+    auto& word = mBits[static_cast<u64>(offset) / BITS_PER_WORD];
+    auto const mask = u64{1} << (static_cast<u64>(offset) % BITS_PER_WORD);
+    bool const seen = (word & mask) != 0;
+    word |= mask;
+    return seen;
   }
 
-  return false;
-}
+ private:
+  static constexpr i64 MARGIN = 1024;
+  static constexpr u64 BITS_PER_WORD = 64;
 
-// ============================================================================
-// IncrementHitCount — returns true when a genome position reaches ≥2 hits.
-// Active region detection uses a threshold of 2: a single read with a
-// mismatch/indel is noise; two reads at the same position is signal.
-// ============================================================================
-inline auto IncrementHitCount(CountMap& counts, u32 const genome_pos) -> bool {
-  return ++counts[genome_pos] == 2;
-}
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  std::vector<u64> mBits;
+  absl::flat_hash_set<u32> mOutside;
+  i64 mOrigin = 0;
+};
 
 // ============================================================================
 // MutationAccumulator — per-sample evidence tracker for active region detection
 //
-// Owns four CountMaps (mismatches, insertions, deletions, softclips) keyed
-// by genome position. CheckAlignment runs three independent checks per read:
-//   1. MD tag mismatches (via ParseMd)
-//   2. CIGAR-based indels and mismatches
-//   3. Soft-clip positions
+// Owns four PositionHits (mismatches, insertions, deletions, softclips).
+// CheckAlignment runs two checks per read:
+//   1. MD tag mismatches (via detail::VisitMdMismatches)
+//   2. One pass over the raw CIGAR words for indels, X ops and soft-clips
 // Returns true the moment any position accumulates ≥2 supporting reads.
+// Nothing is copied out of the record: MD, qualities and CIGAR are all read
+// through zero-copy views.
 //
-// Lifetime: one instance per IsActiveRegion call, cleared between samples.
+// Lifetime: one instance per IsActiveRegion call, reset between samples.
 // ============================================================================
 class MutationAccumulator {
  public:
   // ── 8B Align ────────────────────────────────────────────────────────────
-  CountMap mMismatches;
-  CountMap mInsertions;
-  CountMap mDeletions;
-  CountMap mSoftclips;
-  std::vector<u32> mSoftclipPositions;
-
-  void ClearAll() {
-    mMismatches.clear();
-    mInsertions.clear();
-    mDeletions.clear();
-    mSoftclips.clear();
-    mSoftclipPositions.clear();
+  PositionHits mMismatches;
+  PositionHits mInsertions;
+  PositionHits mDeletions;
+  PositionHits mSoftclips;
+
+  void ResetAll(lancet::hts::Reference::Region const& region) {
+    auto const start0 = static_cast<i64>(region.StartPos1()) - 1;
+    mMismatches.Reset(start0, region.Length());
+    mInsertions.Reset(start0, region.Length());
+    mDeletions.Reset(start0, region.Length());
+    mSoftclips.Reset(start0, region.Length());
   }
 
   /// Entry point: filter QC-fail/dup/unmapped/mapq0 reads, then check
-  /// MD mismatches → CIGAR events → soft-clips in order of cost.
+  /// MD mismatches → CIGAR events + soft-clips in order of cost.
   [[nodiscard]] auto CheckAlignment(lancet::hts::Alignment const& aln) -> bool {
     auto const bflag = aln.Flag();
     if (bflag.IsQcFail() || bflag.IsDuplicate() || bflag.IsUnmapped() || aln.MapQual() == 0) {
@@ -155,41 +220,44 @@ class MutationAccumulator {
     }
 
     if (CheckMdTag(aln)) return true;
-    if (CheckCigarEvents(aln)) return true;
-    return CheckSoftClips(aln);
+    return CheckCigarEvents(aln);
   }
 
  private:
-  /// Check MD:Z tag for reference mismatches. BuildQualities() is called
-  /// on-demand only when the MD tag is present (avoids deep copy otherwise).
+  /// Check MD:Z tag for reference mismatches against the record's own qualities.
   [[nodiscard]] auto CheckMdTag(lancet::hts::Alignment const& aln) -> bool {
-    if (!aln.HasTag("MD")) return false;
     auto const md_tag = aln.GetTag<std::string_view>("MD");
-    // BuildQualities performs on-demand deep copy of quality values
-    auto const quals = aln.BuildQualities();
-    return ParseMd(md_tag.value(), absl::MakeConstSpan(quals), aln.StartPos0(), &mMismatches);
+    if (!md_tag.ok()) return false;
+    return lancet::core::detail::VisitMdMismatches(
+        md_tag.value(), aln.CigarView(), aln.QualView(), aln.StartPos0(),
+        [this](u32 const genome_pos) -> bool { return mMismatches.MarkSeen(genome_pos); });
   }
 
-  /// Scan CIGAR operations for insertions, deletions, and
-  /// explicit mismatch ops (X). Skips alignment-consuming ops.
+  /// Scan CIGAR operations for insertions, deletions, explicit mismatch ops (X)
+  /// and soft-clips. The genome position advances on reference-consuming ops
+  /// before each event is recorded, so soft-clip positions match
+  /// Alignment::GetSoftClips (unpadded).
   [[nodiscard]] auto CheckCigarEvents(lancet::hts::Alignment const& aln) -> bool {
-    auto const cigar_units = aln.CigarData();
     auto curr_genome_pos = static_cast<u32>(aln.StartPos0());
 
-    for (auto const& cig_unit : cigar_units) {
+    for (u32 const raw_unit : aln.CigarView()) {
+      lancet::hts::CigarUnit const cig_unit(raw_unit);
       if (cig_unit.ConsumesReference()) {
         curr_genome_pos += cig_unit.Length();
       }
 
       switch (cig_unit.Operation()) {
         case lancet::hts::CigarOp::INSERTION:
-          if (IncrementHitCount(mInsertions, curr_genome_pos)) return true;
+          if (mInsertions.MarkSeen(curr_genome_pos)) return true;
           break;
         case lancet::hts::CigarOp::DELETION:
-          if (IncrementHitCount(mDeletions, curr_genome_pos)) return true;
+          if (mDeletions.MarkSeen(curr_genome_pos)) return true;
           break;
         case lancet::hts::CigarOp::SEQUENCE_MISMATCH:
-          if (IncrementHitCount(mMismatches, curr_genome_pos)) return true;
+          if (mMismatches.MarkSeen(curr_genome_pos)) return true;
+          break;
+        case lancet::hts::CigarOp::SOFT_CLIP:
+          if (mSoftclips.MarkSeen(curr_genome_pos)) return true;
           break;
         default:
           break;
@@ -197,38 +265,58 @@ class MutationAccumulator {
     }
     return false;
   }
-
-  /// Extract soft-clip genome positions and check for ≥2 reads clipped
-  /// at the same position — a common signal for structural variant edges.
-  [[nodiscard]] auto CheckSoftClips(lancet::hts::Alignment const& aln) -> bool {
-    mSoftclipPositions.clear();
-    if (!aln.GetSoftClips(nullptr, nullptr, &mSoftclipPositions, false)) return false;
-    return std::ranges::any_of(mSoftclipPositions,
-                               [this](u32 gpos) { return IncrementHitCount(mSoftclips, gpos); });
-  }
 };
 
 }  // namespace
 
 namespace lancet::core {
 
+// ============================================================================
+// IsActiveRegion — prescan every sample until one position has ≥2 reads of
+// evidence. For CRAM inputs the extractor is narrowed to the prescan fields
+// (no QNAME, mate fields or read groups); ReadCollector restores the full
+// field set before it collects reads.
+//
+// With a SampleFanout every sample is scanned on its own thread with its own
+// accumulator; evidence is never pooled across samples, so the verdict is the
+// same as the sequential scan. The first sample to find a hotspot raises a
+// flag that stops the others at their next record.
+// ============================================================================
 auto IsActiveRegion(absl::Span<SampleInfo const> samples,
                     ReadCollector::SampleExtractors& extractors,
-                    hts::Reference::Region const& region) -> bool {
-  MutationAccumulator accumulator;
-
-  for (auto const& sinfo : samples) {
-    accumulator.ClearAll();
-
+                    hts::Reference::Region const& region, SampleFanout* fanout) -> bool {
+  auto const start_prescan = [&extractors, &region](SampleInfo const& sinfo) -> hts::Extractor& {
     auto& extractor = *extractors.at(sinfo);
+    extractor.SetRequiredFields(hts::Alignment::Fields::ACTIVE_REGION_PRESCAN);
     extractor.SetRegionToExtract(region);
-
-    for (auto const& aln : extractor) {
-      if (accumulator.CheckAlignment(aln)) return true;
+    return extractor;
+  };
+
+  if (fanout == nullptr || samples.size() < 2) {
+    MutationAccumulator accumulator;
+    for (auto const& sinfo : samples) {
+      accumulator.ResetAll(region);
+      for (auto const& aln : start_prescan(sinfo)) {
+        if (accumulator.CheckAlignment(aln)) return true;
+      }
     }
+    return false;
   }
 
-  return false;
+  std::atomic<bool> is_active{false};
+  fanout->Run(samples.size(), [&](usize const sample_idx) -> void {
+    MutationAccumulator accumulator;
+    accumulator.ResetAll(region);
+    for (auto const& aln : start_prescan(samples[sample_idx])) {
+      if (is_active.load(std::memory_order_relaxed)) return;
+      if (accumulator.CheckAlignment(aln)) {
+        is_active.store(true, std::memory_order_relaxed);
+        return;
+      }
+    }
+  });
+
+  return is_active.load(std::memory_order_relaxed);
 }
 
 }  // namespace lancet::core
@@ -1,16 +1,32 @@
 #ifndef SRC_LANCET_CORE_ACTIVE_REGION_DETECTOR_H_
 #define SRC_LANCET_CORE_ACTIVE_REGION_DETECTOR_H_
 
+#include "lancet/base/types.h"
 #include "lancet/core/read_collector.h"
+#include "lancet/core/sample_fanout.h"
 #include "lancet/core/sample_info.h"
 #include "lancet/hts/reference.h"
 
+#include "absl/functional/function_ref.h"
 #include "absl/types/span.h"
 
 #include <filesystem>
+#include <string_view>
 
 namespace lancet::core {
 
+namespace detail {
+
+/// Walks an MD:Z tag alongside its record's raw BAM CIGAR words and calls `visit` with
+/// the 0-based reference position of every mismatch whose read base has quality ≥ 20.
+/// Deleted reference bases (after '^') are not mismatches. Returns true as soon as
+/// `visit` returns true. Exposed for the active region prescan tests.
+[[nodiscard]] auto VisitMdMismatches(std::string_view md_val, absl::Span<u32 const> cigar,
+                                     absl::Span<u8 const> quals, i64 start0,
+                                     absl::FunctionRef<bool(u32)> visit) -> bool;
+
+}  // namespace detail
+
 /// Returns true if the given BAM/CRAM file contains MD tags.
 /// Peeks at the first 1000 reads to check for the MD auxiliary field.
 /// Active region detection depends on MD tags — if absent, the caller
@@ -29,10 +45,12 @@ namespace lancet::core {
 /// Uses a lightweight MD tag + CIGAR prescan to avoid full assembly.
 ///
 /// Accepts pre-built sample list and per-thread extractors by reference
-/// to avoid redundant BAM file opens and index loads per window.
+/// to avoid redundant BAM file opens and index loads per window. A non-null
+/// `fanout` scans the samples concurrently, one helper thread per sample.
 [[nodiscard]] auto IsActiveRegion(absl::Span<SampleInfo const> samples,
                                   ReadCollector::SampleExtractors& extractors,
-                                  hts::Reference::Region const& region) -> bool;
+                                  hts::Reference::Region const& region, SampleFanout* fanout)
+    -> bool;
 
 }  // namespace lancet::core
 
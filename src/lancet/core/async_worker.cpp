@@ -5,6 +5,7 @@
 #include "lancet/base/timer.h"
 #include "lancet/base/types.h"
 #include "lancet/core/window.h"
+#include "lancet/core/window_prefetcher.h"
 
 #include "absl/hash/hash.h"
 #include "blockingconcurrentqueue.h"
@@ -14,6 +15,7 @@
 #include <cxxabi.h>
 #include <exception>
 #include <memory>
+#include <optional>
 #include <stop_token>
 #include <string>
 #include <thread>
@@ -33,8 +35,18 @@ namespace lancet::core {
 //   1. Check stop_token — cooperative cancellation from the main thread
 //   2. Dequeue a window (10ms timeout — prevents busy-spinning)
 //   3. Register crash context (genome index + region string)
-//   4. Run VariantBuilder::ProcessWindow → assemble, call, genotype
-//   5. Clear crash context and push result to output queue
+//   4. Load the window's reads (VariantBuilder::LoadWindowInput)
+//   5. Run VariantBuilder::ProcessWindow → assemble, call, genotype
+//   6. Clear crash context and push result to output queue
+//
+// Read prefetch (off by default, --read-prefetch enables):
+//   After step 4 the worker tries a non-blocking dequeue of one more window
+//   and hands it to its WindowPrefetcher, so that window's BAM/CRAM reads are
+//   collected while step 5 runs for the current one. The next iteration then
+//   skips the queue and takes the prefetched window and its input. Only one
+//   window is ever held back, so load balancing across workers is unaffected
+//   except at the very tail of the run. A prefetched window's runtime covers
+//   only the part of its read collection that did not overlap.
 //
 // Crash context lifecycle:
 //   RegisterThreadSlot()     — once at thread startup
@@ -54,15 +66,25 @@ void AsyncWorker::Process(std::stop_token stop_token) {
   lancet::base::Timer timer;
   usize num_done = 0;
   auto window_ptr = std::make_shared<Window>();
+  WindowPtr next_window_ptr;
+  bool next_is_prefetched = false;
   moodycamel::ProducerToken const out_token(*mOutPtr);
   constexpr auto QUEUE_TIMEOUT = std::chrono::milliseconds(10);
 
-  while (true) {
-    if (stop_token.stop_requested()) break;
+  std::optional<WindowPrefetcher> prefetcher;
+  if (mPrefetchReads) prefetcher.emplace(*mBuilderPtr);
 
-    // Blocking dequeue with timeout — prevents busy-spinning while allowing
-    // periodic re-check of the stop_token.
-    if (!mInPtr->wait_dequeue_timed(window_ptr, QUEUE_TIMEOUT)) continue;
+  while (true) {
+    bool const is_prefetched = std::exchange(next_is_prefetched, false);
+    if (is_prefetched) {
+      window_ptr = std::move(next_window_ptr);
+    } else {
+      if (stop_token.stop_requested()) break;
+
+      // Blocking dequeue with timeout — prevents busy-spinning while allowing
+      // periodic re-check of the stop_token.
+      if (!mInPtr->wait_dequeue_timed(window_ptr, QUEUE_TIMEOUT)) continue;
+    }
 
     // Record which window this thread is about to process.  If a crash occurs
     // inside ProcessWindow(), the crash handler prints this context.
@@ -71,7 +93,15 @@ void AsyncWorker::Process(std::stop_token stop_token) {
 
     timer.Reset();
     try {
-      auto variants = mBuilderPtr->ProcessWindow(std::const_pointer_cast<Window const>(window_ptr));
+      auto const input =
+          is_prefetched ? prefetcher->Take() : mBuilderPtr->LoadWindowInput(*window_ptr);
+      if (prefetcher.has_value() && mInPtr->try_dequeue(next_window_ptr)) {
+        prefetcher->Submit(next_window_ptr);
+        next_is_prefetched = true;
+      }
+
+      auto variants =
+          mBuilderPtr->ProcessWindow(std::const_pointer_cast<Window const>(window_ptr), input);
       mStorePtr->AddVariants(std::move(variants));
     } catch (std::exception const& exc) {
       LOG_CRITICAL("AsyncWorker thread {:#x} CRASHED on window idx={} region={}: {}", THREAD_ID,
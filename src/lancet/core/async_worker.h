@@ -42,7 +42,8 @@ class AsyncWorker {
       : mInPtr(std::move(in_queue_ptr)),
         mOutPtr(std::move(out_queue_ptr)),
         mStorePtr(std::move(variant_store_ptr)),
-        mBuilderPtr(std::make_unique<VariantBuilder>(std::move(params), window_len, worker_id)) {}
+        mBuilderPtr(std::make_unique<VariantBuilder>(params, window_len, worker_id)),
+        mPrefetchReads(params->mReadPrefetch) {}
 
   void Process(std::stop_token stop_token);
 
@@ -52,6 +53,8 @@ class AsyncWorker {
   OutQueuePtr mOutPtr;
   VariantStorePtr mStorePtr;
   VariantBuilderPtr mBuilderPtr;
+  // ── 1B Align ────────────────────────────────────────────────────────────
+  bool mPrefetchReads;  // overlap window N+1's read collection with window N's assembly
 };
 
 }  // namespace lancet::core
@@ -11,8 +11,11 @@
 #include "lancet/core/async_worker.h"
 #include "lancet/core/variant_builder.h"
 #include "lancet/core/variant_store.h"
+#include "lancet/core/vcf_writer.h"
 #include "lancet/core/window.h"
 #include "lancet/core/window_builder.h"
+#include "lancet/hts/record_stream.h"
+#include "lancet/hts/reference.h"
 
 #include "absl/container/fixed_array.h"
 #include "absl/hash/hash.h"
@@ -55,6 +58,7 @@ namespace {
                                        {SKIPPED_REF_REPEAT_SEEN, 0},
                                        {SKIPPED_INACTIVE_REGION, 0},
                                        {SKIPPED_ANCHOR_COVERAGE, 0},
+                                       {SKIPPED_EXTREME_COVERAGE, 0},
                                        {SKIPPED_NOASM_HAPLOTYPE, 0},
                                        {MISSING_NO_MSA_VARIANTS, 0},
                                        {FOUND_GENOTYPED_VARIANT, 0}};
@@ -95,7 +99,7 @@ void PipelineExecutor::LogWindowStats(WindowStats const& stats) {
 // ============================================================================
 // Execute — orchestrator: allocate → feed → launch → process → shutdown
 // ============================================================================
-auto PipelineExecutor::Execute(std::ostream& output) -> WindowStats {
+auto PipelineExecutor::Execute(VcfWriter& writer) -> WindowStats {
   auto const num_total = mWindowBuilder.ExpectedTargetWindows();
 
   static thread_local auto const THREAD_ID = std::this_thread::get_id();
@@ -117,12 +121,19 @@ auto PipelineExecutor::Execute(std::ostream& output) -> WindowStats {
 
   moodycamel::ProducerToken const producer_token(*mSendQueue);
   FeedInitialWindows(producer_token, num_total);
+  auto const base_params = mParams;
+  OpenRecordStreams();
+  ReleaseStreamedRecords();  // tells the streams which window is oldest before any is read
   LaunchWorkers();
 
-  auto stats = ProcessAllResults(output, num_total, producer_token);
+  // Formatting, compression and indexing run on the writer thread; the main
+  // thread below only tracks window completion and hands over sorted batches.
+  auto stats = ProcessAllResults(writer, num_total, producer_token);
 
   ShutdownWorkers();
-  mVariantStore->FlushAllVariantsInStore(output);
+  mParams = base_params;  // drops the record streams, stopping their readers
+  writer.Submit(mVariantStore->ExtractAllVariants());
+  writer.Finish();
 
   return stats;
 }
@@ -164,6 +175,52 @@ void PipelineExecutor::FeedNextBatch(moodycamel::ProducerToken const& token) {
   }
 }
 
+// ============================================================================
+// OpenRecordStreams — --linear-scan: read each sample once for all workers
+//
+// Every worker keeps its own extractors, but with streams attached they
+// answer window regions from the stream's buffer instead of seeking the
+// index, so each BGZF block is decoded once per sample instead of once per
+// overlapping window. The streams scan the padded input regions in the same
+// order the windows are emitted, and ReleaseStreamedRecords() trails the
+// contiguous-done watermark. Must run before LaunchWorkers(), since workers
+// build their ReadCollector from mParams.
+// ============================================================================
+void PipelineExecutor::OpenRecordStreams() {
+  if (!mParams->mRdCollParams.mLinearScan) return;
+
+  auto params = std::make_shared<VariantBuilder::Params>(*mParams);
+  auto& streams = params->mRdCollParams.mRecordStreams;
+  hts::Reference const ref(params->mRdCollParams.mRefPath);
+  auto const scan_specs = mWindowBuilder.ScanRegionSpecs();
+  for (auto const& sinfo : params->mSampleList) {
+    streams.push_back(std::make_shared<hts::RecordStream>(sinfo.Path(), ref, scan_specs,
+                                                          hts::RecordStream::Params{}));
+  }
+
+  LOG_INFO("Streaming {} sample(s) once across {} scan region(s)", streams.size(),
+           scan_specs.size())
+  mParams = std::move(params);
+}
+
+// ============================================================================
+// ReleaseStreamedRecords — let the stream readers move on
+//
+// Windows before the contiguous-done watermark are finished, and every window
+// after it starts at or after the watermark window, so no worker can still ask
+// for records that end before its start. The watermark window is also the one
+// a stream lets past its buffer cap, so this runs once before workers start.
+// ============================================================================
+void PipelineExecutor::ReleaseStreamedRecords() {
+  auto const& streams = mParams->mRdCollParams.mRecordStreams;
+  if (streams.empty() || mLastContiguousDone >= mWindows.size()) return;
+
+  auto const& oldest_window = *mWindows[mLastContiguousDone];
+  auto const chrom_name = oldest_window.ChromName();
+  auto const start0 = static_cast<i64>(oldest_window.StartPos1()) - 1;
+  for (auto const& stream : streams) stream->ReleaseBefore(chrom_name, start0);
+}
+
 // ============================================================================
 // LaunchWorkers — spawn jthreads with cooperative cancellation
 //
@@ -212,7 +269,7 @@ void PipelineExecutor::ShutdownWorkers() {
 // ============================================================================
 // FlushCompletedVariants — coordinate-sorted VCF output synchronization
 // ============================================================================
-void PipelineExecutor::FlushCompletedVariants(std::ostream& output, usize num_total,
+void PipelineExecutor::FlushCompletedVariants(VcfWriter& writer, usize num_total,
                                               absl::FixedArray<bool> const& done_windows) {
   // ============================================================================
   // VCF Output Synchronization & Bulk Flushing
@@ -233,8 +290,8 @@ void PipelineExecutor::FlushCompletedVariants(std::ostream& output, usize num_to
     target_flush_idx = mLastContiguousDone - NUM_BUFFER_WINDOWS;
   }
 
-  // varstore->FlushVariantsBeforeWindow takes a target window and dumps ALL
-  // buffered variants chronologically up to that genomic threshold in one shot.
+  // varstore->ExtractVariantsBeforeWindow takes a target window and hands ALL
+  // buffered variants up to that genomic threshold to the writer in one batch.
   //
   // Example Scenario (If NUM_BUFFER_WINDOWS = 2):
   //  - `last_contiguous_done` evaluates to 3.
@@ -243,11 +300,11 @@ void PipelineExecutor::FlushCompletedVariants(std::ostream& output, usize num_to
   //  - `last_contiguous_done` instantly slides from 3 up to 5.
   //  - `target_flush_idx` evaluates to (5 - 2) = 3.
   //  - `idx_to_flush` jumps from its old state directly to 3.
-  //  - A single FlushVariantsBeforeWindow(*windows[3]) call fires, sweeping
-  //    the store and safely dumping all variants prior to window #3 to disk.
+  //  - A single ExtractVariantsBeforeWindow(*windows[3]) call fires, and the
+  //    writer thread dumps all variants prior to window #3 to disk.
   if (mIdxToFlush < target_flush_idx) {
     mIdxToFlush = target_flush_idx;
-    mVariantStore->FlushVariantsBeforeWindow(*mWindows[mIdxToFlush], output);
+    writer.Submit(mVariantStore->ExtractVariantsBeforeWindow(*mWindows[mIdxToFlush]));
   }
 }
 
@@ -258,7 +315,7 @@ void PipelineExecutor::FlushCompletedVariants(std::ostream& output, usize num_to
 // new window batches when queue runs low, and flushes completed variants in
 // coordinate order.
 // ============================================================================
-auto PipelineExecutor::ProcessAllResults(std::ostream& output, usize num_total,
+auto PipelineExecutor::ProcessAllResults(VcfWriter& writer, usize num_total,
                                          moodycamel::ProducerToken const& token) -> WindowStats {
   auto stats = InitWindowStats();
 
@@ -307,7 +364,9 @@ auto PipelineExecutor::ProcessAllResults(std::ostream& output, usize num_total,
              percent, elapsed, remaining, eta_timer.RatePerSecond(), window_name,
              ToString(result.mStatus), window_runtime)
 
-    FlushCompletedVariants(output, num_total, done_windows);
+    auto const prev_contiguous_done = mLastContiguousDone;
+    FlushCompletedVariants(writer, num_total, done_windows);
+    if (mLastContiguousDone != prev_contiguous_done) ReleaseStreamedRecords();
   }
 
   return stats;
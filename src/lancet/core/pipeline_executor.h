@@ -5,6 +5,7 @@
 #include "lancet/core/async_worker.h"
 #include "lancet/core/variant_builder.h"
 #include "lancet/core/variant_store.h"
+#include "lancet/core/vcf_writer.h"
 #include "lancet/core/window.h"
 #include "lancet/core/window_builder.h"
 
@@ -12,7 +13,6 @@
 #include "absl/container/fixed_array.h"
 #include "concurrentqueue.h"
 
-#include <iosfwd>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -32,8 +32,9 @@ class PipelineExecutor {
 
   /// Run the full pipeline execution lifecycle:
   /// feed windows → launch workers → process results → flush variants → shutdown.
+  /// Completed batches go to `writer`, which is Finish()ed before returning.
   /// Returns per-status-code window counts for downstream logging.
-  [[nodiscard]] auto Execute(std::ostream& output) -> WindowStats;
+  [[nodiscard]] auto Execute(VcfWriter& writer) -> WindowStats;
 
   /// Log final window status breakdown to the application logger.
   static void LogWindowStats(WindowStats const& stats);
@@ -71,6 +72,13 @@ class PipelineExecutor {
   /// Uses BuildWindows() for small runs, BuildWindowsBatch() for large runs.
   void FeedInitialWindows(moodycamel::ProducerToken const& token, usize num_total);
 
+  /// With --linear-scan, opens one RecordStream per sample and swaps mParams for a copy
+  /// that carries them, so every worker's extractors read from the shared streams.
+  void OpenRecordStreams();
+
+  /// Frees streamed records that end before the oldest window not yet done.
+  void ReleaseStreamedRecords();
+
   /// Launch num_threads jthreads, each owning a VariantBuilder instance.
   /// Uses C++20 cooperative cancellation via std::stop_token.
   void LaunchWorkers();
@@ -79,14 +87,14 @@ class PipelineExecutor {
   /// Also stops gperftools profiler in LANCET_PROFILE_MODE.
   void ShutdownWorkers();
 
-  /// Advance the contiguous-done watermark and flush completed variants
-  /// to the output stream, maintaining coordinate-sorted VCF output.
-  void FlushCompletedVariants(std::ostream& output, usize num_total,
+  /// Advance the contiguous-done watermark and submit completed variants
+  /// to the writer thread, maintaining coordinate-sorted VCF output.
+  void FlushCompletedVariants(VcfWriter& writer, usize num_total,
                               absl::FixedArray<bool> const& done_windows);
 
   /// The main event loop: dequeue results, track progress, flush variants.
   /// Returns accumulated per-status-code window counts.
-  [[nodiscard]] auto ProcessAllResults(std::ostream& output, usize num_total,
+  [[nodiscard]] auto ProcessAllResults(VcfWriter& writer, usize num_total,
                                        moodycamel::ProducerToken const& token) -> WindowStats;
 };
 
@@ -3,6 +3,9 @@
 #include "lancet/base/types.h"
 #include "lancet/cbdg/label.h"
 #include "lancet/cbdg/read.h"
+#include "lancet/cbdg/read_arena.h"
+#include "lancet/cbdg/read_batch.h"
+#include "lancet/core/sample_fanout.h"
 #include "lancet/core/sample_info.h"
 #include "lancet/hts/alignment.h"
 #include "lancet/hts/extractor.h"
@@ -38,6 +41,8 @@ namespace {
 // order across runs.
 //
 // Priority: filter-pass status > sample tag > sample name > qname > chrom > position.
+// Sample name order is compared through SampleIndex: MakeSampleList assigns
+// indices in (tag, name) order, so the two orders agree.
 // ============================================================================
 auto CompareReadsByPriority(lancet::cbdg::Read const& lhs, lancet::cbdg::Read const& rhs) -> bool {
   if (lhs.PassesAlnFilters() != rhs.PassesAlnFilters()) {
@@ -46,7 +51,7 @@ auto CompareReadsByPriority(lancet::cbdg::Read const& lhs, lancet::cbdg::Read co
   if (lhs.TagKind() != rhs.TagKind()) {
     return static_cast<u8>(lhs.TagKind()) < static_cast<u8>(rhs.TagKind());
   }
-  if (lhs.SampleName() != rhs.SampleName()) return lhs.SampleName() < rhs.SampleName();
+  if (lhs.SampleIndex() != rhs.SampleIndex()) return lhs.SampleIndex() < rhs.SampleIndex();
   if (lhs.QnameView() != rhs.QnameView()) return lhs.QnameView() < rhs.QnameView();
   if (lhs.ChromIndex() != rhs.ChromIndex()) return lhs.ChromIndex() < rhs.ChromIndex();
   return lhs.StartPos0() < rhs.StartPos0();
@@ -67,7 +72,10 @@ auto ReadCollector::HashQname(std::string_view qname) -> u64 {
 // Constructor
 // ============================================================================
 ReadCollector::ReadCollector(Params params, absl::Span<SampleInfo const> sample_list)
-    : mParams(std::move(params)), mSampleList(sample_list.begin(), sample_list.end()) {
+    : mParams(std::move(params)),
+      mSampleList(sample_list.begin(), sample_list.end()),
+      mSampleReads(mSampleList.size()),
+      mArenaPool(std::make_shared<cbdg::ReadArena::BlockPool>()) {
   using hts::Extractor;
   using hts::Alignment::Fields::AUX_RGAUX;
 
@@ -89,10 +97,18 @@ ReadCollector::ReadCollector(Params params, absl::Span<SampleInfo const> sample_
   mIsCaseCtrlMode =
       std::ranges::any_of(mSampleList, IS_CASE) && std::ranges::any_of(mSampleList, IS_CTRL);
 
-  for (auto const& sinfo : mSampleList) {
+  auto const& streams = mParams.mRecordStreams;
+  for (usize sample_idx = 0; sample_idx < mSampleList.size(); ++sample_idx) {
+    auto const& sinfo = mSampleList[sample_idx];
     auto extractor = std::make_unique<Extractor>(sinfo.Path(), hts::Reference(mParams.mRefPath),
                                                  AUX_RGAUX, sam_tags, no_ctgcheck);
+    if (sample_idx < streams.size()) extractor->AttachStream(streams[sample_idx]);
     mExtractors.emplace(sinfo, std::move(extractor));
+    mSampleArenas.emplace_back(mArenaPool);
+  }
+
+  if (mParams.mParallelSamples && mSampleList.size() > 1) {
+    mFanout = std::make_unique<SampleFanout>(mSampleList.size() - 1);
   }
 }
 
@@ -100,31 +116,153 @@ ReadCollector::ReadCollector(Params params, absl::Span<SampleInfo const> sample_
 // CollectRegionResult: orchestrator for three-pass paired downsampling.
 //
 // Pass 1 (Profile): zero-copy profiling + deterministic downsampling.
-// Pass 2 (Extract): deep-copy only kept reads into mSampledReads.
+// Pass 2 (Extract): copy only kept reads into the sample's accumulator and arena.
 // Pass 3 (Mates):   fetch out-of-region mates for kept reads.
+//
+// Samples are independent until the merge: each runs all three passes on its
+// own extractor into its own accumulator, either in a loop or concurrently on
+// the SampleFanout helpers. The merged reads then get the final priority sort,
+// which fixes the read order regardless of which sample finished first, and
+// the per-window ReadBatch (nt4 bases, error prefix sums, qname hashes) is
+// built against that order. The reads view bytes in the sample arenas, which
+// are absorbed into the Result's arena so the bytes live exactly as long as
+// the reads; when the Result dies the blocks return to mArenaPool.
 // ============================================================================
 auto ReadCollector::CollectRegionResult(Region const& region) -> Result {
-  mSampledReads.clear();
   auto const max_sample_bases = mParams.mMaxSampleCov * static_cast<f64>(region.Length());
   auto const region_spec = region.ToSamtoolsRegion();
+  auto const collect_sample = [&](usize const sample_idx) -> void {
+    CollectSample(sample_idx, region_spec, max_sample_bases);
+  };
+
+  if (mFanout != nullptr) {
+    mFanout->Run(mSampleList.size(), collect_sample);
+  } else {
+    for (usize sample_idx = 0; sample_idx < mSampleList.size(); ++sample_idx) {
+      collect_sample(sample_idx);
+    }
+  }
+
+  usize num_reads = 0;
+  for (auto const& sample_reads : mSampleReads) num_reads += sample_reads.size();
+
+  cbdg::ReadArena read_arena(mArenaPool);
+  std::vector<Read> sampled_reads;
+  sampled_reads.reserve(num_reads);
+  for (usize sample_idx = 0; sample_idx < mSampleList.size(); ++sample_idx) {
+    std::ranges::copy(mSampleReads[sample_idx], std::back_inserter(sampled_reads));
+    mSampleReads[sample_idx].clear();
+    read_arena.Absorb(std::move(mSampleArenas[sample_idx]));
+  }
+
+  std::ranges::sort(sampled_reads, CompareReadsByPriority);
+  cbdg::ReadBatch read_batch(absl::MakeConstSpan(sampled_reads));
+  return {.mReadArena = std::move(read_arena),
+          .mSampleReads = std::move(sampled_reads),
+          .mSampleList = mSampleList,
+          .mReadBatch = std::move(read_batch)};
+}
 
-  for (auto& sinfo : mSampleList) {
-    auto& extractor = mExtractors.at(sinfo);
-    mSampledBaseCount = 0;
+void ReadCollector::CollectSample(usize const sample_idx, std::string const& region_spec,
+                                  f64 const max_sample_bases) {
+  auto& sinfo = mSampleList[sample_idx];
+  auto& extractor = mExtractors.at(sinfo);
+  auto& sample_reads = mSampleReads[sample_idx];
+  auto& sample_arena = mSampleArenas[sample_idx];
+
+  // IsActiveRegion narrows CRAM decoding to its prescan fields; restore the full record
+  extractor->SetRequiredFields(hts::Extractor::DEFAULT_FIELDS);
+  auto profile = ProfileAndDownsample(*extractor, region_spec, max_sample_bases);
+  ExtractKeptReads(*extractor, region_spec, profile.mKeepQnames, sinfo, sample_arena,
+                   sample_reads);
+
+  if (!profile.mExpectedMates.empty() && mParams.mExtractPairs) {
+    RecaptureMates(*extractor, profile.mKeepQnames, profile.mExpectedMates, sinfo, sample_arena,
+                   sample_reads);
+  }
 
-    auto profile = ProfileAndDownsample(*extractor, region_spec, max_sample_bases);
-    ExtractKeptReads(*extractor, region_spec, profile.mKeepQnames, sinfo);
+  u64 sampled_base_count = 0;
+  for (auto const& read : sample_reads) sampled_base_count += read.Length();
+  sinfo.SetNumSampledReads(profile.mSampledReadCount);
+  sinfo.SetNumSampledBases(sampled_base_count);
+}
 
-    if (!profile.mExpectedMates.empty() && mParams.mExtractPairs) {
-      RecaptureMates(*extractor, profile.mKeepQnames, profile.mExpectedMates, sinfo);
+// ============================================================================
+// EstimateIndexDepth: classify a window before decoding any record.
+//
+// EMPTY is exact — a region without index chunks yields no record, so the
+// window would end with zero coverage anyway. EXTREME is an estimate: chunk
+// bytes are counted at 16kb-tile granularity, so they are spread over the
+// whole tiles the window touches and converted to depth with the sample's
+// fixed bases-per-byte ratio from CalibrateIndexDepth.
+// ============================================================================
+auto ReadCollector::EstimateIndexDepth(Region const& region) const -> IndexDepth {
+  // BAI linear-index tile, also the CSI default min_shift
+  static constexpr u64 INDEX_TILE_SHIFT = 14;
+  auto const first_tile = (region.StartPos1() - 1) >> INDEX_TILE_SHIFT;
+  auto const last_tile = (region.EndPos1() - 1) >> INDEX_TILE_SHIFT;
+  auto const tiles_span = static_cast<f64>((last_tile - first_tile + 1) << INDEX_TILE_SHIFT);
+  auto const extreme_depth = EXTREME_DEPTH_FOLD * mParams.mMaxSampleCov;
+  auto const& bases_per_byte = mParams.mBasesPerIndexByte;
+  auto const region_spec = region.ToSamtoolsRegion();
+
+  bool all_empty = true;
+  for (usize sample_idx = 0; sample_idx < mSampleList.size(); ++sample_idx) {
+    auto const& extractor = *mExtractors.at(mSampleList[sample_idx]);
+    auto const footprint = extractor.QueryIndexFootprint(region_spec);
+    if (!footprint.has_value()) {
+      all_empty = false;
+      continue;
     }
 
-    sinfo.SetNumSampledReads(profile.mSampledReadCount);
-    sinfo.SetNumSampledBases(mSampledBaseCount);
+    if (footprint->mNumChunks > 0) all_empty = false;
+
+    if (!mParams.mSkipExtremeDepth || sample_idx >= bases_per_byte.size()) continue;
+    auto const est_bases =
+        static_cast<f64>(footprint->mCompressedBytes) * bases_per_byte[sample_idx];
+    if (est_bases / tiles_span > extreme_depth) return IndexDepth::EXTREME;
   }
 
-  std::ranges::sort(mSampledReads, CompareReadsByPriority);
-  return {.mSampleReads = std::move(mSampledReads), .mSampleList = mSampleList};
+  return all_empty ? IndexDepth::EMPTY : IndexDepth::NORMAL;
+}
+
+// ============================================================================
+// CalibrateIndexDepth: one fixed bases-per-byte ratio per alignment file.
+//
+// The index gives the mapped record count and the compressed bytes of every
+// contig. The first records of the file give the share of mapped records that
+// pass the Pass 1 filters and their mean length. Runs once per sample before
+// the workers start, so every worker classifies windows with the same ratio.
+// ============================================================================
+auto ReadCollector::CalibrateIndexDepth(std::filesystem::path const& aln_path,
+                                        std::filesystem::path const& ref_path)
+    -> std::optional<f64> {
+  static constexpr u64 NUM_RECORDS_TO_PEEK = 10'000;
+
+  hts::Reference const ref(ref_path);
+  hts::Extractor extractor(aln_path, ref, hts::Alignment::Fields::CORE_QNAME, {}, true);
+  auto const totals = extractor.QueryIndexTotals();
+  if (!totals.has_value() || totals->mMappedRecords == 0 || totals->mCompressedBytes == 0) {
+    return std::nullopt;
+  }
+
+  u64 num_mapped = 0;
+  u64 num_pass_bases = 0;
+  for (auto const& aln : extractor) {
+    if (num_mapped >= NUM_RECORDS_TO_PEEK) break;
+    auto const bflag = aln.Flag();
+    if (bflag.IsUnmapped()) continue;
+
+    num_mapped += 1;
+    if (bflag.IsQcFail() || bflag.IsDuplicate() || aln.MapQual() < 20) continue;
+    num_pass_bases += aln.Length();
+  }
+
+  if (num_mapped == 0) return std::nullopt;
+  auto const pass_bases_per_record =
+      static_cast<f64>(num_pass_bases) / static_cast<f64>(num_mapped);
+  return static_cast<f64>(totals->mMappedRecords) * pass_bases_per_record /
+         static_cast<f64>(totals->mCompressedBytes);
 }
 
 // ============================================================================
@@ -204,15 +342,15 @@ auto ReadCollector::ProfileAndDownsample(hts::Extractor& extractor, std::string
 }
 
 // ============================================================================
-// Pass 2: Deep Copy & Object Emplacement (only for kept reads)
+// Pass 2: Copy & Object Emplacement (only for kept reads)
 //
 // Re-iterates the region. Only reads whose qname hash is in keep_qnames
-// trigger deep extraction (BuildSequence, BuildQualities via Read ctor).
+// are decoded, into one arena slice each via the Read ctor.
 // ============================================================================
 void ReadCollector::ExtractKeptReads(hts::Extractor& extractor, std::string const& region_spec,
                                      absl::flat_hash_set<u64> const& keep_qnames,
-                                     SampleInfo const& sinfo) {
-  auto const sample_name = std::string(sinfo.SampleName());
+                                     SampleInfo const& sinfo, cbdg::ReadArena& arena,
+                                     std::vector<Read>& out_reads) {
   extractor.SetRegionToExtract(region_spec);
   for (auto const& aln : extractor) {
     auto const bflag = aln.Flag();
@@ -222,76 +360,67 @@ void ReadCollector::ExtractKeptReads(hts::Extractor& extractor, std::string cons
 
     if (!keep_qnames.contains(HashQname(aln.QnameView()))) continue;
 
-    mSampledReads.emplace_back(aln, sample_name, sinfo.TagKind(), sinfo.SampleIndex());
-    mSampledBaseCount += mSampledReads.back().Length();
+    out_reads.emplace_back(aln, arena, sinfo.TagKind(), sinfo.SampleIndex());
   }
 }
 
 // ============================================================================
 // Pass 3: Recapture out-of-region mates for kept reads
 //
-// Walks mate locations in reverse-sorted genomic order for sequential
-// disk access. Removes mates whose qnames were not kept during downsampling
-// before querying, to avoid unnecessary HTSlib seeks.
+// Removes mates whose qnames were not kept during downsampling, then fetches
+// every remaining mate location through ONE multi-region iterator
+// (sam_itr_regarray). HTSlib sorts the regions, merges the ones whose index
+// chunks overlap and reads each chunk once, so mates that share a BGZF block
+// cost one decompression instead of one index query and block seek each.
+// Blocks revisited across windows are served by the extractor's BGZF cache.
 // ============================================================================
 void ReadCollector::RecaptureMates(hts::Extractor& extractor,
                                    absl::flat_hash_set<u64> const& keep_qnames,
-                                   MateRegionsMap& expected_mates, SampleInfo const& sinfo) {
-  // Remove mates whose qnames are not in the keep set (rejected by downsampling
-  // or already captured during the in-region linear scan)
+                                   MateRegionsMap& expected_mates, SampleInfo const& sinfo,
+                                   cbdg::ReadArena& arena, std::vector<Read>& out_reads) {
   absl::erase_if(expected_mates, [&keep_qnames](auto const& entry) -> bool {
     return !keep_qnames.contains(entry.first);
   });
+  if (expected_mates.empty()) return;
 
-  auto const sample_name = std::string(sinfo.SampleName());
-  // Reverse-sorted so pop_back() yields ascending genomic order (sequential BAM I/O)
-  auto rev_mate_regions = ReverseSortMateRegions(expected_mates);
-  while (!expected_mates.empty()) {
-    auto const& [qhash, minfo] = rev_mate_regions.back();
-    if (!expected_mates.contains(qhash)) {
-      rev_mate_regions.pop_back();
-      continue;
-    }
-
-    auto const mate_reg_spec = MakeRegionSpec(minfo, &extractor);
-    extractor.SetRegionToExtract(mate_reg_spec);
+  auto mate_region_specs = MakeMateRegionSpecs(expected_mates, extractor);
+  extractor.SetRegionBatchToExtract(absl::MakeSpan(mate_region_specs));
 
-    for (auto const& aln : extractor) {
-      auto const mate_qhash = HashQname(aln.QnameView());
-      auto const itr = expected_mates.find(mate_qhash);
-      if (itr == expected_mates.end()) continue;
-
-      mSampledReads.emplace_back(aln, sample_name, sinfo.TagKind(), sinfo.SampleIndex());
-      mSampledBaseCount += mSampledReads.back().Length();
-      expected_mates.erase(itr);
-    }
+  for (auto const& aln : extractor) {
+    auto const mate_qhash = HashQname(aln.QnameView());
+    auto const itr = expected_mates.find(mate_qhash);
+    if (itr == expected_mates.end()) continue;
 
-    rev_mate_regions.pop_back();
+    out_reads.emplace_back(aln, arena, sinfo.TagKind(), sinfo.SampleIndex());
+    expected_mates.erase(itr);
+    if (expected_mates.empty()) break;
   }
 }
 
 // ============================================================================
-// ReverseSortMateRegions — descending-order sort for stack-based consumption
+// MakeMateRegionSpecs — one single-base region per distinct mate location
 //
-// Returns mate locations sorted by descending chrom index, then descending
-// start position. RecaptureMates consumes via pop_back(), which yields
-// ascending genomic order — matching BAM/CRAM coordinate sort for sequential
-// disk I/O. Using pop_back() is O(1), unlike front-erasure which is O(n).
+// Sorted by (chrom index, position) with duplicate locations collapsed, so
+// the region array handed to sam_itr_regarray is already in file order.
 // ============================================================================
-auto ReadCollector::ReverseSortMateRegions(MateRegionsMap const& data)
-    -> std::vector<MateHashAndLocation> {
-  // Descending comparator: higher chrom index first,
-  // then higher start position within the same chrom.
-  static auto const COMPARE_DESCENDING = [](MateHashAndLocation const& lhs,
-                                            MateHashAndLocation const& rhs) -> bool {
-    if (lhs.second.mChromIndex != rhs.second.mChromIndex) {
-      return lhs.second.mChromIndex > rhs.second.mChromIndex;
-    }
-    return lhs.second.mMateStartPos0 > rhs.second.mMateStartPos0;
+auto ReadCollector::MakeMateRegionSpecs(MateRegionsMap const& mates, hts::Extractor const& ext)
+    -> std::vector<std::string> {
+  std::vector<hts::MateInfo> locations;
+  locations.reserve(mates.size());
+  std::ranges::transform(mates, std::back_inserter(locations),
+                         [](auto const& entry) -> hts::MateInfo { return entry.second; });
+
+  static auto const AS_KEY = [](hts::MateInfo const& info) -> std::pair<i32, i64> {
+    return {info.mChromIndex, info.mMateStartPos0};
   };
-
-  std::vector<MateHashAndLocation> results(data.cbegin(), data.cend());
-  std::ranges::sort(results, COMPARE_DESCENDING);
+  std::ranges::sort(locations, std::less{}, AS_KEY);
+  auto const duplicates = std::ranges::unique(locations, std::equal_to{}, AS_KEY);
+  locations.erase(duplicates.begin(), duplicates.end());
+
+  std::vector<std::string> results;
+  results.reserve(locations.size());
+  std::ranges::transform(locations, std::back_inserter(results),
+                         [&ext](hts::MateInfo const& info) { return MakeRegionSpec(info, &ext); });
   return results;
 }
 
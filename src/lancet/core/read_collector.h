@@ -3,10 +3,14 @@
 
 #include "lancet/base/types.h"
 #include "lancet/cbdg/read.h"
+#include "lancet/cbdg/read_arena.h"
+#include "lancet/cbdg/read_batch.h"
+#include "lancet/core/sample_fanout.h"
 #include "lancet/core/sample_info.h"
 #include "lancet/hts/alignment.h"
 #include "lancet/hts/extractor.h"
 #include "lancet/hts/mate_info.h"
+#include "lancet/hts/record_stream.h"
 #include "lancet/hts/reference.h"
 
 #include "absl/container/flat_hash_map.h"
@@ -16,6 +20,7 @@
 #include <array>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -38,10 +43,20 @@ class ReadCollector {
     /// Forward-facing unified sample input. Each entry is "<path>:<role>"
     /// where role is control or case. If role is omitted, defaults to control.
     std::vector<std::string> mSampleSpecs;            // 8B+
+    /// Shared per-sample read streams, indexed like the sample list (--linear-scan).
+    /// Empty unless PipelineExecutor opened them; windows then read from the streams.
+    std::vector<std::shared_ptr<hts::RecordStream>> mRecordStreams;  // 8B+
+    /// Passing bases per BAI/CSI chunk byte, indexed like the sample list (0 → unknown).
+    /// Filled once by CalibrateIndexDepth before workers start; empty unless
+    /// --skip-extreme-depth, in which case no window is classified EXTREME.
+    std::vector<f64> mBasesPerIndexByte;  // 8B+
     f64 mMaxSampleCov = DEFAULT_MAX_WINDOW_COVERAGE;  // 8B
     // ── 1B Align ────────────────────────────────────────────────────────────
-    bool mNoCtgCheck = false;    // 1B
-    bool mExtractPairs = false;  // 1B
+    bool mNoCtgCheck = false;        // 1B
+    bool mExtractPairs = false;      // 1B
+    bool mSkipExtremeDepth = false;  // 1B
+    bool mParallelSamples = false;   // 1B — one helper thread per extra sample
+    bool mLinearScan = false;        // 1B — stream each sample once (see mRecordStreams)
 
     /// Number of input file paths (NOT unique logical samples).
     /// Unique sample count is determined after sorting by MakeSampleList().
@@ -58,11 +73,36 @@ class ReadCollector {
 
   struct Result {
     // ── 8B Align ────────────────────────────────────────────────────────────
+    cbdg::ReadArena mReadArena;           // 8B+ — owns the bytes mSampleReads view
     std::vector<Read> mSampleReads;       // 8B+
     std::vector<SampleInfo> mSampleList;  // 8B+
+    cbdg::ReadBatch mReadBatch;           // 8B+ — derived encodings, indexed like mSampleReads
   };
 
   [[nodiscard]] auto CollectRegionResult(Region const& region) -> Result;
+
+  /// Index-only depth class of a region, decided before any record is decoded.
+  enum class IndexDepth : u8 {
+    NORMAL = 0,   // collect as usual (also: no BAI/CSI chunks to count, i.e. CRAM)
+    EMPTY = 1,    // no record of any sample overlaps the region
+    EXTREME = 2,  // some sample far above --max-sample-cov (only with --skip-extreme-depth)
+  };
+
+  /// Classifies `region` from the BAI/CSI chunk footprint of each sample. EXTREME
+  /// converts bytes to depth with Params::mBasesPerIndexByte, which is fixed for the
+  /// whole run, so the class of a window never depends on thread count or scheduling.
+  [[nodiscard]] auto EstimateIndexDepth(Region const& region) const -> IndexDepth;
+
+  /// Passing bases per index chunk byte of one alignment file, from the index's
+  /// whole-file mapped records and bytes and the first records of the file.
+  /// std::nullopt when the index has no chunks or counts to use (CRAM).
+  [[nodiscard]] static auto CalibrateIndexDepth(std::filesystem::path const& aln_path,
+                                                std::filesystem::path const& ref_path)
+      -> std::optional<f64>;
+
+  /// EXTREME threshold as a multiple of --max-sample-cov.
+  static constexpr f64 EXTREME_DEPTH_FOLD = 10.0;
+
   [[nodiscard]] auto IsCaseCtrlMode() const noexcept -> bool { return mIsCaseCtrlMode; }
 
   /// Expose cached sample list for IsActiveRegion (per-thread, not shared).
@@ -73,13 +113,16 @@ class ReadCollector {
   /// Expose per-sample extractors for IsActiveRegion (per-thread, not shared).
   [[nodiscard]] auto Extractors() noexcept -> SampleExtractors& { return mExtractors; }
 
+  /// Helper threads that decode samples concurrently, or nullptr when samples
+  /// are read one after another (single sample, or --parallel-samples off).
+  [[nodiscard]] auto Fanout() noexcept -> SampleFanout* { return mFanout.get(); }
+
  private:
   using AlnAndRefPaths = std::array<std::filesystem::path, 2>;
 
   /// Maps qname hash (u64) -> mate location info for out-of-region mate retrieval.
   /// Using u64 hashes instead of std::string keys avoids string copies during Pass 1.
   using MateRegionsMap = absl::flat_hash_map<u64, hts::MateInfo>;
-  using MateHashAndLocation = std::pair<u64, hts::MateInfo>;
 
   /// Pass 1 output: downsampling decisions + mate locations.
   struct ProfileResult {
@@ -90,38 +133,47 @@ class ReadCollector {
   };
 
   // ── 8B Align ────────────────────────────────────────────────────────────
-  Params mParams;                       // 8B+ — immutable construction params
-  SampleExtractors mExtractors;         // 8B+ — per-sample HTSlib extractors
-  std::vector<SampleInfo> mSampleList;  // 8B+ — sorted sample metadata
-  std::vector<Read> mSampledReads;      // 8B+ — reusable per-region accumulator
-  u64 mSampledBaseCount = 0;            // 8B  — tracks bases across Pass 2 + 3
+  Params mParams;                                          // 8B+ — immutable construction params
+  SampleExtractors mExtractors;                            // 8B+ — per-sample HTSlib extractors
+  std::vector<SampleInfo> mSampleList;                     // 8B+ — sorted sample metadata
+  std::vector<std::vector<Read>> mSampleReads;             // 8B+ — per-sample Pass 2 + 3 reads
+  std::vector<cbdg::ReadArena> mSampleArenas;              // 8B+ — bytes those reads view
+  std::shared_ptr<cbdg::ReadArena::BlockPool> mArenaPool;  // 8B  — blocks recycled across windows
+  std::unique_ptr<SampleFanout> mFanout;                   // 8B  — null unless mParallelSamples
   // ── 1B Align ────────────────────────────────────────────────────────────
   bool mIsCaseCtrlMode{false};  // 1B
 
   /// Computes a deterministic u64 hash for a query name string_view.
   [[nodiscard]] static auto HashQname(std::string_view qname) -> u64;
 
+  /// Runs Pass 1 → 2 → 3 for one sample into mSampleReads[sample_idx] and its arena.
+  /// Touches only that sample's extractor, metadata and accumulators, so samples may
+  /// run concurrently.
+  void CollectSample(usize sample_idx, std::string const& region_spec, f64 max_sample_bases);
+
   /// Pass 1: zero-copy profiling + deterministic downsampling.
   /// Scans all alignments in the region for a single sample, computing
   /// coverage statistics and selecting which reads survive downsampling.
   [[nodiscard]] auto ProfileAndDownsample(hts::Extractor& extractor, std::string const& region_spec,
                                           f64 max_sample_bases) const -> ProfileResult;
 
-  /// Pass 2: re-iterate region, deep-copy only kept reads into mSampledReads.
-  /// Each read gets tagged with sample metadata (name, index, label).
-  void ExtractKeptReads(hts::Extractor& extractor, std::string const& region_spec,
-                        absl::flat_hash_set<u64> const& keep_qnames, SampleInfo const& sinfo);
+  /// Pass 2: re-iterate region, copy only kept reads into `arena` and `out_reads`.
+  /// Each read gets tagged with sample metadata (index, label).
+  static void ExtractKeptReads(hts::Extractor& extractor, std::string const& region_spec,
+                               absl::flat_hash_set<u64> const& keep_qnames,
+                               SampleInfo const& sinfo, cbdg::ReadArena& arena,
+                               std::vector<Read>& out_reads);
 
   /// Pass 3: fetch out-of-region mates for reads with distant mates.
-  /// Walks mate locations in reverse-sorted genomic order for cache efficiency.
-  void RecaptureMates(hts::Extractor& extractor, absl::flat_hash_set<u64> const& keep_qnames,
-                      MateRegionsMap& expected_mates, SampleInfo const& sinfo);
-
-  /// Sort mate regions in descending genomic order (largest chrom + position first).
-  /// RecaptureMates processes via pop_back(), yielding ascending order for
-  /// sequential BAM/CRAM disk access with O(1) removal per element.
-  [[nodiscard]] static auto ReverseSortMateRegions(MateRegionsMap const& data)
-      -> std::vector<MateHashAndLocation>;
+  /// All mate locations of a sample are read through one multi-region iterator.
+  static void RecaptureMates(hts::Extractor& extractor, absl::flat_hash_set<u64> const& keep_qnames,
+                             MateRegionsMap& expected_mates, SampleInfo const& sinfo,
+                             cbdg::ReadArena& arena, std::vector<Read>& out_reads);
+
+  /// Distinct mate locations as single-base region specs, in ascending genomic order.
+  [[nodiscard]] static auto MakeMateRegionSpecs(MateRegionsMap const& mates,
+                                                hts::Extractor const& ext)
+      -> std::vector<std::string>;
 
   [[nodiscard]] static auto MakeRegionSpec(hts::MateInfo const& info, hts::Extractor const* ext)
       -> std::string;
@@ -0,0 +1,88 @@
+#include "lancet/core/sample_fanout.h"
+
+#include "lancet/base/types.h"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace lancet::core {
+
+SampleFanout::SampleFanout(usize const num_helpers) {
+  mHelpers.reserve(num_helpers);
+  for (usize idx = 0; idx < num_helpers; ++idx) {
+    mHelpers.emplace_back([this](std::stop_token stop_token) { HelperLoop(stop_token); });
+  }
+}
+
+SampleFanout::~SampleFanout() {
+  for (auto& helper : mHelpers) helper.request_stop();
+  for (auto& helper : mHelpers) helper.join();
+}
+
+// ============================================================================
+// Run — hand out tasks 1..N-1, run task 0 inline, then help drain the queue
+//
+// Tasks the caller steals back are not answered on mResponses, so the caller
+// waits for exactly as many responses as the helpers dequeued. Waiting for all
+// of them before rethrowing matters: every task refers to `task`, which lives
+// on the caller's stack.
+// ============================================================================
+void SampleFanout::Run(usize const num_tasks, Task task) {
+  if (num_tasks == 0) return;
+
+  mCancelled.store(false, std::memory_order_relaxed);
+  for (usize idx = 1; idx < num_tasks; ++idx) {
+    mRequests.enqueue(Request{.mTask = &task, .mIndex = idx});
+  }
+
+  usize num_pending = num_tasks;
+  std::exception_ptr first_error = Execute(Request{.mTask = &task, .mIndex = 0});
+  num_pending--;
+
+  Request stolen;
+  while (mRequests.try_dequeue(stolen)) {
+    auto error = Execute(stolen);
+    if (!first_error) first_error = std::move(error);
+    num_pending--;
+  }
+
+  std::exception_ptr error;
+  for (; num_pending > 0; --num_pending) {
+    mResponses.wait_dequeue(error);
+    if (!first_error) first_error = std::move(error);
+  }
+
+  if (first_error) std::rethrow_exception(first_error);
+}
+
+auto SampleFanout::Execute(Request const& request) -> std::exception_ptr {
+  if (mCancelled.load(std::memory_order_relaxed)) return nullptr;
+  try {
+    (*request.mTask)(request.mIndex);
+  } catch (...) {
+    mCancelled.store(true, std::memory_order_relaxed);
+    return std::current_exception();
+  }
+  return nullptr;
+}
+
+// ============================================================================
+// HelperLoop — same timed-dequeue shape as WindowPrefetcher::Run. Helpers do
+// not claim crash slots: a worker can own several of them, and the worker's
+// own slot already names the window whose samples they are decoding.
+// ============================================================================
+void SampleFanout::HelperLoop(std::stop_token const& stop_token) {
+  constexpr auto QUEUE_TIMEOUT = std::chrono::milliseconds(10);
+  Request request;
+
+  while (!stop_token.stop_requested()) {
+    if (!mRequests.wait_dequeue_timed(request, QUEUE_TIMEOUT)) continue;
+    mResponses.enqueue(Execute(request));
+  }
+}
+
+}  // namespace lancet::core
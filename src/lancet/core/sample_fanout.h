@@ -0,0 +1,74 @@
+#ifndef SRC_LANCET_CORE_SAMPLE_FANOUT_H_
+#define SRC_LANCET_CORE_SAMPLE_FANOUT_H_
+
+#include "lancet/base/types.h"
+
+#include "absl/functional/function_ref.h"
+#include "blockingconcurrentqueue.h"
+
+#include <atomic>
+#include <exception>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace lancet::core {
+
+// ============================================================================
+// SampleFanout: runs one task per sample of a window concurrently.
+//
+// Every sample of a window is a separate BAM/CRAM file with its own
+// extractor, so its profile, extract and mate passes share nothing with the
+// other samples until the final priority sort. With N samples, a window's
+// collection costs the sum of N decode latencies when run in a loop; spread
+// over N threads it costs roughly the slowest one:
+//
+//   loop:     [ normal ──────── ][ tumor ──────────── ]
+//   fanout:   [ normal ──────── ]                        (caller thread)
+//             [ tumor ──────────── ]                     (helper thread)
+//
+// A fanout owns N − 1 helper threads; the calling thread runs task 0 and then
+// steals any task no helper has picked up yet. Run() returns only after every
+// task finished, and rethrows the first exception a task raised. Once a task
+// has thrown, tasks that have not started yet are skipped; the window fails
+// either way, so there is no point decoding the other samples.
+// ============================================================================
+class SampleFanout {
+ public:
+  using Task = absl::FunctionRef<void(usize)>;
+
+  explicit SampleFanout(usize num_helpers);
+  ~SampleFanout();
+
+  SampleFanout(SampleFanout const&) = delete;
+  SampleFanout(SampleFanout&&) = delete;
+  auto operator=(SampleFanout const&) -> SampleFanout& = delete;
+  auto operator=(SampleFanout&&) -> SampleFanout& = delete;
+
+  /// Calls task(idx) for every idx in [0, num_tasks) and blocks until all return.
+  /// After a task throws, tasks not yet started are skipped and the error is rethrown.
+  /// Not reentrant: one Run() at a time per fanout.
+  void Run(usize num_tasks, Task task);
+
+ private:
+  struct Request {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    Task const* mTask = nullptr;
+    usize mIndex = 0;
+  };
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  moodycamel::BlockingConcurrentQueue<Request> mRequests;
+  moodycamel::BlockingConcurrentQueue<std::exception_ptr> mResponses;
+  // ── 1B Align ────────────────────────────────────────────────────────────
+  std::atomic<bool> mCancelled = false;  // a task of the current Run() has thrown
+  std::vector<std::jthread> mHelpers;  // declared last: started after every other member exists
+
+  void HelperLoop(std::stop_token const& stop_token);
+
+  [[nodiscard]] auto Execute(Request const& request) -> std::exception_ptr;
+};
+
+}  // namespace lancet::core
+
+#endif  // SRC_LANCET_CORE_SAMPLE_FANOUT_H_
@@ -1,5 +1,6 @@
 #include "lancet/core/variant_annotator.h"
 
+#include "lancet/base/sequence_complexity.h"
 #include "lancet/base/types.h"
 #include "lancet/caller/alt_allele.h"
 #include "lancet/caller/raw_variant.h"
@@ -11,6 +12,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -39,17 +41,34 @@ VariantAnnotator::VariantAnnotator(f64 gc_frac) : mSeqCxScorer(gc_frac) {}
 //
 // If a variant only exists on the REF haplotype (no ALT haps), we score
 // REF vs REF to populate context features (deltas will be zero).
+//
+// Shared work: each haplotype that carries a variant gets one HaplotypeProfile
+// (full-haplotype LongdustQ, sliding ±50bp LongdustQ window), so the k=7
+// haplotype score is computed once per component. The REF context of a variant
+// is scored once, not once per ALT haplotype. Scores are identical to calling
+// Score() per haplotype.
 // ============================================================================
 void VariantAnnotator::AnnotateSequenceComplexity(
     caller::VariantSet const& vset, absl::Span<std::string_view const> haplotypes) const {
   static constexpr usize REF_HAP_IDX = 0;
+  if (vset.IsEmpty() || REF_HAP_IDX >= haplotypes.size()) return;
+
+  std::vector<std::optional<base::HaplotypeProfile>> profiles(haplotypes.size());
+  auto const profile_of = [&profiles, &haplotypes](usize hap_idx) -> base::HaplotypeProfile const* {
+    if (!profiles[hap_idx].has_value()) profiles[hap_idx].emplace(haplotypes[hap_idx]);
+    return &*profiles[hap_idx];
+  };
 
   for (auto const& var : vset) {
     auto const ref_pos = var.mLocalRefStart0Idx;
-    if (ref_pos == std::numeric_limits<usize>::max() || REF_HAP_IDX >= haplotypes.size()) continue;
+    if (ref_pos == std::numeric_limits<usize>::max()) continue;
 
-    auto const& ref_hap = haplotypes[REF_HAP_IDX];
     auto const ref_len = var.mRefAllele.size();
+    base::HapRegion const ref_region{.mHaplotype = haplotypes[REF_HAP_IDX],
+                                     .mPos = ref_pos,
+                                     .mLen = ref_len,
+                                     .mProfile = profile_of(REF_HAP_IDX)};
+    auto const ref_context = mSeqCxScorer.ScoreRefContext(ref_region);
 
     bool scored_any_alt = false;
 
@@ -61,19 +80,18 @@ void VariantAnnotator::AnnotateSequenceComplexity(
       for (auto const& [hap_idx, hap_pos] : alt.mLocalHapStart0Idxs) {
         if (hap_idx >= haplotypes.size() || hap_idx == REF_HAP_IDX) continue;
 
-        auto cplx = mSeqCxScorer.Score(
-            {.mHaplotype = ref_hap, .mPos = ref_pos, .mLen = ref_len},
-            {.mHaplotype = haplotypes[hap_idx], .mPos = hap_pos, .mLen = alt_len});
-
-        var.mSeqCx.MergeMax(cplx);
+        base::HapRegion const alt_region{.mHaplotype = haplotypes[hap_idx],
+                                         .mPos = hap_pos,
+                                         .mLen = alt_len,
+                                         .mProfile = profile_of(hap_idx)};
+        var.mSeqCx.MergeMax(mSeqCxScorer.ScoreWithContext(ref_context, ref_region, alt_region));
         scored_any_alt = true;
       }
     }
 
     // If no ALT haplotypes found, score REF vs REF to populate context features
     if (!scored_any_alt) {
-      var.mSeqCx = mSeqCxScorer.Score({.mHaplotype = ref_hap, .mPos = ref_pos, .mLen = ref_len},
-                                      {.mHaplotype = ref_hap, .mPos = ref_pos, .mLen = ref_len});
+      var.mSeqCx = mSeqCxScorer.ScoreWithContext(ref_context, ref_region, ref_region);
     }
   }
 }
@@ -30,6 +30,8 @@ class VariantAnnotator {
   /// Annotate all variants in `vset` with 11-feature sequence complexity.
   /// Scores each variant against REF and ALT haplotypes, merging across
   /// multiple ALT haplotypes via element-wise max (pessimistic worst-case).
+  /// LongdustQ scores come from one base::HaplotypeProfile per haplotype, built
+  /// on first use and shared by every variant in the set.
   void AnnotateSequenceComplexity(caller::VariantSet const& vset,
                                   absl::Span<std::string_view const> haplotypes) const;
 
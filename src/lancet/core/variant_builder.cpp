@@ -24,6 +24,7 @@
 #include <filesystem>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -38,9 +39,8 @@ namespace {
 // HasAltSupport: true if any sample has > 0 ALT-supporting reads.
 // ============================================================================
 auto HasAltSupport(caller::SupportArray const& evidence) -> bool {
-  return std::ranges::any_of(evidence, [](auto const& item) -> bool {
-    return item.mData && item.mData->TotalAltCov() > 0;
-  });
+  return std::ranges::any_of(
+      evidence, [](auto const& support) -> bool { return support.TotalAltCov() > 0; });
 }
 
 // ============================================================================
@@ -74,6 +74,7 @@ void SerializeSpoaState(caller::MsaBuilder& state, Window const& window, u32 com
 VariantBuilder::VariantBuilder(ParamsPtr params, u32 window_len, u32 worker_id)
     : mDebruijnGraph(params->mGraphParams),
       mReadCollector(params->mRdCollParams, absl::MakeConstSpan(params->mSampleList)),
+      mGenotyper(params->mGenotypingBackend),
       mParamsPtr(std::move(params)),
       mSpoaState(lancet::caller::MsaBuilder()),
       mAnnotator(mParamsPtr->mGcFraction) {
@@ -102,38 +103,50 @@ VariantBuilder::VariantBuilder(ParamsPtr params, u32 window_len, u32 worker_id)
 }
 
 // ============================================================================
-// ShouldSkipWindow: pre-read guard checks for N-only, repeat, and inactive.
+// PreReadSkipCode: pre-read guard checks for N-only, repeat, index depth and
+// inactive. Returns UNKNOWN when the window passes every guard. The index
+// depth check runs before IsActiveRegion because it needs no record decoding.
 // ============================================================================
-auto VariantBuilder::ShouldSkipWindow(Window const& window) -> bool {
+auto VariantBuilder::PreReadSkipCode(Window const& window) -> StatusCode {
   auto const region_string = window.AsRegionPtr()->ToSamtoolsRegion();
 
   if (std::ranges::all_of(window.SeqView(), [](char base) { return base == 'N'; })) {
     LOG_DEBUG("Skipping window {} as reference contains only N bases", region_string)
-    mCurrentCode = StatusCode::SKIPPED_NONLY_REF_BASES;
-    return true;
+    return StatusCode::SKIPPED_NONLY_REF_BASES;
   }
 
   auto const max_k = mParamsPtr->mGraphParams.mMaxKmerLen;
   if (lancet::base::HasExactRepeat(lancet::base::SlidingView(window.SeqView(), max_k))) {
     LOG_DEBUG("Skipping window {} as reference contains {}-mer repeats", region_string, max_k)
-    mCurrentCode = StatusCode::SKIPPED_REF_REPEAT_SEEN;
-    return true;
+    return StatusCode::SKIPPED_REF_REPEAT_SEEN;
+  }
+
+  using IndexDepth = ReadCollector::IndexDepth;
+  auto const index_depth = mReadCollector.EstimateIndexDepth(*window.AsRegionPtr());
+  if (index_depth == IndexDepth::EMPTY && mParamsPtr->mGraphParams.mMinAnchorCov > 0) {
+    LOG_DEBUG("Skipping window {} as no sample has indexed reads overlapping it", region_string)
+    return StatusCode::SKIPPED_ANCHOR_COVERAGE;
+  }
+  if (index_depth == IndexDepth::EXTREME) {
+    LOG_DEBUG("Skipping window {} as index-estimated depth exceeds {}x max. sample coverage",
+              region_string, ReadCollector::EXTREME_DEPTH_FOLD)
+    return StatusCode::SKIPPED_EXTREME_COVERAGE;
   }
 
   if (!mParamsPtr->mSkipActiveRegion &&
       !core::IsActiveRegion(mReadCollector.SampleList(), mReadCollector.Extractors(),
-                            *window.AsRegionPtr())) {
+                            *window.AsRegionPtr(), mReadCollector.Fanout())) {
     LOG_DEBUG("Skipping window {} as it has no evidence of mutation in any sample", region_string)
-    mCurrentCode = StatusCode::SKIPPED_INACTIVE_REGION;
-    return true;
+    return StatusCode::SKIPPED_INACTIVE_REGION;
   }
 
-  return false;
+  return StatusCode::UNKNOWN;
 }
 
 // ============================================================================
-// ExtractVariants: build MSA from component haplotypes, extract variants
-// from the alignment graph, and annotate complexity + path metrics.
+// ExtractVariants: build MSA from component haplotypes (or take one of the
+// POA-free VariantSet::FromSimplePair / FromWalkBubbles paths), extract
+// variants from the alignment graph, and annotate complexity + path metrics.
 //
 // Uses ComponentResult's zero-copy HaplotypeSequenceViews() for SPOA/scorer
 // and pre-computed MaxAltPathCv()/NumPaths() for path metric annotation.
@@ -146,15 +159,38 @@ auto VariantBuilder::ExtractVariants(cbdg::ComponentResult const& component,
   auto const hap_views = component.HaplotypeSequenceViews();
   auto const weights = component.HaplotypeWeights();
 
-  LOG_DEBUG("Building MSA for graph component {} from window {} with {} assembled haplotypes",
-            component_id, region_string, component.NumPaths())
+  // REF + one ALT differing by a lone SNV or unambiguous indel has a single optimal
+  // alignment, so its variant is read off the pair directly and SPOA is skipped.
+  // --variant-extraction walk reads every bubble off the de Bruijn walks instead.
+  // Graph shards need the POA graph, so --out-graphs-tgz always takes the SPOA path.
+  std::optional<caller::VariantSet> simple_vset;
+  if (mGraphShardWriter == nullptr) {
+    simple_vset = mParamsPtr->mVariantExtraction == caller::VariantExtractionMode::WALK
+                      ? caller::VariantSet::FromWalkBubbles(component.Paths(),
+                                                            component.KmerLength(), window,
+                                                            ref_anchor_pos1)
+                      : caller::VariantSet::FromSimplePair(absl::MakeConstSpan(hap_views),
+                                                           window, ref_anchor_pos1);
+  }
+
+  if (!simple_vset.has_value()) {
+    LOG_DEBUG("Building MSA for graph component {} from window {} with {} assembled haplotypes",
+              component_id, region_string, component.NumPaths())
 
-  mSpoaState.UpdateSpoaState(absl::MakeConstSpan(hap_views), absl::MakeConstSpan(weights));
-  if (mGraphShardWriter) {
-    SerializeSpoaState(mSpoaState, window, component_id, *mGraphShardWriter);
+    // POA runs only over the divergent core; shards keep the full-length MSA.
+    auto const flanks = mGraphShardWriter ? caller::MsaFlanks::FULL : caller::MsaFlanks::CLIPPED;
+    mSpoaState.UpdateSpoaState(absl::MakeConstSpan(hap_views), absl::MakeConstSpan(weights),
+                               flanks);
+    if (mGraphShardWriter) {
+      SerializeSpoaState(mSpoaState, window, component_id, *mGraphShardWriter);
+    }
   }
 
-  caller::VariantSet vset(mSpoaState.mGraph, window, ref_anchor_pos1);
+  auto const clipped = mSpoaState.mClippedPrefixLen;
+  auto vset = simple_vset.has_value()
+                  ? *std::move(simple_vset)
+                  : caller::VariantSet(mSpoaState.mGraph, window, ref_anchor_pos1 + clipped,
+                                       clipped);
 
   mAnnotator.AnnotateSequenceComplexity(vset, absl::MakeConstSpan(hap_views));
   VariantAnnotator::AnnotateGraphComplexity(vset, component.Metrics());
@@ -198,22 +234,50 @@ void VariantBuilder::CollectSupportedCalls(caller::VariantSet const& extracted,
   }
 }
 
+// ============================================================================
+// LoadWindowInput: Phases 1–2 — every BAM/CRAM access a window needs.
+//
+// Reads only mReadCollector and the immutable params, so it may run on a
+// helper thread for the next window while ProcessWindow(window, input) runs
+// phases 3–4 of the current one (see WindowPrefetcher). Two LoadWindowInput
+// calls on the same builder must never overlap.
+// ============================================================================
+auto VariantBuilder::LoadWindowInput(Window const& window) -> WindowInput {
+  WindowInput input;
+
+  // Phase 1: Pre-read qualification — N-only, repeat k-mers, active region
+  input.mSkipCode = PreReadSkipCode(window);
+  if (input.mSkipCode != StatusCode::UNKNOWN) return input;
+
+  // Phase 2: Read collection
+  LOG_DEBUG("Collecting all available sample reads for window {}",
+            window.AsRegionPtr()->ToSamtoolsRegion())
+  input.mReads = mReadCollector.CollectRegionResult(*window.AsRegionPtr());
+  return input;
+}
+
 auto VariantBuilder::ProcessWindow(std::shared_ptr<Window const> const& window) -> WindowResults {
-  auto const region = window->AsRegionPtr();
-  auto const region_string = region->ToSamtoolsRegion();
+  return ProcessWindow(window, LoadWindowInput(*window));
+}
+
+auto VariantBuilder::ProcessWindow(std::shared_ptr<Window const> const& window,
+                                   WindowInput const& input) -> WindowResults {
+  auto const region_string = window->AsRegionPtr()->ToSamtoolsRegion();
 
   static thread_local auto const CURRENT_TID = std::this_thread::get_id();
   static thread_local auto const THREAD_ID = absl::Hash<std::thread::id>()(CURRENT_TID);
   LOG_DEBUG("Processing window {} in thread {:#x}", region_string, THREAD_ID)
 
-  // Phase 1: Pre-read qualification — N-only, repeat k-mers, active region
-  if (ShouldSkipWindow(*window)) return {};
+  if (input.mSkipCode != StatusCode::UNKNOWN) {
+    mCurrentCode = input.mSkipCode;
+    return {};
+  }
 
-  // Phase 2: Read collection and depth qualification
-  LOG_DEBUG("Collecting all available sample reads for window {}", region_string)
-  auto const rc_result = mReadCollector.CollectRegionResult(*region);
+  // Phase 2 (cont.): depth qualification on the collected reads
+  auto const& rc_result = input.mReads;
   auto const reads = absl::MakeConstSpan(rc_result.mSampleReads);
   auto const samples = absl::MakeConstSpan(rc_result.mSampleList);
+  auto const& read_batch = rc_result.mReadBatch;
 
   auto const cross_sample_cov = SampleInfo::CrossSampleMeanCoverage(samples, window->Length());
   if (cross_sample_cov < static_cast<f64>(mParamsPtr->mGraphParams.mMinAnchorCov)) {
@@ -226,7 +290,8 @@ auto VariantBuilder::ProcessWindow(std::shared_ptr<Window const> const& window)
   // Phase 3: de Bruijn graph assembly and haplotype enumeration
   LOG_DEBUG("Building graph for {} with {} extracted sample reads and {:.2f}x total coverage",
             region_string, reads.size(), cross_sample_cov)
-  auto const components = mDebruijnGraph.BuildComponentResults(window->AsRegionPtr(), reads);
+  auto const components =
+      mDebruijnGraph.BuildComponentResults(window->AsRegionPtr(), reads, read_batch);
 
   auto const num_assembled_haps = std::accumulate(
       components.cbegin(), components.cend(), u64{0},
@@ -256,7 +321,7 @@ auto VariantBuilder::ProcessWindow(std::shared_ptr<Window const> const& window)
     // HaplotypeSequences() allocates — only called when variants exist.
     // Genotyper's minimap2 requires null-terminated c_str() pointers.
     auto const hap_seqs = component.HaplotypeSequences();
-    auto geno_result = mGenotyper.Genotype(hap_seqs, reads, extracted);
+    auto geno_result = mGenotyper.Genotype(hap_seqs, reads, read_batch, extracted);
     mProbeDiagnostics.CheckGenotyperResult(geno_result, extracted);
     CollectSupportedCalls(extracted, geno_result, samples, window->Length(), variant_calls);
   }
@@ -287,6 +352,8 @@ auto ToString(VariantBuilder::StatusCode const status_code) -> std::string {
       return "SKIPPED_INACTIVE_REGION";
     case SKIPPED_ANCHOR_COVERAGE:
       return "SKIPPED_ANCHOR_COVERAGE";
+    case SKIPPED_EXTREME_COVERAGE:
+      return "SKIPPED_EXTREME_COVERAGE";
     case SKIPPED_NOASM_HAPLOTYPE:
       return "SKIPPED_NOASM_HAPLOTYPE";
     case MISSING_NO_MSA_VARIANTS:
@@ -61,6 +61,12 @@ class VariantBuilder {
 
     // ── 1B Align ────────────────────────────────────────────────────────────
     bool mSkipActiveRegion = false;
+    /// Collect the next window's reads on one extra thread per worker. See --read-prefetch.
+    bool mReadPrefetch = false;
+    /// Read-to-allele assignment evidence. See --genotyper-backend CLI parameter.
+    caller::GenotypingBackend mGenotypingBackend = caller::GenotypingBackend::MINIMAP2;
+    /// ALT allele extraction from assembled paths. See --variant-extraction CLI parameter.
+    caller::VariantExtractionMode mVariantExtraction = caller::VariantExtractionMode::MSA;
   };
 
   /// `worker_index` is assigned by PipelineExecutor when constructing the worker pool
@@ -77,15 +83,33 @@ class VariantBuilder {
     SKIPPED_REF_REPEAT_SEEN = 2,
     SKIPPED_INACTIVE_REGION = 3,
     SKIPPED_ANCHOR_COVERAGE = 4,
-    SKIPPED_NOASM_HAPLOTYPE = 5,
-    MISSING_NO_MSA_VARIANTS = 6,
-    FOUND_GENOTYPED_VARIANT = 7
+    SKIPPED_EXTREME_COVERAGE = 5,
+    SKIPPED_NOASM_HAPLOTYPE = 6,
+    MISSING_NO_MSA_VARIANTS = 7,
+    FOUND_GENOTYPED_VARIANT = 8
   };
 
   [[nodiscard]] auto CurrentStatus() const noexcept -> StatusCode { return mCurrentCode; }
 
+  /// Everything a window needs from the alignment files: the pre-read skip verdict,
+  /// or the collected reads when the window passed every pre-read guard.
+  struct WindowInput {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    ReadCollector::Result mReads;
+    // ── 1B Align ──────────────────────────────────────────────────────────
+    StatusCode mSkipCode = StatusCode::UNKNOWN;  // UNKNOWN → not skipped
+  };
+
+  /// Phases 1–2 (pre-read guards + read collection). Touches only the read collector,
+  /// never the assembly state, so it may overlap ProcessWindow(window, input) for a
+  /// different window. Calls must not overlap each other.
+  [[nodiscard]] auto LoadWindowInput(Window const& window) -> WindowInput;
+
   using WindowResults = std::vector<std::unique_ptr<caller::VariantCall>>;
   [[nodiscard]] auto ProcessWindow(std::shared_ptr<Window const> const& window) -> WindowResults;
+  /// Phases 3–4 on an input produced by LoadWindowInput for the same window.
+  [[nodiscard]] auto ProcessWindow(std::shared_ptr<Window const> const& window,
+                                   WindowInput const& input) -> WindowResults;
 
  private:
   // ── 8B Align ────────────────────────────────────────────────────────────
@@ -113,7 +137,7 @@ class VariantBuilder {
   StatusCode mCurrentCode = StatusCode::UNKNOWN;
 
   // ── ProcessWindow helpers ───────────────────────────────────────────────
-  [[nodiscard]] auto ShouldSkipWindow(Window const& window) -> bool;
+  [[nodiscard]] auto PreReadSkipCode(Window const& window) -> StatusCode;
 
   [[nodiscard]] auto ExtractVariants(cbdg::ComponentResult const& component, usize component_id,
                                      Window const& window) -> caller::VariantSet;
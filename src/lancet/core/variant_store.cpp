@@ -1,17 +1,14 @@
 #include "lancet/core/variant_store.h"
 
-#include "lancet/base/logging.h"
 #include "lancet/base/types.h"
 #include "lancet/caller/alt_allele.h"
 #include "lancet/caller/raw_variant.h"
 #include "lancet/core/window.h"
 
-#include "absl/hash/hash.h"
 #include "absl/synchronization/mutex.h"
-#include "spdlog/fmt/bundled/ostream.h"
 
 #include <algorithm>
-#include <ostream>
+#include <iterator>
 #include <utility>
 #include <vector>
 
@@ -20,17 +17,17 @@ namespace lancet::core {
 void VariantStore::AddVariants(std::vector<Value> variants) {
   if (variants.empty()) return;
 
+  // One lock per window batch: a window yields a handful of calls, so the
+  // critical section is a few B-tree point operations.
+  absl::MutexLock const lock(mMutex);
   for (auto&& curr : variants) {
-    auto const identifier = curr->Identifier();
-    usize const shard_idx = absl::Hash<Key>()(identifier) & (NUM_SHARDS - 1);
+    Key const key{.mChromIndex = curr->ChromIndex(),
+                  .mStartPos1 = curr->StartPos1(),
+                  .mId = curr->Identifier()};
 
-    // Independent lock specifically for this shard
-    absl::MutexLock const lock(mBuckets[shard_idx].mMutex);
-    auto& map = mBuckets[shard_idx].mData;
-
-    auto prev = map.find(identifier);
-    if (prev == map.end()) {
-      map.emplace(identifier, std::move(curr));
+    auto [prev, inserted] = mData.try_emplace(key, nullptr);
+    if (inserted) {
+      prev->second = std::move(curr);
       continue;
     }
 
@@ -43,81 +40,69 @@ void VariantStore::AddVariants(std::vector<Value> variants) {
   }
 }
 
-void VariantStore::FlushVariantsBeforeWindow(Window const& win, std::ostream& out) {
-  std::vector<Value> variants_to_write;
-
-  // Extract variants from each bucket completely independently
-  for (auto& bucket : mBuckets) {
-    absl::MutexLock const lock(bucket.mMutex);
-
-    std::vector<Key> keys_to_extract;
-    for (auto const& item : bucket.mData) {
-      auto const& var_ptr = item.second;
-      auto const is_before_window = var_ptr->ChromIndex() != win.ChromIndex()
-                                        ? var_ptr->ChromIndex() < win.ChromIndex()
-                                        : var_ptr->StartPos1() < win.EndPos1();
-      if (is_before_window) keys_to_extract.emplace_back(item.first);
-    }
-
-    using caller::AlleleType::REF;
-    static auto const HAS_NO_SUPPORT = [](Value const& item) -> bool {
-      return !item->HasAltSupport() ||
-             std::ranges::all_of(item->Categories(), [](auto call) -> bool { return call == REF; });
-    };
+auto VariantStore::ExtractVariantsBeforeWindow(Window const& win) -> std::vector<Value> {
+  std::vector<Value> extracted;
 
-    for (auto const& key : keys_to_extract) {
-      auto handle = bucket.mData.extract(key);
-      if (handle.empty() || HAS_NO_SUPPORT(handle.mapped())) continue;
-      variants_to_write.emplace_back(std::move(handle.mapped()));
-    }
+  {
+    absl::MutexLock const lock(mMutex);
+    // Everything strictly before (win.ChromIndex, win.EndPos1) — the smallest
+    // key at that position has VariantID 0, so lower_bound is the watermark.
+    Key const watermark{.mChromIndex = win.ChromIndex(), .mStartPos1 = win.EndPos1(), .mId = 0};
+    ExtractPrefix(mData.lower_bound(watermark), extracted);
   }
 
-  FlushExtractedVariants(variants_to_write, out);
+  SortSamePositionRuns(extracted);
+  return extracted;
 }
 
-void VariantStore::FlushAllVariantsInStore(std::ostream& out) {
-  std::vector<Value> variants_to_write;
-
-  for (auto& bucket : mBuckets) {
-    absl::MutexLock const lock(bucket.mMutex);
+auto VariantStore::ExtractAllVariants() -> std::vector<Value> {
+  std::vector<Value> extracted;
 
-    using caller::AlleleType::REF;
-    static auto const HAS_NO_SUPPORT = [](Value const& item) -> bool {
-      return !item->HasAltSupport() ||
-             std::ranges::all_of(item->Categories(), [](auto call) -> bool { return call == REF; });
-    };
+  {
+    absl::MutexLock const lock(mMutex);
+    ExtractPrefix(mData.end(), extracted);
+  }
 
-    for (auto& item : bucket.mData) {
-      if (HAS_NO_SUPPORT(item.second)) continue;
-      variants_to_write.emplace_back(std::move(item.second));
-    }
+  SortSamePositionRuns(extracted);
+  return extracted;
+}
 
-    bucket.mData.clear();
+void VariantStore::ExtractPrefix(absl::btree_map<Key, Value>::iterator end,
+                                 std::vector<Value>& out) {
+  using caller::AlleleType::REF;
+  static auto const HAS_NO_SUPPORT = [](Value const& item) -> bool {
+    return !item->HasAltSupport() ||
+           std::ranges::all_of(item->Categories(), [](auto call) -> bool { return call == REF; });
+  };
+
+  for (auto itr = mData.begin(); itr != end; ++itr) {
+    if (HAS_NO_SUPPORT(itr->second)) continue;
+    out.emplace_back(std::move(itr->second));
   }
 
-  FlushExtractedVariants(variants_to_write, out);
+  mData.erase(mData.begin(), end);
 }
 
-void VariantStore::FlushExtractedVariants(std::vector<Value>& variants_to_write,
-                                          std::ostream& out) {
-  // Sort by genomic position (CHROM, POS) so VCF output is coordinate-ordered.
-  // libc++ stdlib false positive: introsort partition's `__pivot(__iter_move(__first))`
-  // resets a unique_ptr slot to null, but libc++ always swaps a valid object back
-  // into the slot before any comparator call — the comparator never sees null.
-  // NOLINTBEGIN(clang-analyzer-cplusplus.Move)
-  std::ranges::sort(variants_to_write,
-                    [](Value const& lhs, Value const& rhs) -> bool { return *lhs < *rhs; });
-  // NOLINTEND(clang-analyzer-cplusplus.Move)
-
-  // Write sorted records to the output stream
-  std::ranges::for_each(variants_to_write, [&out](Value const& item) {
-    fmt::print(out, "{}\n", item->AsVcfRecord());
-  });
-
-  if (!variants_to_write.empty()) {
-    out.flush();
-    LOG_DEBUG("Flushed {} variant(s) from VariantStore to output VCF file",
-              variants_to_write.size())
+void VariantStore::SortSamePositionRuns(std::vector<Value>& variants) {
+  // Calls arrive in (CHROM, POS, VariantID) order from the B-tree. Only calls that
+  // share a POS (different REF at one locus) still need ordering by operator<,
+  // so each equal-(CHROM, POS) run is sorted in place — almost always length 1.
+  auto run_begin = variants.begin();
+  while (run_begin != variants.end()) {
+    auto const run_end = std::find_if(run_begin, variants.end(), [&](Value const& item) {
+      return item->ChromIndex() != (*run_begin)->ChromIndex() ||
+             item->StartPos1() != (*run_begin)->StartPos1();
+    });
+    // libc++ stdlib false positive: introsort partition's `__pivot(__iter_move(__first))`
+    // resets a unique_ptr slot to null, but libc++ always swaps a valid object back
+    // into the slot before any comparator call — the comparator never sees null.
+    // NOLINTBEGIN(clang-analyzer-cplusplus.Move)
+    if (std::distance(run_begin, run_end) > 1) {
+      std::sort(run_begin, run_end,
+                [](Value const& lhs, Value const& rhs) -> bool { return *lhs < *rhs; });
+    }
+    // NOLINTEND(clang-analyzer-cplusplus.Move)
+    run_begin = run_end;
   }
 }
 
@@ -6,40 +6,63 @@
 #include "lancet/core/window.h"
 
 #include "absl/base/thread_annotations.h"
-#include "absl/container/flat_hash_map.h"
+#include "absl/container/btree_map.h"
 #include "absl/synchronization/mutex.h"
 
-#include <array>
-#include <iosfwd>
+#include <compare>
 #include <memory>
-#include <utility>
 #include <vector>
 
 namespace lancet::core {
 
+// ============================================================================
+// VariantStore: genome-ordered staging area between workers and the VCF.
+//
+// Workers add each window's calls concurrently; the main thread periodically
+// extracts every call that lies before a watermark window and hands the
+// batch to VcfWriter. Calls are keyed by
+// (chrom index, POS, VariantID) in a B-tree, so:
+//
+//   Dedup   VariantID hashes CHROM+POS+REF, so two calls with the same ID
+//           also share the (chrom, POS) prefix and land on the same key —
+//           a duplicate is a point lookup, and the higher-coverage call wins.
+//   Flush   the records before the watermark are exactly the prefix
+//           [begin, lower_bound(watermark)) — already in coordinate order.
+//           Flushing costs O(flushed · log n), independent of how many calls
+//           are still buffered behind the watermark.
+// ============================================================================
 class VariantStore {
  public:
-  using Key = caller::VariantID;
   using Value = std::unique_ptr<caller::VariantCall>;
-  using Item = std::pair<Key const, Value>;
 
   VariantStore() = default;
 
   void AddVariants(std::vector<Value> variants);
-  void FlushVariantsBeforeWindow(Window const& win, std::ostream& out);
-  void FlushAllVariantsInStore(std::ostream& out);
+
+  /// Removes and returns the supported calls before `win`, coordinate-sorted.
+  [[nodiscard]] auto ExtractVariantsBeforeWindow(Window const& win) -> std::vector<Value>;
+  /// Removes and returns every remaining supported call, coordinate-sorted.
+  [[nodiscard]] auto ExtractAllVariants() -> std::vector<Value>;
 
  private:
-  // ── 8B Align ────────────────────────────────────────────────────────────
-  struct alignas(64) VariantBucket {
-    mutable absl::Mutex mMutex;
-    absl::flat_hash_map<Key, Value> mData ABSL_GUARDED_BY(mMutex);
+  struct Key {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    usize mChromIndex = 0;
+    usize mStartPos1 = 0;
+    caller::VariantID mId = 0;
+
+    auto operator<=>(Key const& other) const -> std::strong_ordering = default;
   };
 
-  static constexpr usize NUM_SHARDS = 256;
-  std::array<VariantBucket, NUM_SHARDS> mBuckets;
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  mutable absl::Mutex mMutex;
+  absl::btree_map<Key, Value> mData ABSL_GUARDED_BY(mMutex);
+
+  /// Moves the calls in [mData.begin(), end) that carry ALT support into `out`.
+  void ExtractPrefix(absl::btree_map<Key, Value>::iterator end, std::vector<Value>& out)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mMutex);
 
-  static void FlushExtractedVariants(std::vector<Value>& variants_to_write, std::ostream& out);
+  static void SortSamePositionRuns(std::vector<Value>& variants);
 };
 
 }  // namespace lancet::core
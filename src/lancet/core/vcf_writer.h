@@ -0,0 +1,76 @@
+#ifndef SRC_LANCET_CORE_VCF_WRITER_H_
+#define SRC_LANCET_CORE_VCF_WRITER_H_
+
+#include "lancet/base/types.h"
+#include "lancet/caller/bcf_record_encoder.h"
+#include "lancet/core/variant_store.h"
+#include "lancet/hts/bcf_writer.h"
+#include "lancet/hts/bgzf_ostream.h"
+
+#include "blockingconcurrentqueue.h"
+#include "lightweightsemaphore.h"
+
+#include <memory>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace lancet::core {
+
+// ============================================================================
+// VcfWriter: asynchronous output stage for coordinate-sorted VCF records.
+//
+// The main thread only decides *when* a genome prefix is complete; it extracts
+// the batch from VariantStore and Submit()s it. A dedicated writer thread then
+// either formats each record as text into the BGZF stream (tabix-indexed on
+// the fly) or encodes it as a binary BCF record (CSI-indexed by htslib).
+// Block compression runs on the output's own pool in both cases.
+// Batches are consumed in submission order, so coordinate order is preserved.
+//
+// At most MAX_QUEUED_BATCHES batches wait for the writer thread. Once that many
+// are queued, Submit() blocks until the writer takes one, so a slow disk or
+// object store back-pressures the main thread (and through it the workers)
+// instead of buffering formatted calls without bound.
+//
+// The output stream belongs to the writer thread from construction until
+// Finish() returns; callers must not touch it in between.
+// ============================================================================
+class VcfWriter {
+ public:
+  using Batch = std::vector<VariantStore::Value>;
+  static constexpr usize MAX_QUEUED_BATCHES = 8;
+
+  explicit VcfWriter(hts::BgzfOstream& output);
+  explicit VcfWriter(hts::BcfWriter& output);
+  ~VcfWriter() { Finish(); }
+
+  VcfWriter(VcfWriter const&) = delete;
+  VcfWriter(VcfWriter&&) = delete;
+  auto operator=(VcfWriter const&) -> VcfWriter& = delete;
+  auto operator=(VcfWriter&&) -> VcfWriter& = delete;
+
+  /// Queues a coordinate-sorted batch; empty batches are dropped. Blocks while
+  /// MAX_QUEUED_BATCHES batches are already waiting for the writer thread.
+  void Submit(Batch batch);
+
+  /// Writes every queued batch, then joins the writer thread. Idempotent.
+  void Finish();
+
+ private:
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  moodycamel::BlockingConcurrentQueue<Batch> mQueue;
+  moodycamel::LightweightSemaphore mFreeSlots{MAX_QUEUED_BATCHES};
+  hts::BgzfOstream* mVcfOutput = nullptr;  // exactly one of mVcfOutput / mBcfOutput is set
+  hts::BcfWriter* mBcfOutput = nullptr;
+  std::unique_ptr<caller::BcfRecordEncoder> mBcfEncoder;
+  std::jthread mThread;  // declared last: started after every other member exists
+
+  void Run(std::stop_token const& stop_token);
+  static void WriteVcfBatch(Batch const& batch, hts::BgzfOstream& out);
+  static void WriteBcfBatch(Batch const& batch, hts::BcfWriter& out,
+                            caller::BcfRecordEncoder& encoder);
+};
+
+}  // namespace lancet::core
+
+#endif  // SRC_LANCET_CORE_VCF_WRITER_H_
@@ -283,6 +283,30 @@ auto WindowBuilder::BuildWindowsBatch(usize& region_idx, i64& window_start, usiz
   return batch;
 }
 
+// ============================================================================
+// ScanRegionSpecs: the spans that windows are cut from, for --linear-scan
+// ============================================================================
+auto WindowBuilder::ScanRegionSpecs() const -> std::vector<std::string> {
+  std::vector<std::string> results;
+  results.reserve(mInputRegions.size());
+
+  for (auto region : mInputRegions) {
+    // BuildWindowsBatch skips regions on contigs missing from the reference
+    if (!mRefPtr->FindChromByName(region.mChromName).ok()) continue;
+    PadInputRegion(region);
+
+    // PadInputRegion unconditionally sets both mRegionSpan entries; value_or defaults are
+    // unreachable
+    auto const start = region.mRegionSpan[0].value_or(1);
+    auto const end = region.mRegionSpan[1].value_or(0);
+    auto const chrom_has_colon = region.mChromName.find(':') != std::string::npos;
+    results.push_back(chrom_has_colon ? fmt::format("{{{}}}:{}-{}", region.mChromName, start, end)
+                                      : fmt::format("{}:{}-{}", region.mChromName, start, end));
+  }
+
+  return results;
+}
+
 // ============================================================================
 // PadInputRegion
 // ============================================================================
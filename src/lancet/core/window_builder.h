@@ -66,6 +66,10 @@ class WindowBuilder {
   [[nodiscard]] auto BuildWindowsBatch(usize& region_idx, i64& window_start,
                                        usize& global_idx) const -> std::vector<WindowPtr>;
 
+  /// Returns the padded input regions as samtools region strings, in window emission order.
+  /// Every window lies inside one of them. Requires SortInputRegions() like BuildWindowsBatch().
+  [[nodiscard]] auto ScanRegionSpecs() const -> std::vector<std::string>;
+
   /// Sorts input regions by chromosome index and start position. Must be called before
   /// using BuildWindowsBatch() to ensure sequential emission order.
   void SortInputRegions();
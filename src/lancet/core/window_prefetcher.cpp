@@ -0,0 +1,81 @@
+#include "lancet/core/window_prefetcher.h"
+
+#include "lancet/base/crash_handler.h"
+#include "lancet/base/logging.h"
+#include "lancet/base/types.h"
+#include "lancet/core/variant_builder.h"
+#include "lancet/core/window.h"
+
+#include "absl/hash/hash.h"
+
+#include <chrono>
+#include <exception>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace lancet::core {
+
+WindowPrefetcher::WindowPrefetcher(VariantBuilder& builder)
+    : WindowPrefetcher([&builder](Window const& window) -> VariantBuilder::WindowInput {
+        return builder.LoadWindowInput(window);
+      }) {}
+
+WindowPrefetcher::WindowPrefetcher(Loader load)
+    : mLoad(std::move(load)), mThread([this](std::stop_token stop_token) { Run(stop_token); }) {}
+
+WindowPrefetcher::~WindowPrefetcher() {
+  mThread.request_stop();
+  mThread.join();
+}
+
+void WindowPrefetcher::Submit(WindowPtr window) { mRequests.enqueue(std::move(window)); }
+
+auto WindowPrefetcher::Take() -> VariantBuilder::WindowInput {
+  Loaded loaded;
+  mResponses.wait_dequeue(loaded);
+  if (loaded.mError) std::rethrow_exception(loaded.mError);
+  return std::move(loaded.mInput);
+}
+
+// ============================================================================
+// Run — helper thread loop
+//
+// Same timed-dequeue shape as AsyncWorker::Process. The helper registers its
+// own crash slot, so a signal raised inside htslib while prefetching names
+// the window being loaded rather than the one the worker is assembling.
+// ============================================================================
+void WindowPrefetcher::Run(std::stop_token const& stop_token) {
+  static thread_local auto const THREAD_ID =
+      absl::Hash<std::thread::id>()(std::this_thread::get_id());
+  LOG_DEBUG("Starting WindowPrefetcher thread {:#x}", THREAD_ID)
+
+  auto const crash_slot = lancet::base::RegisterThreadSlot();
+  constexpr auto QUEUE_TIMEOUT = std::chrono::milliseconds(10);
+  usize num_loaded = 0;
+  WindowPtr window_ptr;
+
+  while (!stop_token.stop_requested()) {
+    if (!mRequests.wait_dequeue_timed(window_ptr, QUEUE_TIMEOUT)) continue;
+
+    auto const region_str = window_ptr->ToSamtoolsRegion();
+    lancet::base::SetSlotWindowInfo(crash_slot, window_ptr->GenomeIndex(), region_str.c_str());
+
+    Loaded loaded;
+    try {
+      loaded.mInput = mLoad(*window_ptr);
+    } catch (...) {
+      loaded.mError = std::current_exception();
+    }
+
+    lancet::base::ClearSlotWindowInfo(crash_slot);
+    mResponses.enqueue(std::move(loaded));
+    num_loaded++;
+  }
+
+  lancet::base::UnregisterThreadSlot(crash_slot);
+  LOG_DEBUG("Quitting WindowPrefetcher thread {:#x} after loading {} windows", THREAD_ID,
+            num_loaded)
+}
+
+}  // namespace lancet::core
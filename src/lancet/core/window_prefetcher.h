@@ -0,0 +1,76 @@
+#ifndef SRC_LANCET_CORE_WINDOW_PREFETCHER_H_
+#define SRC_LANCET_CORE_WINDOW_PREFETCHER_H_
+
+#include "lancet/base/types.h"
+#include "lancet/core/variant_builder.h"
+#include "lancet/core/window.h"
+
+#include "absl/functional/any_invocable.h"
+#include "blockingconcurrentqueue.h"
+
+#include <exception>
+#include <stop_token>
+#include <thread>
+
+namespace lancet::core {
+
+// ============================================================================
+// WindowPrefetcher: overlaps one window's BAM/CRAM reads with the previous
+// window's assembly.
+//
+// Read collection (BGZF inflate, CRAM decode, mate recapture) is latency-bound
+// and leaves the core idle, while graph assembly, MSA and genotyping never
+// touch the alignment files. An AsyncWorker that owns a prefetcher runs:
+//
+//   worker:   [ process N ─────────────── ][ process N+1 ───── ] ...
+//   helper:   [ load N+1 ──── ]             [ load N+2 ─── ]
+//
+// The helper thread calls VariantBuilder::LoadWindowInput on the worker's own
+// builder. That is safe because at most one load is in flight per builder and
+// ProcessWindow(window, input) never touches the builder's ReadCollector.
+//
+// Exceptions thrown while loading are carried back to the worker and rethrown
+// from Take(), so they are reported against the right window. Destruction
+// lets a load already in progress finish and drops one not yet started.
+// ============================================================================
+class WindowPrefetcher {
+ public:
+  using Loader = absl::AnyInvocable<VariantBuilder::WindowInput(Window const&)>;
+
+  /// Loads through builder.LoadWindowInput().
+  explicit WindowPrefetcher(VariantBuilder& builder);
+  /// Loads through `load`, which is only ever called on the helper thread.
+  explicit WindowPrefetcher(Loader load);
+  ~WindowPrefetcher();
+
+  WindowPrefetcher(WindowPrefetcher const&) = delete;
+  WindowPrefetcher(WindowPrefetcher&&) = delete;
+  auto operator=(WindowPrefetcher const&) -> WindowPrefetcher& = delete;
+  auto operator=(WindowPrefetcher&&) -> WindowPrefetcher& = delete;
+
+  /// Starts loading `window` on the helper thread. At most one load may be outstanding:
+  /// every Submit() must be followed by Take() before the next Submit().
+  void Submit(WindowPtr window);
+
+  /// Blocks until the submitted load finishes and returns its input.
+  [[nodiscard]] auto Take() -> VariantBuilder::WindowInput;
+
+ private:
+  struct Loaded {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    VariantBuilder::WindowInput mInput;
+    std::exception_ptr mError;
+  };
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  moodycamel::BlockingConcurrentQueue<WindowPtr> mRequests;
+  moodycamel::BlockingConcurrentQueue<Loaded> mResponses;
+  Loader mLoad;
+  std::jthread mThread;  // declared last: started after every other member exists
+
+  void Run(std::stop_token const& stop_token);
+};
+
+}  // namespace lancet::core
+
+#endif  // SRC_LANCET_CORE_WINDOW_PREFETCHER_H_
@@ -11,6 +11,7 @@ extern "C" {
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "spdlog/fmt/bundled/base.h"
 #include "spdlog/fmt/bundled/format.h"
 
@@ -97,6 +98,24 @@ auto Alignment::CigarData() const -> std::vector<CigarUnit> {
   return result;
 }
 
+auto Alignment::CigarView() const noexcept -> absl::Span<u32 const> {
+  if (mRawAln == nullptr) {
+    return {};
+  }
+
+  // htslib bam.h accessor macros (`bam_get_qname`, `bam_get_cigar`) expand to C-style casts.
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+  auto const* raw_cigar = bam_get_cigar(mRawAln);
+  return {raw_cigar, static_cast<usize>(mRawAln->core.n_cigar)};
+}
+
+auto Alignment::QualView() const noexcept -> absl::Span<u8 const> {
+  if (mRawAln == nullptr) {
+    return {};
+  }
+  return {bam_get_qual(mRawAln), static_cast<usize>(mRawAln->core.l_qseq)};
+}
+
 auto Alignment::CigarString() const -> std::string {
   if (mRawAln == nullptr) {
     return {};
@@ -124,13 +143,20 @@ auto Alignment::BuildSequence() const -> std::string {
   if (mRawAln == nullptr) {
     return {};
   }
-  auto const seq_len = static_cast<usize>(mRawAln->core.l_qseq);
+  std::string result(Length(), 'N');
+  DecodeSequenceTo(absl::MakeSpan(result));
+  return result;
+}
+
+void Alignment::DecodeSequenceTo(absl::Span<char> out) const noexcept {
+  if (mRawAln == nullptr) {
+    return;
+  }
+  auto const seq_len = std::min(out.size(), static_cast<usize>(mRawAln->core.l_qseq));
   auto const* raw_seq = bam_get_seq(mRawAln);
-  std::string result(seq_len, 'N');
   for (usize idx = 0; idx < seq_len; ++idx) {
-    result[idx] = SEQ_4BIT_TO_CHAR[bam_seqi(raw_seq, idx)];
+    out[idx] = SEQ_4BIT_TO_CHAR[bam_seqi(raw_seq, idx)];
   }
-  return result;
 }
 
 auto Alignment::BuildQualities() const -> std::vector<u8> {
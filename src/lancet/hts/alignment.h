@@ -15,6 +15,7 @@ extern "C" {
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "spdlog/fmt/bundled/format.h"
 
 #include <string>
@@ -46,6 +47,10 @@ class Alignment {
     SEQ_QUAL = CORE_QNAME | SAM_SEQ | SAM_QUAL,
     CIGAR_SEQ_QUAL = SEQ_QUAL | SAM_CIGAR,
     AUX_RGAUX = CIGAR_SEQ_QUAL | SAM_AUX | SAM_RGAUX,
+    // Active region prescan: no QNAME, mate fields or RG. SEQ stays because CRAM
+    // regenerates the MD tag from the decoded sequence.
+    ACTIVE_REGION_PRESCAN = SAM_FLAG | SAM_RNAME | SAM_POS | SAM_MAPQ | SAM_CIGAR | SAM_SEQ |
+                            SAM_QUAL | SAM_AUX,
   };
 
   // ============================================================================
@@ -75,6 +80,12 @@ class Alignment {
   /// Zero-copy view of the raw CIGAR array from the bam1_t record.
   [[nodiscard]] auto CigarData() const -> std::vector<CigarUnit>;
 
+  /// Raw BAM-encoded CIGAR words, without building a vector. Decode each with CigarUnit.
+  [[nodiscard]] auto CigarView() const noexcept -> absl::Span<u32 const>;
+
+  /// Per-base Phred qualities, without the copy BuildQualities() makes.
+  [[nodiscard]] auto QualView() const noexcept -> absl::Span<u8 const>;
+
   [[nodiscard]] auto CigarString() const -> std::string;
 
   // ============================================================================
@@ -86,6 +97,10 @@ class Alignment {
   /// This allocates a new std::string on every call.
   [[nodiscard]] auto BuildSequence() const -> std::string;
 
+  /// Decodes the 4-bit packed BAM sequence into `out`, which must hold Length() chars.
+  /// Same bases as BuildSequence(), written into caller-owned storage.
+  void DecodeSequenceTo(absl::Span<char> out) const noexcept;
+
   /// Copies the raw quality values into a new vector.
   /// This allocates a new std::vector<u8> on every call.
   [[nodiscard]] auto BuildQualities() const -> std::vector<u8>;
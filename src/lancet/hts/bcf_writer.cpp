@@ -0,0 +1,86 @@
+#include "lancet/hts/bcf_writer.h"
+
+#include "lancet/base/logging.h"
+
+extern "C" {
+#include "htslib/hts.h"
+#include "htslib/vcf.h"
+}
+
+#include <filesystem>
+#include <string>
+#include <utility>
+
+#include <cstdlib>
+
+namespace lancet::hts {
+
+auto BcfWriter::Open(std::filesystem::path const& path, std::string header_text,
+                     int const num_threads) -> bool {
+  if (mFilePtr != nullptr) Close();
+
+  // CSI with the htslib default 2^14 minimum bin; BCF cannot carry a TBI index.
+  static constexpr int CSI_MIN_SHIFT = 14;
+  mFileName = path;
+
+  // "r" mode: start from an empty header and take every line (including
+  // ##fileformat) from the text, exactly as vcf_hdr_read would.
+  mHeader.reset(bcf_hdr_init("r"));
+  if (!mHeader || bcf_hdr_parse(mHeader.get(), header_text.data()) < 0) {
+    LOG_CRITICAL("Failed to parse VCF header for BCF output: {}", mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+
+  mFilePtr = hts_open(mFileName.c_str(), "wb");
+  if (mFilePtr == nullptr) return false;
+
+  if (num_threads > 1 && hts_set_threads(mFilePtr, num_threads) < 0) {
+    LOG_WARN("Could not start {} BGZF compression threads for {}. Compressing inline.",
+             num_threads, mFileName.string())
+  }
+
+  auto const csi_path = mFileName.string() + ".csi";
+  if (bcf_hdr_write(mFilePtr, mHeader.get()) < 0 ||
+      bcf_idx_init(mFilePtr, mHeader.get(), CSI_MIN_SHIFT, csi_path.c_str()) < 0) {
+    LOG_CRITICAL("Failed to write BCF header or start CSI index: {}", mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+
+  mRecord.reset(bcf_init());
+  return mRecord != nullptr;
+}
+
+void BcfWriter::Close() {
+  if (mFilePtr == nullptr) return;
+
+  // bcf_idx_save flushes the stream, finishes the index from the offsets
+  // bcf_write recorded, and writes the .csi before the data file is closed.
+  auto const index_saved = bcf_idx_save(mFilePtr) >= 0;
+  auto const closed = hts_close(mFilePtr) >= 0;
+  mFilePtr = nullptr;
+  mRecord.reset();
+  mHeader.reset();
+
+  if (!index_saved || !closed) {
+    LOG_CRITICAL("Failed to close BCF output or write its CSI index. If writing to cloud URIs, "
+                 "check remote auth/permissions: {}",
+                 mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+auto BcfWriter::NextRecord() -> bcf1_t* {
+  bcf_clear(mRecord.get());
+  return mRecord.get();
+}
+
+void BcfWriter::WriteRecord() {
+  if (bcf_write(mFilePtr, mHeader.get(), mRecord.get()) < 0) {
+    LOG_CRITICAL("Failed to write BCF record at {}:{} (output not coordinate-sorted?): {}",
+                 bcf_seqname_safe(mHeader.get(), mRecord.get()), mRecord->pos + 1,
+                 mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+}  // namespace lancet::hts
@@ -0,0 +1,83 @@
+#ifndef SRC_LANCET_HTS_BCF_WRITER_H_
+#define SRC_LANCET_HTS_BCF_WRITER_H_
+
+#include "lancet/base/types.h"
+
+extern "C" {
+#include "htslib/hts.h"
+#include "htslib/vcf.h"
+}
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace lancet::hts {
+
+namespace detail {
+
+struct BcfHdrDeleter {
+  void operator()(bcf_hdr_t* hdr) noexcept { bcf_hdr_destroy(hdr); }
+};
+
+struct Bcf1Deleter {
+  void operator()(bcf1_t* rec) noexcept { bcf_destroy(rec); }
+};
+
+}  // namespace detail
+
+// ============================================================================
+// BcfWriter: compressed binary VCF (BCF2) output with an on-the-fly CSI index.
+//
+// The header is parsed once from the same text VcfHeaderBuilder emits for the
+// VCF path, so both outputs declare identical contigs, INFO and FORMAT tags.
+// Records are written from a single reusable bcf1_t that callers fill with
+// the bcf_update_* API (see caller::BcfRecordEncoder); htslib indexes each
+// record as bcf_write emits it, and Close() saves `<path>.csi`.
+//
+// Thread safety: NOT thread-safe. One writer thread owns the instance.
+// ============================================================================
+class BcfWriter {
+ public:
+  BcfWriter() = default;
+  ~BcfWriter() {
+    // See BgzfStreambuf::~BgzfStreambuf for rationale.
+    try {
+      Close();
+      // intentional swallow: dtor cannot propagate exceptions
+      // NOLINTNEXTLINE(bugprone-empty-catch)
+    } catch (...) {}
+  }
+
+  BcfWriter(BcfWriter const&) = delete;
+  BcfWriter(BcfWriter&&) = delete;
+  auto operator=(BcfWriter const&) -> BcfWriter& = delete;
+  auto operator=(BcfWriter&&) -> BcfWriter& = delete;
+
+  /// Opens `path`, writes the parsed `header_text` and starts the CSI index.
+  /// `num_threads` > 1 compresses BGZF blocks on an htslib thread pool.
+  auto Open(std::filesystem::path const& path, std::string header_text, int num_threads = 1)
+      -> bool;
+  void Close();
+
+  [[nodiscard]] auto Header() const noexcept -> bcf_hdr_t* { return mHeader.get(); }
+
+  /// The reusable record, cleared and ready to be filled for the next write.
+  [[nodiscard]] auto NextRecord() -> bcf1_t*;
+  /// Writes (and indexes) the record returned by the last NextRecord() call.
+  void WriteRecord();
+
+ private:
+  using BcfHdr = std::unique_ptr<bcf_hdr_t, detail::BcfHdrDeleter>;
+  using BcfRec = std::unique_ptr<bcf1_t, detail::Bcf1Deleter>;
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  std::filesystem::path mFileName;
+  htsFile* mFilePtr = nullptr;
+  BcfHdr mHeader;
+  BcfRec mRecord;
+};
+
+}  // namespace lancet::hts
+
+#endif  // SRC_LANCET_HTS_BCF_WRITER_H_
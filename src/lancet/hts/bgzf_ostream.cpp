@@ -4,25 +4,70 @@
 
 extern "C" {
 #include "htslib/bgzf.h"
+#include "htslib/hts.h"
 #include "htslib/tbx.h"
 }
 
+#include <array>
+#include <bit>
 #include <filesystem>
 #include <ios>
 #include <string>
+#include <string_view>
 
+#include <cstdint>
 #include <cstdlib>
 
+// Private htslib API, declared in hts_internal.h (present in the htslib source tree we
+// build against, but not an installed header). It is what vcf_write / sam_write use to
+// index while writing: without a compression pool it forwards to hts_idx_push; with
+// one, it queues the entry until the pool's writer thread has assigned the enclosing
+// block its final file offset, so bgzf_tell()'s provisional block address is never used.
+// The public bcf_idx_init / bcf_idx_save path only reaches it through vcf_write, which
+// needs every record re-encoded as a bcf1_t, so the declaration is pinned to the htslib
+// release cmake/dependencies.cmake downloads instead. Re-check it against hts_internal.h
+// when bumping that version.
+static_assert(HTS_VERSION >= 102300 && HTS_VERSION < 102400,
+              "bgzf_idx_push declaration verified against htslib 1.23.x only");
+
+extern "C" {
+auto bgzf_idx_push(BGZF* fp, hts_idx_t* hidx, int tid, hts_pos_t beg, hts_pos_t end,
+                   std::uint64_t offset, int is_mapped) -> int;
+}
+
 namespace lancet::hts {
 
 namespace detail {
 
-auto BgzfStreambuf::Open(std::filesystem::path const& path, char const* mode) -> bool {
+// ============================================================================
+// Open: bgzf_open, optionally followed by bgzf_mt.
+//
+// bgzf_mt gives the handle its own hts_tpool. Every full 64 KiB block that
+// bgzf_write produces is queued to the pool and deflated there (libdeflate —
+// htslib is configured --with-libdeflate); a dedicated writer thread inside
+// htslib emits the compressed blocks in submission order. The pool's job queue
+// is bounded (a small multiple of num_threads), so a slow disk back-pressures
+// the writing thread instead of growing memory without bound.
+// ============================================================================
+auto BgzfStreambuf::Open(std::filesystem::path const& path, char const* mode,
+                         int const num_threads) -> bool {
   if (mFilePtr != nullptr) Close();
 
+  static constexpr int BGZF_SUB_BLOCKS = 64;
   mFileName = path;
   mFilePtr = bgzf_open(mFileName.c_str(), mode);
-  return mFilePtr != nullptr;
+  mIsMultiThreaded = false;
+  if (mFilePtr == nullptr) return false;
+
+  if (num_threads > 1) {
+    if (bgzf_mt(mFilePtr, num_threads, BGZF_SUB_BLOCKS) < 0) {
+      LOG_WARN("Could not start {} BGZF compression threads for {}. Compressing inline.",
+               num_threads, mFileName.string())
+    } else {
+      mIsMultiThreaded = true;
+    }
+  }
+  return true;
 }
 
 void BgzfStreambuf::Close() {
@@ -37,6 +82,7 @@ void BgzfStreambuf::Close() {
       std::exit(EXIT_FAILURE);
     }
     mFilePtr = nullptr;
+    mIsMultiThreaded = false;
   }
 }
 
@@ -89,6 +135,12 @@ auto BgzfStreambuf::sync() -> int {
     return 0;
   }
 
+  // With a compression pool, bgzf_flush is a barrier: it waits for every queued
+  // block to be deflated and written. Full blocks already stream through the pool
+  // in order, so sync() leaves only the partial tail block buffered — it is written
+  // (and any I/O error reported) by bgzf_close in Close().
+  if (mIsMultiThreaded) return 0;
+
   // std::ostream::flush invokes sync(). HTSlib manages its own buffered remote streams,
   // so we must forward the flush to bgzf_flush to ensure data reaches the network layer.
   if (bgzf_flush(mFilePtr) < 0) {
@@ -102,18 +154,124 @@ auto BgzfStreambuf::sync() -> int {
 
 }  // namespace detail
 
-auto BgzfOstream::Open(std::filesystem::path const& path, BgzfFormat ofmt) -> bool {
+auto BgzfOstream::Open(std::filesystem::path const& path, BgzfFormat ofmt,
+                       int const num_threads) -> bool {
   mOutFmt = ofmt;
-  auto result = mBgzfBuffer.Open(path, "w");
+  auto result = mBgzfBuffer.Open(path, "w", num_threads);
   rdbuf(&mBgzfBuffer);
   return result;
 }
 
 void BgzfOstream::Close() {
+  // Close() also runs from the destructor after an explicit Close(); only the
+  // first call may finish or build the index.
+  if (mBgzfBuffer.Handle() == nullptr) return;
+
+  if (mIndex != nullptr) {
+    FinishIndex();
+    return;
+  }
+
   mBgzfBuffer.Close();
   if (mOutFmt != BgzfFormat::UNSPECIFIED) BuildIndex();
 }
 
+// ============================================================================
+// On-the-fly tabix index — the same construction vcf_write performs for
+// `bcftools view --write-index`:
+//
+//   InitIndex    hts_idx_init(TBI, offset at end of header, min_shift 14, 5 levels)
+//                + tabix meta block (tbx_conf_vcf column layout)
+//   IndexRecord  hts_idx_push(tid, beg, end, virtual offset just past the record)
+//   Close        hts_idx_finish + hts_idx_save_as("<path>.tbi")
+//
+// The records already carry CHROM/POS/REF when they are written, so the index
+// is a by-product of the write instead of a second decompress-and-parse pass
+// over the finished file (tbx_index_build), which grows with the output size
+// and used to run serially after the last window.
+// ============================================================================
+void BgzfOstream::InitIndex() {
+  if (mOutFmt != BgzfFormat::VCF || mIndex != nullptr) return;
+
+  static constexpr int TBI_MIN_SHIFT = 14;
+  static constexpr int TBI_NUM_LEVELS = 5;
+  auto* bgzf = mBgzfBuffer.Handle();
+  if (bgzf == nullptr) return;
+
+  // Records must start in a fresh block for the header-end offset to be exact.
+  // With a compression pool this is a barrier, but it only runs once.
+  if (bgzf_flush(bgzf) < 0) {
+    LOG_CRITICAL("Failed to flush VCF header before indexing: {}", mBgzfBuffer.mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+
+  mIndex = hts_idx_init(0, HTS_FMT_TBI, bgzf_tell(bgzf), TBI_MIN_SHIFT, TBI_NUM_LEVELS);
+  if (mIndex == nullptr) {
+    LOG_CRITICAL("Failed to initialize tabix index for output file: {}",
+                 mBgzfBuffer.mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+
+  // Tabix meta block: preset, name/begin/end columns, comment char, skipped lines,
+  // then the contig-name list that hts_idx_tbi_name appends to as contigs appear.
+  // Stored little-endian, which std::bit_cast preserves on x86-64.
+  std::array<std::int32_t, 7> const meta = {tbx_conf_vcf.preset,    tbx_conf_vcf.sc,
+                                            tbx_conf_vcf.bc,        tbx_conf_vcf.ec,
+                                            tbx_conf_vcf.meta_char, tbx_conf_vcf.line_skip,
+                                            0};
+  auto meta_bytes = std::bit_cast<std::array<u8, sizeof(meta)>>(meta);
+  if (hts_idx_set_meta(mIndex, meta_bytes.size(), meta_bytes.data(), 1) < 0) {
+    LOG_CRITICAL("Failed to set tabix metadata for output file: {}",
+                 mBgzfBuffer.mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void BgzfOstream::IndexRecord(std::string_view chrom, i64 const beg0, i64 const end0) {
+  if (mIndex == nullptr) return;
+  auto* bgzf = mBgzfBuffer.Handle();
+
+  // Output is coordinate-sorted, so a contig never reappears once left: a new
+  // name always gets the next tid, which is what hts_idx_tbi_name expects.
+  if (mIndexTid < 0 || chrom != mIndexChrom) {
+    mIndexChrom.assign(chrom);
+    mIndexTid = hts_idx_tbi_name(mIndex, mIndexTid + 1, mIndexChrom.c_str());
+  }
+
+  // End offset of the record, as vcf_write passes it: hts_idx_push attributes the
+  // bytes between the previous and this offset to [beg0, end0).
+  auto const voffset = static_cast<std::uint64_t>(bgzf_tell(bgzf));
+  if (mIndexTid < 0 || bgzf_idx_push(bgzf, mIndex, mIndexTid, beg0, end0, voffset, 1) < 0) {
+    LOG_CRITICAL("Failed to index record at {}:{} (output not coordinate-sorted?): {}", chrom,
+                 beg0 + 1, mBgzfBuffer.mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+void BgzfOstream::FinishIndex() {
+  auto* bgzf = mBgzfBuffer.Handle();
+  // Drain the compression pool so every queued entry has its final block offset,
+  // then point the last bin at the end of the data (mirrors sam_idx_save).
+  auto const flushed = bgzf_flush(bgzf) >= 0;
+  if (flushed) hts_idx_amend_last(mIndex, bgzf_tell(bgzf));
+  auto const finished = flushed && hts_idx_finish(mIndex, bgzf_tell(bgzf)) >= 0;
+  mBgzfBuffer.Close();
+
+  auto const saved =
+      finished &&
+      hts_idx_save_as(mIndex, mBgzfBuffer.mFileName.c_str(), nullptr, HTS_FMT_TBI) >= 0;
+  hts_idx_destroy(mIndex);
+  mIndex = nullptr;
+  mIndexTid = -1;
+  mIndexChrom.clear();
+
+  if (!saved) {
+    LOG_CRITICAL("Failed to write tabix index for output file: {}",
+                 mBgzfBuffer.mFileName.string())
+    std::exit(EXIT_FAILURE);
+  }
+}
+
 void BgzfOstream::BuildIndex() {
   int result = 0;
   switch (mOutFmt) {
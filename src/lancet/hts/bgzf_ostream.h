@@ -5,11 +5,15 @@
 
 extern "C" {
 #include "htslib/bgzf.h"
+#include "htslib/hts.h"
 }
 
 #include <filesystem>
 #include <ios>
 #include <ostream>
+#include <string>
+#include <string_view>
+
 #include <stdio.h>
 
 namespace lancet::hts {
@@ -37,9 +41,12 @@ class BgzfStreambuf : public std::streambuf {
     } catch (...) {}
   }
 
-  auto Open(std::filesystem::path const& path, char const* mode) -> bool;
+  /// `num_threads` > 1 attaches a BGZF compression pool (see BgzfOstream::Open).
+  auto Open(std::filesystem::path const& path, char const* mode, int num_threads = 1) -> bool;
   void Close();
 
+  [[nodiscard]] auto Handle() const noexcept -> BGZF* { return mFilePtr; }
+
   // std::streambuf declares these virtuals as protected; we re-expose them as public so the
   // detail-namespace BgzfStreambuf can be exercised directly by tests without subclassing.
   // NOLINTBEGIN(misc-override-with-different-visibility)
@@ -56,6 +63,8 @@ class BgzfStreambuf : public std::streambuf {
   BGZF* mFilePtr = nullptr;
   // ── 4B Align ────────────────────────────────────────────────────────────
   int mCurrPos = 0;
+  // ── 1B Align ────────────────────────────────────────────────────────────
+  bool mIsMultiThreaded = false;
 };
 
 }  // namespace detail
@@ -83,19 +92,36 @@ class BgzfOstream : public std::ostream {
   auto operator=(BgzfOstream const&) -> BgzfOstream& = delete;
   auto operator=(BgzfOstream&&) -> BgzfOstream& = delete;
 
-  auto Open(std::filesystem::path const& path, BgzfFormat ofmt) -> bool;
+  /// `num_threads` > 1 compresses BGZF blocks on a dedicated htslib thread pool
+  /// (block-parallel libdeflate, written back in order) instead of inline on the
+  /// writing thread. The writer only blocks when the pool's bounded queue is full.
+  auto Open(std::filesystem::path const& path, BgzfFormat ofmt, int num_threads = 1) -> bool;
   auto Open(std::filesystem::path const& path) -> bool {
     return Open(path, BgzfFormat::UNSPECIFIED);
   }
   void Close();
 
+  /// Starts an on-the-fly tabix index at the current write position (VCF output only).
+  /// Call once, after the header has been written and before the first record.
+  /// Close() then writes `<path>.tbi` directly instead of re-reading the file.
+  void InitIndex();
+
+  /// Registers the record that was just written, as the 0-based half-open interval
+  /// [beg0, end0) on `chrom`. Records must arrive coordinate-sorted, contig by contig.
+  void IndexRecord(std::string_view chrom, i64 beg0, i64 end0);
+
  private:
   // ── 8B Align ────────────────────────────────────────────────────────────
   detail::BgzfStreambuf mBgzfBuffer;
+  hts_idx_t* mIndex = nullptr;  // non-null once InitIndex() has been called
+  std::string mIndexChrom;      // contig of the last indexed record
+  // ── 4B Align ────────────────────────────────────────────────────────────
+  int mIndexTid = -1;  // tid of mIndexChrom, assigned in first-seen order
   // ── 1B Align ────────────────────────────────────────────────────────────
   BgzfFormat mOutFmt = BgzfFormat::UNSPECIFIED;
 
   void BuildIndex();
+  void FinishIndex();
 };
 
 }  // namespace lancet::hts
@@ -0,0 +1,474 @@
+#include "lancet/hts/block_cache.h"
+
+#include "lancet/base/hash.h"
+#include "lancet/base/logging.h"
+#include "lancet/base/types.h"
+#include "lancet/hts/uri_utils.h"
+
+extern "C" {
+#include "htslib/hfile.h"
+#include "htslib/hts.h"
+}
+
+#include "absl/base/thread_annotations.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/match.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "spdlog/fmt/bundled/format.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <sys/types.h>
+#include <unistd.h>
+
+// htslib's hFILE plugin ABI: the HTSLIB_EXPORT'ed entry points its own scheme plugins
+// (hfile_libcurl, hfile_s3, hfile_gcs) register through. They are declared in the
+// uninstalled hfile_internal.h, so only these four are mirrored here, pinned to the
+// htslib release cmake/dependencies.cmake downloads (see bgzf_ostream.cpp). Re-check
+// them against hfile_internal.h when bumping that version.
+static_assert(HTS_VERSION >= 102300 && HTS_VERSION < 102400,
+              "hFILE plugin ABI declarations verified against htslib 1.23.x only");
+
+extern "C" {
+struct hFILE_backend {
+  ssize_t (*read)(hFILE* fptr, void* buffer, size_t nbytes);
+  ssize_t (*write)(hFILE* fptr, void const* buffer, size_t nbytes);
+  off_t (*seek)(hFILE* fptr, off_t offset, int whence);
+  int (*flush)(hFILE* fptr);
+  int (*close)(hFILE* fptr);
+};
+
+struct hFILE_scheme_handler {
+  hFILE* (*open)(char const* filename, char const* mode);
+  int (*isremote)(char const* filename);
+  char const* provider;
+  int priority;
+  hFILE* (*vopen)(char const* filename, char const* mode, va_list args);
+};
+
+auto hfile_init(size_t struct_size, char const* mode, size_t capacity) -> hFILE*;
+void hfile_add_scheme_handler(char const* scheme, hFILE_scheme_handler const* handler);
+}
+
+namespace {
+
+namespace fs = std::filesystem;
+using lancet::hts::BlockCache;
+
+// ============================================================================
+// CacheState — process-wide cache directory, size cap and eviction.
+//
+// Written by BlockCache::Enable/Disable before workers start; read by every
+// hFILE open and chunk store. Eviction runs on whichever thread pushes the
+// bytes written since the last scan past 1/16 of the cap; other threads skip
+// it rather than queue behind the directory scan.
+// ============================================================================
+class CacheState {
+ public:
+  static auto Instance() -> CacheState& {
+    static CacheState instance;
+    return instance;
+  }
+
+  void Configure(fs::path cache_dir, u64 const max_bytes, bool const cache_remote) {
+    absl::MutexLock const lock(mMutex);
+    mCacheDir = std::move(cache_dir);
+    mMaxBytes = max_bytes;
+    mBytesSinceTrim = 0;
+    mCacheRemote.store(cache_remote);
+  }
+
+  [[nodiscard]] auto CacheDir() const -> fs::path {
+    absl::MutexLock const lock(mMutex);
+    return mCacheDir;
+  }
+
+  void AccountWrite(u64 const num_bytes) {
+    fs::path cache_dir;
+    u64 max_bytes = 0;
+    {
+      absl::MutexLock const lock(mMutex);
+      mBytesSinceTrim += num_bytes;
+      if (mBytesSinceTrim < std::max(mMaxBytes / TRIM_FRACTION, u64{1})) return;
+      mBytesSinceTrim = 0;
+      cache_dir = mCacheDir;
+      max_bytes = mMaxBytes;
+    }
+
+    if (!mTrimMutex.TryLock()) return;
+    Trim(cache_dir, max_bytes);
+    mTrimMutex.Unlock();
+  }
+
+  std::atomic<bool> mIsRouting{false};
+  std::atomic<bool> mCacheRemote{false};
+
+ private:
+  static constexpr u64 TRIM_FRACTION = 16;
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  mutable absl::Mutex mMutex;
+  absl::Mutex mTrimMutex;
+  fs::path mCacheDir ABSL_GUARDED_BY(mMutex);
+  u64 mMaxBytes ABSL_GUARDED_BY(mMutex) = 0;
+  u64 mBytesSinceTrim ABSL_GUARDED_BY(mMutex) = 0;
+
+  /// Deletes the least recently used chunks until the directory is at 90% of its cap.
+  /// Entries vanishing under a concurrent process's trim are simply skipped.
+  static void Trim(fs::path const& cache_dir, u64 const max_bytes) {
+    struct Entry {
+      // ── 8B Align ──────────────────────────────────────────────────────────
+      fs::file_time_type mLastUse;
+      fs::path mPath;
+      u64 mSize = 0;
+    };
+
+    std::error_code err;
+    std::vector<Entry> entries;
+    u64 total_bytes = 0;
+    auto itr = fs::recursive_directory_iterator(cache_dir, err);
+    for (; !err && itr != fs::recursive_directory_iterator(); itr.increment(err)) {
+      if (!itr->is_regular_file(err)) continue;
+      auto const size = itr->file_size(err);
+      auto const last_use = itr->last_write_time(err);
+      if (err) continue;
+      entries.push_back({.mLastUse = last_use, .mPath = itr->path(), .mSize = size});
+      total_bytes += size;
+    }
+
+    if (total_bytes <= max_bytes) return;
+    std::ranges::sort(entries, std::less{}, &Entry::mLastUse);
+
+    auto const target_bytes = max_bytes - (max_bytes / 10);
+    for (auto const& entry : entries) {
+      if (total_bytes <= target_bytes) break;
+      if (fs::remove(entry.mPath, err)) total_bytes -= entry.mSize;
+    }
+  }
+};
+
+// ============================================================================
+// ChunkReader — the state behind one cached hFILE.
+//
+// Keeps the current chunk in memory, so htslib's small sequential reads inside
+// a chunk cost a memcpy. Moving to another chunk first looks for it on disk
+// and only then reads it from the underlying hFILE and stores it.
+// ============================================================================
+class ChunkReader {
+ public:
+  ChunkReader(hFILE* inner, fs::path chunk_dir, i64 const file_size)
+      : mChunkDir(std::move(chunk_dir)), mInner(inner), mFileSize(file_size) {}
+
+  ChunkReader(ChunkReader const&) = delete;
+  ChunkReader(ChunkReader&&) = delete;
+  auto operator=(ChunkReader const&) -> ChunkReader& = delete;
+  auto operator=(ChunkReader&&) -> ChunkReader& = delete;
+  ~ChunkReader() = default;
+
+  auto Read(void* buffer, usize const num_bytes) -> ssize_t {
+    if (mFileSize >= 0 && mPosition >= mFileSize) return 0;
+
+    auto const chunk_idx = static_cast<u64>(mPosition) / BlockCache::CHUNK_SIZE;
+    if (chunk_idx != mChunkIdx && !LoadChunk(chunk_idx)) return -1;
+
+    auto const offset = static_cast<usize>(mPosition) - (chunk_idx * BlockCache::CHUNK_SIZE);
+    if (offset >= mChunk.size()) return 0;
+
+    auto const num_copied = std::min(num_bytes, mChunk.size() - offset);
+    std::memcpy(buffer, mChunk.data() + offset, num_copied);
+    mPosition += static_cast<i64>(num_copied);
+    return static_cast<ssize_t>(num_copied);
+  }
+
+  auto Seek(off_t const offset, int const whence) -> off_t {
+    i64 base = 0;
+    if (whence == SEEK_CUR) base = mPosition;
+    if (whence == SEEK_END) {
+      if (mFileSize < 0) {
+        errno = ESPIPE;
+        return -1;
+      }
+      base = mFileSize;
+    }
+
+    if (base + offset < 0) {
+      errno = EINVAL;
+      return -1;
+    }
+    mPosition = base + offset;
+    return static_cast<off_t>(mPosition);
+  }
+
+  auto Close() -> int { return hclose(mInner); }
+
+ private:
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  fs::path mChunkDir;
+  std::vector<char> mChunk;
+  hFILE* mInner;
+  i64 mFileSize;  // -1 when the underlying hFILE cannot seek to its end
+  i64 mPosition = 0;
+  u64 mChunkIdx = static_cast<u64>(-1);
+
+  /// Bytes a complete chunk at `chunk_idx` must hold, or CHUNK_SIZE if the size is unknown.
+  [[nodiscard]] auto ExpectedChunkSize(u64 const chunk_idx) const -> usize {
+    if (mFileSize < 0) return BlockCache::CHUNK_SIZE;
+    auto const start = chunk_idx * BlockCache::CHUNK_SIZE;
+    return std::min(BlockCache::CHUNK_SIZE, static_cast<usize>(mFileSize) - start);
+  }
+
+  auto LoadChunk(u64 const chunk_idx) -> bool {
+    auto const chunk_path = mChunkDir / fmt::format("{:010x}", chunk_idx);
+    auto const expected = ExpectedChunkSize(chunk_idx);
+
+    if (ReadStoredChunk(chunk_path, expected)) {
+      mChunkIdx = chunk_idx;
+      return true;
+    }
+
+    auto const start = static_cast<off_t>(chunk_idx * BlockCache::CHUNK_SIZE);
+    if (hseek(mInner, start, SEEK_SET) < 0) return false;
+
+    mChunk.resize(BlockCache::CHUNK_SIZE);
+    usize num_read = 0;
+    while (num_read < mChunk.size()) {
+      auto const res = hread(mInner, mChunk.data() + num_read, mChunk.size() - num_read);
+      if (res < 0) return false;
+      if (res == 0) break;
+      num_read += static_cast<usize>(res);
+    }
+    mChunk.resize(num_read);
+    mChunkIdx = chunk_idx;
+
+    // A short chunk is only final when the file size confirms it; never store a guess
+    if (num_read == expected) StoreChunk(chunk_path);
+    return true;
+  }
+
+  auto ReadStoredChunk(fs::path const& chunk_path, usize const expected) -> bool {
+    std::ifstream input(chunk_path, std::ios::binary | std::ios::ate);
+    if (!input) return false;
+
+    auto const stored_size = static_cast<usize>(input.tellg());
+    if (stored_size != expected) return false;
+
+    mChunk.resize(stored_size);
+    input.seekg(0);
+    if (!input.read(mChunk.data(), static_cast<std::streamsize>(stored_size))) return false;
+
+    // Refresh the chunk's last use for LRU eviction; a failure only makes it older
+    std::error_code err;
+    fs::last_write_time(chunk_path, fs::file_time_type::clock::now(), err);
+    return true;
+  }
+
+  void StoreChunk(fs::path const& chunk_path) const {
+    std::error_code err;
+    fs::create_directories(mChunkDir, err);
+    if (err) return;
+
+    auto const thread_hash = absl::HashOf(std::this_thread::get_id());
+    auto tmp_path = chunk_path;
+    tmp_path += fmt::format(".tmp.{}.{:x}", getpid(), thread_hash);
+    {
+      std::ofstream output(tmp_path, std::ios::binary | std::ios::trunc);
+      output.write(mChunk.data(), static_cast<std::streamsize>(mChunk.size()));
+      if (!output) {
+        output.close();
+        fs::remove(tmp_path, err);
+        return;
+      }
+    }
+
+    // rename() replaces atomically: concurrent readers see the old chunk or the new one
+    fs::rename(tmp_path, chunk_path, err);
+    if (err) {
+      fs::remove(tmp_path, err);
+      return;
+    }
+    CacheState::Instance().AccountWrite(mChunk.size());
+  }
+};
+
+// ============================================================================
+// htslib hFILE glue
+//
+// hfile_init allocates `sizeof(CachedHFile)` bytes and fills the leading
+// hFILE; htslib then passes that same pointer to every backend callback, so
+// the callbacks recover the CachedHFile from it.
+// ============================================================================
+struct CachedHFile {
+  hFILE mBase;  // must stay first
+  ChunkReader* mReader;
+};
+
+auto AsCached(hFILE* fptr) -> CachedHFile* {
+  // hfile_init sized the allocation for CachedHFile, whose first member is this hFILE
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<CachedHFile*>(fptr);
+}
+
+auto CachedRead(hFILE* fptr, void* buffer, size_t nbytes) -> ssize_t {
+  return AsCached(fptr)->mReader->Read(buffer, nbytes);
+}
+
+auto CachedWrite(hFILE* /*fptr*/, void const* /*buffer*/, size_t /*nbytes*/) -> ssize_t {
+  errno = EROFS;
+  return -1;
+}
+
+auto CachedSeek(hFILE* fptr, off_t offset, int whence) -> off_t {
+  return AsCached(fptr)->mReader->Seek(offset, whence);
+}
+
+auto CachedFlush(hFILE* /*fptr*/) -> int { return 0; }
+
+auto CachedClose(hFILE* fptr) -> int {
+  auto* cached = AsCached(fptr);
+  auto const result = cached->mReader->Close();
+  std::unique_ptr<ChunkReader> const owned(std::exchange(cached->mReader, nullptr));
+  return result;
+}
+
+constexpr hFILE_backend CACHED_BACKEND = {
+    .read = CachedRead,
+    .write = CachedWrite,
+    .seek = CachedSeek,
+    .flush = CachedFlush,
+    .close = CachedClose,
+};
+
+/// Identity of the underlying file, hashed stably so that separate processes agree on
+/// the chunk directory. Local files: absolute path + size + mtime, or empty if the mtime
+/// cannot be read, since the key would then miss a rewrite that keeps the size. Remote
+/// objects (only cached once declared immutable): URL + size.
+auto MakeFileKey(std::string_view inner_path, i64 const file_size) -> std::string {
+  if (lancet::hts::IsCloudUri(inner_path)) {
+    auto const key = fmt::format("{}\t{}", inner_path, file_size);
+    return fmt::format("{:016x}", lancet::base::HashStr64(key));
+  }
+
+  std::error_code err;
+  fs::path const local_path(absl::StripPrefix(inner_path, "file://"));
+  auto const mtime = fs::last_write_time(local_path, err);
+  if (err) return {};
+  auto const mtime_count = static_cast<i64>(mtime.time_since_epoch().count());
+
+  std::string identity(inner_path);
+  auto const abs_path = fs::absolute(local_path, err);
+  if (!err) identity = abs_path.string();
+
+  auto const key = fmt::format("{}\t{}\t{}", identity, file_size, mtime_count);
+  return fmt::format("{:016x}", lancet::base::HashStr64(key));
+}
+
+auto OpenCached(char const* filename, char const* mode) -> hFILE* {
+  std::string const inner_path(absl::StripPrefix(filename, BlockCache::SCHEME_PREFIX));
+  // hopen is variadic in the htslib C API
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  auto* inner = hopen(inner_path.c_str(), mode);
+  if (inner == nullptr) return nullptr;
+
+  auto const cache_dir = CacheState::Instance().CacheDir();
+  std::string_view const mode_view(mode);
+  bool const is_read_only = mode_view.find_first_of("wa+") == std::string_view::npos;
+  bool const is_uncached_remote = lancet::hts::IsCloudUri(inner_path) &&
+                                  !CacheState::Instance().mCacheRemote.load();
+  if (cache_dir.empty() || !is_read_only || is_uncached_remote) return inner;
+
+  auto const file_size = static_cast<i64>(hseek(inner, 0, SEEK_END));
+  if (hseek(inner, 0, SEEK_SET) < 0) {
+    hclose(inner);
+    return nullptr;
+  }
+
+  auto file_key = MakeFileKey(inner_path, file_size);
+  if (file_key.empty()) return inner;
+
+  auto* fptr = hfile_init(sizeof(CachedHFile), mode, 0);
+  if (fptr == nullptr) return inner;
+
+  auto chunk_dir = cache_dir / std::move(file_key);
+  AsCached(fptr)->mReader = std::make_unique<ChunkReader>(inner, std::move(chunk_dir), file_size)
+                                .release();
+  fptr->backend = &CACHED_BACKEND;
+  return fptr;
+}
+
+auto IsRemoteCached(char const* filename) -> int {
+  std::string const inner_path(absl::StripPrefix(filename, BlockCache::SCHEME_PREFIX));
+  return hisremote(inner_path.c_str());
+}
+
+// htslib keeps this pointer as its scheme table key, so it must have static storage
+constexpr auto CACHE_SCHEME = "lancet-cache";
+constexpr hFILE_scheme_handler CACHE_SCHEME_HANDLER = {
+    .open = OpenCached,
+    .isremote = IsRemoteCached,
+    .provider = "lancet",
+    .priority = 50,
+    .vopen = nullptr,
+};
+
+}  // namespace
+
+namespace lancet::hts {
+
+void BlockCache::Enable(std::filesystem::path const& cache_dir, u64 const max_bytes,
+                        bool const cache_remote) {
+  std::error_code err;
+  fs::create_directories(cache_dir, err);
+  if (err) {
+    auto const msg = fmt::format("Could not create I/O cache directory {}: {}", cache_dir.string(),
+                                 err.message());
+    throw std::runtime_error(msg);
+  }
+
+  static std::once_flag registered;
+  std::call_once(registered, [] {
+    // Looking up any scheme loads htslib's built-in handlers first, so ours is added to them
+    static_cast<void>(hisremote("file:"));
+    hfile_add_scheme_handler(CACHE_SCHEME, &CACHE_SCHEME_HANDLER);
+  });
+
+  CacheState::Instance().Configure(cache_dir, max_bytes, cache_remote);
+  CacheState::Instance().mIsRouting.store(true);
+  LOG_INFO("Caching {} input reads in {} (up to {} MiB)",
+           cache_remote ? "local and remote" : "local", cache_dir.string(), max_bytes >> 20)
+}
+
+void BlockCache::Disable() { CacheState::Instance().mIsRouting.store(false); }
+
+auto BlockCache::IsEnabled() -> bool { return CacheState::Instance().mIsRouting.load(); }
+
+auto BlockCache::Route(std::string const& path) -> std::string {
+  if (!IsEnabled() || absl::StartsWith(path, SCHEME_PREFIX)) return path;
+  if (IsCloudUri(path) && !CacheState::Instance().mCacheRemote.load()) {
+    static std::once_flag warned;
+    std::call_once(warned, [] {
+      LOG_WARN("Remote inputs are read directly: the I/O cache has no ETag or Last-Modified "
+               "to detect a replaced object. Pass --io-cache-remote if they are immutable")
+    });
+    return path;
+  }
+  return std::string(SCHEME_PREFIX) + path;
+}
+
+}  // namespace lancet::hts
@@ -0,0 +1,69 @@
+#ifndef SRC_LANCET_HTS_BLOCK_CACHE_H_
+#define SRC_LANCET_HTS_BLOCK_CACHE_H_
+
+#include "lancet/base/types.h"
+
+#include <filesystem>
+#include <string>
+
+namespace lancet::hts {
+
+// ============================================================================
+// BlockCache — optional read-through disk cache beneath htslib's hFILE layer.
+//
+// Every worker owns its own BAM/CRAM handles, so with inputs on a shared
+// filesystem (NFS, Lustre) each thread issues its own reads — and overlapping
+// windows, mate recapture and index loads re-read the same bytes many times.
+// When enabled, local paths handed to htslib are routed through a
+// "lancet-cache:" hFILE scheme that serves reads in fixed CHUNK_SIZE pieces
+// from a local directory:
+//
+//   hts_open("lancet-cache:/nfs/tumor.bam")
+//     └─ hFILE read @ offset ─▶ <dir>/<file key>/<chunk index>  ── hit ──▶ bytes
+//                                        │ miss
+//                                        └─▶ hread(/nfs/tumor.bam) ─▶ store
+//
+// Chunks are aligned byte ranges of the underlying file, so every BGZF block
+// (and CRAM container, index and FASTA block) inside a chunk is served from
+// disk after its first read. The file key hashes the absolute path with the
+// file size and modification time, so a changed input never hits stale
+// chunks. Remote URIs (s3://, gs://, http(s)://, ftp(s)://) are only cached
+// when the caller declares them immutable: htslib's hFILE exposes no ETag or
+// Last-Modified for them, and URL plus size cannot tell a replaced object
+// from the original. Derived paths
+// (.bai/.crai/.fai/.gzi) go through the same scheme because htslib appends
+// their suffix to the routed name.
+//
+// Chunks are written to a temporary name and renamed into place, so several
+// processes may share one cache directory: a reader sees a whole chunk or
+// none. When the directory grows beyond its size cap, the least recently used
+// chunks (hits refresh the modification time) are deleted. Any cache I/O
+// failure falls back to reading the underlying file; only the underlying
+// file's own errors are reported to htslib.
+// ============================================================================
+class BlockCache {
+ public:
+  static constexpr usize CHUNK_SIZE = usize{1} << 20;
+  static constexpr auto SCHEME_PREFIX = "lancet-cache:";
+
+  /// Registers the cache scheme with htslib and starts routing paths through `cache_dir`
+  /// (created if missing). `cache_remote` also routes remote URIs, keyed on URL + size;
+  /// only safe for objects that are never overwritten in place. Call before opening any
+  /// BAM/CRAM/FASTA, and before starting worker threads. Throws std::runtime_error if
+  /// the directory cannot be created.
+  static void Enable(std::filesystem::path const& cache_dir, u64 max_bytes,
+                     bool cache_remote = false);
+
+  /// Stops routing new paths through the cache. Handles that are already open keep working.
+  static void Disable();
+
+  [[nodiscard]] static auto IsEnabled() -> bool;
+
+  /// `path` prefixed with SCHEME_PREFIX while the cache is enabled, unchanged otherwise.
+  /// Remote URIs are returned unchanged unless Enable() was told they are immutable.
+  [[nodiscard]] static auto Route(std::string const& path) -> std::string;
+};
+
+}  // namespace lancet::hts
+
+#endif  // SRC_LANCET_HTS_BLOCK_CACHE_H_
@@ -3,6 +3,8 @@
 #include "lancet/base/logging.h"
 #include "lancet/base/types.h"
 #include "lancet/hts/alignment.h"
+#include "lancet/hts/block_cache.h"
+#include "lancet/hts/record_stream.h"
 #include "lancet/hts/reference.h"
 
 extern "C" {
@@ -13,10 +15,13 @@ extern "C" {
 #include "htslib/sam.h"
 }
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "spdlog/fmt/bundled/core.h"
 #include "spdlog/fmt/bundled/format.h"
@@ -25,6 +30,8 @@ extern "C" {
 #include <filesystem>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -33,6 +40,83 @@ extern "C" {
 
 namespace lancet::hts {
 
+namespace {
+
+// ============================================================================
+// SharedCramRefs — one htslib CRAM reference cache per process
+//
+// Every CRAM file handle owns a refs_t: the FASTA index plus the reference
+// sequences it has loaded for decoding. Left alone, each worker's extractor
+// for the same sample loads its own copy of the same chromosome, so reference
+// memory and FASTA reads scale with threads × samples.
+//
+// htslib can share one refs_t between handles (CRAM_OPT_SHARED_REF, as used
+// by `samtools merge`). The refs_t is reference-counted, guards its loads
+// with its own mutex and drops a chromosome once no handle is decoding
+// against it, so sharing also keeps the htslib memory bound: roughly one
+// chromosome per process instead of one per handle.
+//
+// A refs_t maps reference IDs by the @SQ order of the header it was built
+// from, so handles only share when both the FASTA path and the full @SQ list
+// (names + lengths, in order) match. Each key holds one "anchor" handle that
+// owns the shared refs_t for the life of the process; it is never read from.
+// ============================================================================
+class SharedCramRefs {
+ public:
+  static auto Instance() -> SharedCramRefs& {
+    static SharedCramRefs instance;
+    return instance;
+  }
+
+  /// Points `cram_fp` at the shared reference cache for its FASTA + @SQ list.
+  /// Must be called after the handle's own FASTA path is set.
+  void Attach(htsFile* cram_fp, sam_hdr_t* hdr, std::string const& aln_path,
+              std::string const& fasta_path) {
+    auto const key = MakeKey(hdr, fasta_path);
+
+    absl::MutexLock const lock(mMutex);
+    auto itr = mAnchors.find(key);
+    if (itr == mAnchors.end()) {
+      AnchorFile anchor(hts_open(BlockCache::Route(aln_path).c_str(), "r"));
+      if (anchor == nullptr || hts_set_fai_filename(anchor.get(), fasta_path.c_str()) != 0) {
+        LOG_WARN("Could not open shared CRAM reference cache for {}", aln_path)
+        return;
+      }
+      itr = mAnchors.emplace(key, std::move(anchor)).first;
+    }
+
+    // htslib `htsFile::fp` is a tagged union; cram-specific access goes through the cram leg.
+    // cram_set_option is variadic per the htslib C API.
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-union-access,cppcoreguidelines-pro-type-vararg)
+    cram_set_option(cram_fp->fp.cram, CRAM_OPT_SHARED_REF, cram_get_refs(itr->second.get()));
+    // NOLINTEND(cppcoreguidelines-pro-type-union-access,cppcoreguidelines-pro-type-vararg)
+  }
+
+ private:
+  struct AnchorCloser {
+    void operator()(htsFile* file_handle) noexcept { hts_close(file_handle); }
+  };
+  using AnchorFile = std::unique_ptr<htsFile, AnchorCloser>;
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  absl::Mutex mMutex;
+  absl::flat_hash_map<u64, AnchorFile> mAnchors ABSL_GUARDED_BY(mMutex);
+
+  SharedCramRefs() = default;
+
+  [[nodiscard]] static auto MakeKey(sam_hdr_t* hdr, std::string const& fasta_path) -> u64 {
+    auto key = absl::HashOf(fasta_path);
+    auto const num_targets = sam_hdr_nref(hdr);
+    for (i32 tid = 0; tid < num_targets; ++tid) {
+      key = absl::HashOf(key, std::string_view(sam_hdr_tid2name(hdr, tid)),
+                         static_cast<i64>(sam_hdr_tid2len(hdr, tid)));
+    }
+    return key;
+  }
+};
+
+}  // namespace
+
 Extractor::Extractor(std::filesystem::path aln_file, Reference const& ref,
                      Alignment::Fields const fields, absl::Span<std::string const> tags,
                      bool const skip_ref_contig_check)
@@ -42,13 +126,17 @@ Extractor::Extractor(std::filesystem::path aln_file, Reference const& ref,
   hts_set_log_level(HTS_LOG_ERROR);
   auto const bc_path = mBamCramPath.string();
 
-  mFilePtr = InitHtsFile(bc_path.c_str());
+  mFilePtr = InitHtsFile(bc_path);
   EnsureValidBamOrCram(mFilePtr.get(), bc_path);
   mHdrPtr = InitSamHdr(mFilePtr.get(), bc_path);
 
   if (!skip_ref_contig_check) HeaderContigsCheck(mHdrPtr.get(), ref);
 
   SetDefaultHtsOpts(mFilePtr.get(), ref, bc_path);
+  if (mFilePtr->format.format == cram) {
+    SharedCramRefs::Instance().Attach(mFilePtr.get(), mHdrPtr.get(), bc_path,
+                                      ref.FastaPath().string());
+  }
   mIdxPtr = InitHtsIdx(mFilePtr.get(), bc_path);
   mItrPtr = InitHtsItr(mIdxPtr.get(), bc_path);
   mAlnPtr = InitSamAln(bc_path);
@@ -64,6 +152,19 @@ void Extractor::SetFilterExpression(std::string const& expr) {
 }
 
 void Extractor::SetRegionToExtract(std::string const& region_spec) {
+  mIsStreamRegion = false;
+  if (mStream != nullptr) {
+    i32 tid = -1;
+    hts_pos_t beg0 = 0;
+    hts_pos_t end0 = 0;
+    auto const* parsed =
+        sam_parse_region(mHdrPtr.get(), region_spec.c_str(), &tid, &beg0, &end0, 0);
+    if (parsed != nullptr && tid >= 0 && mStream->Collect(tid, beg0, end0, mStreamRecords)) {
+      mIsStreamRegion = true;
+      return;
+    }
+  }
+
   mItrPtr.reset(sam_itr_querys(mIdxPtr.get(), mHdrPtr.get(), region_spec.c_str()));
   if (mItrPtr == nullptr) {
     auto const err_msg = fmt::format("Could not set BAM/CRAM iterator for region: {}", region_spec);
@@ -76,6 +177,7 @@ void Extractor::SetRegionToExtract(Reference::Region const& region) {
 }
 
 void Extractor::SetRegionBatchToExtract(absl::Span<std::string> region_specs) {
+  mIsStreamRegion = false;
   std::vector<char*> regarray;
   regarray.reserve(region_specs.size() + 1);
   std::ranges::transform(region_specs, std::back_inserter(regarray),
@@ -105,6 +207,82 @@ void Extractor::SetNumThreads(int const nthreads) {
   }
 }
 
+void Extractor::AttachStream(std::shared_ptr<RecordStream> stream) {
+  mStream = std::move(stream);
+  mIsStreamRegion = false;
+}
+
+// ============================================================================
+// QueryIndexFootprint: index-only depth proxy for a region.
+//
+// A BAM index query resolves the region to the list of [u, v) virtual-offset
+// chunks whose bins overlap it, already pruned by the 16kb linear index. An
+// empty list means no record overlaps the region at all. Otherwise the upper
+// 48 bits of each offset are the compressed BGZF block address, so their
+// difference is the on-disk size of the records the iterator would decode.
+// ============================================================================
+auto Extractor::QueryIndexFootprint(std::string const& region_spec) const
+    -> std::optional<IndexFootprint> {
+  if (mFilePtr->format.format != bam) return std::nullopt;
+
+  HtsItr const itr(sam_itr_querys(mIdxPtr.get(), mHdrPtr.get(), region_spec.c_str()));
+  if (itr == nullptr) {
+    auto const err_msg = fmt::format("Could not query BAM index for region: {}", region_spec);
+    throw std::runtime_error(err_msg);
+  }
+
+  static constexpr u32 BGZF_BLOCK_SHIFT = 16;
+  IndexFootprint result{.mNumChunks = static_cast<u64>(itr->n_off)};
+  for (auto const& chunk : absl::MakeConstSpan(itr->off, result.mNumChunks)) {
+    result.mCompressedBytes += (chunk.v >> BGZF_BLOCK_SHIFT) - (chunk.u >> BGZF_BLOCK_SHIFT);
+  }
+
+  return result;
+}
+
+// ============================================================================
+// QueryIndexTotals: whole-file counterpart of QueryIndexFootprint.
+//
+// The mapped record count comes from each contig's pseudo-bin, and the bytes
+// from querying each contig end to end, so both are read from the in-memory
+// index without decoding a record.
+// ============================================================================
+auto Extractor::QueryIndexTotals() const -> std::optional<IndexTotals> {
+  if (mFilePtr->format.format != bam) return std::nullopt;
+
+  static constexpr u32 BGZF_BLOCK_SHIFT = 16;
+  IndexTotals result;
+  auto const num_contigs = hts_idx_nseq(mIdxPtr.get());
+  for (i32 tid = 0; tid < num_contigs; ++tid) {
+    // Contigs without records have no pseudo-bin, and neither does an index written
+    // without counts; both report failure here.
+    u64 num_mapped = 0;
+    u64 num_unmapped = 0;
+    if (hts_idx_get_stat(mIdxPtr.get(), tid, &num_mapped, &num_unmapped) != 0) continue;
+    if (num_mapped == 0) continue;
+
+    HtsItr const itr(sam_itr_queryi(mIdxPtr.get(), tid, 0, HTS_POS_MAX));
+    if (itr == nullptr) {
+      auto const err_msg = fmt::format("Could not query BAM index for contig: {}", ChromName(tid));
+      throw std::runtime_error(err_msg);
+    }
+
+    result.mMappedRecords += num_mapped;
+    for (auto const& chunk : absl::MakeConstSpan(itr->off, static_cast<usize>(itr->n_off))) {
+      result.mCompressedBytes += (chunk.v >> BGZF_BLOCK_SHIFT) - (chunk.u >> BGZF_BLOCK_SHIFT);
+    }
+  }
+
+  if (result.mMappedRecords == 0) return std::nullopt;
+  return result;
+}
+
+auto Extractor::SharesCramReference(Extractor const& other) const -> bool {
+  if (mFilePtr->format.format != cram || other.mFilePtr->format.format != cram) return false;
+  auto const* refs = cram_get_refs(mFilePtr.get());
+  return refs != nullptr && refs == cram_get_refs(other.mFilePtr.get());
+}
+
 auto Extractor::begin() -> Iterator {
   auto result = Iterator();
   result.mRawFilePtr = mFilePtr.get();
@@ -112,6 +290,10 @@ auto Extractor::begin() -> Iterator {
   result.mRawItrPtr = mItrPtr.get();
   result.mRawAlnPtr = mAlnPtr.get();
   result.mRawFiltrPtr = mFiltrPtr.get();
+  if (mIsStreamRegion) {
+    result.mStreamRecords = absl::MakeConstSpan(mStreamRecords);
+    result.mIsStreamed = true;
+  }
   result.FetchNextAlignment();
   return result;
 }
@@ -133,19 +315,28 @@ auto Extractor::ChromName(i32 chrom_index) const -> std::string {
   return {result};
 }
 
+void Extractor::SetRequiredFields(Alignment::Fields const fields) {
+  if (fields == mFieldsNeeded) return;
+  mFieldsNeeded = fields;
+  SetCramRequiredFields(mFieldsNeeded);
+}
+
 void Extractor::SetCramRequiredFields(Alignment::Fields fields) {
-  if (mFilePtr->format.format == cram && fields != Alignment::Fields::AUX_RGAUX) {
-    // htslib `htsFile::fp` is a tagged union; cram-specific access goes through the cram leg.
-    // cram_set_option is variadic per the htslib C API.
-    // NOLINTBEGIN(cppcoreguidelines-pro-type-union-access,cppcoreguidelines-pro-type-vararg)
-    cram_set_option(mFilePtr->fp.cram, CRAM_OPT_REQUIRED_FIELDS, fields);
-    cram_set_option(mFilePtr->fp.cram, CRAM_OPT_DECODE_MD, 0);
-    // NOLINTEND(cppcoreguidelines-pro-type-union-access,cppcoreguidelines-pro-type-vararg)
-  }
+  if (mFilePtr->format.format != cram) return;
+
+  // Takes effect from the next container decoded, i.e. the next region query.
+  // htslib `htsFile::fp` is a tagged union; cram-specific access goes through the cram leg.
+  // cram_set_option is variadic per the htslib C API.
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-union-access,cppcoreguidelines-pro-type-vararg)
+  auto const field_bits = static_cast<int>(fields);
+  cram_set_option(mFilePtr->fp.cram, CRAM_OPT_REQUIRED_FIELDS, field_bits);
+  // MD is only worth regenerating when aux fields are decoded at all
+  if ((field_bits & SAM_AUX) == 0) cram_set_option(mFilePtr->fp.cram, CRAM_OPT_DECODE_MD, 0);
+  // NOLINTEND(cppcoreguidelines-pro-type-union-access,cppcoreguidelines-pro-type-vararg)
 }
 
-auto Extractor::InitHtsFile(char const* file_path) -> HtsFile {
-  auto file_ptr = HtsFile(hts_open(file_path, "r"));
+auto Extractor::InitHtsFile(std::string const& file_path) -> HtsFile {
+  auto file_ptr = HtsFile(hts_open(BlockCache::Route(file_path).c_str(), "r"));
   if (file_ptr == nullptr) {
     auto const err_msg = fmt::format("Could not open alignment file: {}", file_path);
     throw std::runtime_error(err_msg);
@@ -165,14 +356,16 @@ auto Extractor::InitSamHdr(htsFile* raw_fp, std::string_view aln_path) -> SamHdr
 }
 
 auto Extractor::InitHtsIdx(htsFile* raw_fp, std::string const& aln_path) -> HtsIdx {
-  // Try loading alternative index before failing
-  auto idx_ptr = HtsIdx(sam_index_load(raw_fp, aln_path.c_str()));
+  // Try loading alternative index before failing. htslib derives the default index name
+  // from the routed path, so the index is read through the block cache as well.
+  auto const hts_path = BlockCache::Route(aln_path);
+  auto idx_ptr = HtsIdx(sam_index_load(raw_fp, hts_path.c_str()));
   if (idx_ptr == nullptr) {
-    usize const dot_position = aln_path.rfind('.', std::string::npos);
+    usize const dot_position = hts_path.rfind('.', std::string::npos);
     if (dot_position != 0 && dot_position != std::string::npos) {
       auto const* idx_extension = raw_fp->format.format == cram ? "crai" : "bai";
-      auto const alt_idx_path = aln_path.substr(0, dot_position) + idx_extension;
-      idx_ptr.reset(sam_index_load2(raw_fp, aln_path.c_str(), alt_idx_path.c_str()));
+      auto const alt_idx_path = hts_path.substr(0, dot_position) + idx_extension;
+      idx_ptr.reset(sam_index_load2(raw_fp, hts_path.c_str(), alt_idx_path.c_str()));
     }
   }
 
@@ -17,8 +17,10 @@ extern "C" {
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace lancet::hts {
 
@@ -50,6 +52,8 @@ struct HtsFilterDeleter {
 
 }  // namespace detail
 
+class RecordStream;
+
 class Extractor {
  public:
   static constexpr auto DEFAULT_FIELDS = Alignment::Fields::AUX_RGAUX;
@@ -69,6 +73,41 @@ class Extractor {
 
   void SetNumThreads(int nthreads);
 
+  /// Answers SetRegionToExtract(region) from `stream` when the region lies inside one of
+  /// its scan regions; other regions and region batches still query the file. `stream`
+  /// must read the same BAM/CRAM. See RecordStream for when its records are released.
+  void AttachStream(std::shared_ptr<RecordStream> stream);
+
+  /// Restricts which record fields CRAM decodes for subsequent iterations. No-op for BAM,
+  /// and for a CRAM whose fields are already set to `fields`.
+  void SetRequiredFields(Alignment::Fields fields);
+
+  /// BAI/CSI chunks of the records overlapping a region, read from the in-memory index
+  /// without touching the alignment file or decoding a single record.
+  struct IndexFootprint {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    u64 mNumChunks = 0;        // 0 → no record overlaps the region
+    u64 mCompressedBytes = 0;  // BGZF bytes spanned by the chunks (16kb-tile granularity)
+  };
+
+  /// std::nullopt for CRAM, whose .crai index has no bin chunks.
+  [[nodiscard]] auto QueryIndexFootprint(std::string const& region_spec) const
+      -> std::optional<IndexFootprint>;
+
+  /// Whole-file totals of the mapped records, summed over every contig of the index.
+  struct IndexTotals {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    u64 mMappedRecords = 0;    // from the index's per-contig mapped counts
+    u64 mCompressedBytes = 0;  // BGZF bytes spanned by the contigs' chunks
+  };
+
+  /// std::nullopt for CRAM, and for a BAI/CSI without per-contig mapped counts.
+  [[nodiscard]] auto QueryIndexTotals() const -> std::optional<IndexTotals>;
+
+  /// True when both handles decode CRAM against the same process-wide reference cache,
+  /// i.e. they read the same FASTA with the same @SQ list. Always false for BAM.
+  [[nodiscard]] auto SharesCramReference(Extractor const& other) const -> bool;
+
   /// Returns an Iterator that yields Alignment proxies one at a time.
   /// WARNING: each Alignment is invalidated on the next `++itr` call.
   /// See Iterator class documentation for the full lifetime contract.
@@ -97,12 +136,18 @@ class Extractor {
   SamAln mAlnPtr = nullptr;
   std::filesystem::path mBamCramPath;
   absl::flat_hash_set<std::string> mTagsNeeded;
+  std::shared_ptr<RecordStream> mStream;
+  std::vector<bam1_t*> mStreamRecords;  // current region's records, owned by mStream
   // ── 2B Align ────────────────────────────────────────────────────────────
   Alignment::Fields mFieldsNeeded;
+  // ── 1B Align ────────────────────────────────────────────────────────────
+  bool mIsStreamRegion = false;
+
+  friend class RecordStream;
 
   void SetCramRequiredFields(Alignment::Fields fields);
 
-  [[nodiscard]] static auto InitHtsFile(char const* file_path) -> HtsFile;
+  [[nodiscard]] static auto InitHtsFile(std::string const& file_path) -> HtsFile;
   [[nodiscard]] static auto InitSamHdr(htsFile* raw_fp, std::string_view aln_path) -> SamHdr;
   [[nodiscard]] static auto InitHtsIdx(htsFile* raw_fp, std::string const& aln_path) -> HtsIdx;
   [[nodiscard]] static auto InitHtsItr(hts_idx_t* raw_idx, std::string_view aln_path) -> HtsItr;
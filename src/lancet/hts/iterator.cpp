@@ -17,6 +17,11 @@ auto Iterator::operator!=(Iterator const& rhs) const -> bool {
 }
 
 auto Iterator::operator++() -> Iterator& {
+  if (mIsStreamed) {
+    FetchNextStreamedAlignment();
+    return *this;
+  }
+
   if (mRawFilePtr != nullptr &&
       mRawHdrPtr != nullptr &&
       mRawItrPtr != nullptr &&
@@ -34,6 +39,11 @@ auto Iterator::operator++(int) -> Iterator {
 }
 
 void Iterator::FetchNextAlignment() {
+  if (mIsStreamed) {
+    FetchNextStreamedAlignment();
+    return;
+  }
+
   auto const next_result = sam_itr_next(mRawFilePtr, mRawItrPtr, mRawAlnPtr);
   if (next_result < -1) {
     throw std::runtime_error("Could not fetch next alignment from BAM/CRAM iterator");
@@ -58,6 +68,19 @@ void Iterator::FetchNextAlignment() {
   FetchNextAlignment();
 }
 
+void Iterator::FetchNextStreamedAlignment() {
+  // Records are shared with other workers' iterators, so they are only ever read
+  while (mNextStreamIdx < mStreamRecords.size()) {
+    mRawAlnPtr = mStreamRecords[mNextStreamIdx++];
+    if (PassesFilter()) {
+      mParsedAln.PopulateFromRaw(mRawAlnPtr);
+      return;
+    }
+  }
+
+  mParsedAln.ClearAllFields();
+}
+
 auto Iterator::PassesFilter() const -> bool {
   if (mRawFiltrPtr == nullptr) {
     return true;
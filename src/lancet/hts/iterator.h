@@ -1,6 +1,7 @@
 #ifndef SRC_LANCET_HTS_ITERATOR_H_
 #define SRC_LANCET_HTS_ITERATOR_H_
 
+#include "lancet/base/types.h"
 #include "lancet/hts/alignment.h"
 
 extern "C" {
@@ -9,6 +10,8 @@ extern "C" {
 #include "htslib/sam.h"
 }
 
+#include "absl/types/span.h"
+
 #include <iterator>
 #include <string>
 #include <string_view>
@@ -53,12 +56,17 @@ class Iterator {
   hts_itr_t* mRawItrPtr = nullptr;
   bam1_t* mRawAlnPtr = nullptr;
   hts_filter_t* mRawFiltrPtr = nullptr;
+  absl::Span<bam1_t* const> mStreamRecords;  // records from an attached RecordStream
+  usize mNextStreamIdx = 0;
+  // ── 1B Align ────────────────────────────────────────────────────────────
+  bool mIsStreamed = false;
 
   friend class Extractor;
 
   Iterator() = default;
 
   void FetchNextAlignment();
+  void FetchNextStreamedAlignment();
   [[nodiscard]] auto PassesFilter() const -> bool;
 };
 
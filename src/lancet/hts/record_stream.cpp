@@ -0,0 +1,283 @@
+#include "lancet/hts/record_stream.h"
+
+#include "lancet/base/logging.h"
+#include "lancet/base/types.h"
+#include "lancet/hts/extractor.h"
+#include "lancet/hts/reference.h"
+
+extern "C" {
+#include "htslib/hts.h"
+#include "htslib/sam.h"
+}
+
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "spdlog/fmt/bundled/core.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lancet::hts {
+
+RecordStream::RecordStream(std::filesystem::path const& aln_file, Reference const& ref,
+                           std::vector<std::string> const& scan_specs, Params const params)
+    : mParams(params), mExtractor(aln_file, ref, Extractor::DEFAULT_FIELDS, {}, true) {
+  // The workers' own extractors already checked the header contigs against the reference
+  mExtractor.SetNumThreads(mParams.mDecodeThreads);
+  ParseScanRegions(scan_specs);
+  mReader = std::jthread([this] { ReadAll(); });
+}
+
+RecordStream::~RecordStream() {
+  absl::MutexLock const lock(mMutex);
+  mStopRequested = true;
+  mReaderCanRun.Signal();
+  // mReader is destroyed first and joins the reader once the lock is released
+}
+
+// ============================================================================
+// Collect: the records of one window, straight from the buffer.
+//
+// The buffer is sorted by (scan region, start), and no record is longer than
+// mMaxRecordSpan, so the first record that can overlap [beg0, end0) starts at
+// or after beg0 - mMaxRecordSpan. Once the reader has moved past end0, every
+// record starting before end0 is buffered and the scan can stop there.
+// ============================================================================
+auto RecordStream::Collect(i32 const tid, i64 const beg0, i64 const end0,
+                           std::vector<bam1_t*>& out) -> bool {
+  out.clear();
+  auto const scan_idx = FindScanIdx(tid, beg0, end0);
+  if (!scan_idx.has_value()) return false;
+
+  ScanKey const begin_pos{*scan_idx, beg0};
+  ScanKey const needed_pos{*scan_idx, end0};
+  absl::MutexLock const lock(mMutex);
+  if (!mIsDone && mReadPos < needed_pos) {
+    auto const waiting = mWaitingWindows.emplace(begin_pos, needed_pos);
+    mReaderCanRun.Signal();
+    while (!mIsDone && mReadPos < needed_pos) mRecordsArrived.Wait(&mMutex);
+    mWaitingWindows.erase(waiting);
+  }
+
+  if (!mError.empty()) {
+    auto const err_msg = fmt::format("Could not stream BAM/CRAM records: {}", mError);
+    throw std::runtime_error(err_msg);
+  }
+
+  ScanKey const first_key{*scan_idx, beg0 - mMaxRecordSpan};
+  auto itr = std::ranges::partition_point(mBuffer, [&first_key](Entry const& entry) -> bool {
+    return ScanKey{entry.mScanIdx, entry.mStart0} < first_key;
+  });
+
+  for (; itr != mBuffer.end() && itr->mScanIdx == *scan_idx && itr->mStart0 < end0; ++itr) {
+    if (itr->mEnd0 > beg0) out.push_back(itr->mAln.get());
+  }
+
+  return true;
+}
+
+void RecordStream::ReleaseBefore(std::string const& chrom_name, i64 const start0) {
+  auto const tid_itr = mTidsByName.find(chrom_name);
+  if (tid_itr == mTidsByName.end()) return;
+  auto const scan_idx = FindScanIdx(tid_itr->second, start0, start0 + 1);
+  if (!scan_idx.has_value()) return;
+
+  absl::MutexLock const lock(mMutex);
+  mReleasedPos = std::max(mReleasedPos, ScanKey{*scan_idx, start0});
+  mHasReleasedPos = true;
+  EvictReleased();
+  mReaderCanRun.Signal();
+}
+
+auto RecordStream::BufferedBytes() const -> u64 {
+  absl::MutexLock const lock(mMutex);
+  return mBufferedBytes;
+}
+
+auto RecordStream::FindScanIdx(i32 const tid, i64 const beg0, i64 const end0) const
+    -> std::optional<usize> {
+  auto const tid_itr = mScanIdxsByTid.find(tid);
+  if (tid_itr == mScanIdxsByTid.end()) return std::nullopt;
+
+  // Last scan region on the contig that starts at or before beg0
+  auto const& scan_idxs = tid_itr->second;
+  auto const after = std::ranges::upper_bound(scan_idxs, beg0, std::less{},
+                                              [this](usize const scan_idx) -> i64 {
+                                                return mScanRegions[scan_idx].mBeg0;
+                                              });
+  if (after == scan_idxs.begin()) return std::nullopt;
+
+  auto const scan_idx = *std::prev(after);
+  if (end0 > mScanRegions[scan_idx].mEnd0) return std::nullopt;
+  return scan_idx;
+}
+
+void RecordStream::ParseScanRegions(std::vector<std::string> const& scan_specs) {
+  auto* raw_hdr = mExtractor.mHdrPtr.get();
+  for (auto const& spec : scan_specs) {
+    i32 tid = -1;
+    hts_pos_t beg0 = 0;
+    hts_pos_t end0 = 0;
+    if (sam_parse_region(raw_hdr, spec.c_str(), &tid, &beg0, &end0, 0) == nullptr || tid < 0) {
+      LOG_WARN("Region {} is not in the BAM/CRAM header and will not be streamed", spec)
+      continue;
+    }
+
+    auto* last = mScanRegions.empty() ? nullptr : &mScanRegions.back();
+    if (last != nullptr && last->mTid == tid && beg0 >= last->mBeg0 && beg0 <= last->mEnd0) {
+      last->mEnd0 = std::max(last->mEnd0, static_cast<i64>(end0));
+      continue;
+    }
+
+    mScanRegions.push_back({.mBeg0 = beg0, .mEnd0 = end0, .mTid = tid});
+  }
+
+  for (usize scan_idx = 0; scan_idx < mScanRegions.size(); ++scan_idx) {
+    auto const tid = mScanRegions[scan_idx].mTid;
+    mScanIdxsByTid[tid].push_back(scan_idx);
+    mTidsByName.try_emplace(sam_hdr_tid2name(raw_hdr, tid), tid);
+  }
+
+  for (auto& [tid, scan_idxs] : mScanIdxsByTid) {
+    std::ranges::stable_sort(scan_idxs, std::less{}, [this](usize const scan_idx) -> i64 {
+      return mScanRegions[scan_idx].mBeg0;
+    });
+  }
+}
+
+void RecordStream::ReadAll() {
+  std::string error;
+  try {
+    for (usize scan_idx = 0; scan_idx < mScanRegions.size(); ++scan_idx) {
+      if (!ReadScanRegion(scan_idx)) break;
+    }
+  } catch (std::exception const& err) {
+    error = err.what();
+  }
+
+  absl::MutexLock const lock(mMutex);
+  mError = std::move(error);
+  mIsDone = true;
+  mRecordsArrived.SignalAll();
+}
+
+// ============================================================================
+// ReadScanRegion: decode one merged scan region into the buffer.
+//
+// Records are decoded in batches outside the lock, into bam1_t objects taken
+// from the free list when the workers have released enough of them, so a
+// steady-state scan allocates nothing per record. Each batch is appended
+// under the lock and wakes every worker whose window the reader just passed.
+// ============================================================================
+auto RecordStream::ReadScanRegion(usize const scan_idx) -> bool {
+  auto const& scan = mScanRegions[scan_idx];
+  Extractor::HtsItr const itr(
+      sam_itr_queryi(mExtractor.mIdxPtr.get(), scan.mTid, scan.mBeg0, scan.mEnd0));
+  if (itr == nullptr) {
+    auto const err_msg = fmt::format("Could not set BAM/CRAM iterator for contig {}",
+                                     mExtractor.ChromName(scan.mTid));
+    throw std::runtime_error(err_msg);
+  }
+
+  std::vector<Bam1Ptr> batch;
+  batch.reserve(READ_BATCH_SIZE);
+  bool at_end = false;
+
+  while (!at_end) {
+    {
+      absl::MutexLock const lock(mMutex);
+      while (ShouldPauseReading()) mReaderCanRun.Wait(&mMutex);
+      if (mStopRequested) return false;
+
+      while (batch.size() < READ_BATCH_SIZE && !mFreeRecords.empty()) {
+        batch.push_back(std::move(mFreeRecords.back()));
+        mFreeRecords.pop_back();
+      }
+    }
+
+    while (batch.size() < READ_BATCH_SIZE) {
+      batch.emplace_back(bam_init1());
+      if (batch.back() == nullptr) throw std::bad_alloc();
+    }
+
+    usize num_read = 0;
+    for (; num_read < batch.size(); ++num_read) {
+      auto const result = sam_itr_next(mExtractor.mFilePtr.get(), itr.get(), batch[num_read].get());
+      if (result < -1) throw std::runtime_error("Could not fetch next alignment from BAM/CRAM");
+      if (result == -1) {
+        at_end = true;
+        break;
+      }
+    }
+
+    absl::MutexLock const lock(mMutex);
+    for (auto& aln : absl::MakeSpan(batch).first(num_read)) {
+      auto const start0 = static_cast<i64>(aln->core.pos);
+      auto const end0 = static_cast<i64>(bam_endpos(aln.get()));
+      auto const num_bytes = sizeof(bam1_t) + static_cast<u64>(aln->m_data);
+      mMaxRecordSpan = std::max(mMaxRecordSpan, end0 - start0);
+      mBufferedBytes += num_bytes;
+      mBuffer.push_back({.mAln = std::move(aln),
+                         .mScanIdx = scan_idx,
+                         .mStart0 = start0,
+                         .mEnd0 = end0,
+                         .mNumBytes = num_bytes});
+    }
+
+    batch.erase(batch.begin(), batch.begin() + static_cast<i64>(num_read));
+    // A full batch means the buffer holds this scan's latest record
+    mReadPos = at_end ? ScanKey{scan_idx + 1, -1} : ScanKey{scan_idx, mBuffer.back().mStart0};
+    mRecordsArrived.SignalAll();
+  }
+
+  return true;
+}
+
+auto RecordStream::ShouldPauseReading() const -> bool {
+  if (mStopRequested || mBufferedBytes <= mParams.mMaxBufferedBytes) return false;
+  return !IsOldestWindowWaiting();
+}
+
+// ============================================================================
+// IsOldestWindowWaiting: may the reader go past the buffer cap?
+//
+// Records are only released once the oldest window in flight finishes, so if
+// that window is blocked on the reader, pausing would deadlock every worker.
+// mReleasedPos is that window's start, and no window in flight starts before
+// it, so a waiting window at or before it is the oldest one. Later windows
+// get nothing from going over the cap: they wait for the buffer to shrink.
+// A window the reader has already passed no longer counts: it is only waiting
+// to wake up, and reading on for it would take the buffer further over the cap.
+// ============================================================================
+auto RecordStream::IsOldestWindowWaiting() const -> bool {
+  for (auto const& [begin_pos, needed_pos] : mWaitingWindows) {
+    if (mHasReleasedPos && begin_pos > mReleasedPos) break;
+    if (mReadPos < needed_pos) return true;
+  }
+  return false;
+}
+
+void RecordStream::EvictReleased() {
+  while (!mBuffer.empty()) {
+    auto& front = mBuffer.front();
+    auto const is_released =
+        front.mScanIdx < mReleasedPos.first ||
+        (front.mScanIdx == mReleasedPos.first && front.mEnd0 <= mReleasedPos.second);
+    if (!is_released) break;
+
+    mBufferedBytes -= front.mNumBytes;
+    if (mFreeRecords.size() < MAX_FREE_RECORDS) mFreeRecords.push_back(std::move(front.mAln));
+    mBuffer.pop_front();
+  }
+}
+
+}  // namespace lancet::hts
@@ -0,0 +1,158 @@
+#ifndef SRC_LANCET_HTS_RECORD_STREAM_H_
+#define SRC_LANCET_HTS_RECORD_STREAM_H_
+
+#include "lancet/base/types.h"
+#include "lancet/hts/extractor.h"
+#include "lancet/hts/reference.h"
+
+extern "C" {
+#include "htslib/sam.h"
+}
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lancet::hts {
+
+// ============================================================================
+// RecordStream — one sample's alignments read once, front to back, for every
+// worker (--linear-scan).
+//
+// Per-window random access asks the index for every window of every sample,
+// and consecutive windows overlap, so WGS runs seek millions of times and
+// decode most BGZF blocks more than once. A RecordStream instead walks the
+// scan regions in order on its own thread, with htslib decoding BGZF blocks
+// on a thread pool, and keeps the records in a sliding buffer:
+//
+//   reader:   ──▶ [ released │ ← in use by workers → │ read ahead ] ──▶ file
+//                             ▲ ReleaseBefore          ▲ read position
+//
+// An Extractor attached to the stream answers SetRegionToExtract from that
+// buffer, waiting for the reader to pass the region's end if needed. The
+// buffer only shrinks when ReleaseBefore() is given the oldest window still
+// in flight; until then every record a worker may still ask for stays put,
+// so the pointers a worker iterates are never freed underneath it.
+//
+// The buffer cap is hard. Above it the reader pauses even while later windows
+// wait for records; those windows wait until the buffer shrinks. Only the
+// oldest window still in flight (the position last given to ReleaseBefore)
+// may pull the reader past the cap, because finishing it is what releases
+// records. A waiting oldest window is therefore always served, and only the
+// reads up to that window's end can take the buffer past the cap.
+// ============================================================================
+class RecordStream {
+ public:
+  static constexpr u64 DEFAULT_MAX_BUFFERED_BYTES = u64{512} << 20;
+  static constexpr int DEFAULT_DECODE_THREADS = 4;
+  /// Records decoded per reader step; the most the buffer grows between cap checks.
+  static constexpr usize READ_BATCH_SIZE = 256;
+
+  struct Params {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    u64 mMaxBufferedBytes = DEFAULT_MAX_BUFFERED_BYTES;
+    // ── 4B Align ──────────────────────────────────────────────────────────
+    int mDecodeThreads = DEFAULT_DECODE_THREADS;
+  };
+
+  /// Starts reading `scan_specs` (samtools region strings, sorted like the windows) from
+  /// `aln_file`. Overlapping or touching specs on the same contig are merged into one scan.
+  RecordStream(std::filesystem::path const& aln_file, Reference const& ref,
+               std::vector<std::string> const& scan_specs, Params params);
+  ~RecordStream();
+
+  RecordStream(RecordStream const&) = delete;
+  RecordStream(RecordStream&&) = delete;
+  auto operator=(RecordStream const&) -> RecordStream& = delete;
+  auto operator=(RecordStream&&) -> RecordStream& = delete;
+
+  /// Replaces `out` with the buffered records overlapping [beg0, end0) of contig `tid`,
+  /// in file order, blocking until the reader has passed `end0`. Returns false, leaving
+  /// `out` empty, when no scan region covers the range. Throws if the reader failed.
+  /// The records stay valid until ReleaseBefore() passes `beg0`.
+  auto Collect(i32 tid, i64 beg0, i64 end0, std::vector<bam1_t*>& out) -> bool;
+
+  /// Frees records that end before `start0` on `chrom_name`. That position must be the
+  /// start of the oldest window still being read or processed: no later Collect() may
+  /// ask for anything before it. Call it with the first window's start before workers
+  /// begin, so the reader knows which waiting window may go past the buffer cap; until
+  /// the first call, any waiting window may.
+  void ReleaseBefore(std::string const& chrom_name, i64 start0);
+
+  [[nodiscard]] auto BufferedBytes() const -> u64;
+
+ private:
+  using Bam1Ptr = std::unique_ptr<bam1_t, detail::Bam1Deleter>;
+
+  /// Position in scan order: index of the merged scan region, then 0-based start.
+  using ScanKey = std::pair<usize, i64>;
+
+  struct ScanRegion {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    i64 mBeg0 = 0;
+    i64 mEnd0 = 0;
+    // ── 4B Align ──────────────────────────────────────────────────────────
+    i32 mTid = -1;
+  };
+
+  struct Entry {
+    // ── 8B Align ──────────────────────────────────────────────────────────
+    Bam1Ptr mAln;
+    usize mScanIdx = 0;
+    i64 mStart0 = 0;
+    i64 mEnd0 = 0;
+    u64 mNumBytes = 0;
+  };
+
+  static constexpr usize MAX_FREE_RECORDS = 4096;
+
+  // ── 8B Align ────────────────────────────────────────────────────────────
+  mutable absl::Mutex mMutex;
+  absl::CondVar mReaderCanRun;    // buffer shrank, oldest window moved or started waiting, stop
+  absl::CondVar mRecordsArrived;  // reader moved forward, finished or failed
+  std::deque<Entry> mBuffer ABSL_GUARDED_BY(mMutex);
+  std::vector<Bam1Ptr> mFreeRecords ABSL_GUARDED_BY(mMutex);
+  std::string mError ABSL_GUARDED_BY(mMutex);
+  Params mParams;
+  Extractor mExtractor;  // owned by the reader thread once it starts
+  std::vector<ScanRegion> mScanRegions;
+  absl::flat_hash_map<i32, std::vector<usize>> mScanIdxsByTid;  // ascending mBeg0 per contig
+  absl::flat_hash_map<std::string, i32> mTidsByName;
+  ScanKey mReadPos ABSL_GUARDED_BY(mMutex) = {0, -1};
+  ScanKey mReleasedPos ABSL_GUARDED_BY(mMutex) = {0, -1};
+  // Blocked Collect()s: window start -> read position the window needs
+  absl::btree_multimap<ScanKey, ScanKey> mWaitingWindows ABSL_GUARDED_BY(mMutex);
+  u64 mBufferedBytes ABSL_GUARDED_BY(mMutex) = 0;
+  i64 mMaxRecordSpan ABSL_GUARDED_BY(mMutex) = 0;
+  // ── 1B Align ────────────────────────────────────────────────────────────
+  bool mHasReleasedPos ABSL_GUARDED_BY(mMutex) = false;
+  bool mIsDone ABSL_GUARDED_BY(mMutex) = false;
+  bool mStopRequested ABSL_GUARDED_BY(mMutex) = false;
+
+  std::jthread mReader;  // declared last: started after every other member exists
+
+  /// Scan region containing [beg0, end0) of `tid`, if any.
+  [[nodiscard]] auto FindScanIdx(i32 tid, i64 beg0, i64 end0) const -> std::optional<usize>;
+
+  void ParseScanRegions(std::vector<std::string> const& scan_specs);
+  void ReadAll();
+  /// Returns false when the stream was stopped before the region was fully read.
+  [[nodiscard]] auto ReadScanRegion(usize scan_idx) -> bool;
+  [[nodiscard]] auto ShouldPauseReading() const -> bool ABSL_EXCLUSIVE_LOCKS_REQUIRED(mMutex);
+  [[nodiscard]] auto IsOldestWindowWaiting() const -> bool ABSL_EXCLUSIVE_LOCKS_REQUIRED(mMutex);
+  void EvictReleased() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mMutex);
+};
+
+}  // namespace lancet::hts
+
+#endif  // SRC_LANCET_HTS_RECORD_STREAM_H_
@@ -1,6 +1,7 @@
 #include "lancet/hts/reference.h"
 
 #include "lancet/base/types.h"
+#include "lancet/hts/block_cache.h"
 
 extern "C" {
 #include "htslib/faidx.h"
@@ -28,7 +29,8 @@ namespace lancet::hts {
 
 Reference::Reference(std::filesystem::path reference) : mFastaPath(std::move(reference)) {
   hts_set_log_level(HTS_LOG_ERROR);
-  mFastaIndex = FastaIndex(fai_load3(mFastaPath.c_str(), nullptr, nullptr, 0));
+  auto const fasta_path = BlockCache::Route(mFastaPath.string());
+  mFastaIndex = FastaIndex(fai_load3(fasta_path.c_str(), nullptr, nullptr, 0));
   if (mFastaIndex == nullptr) {
     auto const fname = mFastaPath.filename().string();
     auto const msg = fmt::format("Could not load index for reference: {}", fname);
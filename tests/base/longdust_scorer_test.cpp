@@ -1,5 +1,6 @@
 #include "lancet/base/longdust_scorer.h"
 
+#include "lancet/base/rev_comp.h"
 #include "lancet/base/types.h"
 #include "lancet/hts/reference.h"
 
@@ -346,6 +347,43 @@ TEST_CASE("Score: N bases reduce score", "[lancet][base][LongdustQScorer]") {
   CHECK(scorer.Score("AAAAAAANAAAAAAA") < scorer.Score(std::string(15, 'A')));
 }
 
+TEST_CASE("Score: reverse complement scores the same", "[lancet][base][LongdustQScorer]") {
+  LongdustQScorer const scorer(7);  // gc_frac=0.41: the GC classes must not break the symmetry
+  auto seq = BuildRepeat("TTAGGG", 12) + RandomDna(80) + std::string(25, 'A');
+  seq[90] = 'N';
+  for (auto const& sub : {seq, seq.substr(0, 60), seq.substr(40, 100), BuildRepeat("AAC", 30)}) {
+    INFO("seq=" << sub);
+    CHECK(scorer.Score(sub) == Catch::Approx(scorer.ScoreOneStrand(RevComp(sub))).epsilon(1e-12));
+  }
+}
+
+TEST_CASE("Window: sliding scores match Score on substrings", "[lancet][base][LongdustQScorer]") {
+  LongdustQScorer const scorer(4);
+  // Repeats, random stretches and an N, so windows gain and lose repeated k-mers
+  auto hap = RandomDna(120, 7) + BuildRepeat("CA", 40) + RandomDna(60, 8) +
+             std::string(30, 'T') + RandomDna(150, 9);
+  hap[200] = 'N';
+  LongdustQScorer::Window window(scorer, hap);
+
+  auto const check_window = [&](usize const start, usize const end) {
+    auto const expected = scorer.Score(std::string_view(hap).substr(start, end - start));
+    INFO("start=" << start << " end=" << end);
+    CHECK(window.Score(start, end) == Catch::Approx(expected).epsilon(1e-9).margin(1e-12));
+  };
+
+  // ±50bp flanks of variants left to right, then right to left, then jumps
+  for (usize pos = 0; pos < hap.size(); pos += 3) {
+    check_window(pos >= 50 ? pos - 50 : 0, std::min(hap.size(), pos + 51));
+  }
+  for (usize pos = hap.size(); pos-- > 0;) {
+    check_window(pos >= 50 ? pos - 50 : 0, std::min(hap.size(), pos + 51));
+  }
+  check_window(0, 2);
+  check_window(300, hap.size());
+  check_window(10, 400);
+  check_window(hap.size(), hap.size());
+}
+
 // ╔══════════════════════════════════════════════════════════════════════════╗
 // ║  PART 3: Score Formatting & Constants                                    ║
 // ╚══════════════════════════════════════════════════════════════════════════╝
@@ -2,12 +2,16 @@
 
 #include "lancet/base/types.h"
 
+#include "absl/random/distributions.h"
 #include "absl/types/span.h"
 #include "catch_amalgamated.hpp"
 #include "lancet_test_config.h"
 
+#include <array>
 #include <filesystem>
 #include <fstream>
+#include <optional>
+#include <random>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -339,4 +343,98 @@ TEST_CASE("MannWhitneyEffectSize matches scipy mannwhitneyu on a curated corpus"
   }
 }
 
+// ╔══════════════════════════════════════════════════════════════════════════╗
+// ║  Histogram path equivalence                                              ║
+// ╚══════════════════════════════════════════════════════════════════════════╝
+
+TEST_CASE("MannWhitneyEffectSize u8 histogram path equals the sort-based path bit-for-bit",
+          "[lancet][base][MannWhitneyEffectSize]") {
+  // u8 inputs route through MannWhitneyEffectSizeFromCounts. The histogram
+  // walk must reproduce the sort-based rank sum and tie term exactly — not
+  // approximately — so the comparison below uses operator==, not Approx.
+  // Narrow value ranges force heavy ties (the MAPQ 60 / BQ 37 pile-up case).
+  static constexpr u64 BASE_SEED = 0x4D'57'55'48'49'53'54'4FULL;
+  static constexpr usize NUM_PROPERTY_ITERATIONS = 300;
+
+  // Const-literal seed is the project's documented determinism convention
+  // (see test_style.md / §A.9).
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(BASE_SEED);
+
+  for (usize iter = 0; iter < NUM_PROPERTY_ITERATIONS; ++iter) {
+    auto const num_ref = absl::Uniform<usize>(absl::IntervalClosed, generator, 0, 400);
+    auto const num_alt = absl::Uniform<usize>(absl::IntervalClosed, generator, 0, 400);
+    auto const max_val = absl::Uniform<u32>(absl::IntervalClosed, generator, 0, 255);
+    auto const min_val = absl::Uniform<u32>(absl::IntervalClosed, generator, 0, max_val);
+
+    std::vector<u8> ref_vals(num_ref);
+    std::vector<u8> alt_vals(num_alt);
+    for (auto& val : ref_vals) {
+      val = static_cast<u8>(absl::Uniform<u32>(absl::IntervalClosed, generator, min_val, max_val));
+    }
+    for (auto& val : alt_vals) {
+      val = static_cast<u8>(absl::Uniform<u32>(absl::IntervalClosed, generator, min_val, max_val));
+    }
+
+    auto const by_hist =
+        MannWhitneyEffectSize<u8>(absl::MakeConstSpan(ref_vals), absl::MakeConstSpan(alt_vals));
+    auto const by_sort = MannWhitneyEffectSizeBySort<u8>(absl::MakeConstSpan(ref_vals),
+                                                         absl::MakeConstSpan(alt_vals));
+
+    INFO("iteration " << iter << ", n_ref=" << num_ref << ", n_alt=" << num_alt);
+    REQUIRE(by_hist.has_value() == by_sort.has_value());
+    if (by_sort.has_value()) {
+      // engaged-optional asserted on the prior REQUIRE; clang-tidy does not see through Catch2.
+      // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+      CHECK(by_hist.value() == by_sort.value());
+    }
+  }
+}
+
+TEST_CASE("MannWhitneyEffectSizeFromCounts matches the sort-based path on explicit bins",
+          "[lancet][base][MannWhitneyEffectSize]") {
+  // Bins need not be the full u8 domain: any ascending value → count layout
+  // works (e.g. read positions bounded by read length).
+  // Values:   0  1  2  3  4
+  // REF:      2  0  3  1  0   → {0,0,2,2,2,3}
+  // ALT:      0  1  1  2  4   → {1,2,3,3,4,4,4,4}
+  std::array<u64, 5> const ref_counts = {2, 0, 3, 1, 0};
+  std::array<u64, 5> const alt_counts = {0, 1, 1, 2, 4};
+  std::vector<f64> const ref_vals = {0, 0, 2, 2, 2, 3};
+  std::vector<f64> const alt_vals = {1, 2, 3, 3, 4, 4, 4, 4};
+
+  auto const by_counts = MannWhitneyEffectSizeFromCounts(absl::MakeConstSpan(ref_counts),
+                                                         absl::MakeConstSpan(alt_counts));
+  auto const by_sort = MannWhitneyEffectSizeBySort<f64>(absl::MakeConstSpan(ref_vals),
+                                                        absl::MakeConstSpan(alt_vals));
+
+  REQUIRE(by_counts.has_value());
+  REQUIRE(by_sort.has_value());
+  // engaged-optional asserted on the prior REQUIREs; clang-tidy does not see through Catch2.
+  // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+  CHECK(by_counts.value() == by_sort.value());
+  // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+  CHECK(by_counts.value() > 0.0);
+}
+
+TEST_CASE("MannWhitneyEffectSizeFromCounts keeps the nullopt and zero-variance contract",
+          "[lancet][base][MannWhitneyEffectSize]") {
+  std::array<u64, 3> const empty = {0, 0, 0};
+  std::array<u64, 3> const single_bin = {0, 7, 0};
+
+  CHECK_FALSE(MannWhitneyEffectSizeFromCounts(absl::MakeConstSpan(empty),
+                                              absl::MakeConstSpan(single_bin))
+                  .has_value());
+  CHECK_FALSE(MannWhitneyEffectSizeFromCounts(absl::MakeConstSpan(single_bin),
+                                              absl::MakeConstSpan(empty))
+                  .has_value());
+
+  auto const all_tied = MannWhitneyEffectSizeFromCounts(absl::MakeConstSpan(single_bin),
+                                                        absl::MakeConstSpan(single_bin));
+  REQUIRE(all_tied.has_value());
+  // engaged-optional asserted on the prior REQUIRE; clang-tidy does not see through Catch2.
+  // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+  CHECK(all_tied.value() == 0.0);
+}
+
 }  // namespace lancet::base::tests
@@ -1,9 +1,14 @@
 #include "lancet/base/sequence_complexity.h"
 
+#include "lancet/base/types.h"
+
+#include "absl/random/distributions.h"
 #include "catch_amalgamated.hpp"
 
 #include <algorithm>
+#include <random>
 #include <string>
+#include <string_view>
 
 #include <cmath>
 
@@ -358,4 +363,69 @@ TEST_CASE("SequenceComplexity::MergeMax: element-wise max",
   CHECK(cplx1.DeltaHRun() >= cplx2.DeltaHRun());
 }
 
+// ╔══════════════════════════════════════════════════════════════════════════╗
+// ║  PART 7: HaplotypeProfile caches                                         ║
+// ╚══════════════════════════════════════════════════════════════════════════╝
+
+namespace {
+
+// Random haplotype with planted homopolymers and the odd N, so both runs and
+// ignored bases cross window boundaries.
+[[nodiscard]] auto RandomHaplotype(std::mt19937_64& generator, usize length) -> std::string {
+  static constexpr std::string_view BASES = "ACGTN";
+  std::string hap;
+  while (hap.size() < length) {
+    auto const num_symbols = absl::Bernoulli(generator, 0.02) ? BASES.size() : 4;
+    auto const base = BASES[absl::Uniform<usize>(generator, 0, num_symbols)];
+    auto const run = absl::Bernoulli(generator, 0.1)
+                         ? absl::Uniform<usize>(absl::IntervalClosed, generator, 2, 15)
+                         : 1;
+    hap.append(std::min(run, length - hap.size()), base);
+  }
+  return hap;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Score: profiled regions give identical features",
+          "[lancet][base][SequenceComplexityScorer]") {
+  static constexpr u64 BASE_SEED = 0x53'43'4F'52'45ULL;
+  static constexpr usize NUM_PROPERTY_ITERATIONS = 100;
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(BASE_SEED);
+  SequenceComplexityScorer const scorer;
+
+  for (usize iter = 0; iter < NUM_PROPERTY_ITERATIONS; ++iter) {
+    auto const ref_hap = RandomHaplotype(generator, 250);
+    auto const alt_hap = RandomHaplotype(generator, 260);
+    HaplotypeProfile const ref_profile(ref_hap);
+    HaplotypeProfile const alt_profile(alt_hap);
+
+    // Positions include both haplotype ends so the flank windows get clamped.
+    auto const pos = absl::Uniform<usize>(absl::IntervalClosed, generator, 0, 249);
+    auto const len = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 12);
+    HapRegion const ref{.mHaplotype = ref_hap, .mPos = pos, .mLen = len};
+    HapRegion const alt{.mHaplotype = alt_hap, .mPos = pos, .mLen = len};
+    HapRegion const ref_profiled{
+        .mHaplotype = ref_hap, .mPos = pos, .mLen = len, .mProfile = &ref_profile};
+    HapRegion const alt_profiled{
+        .mHaplotype = alt_hap, .mPos = pos, .mLen = len, .mProfile = &alt_profile};
+
+    auto const expected = scorer.Score(ref, alt);
+    auto const context = scorer.ScoreRefContext(ref_profiled);
+    auto const observed = scorer.ScoreWithContext(context, ref_profiled, alt_profiled);
+
+    INFO("iter=" << iter << " pos=" << pos << " len=" << len);
+    CHECK(observed.ContextHRun() == expected.ContextHRun());
+    CHECK(observed.ContextEntropy() == expected.ContextEntropy());
+    CHECK(observed.ContextFlankLQ() == expected.ContextFlankLQ());
+    CHECK(observed.ContextHaplotypeLQ() == expected.ContextHaplotypeLQ());
+    CHECK(observed.DeltaHRun() == expected.DeltaHRun());
+    CHECK(observed.DeltaEntropy() == expected.DeltaEntropy());
+    CHECK(observed.DeltaFlankLQ() == expected.DeltaFlankLQ());
+    CHECK(observed.FormatVcfValue() == expected.FormatVcfValue());
+  }
+}
+
 }  // namespace lancet::base::tests
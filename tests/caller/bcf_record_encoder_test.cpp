@@ -0,0 +1,289 @@
+#include "lancet/caller/bcf_record_encoder.h"
+
+#include "lancet/base/types.h"
+#include "lancet/caller/alt_allele.h"
+#include "lancet/caller/raw_variant.h"
+#include "lancet/caller/support_array.h"
+#include "lancet/caller/variant_call.h"
+#include "lancet/caller/variant_support.h"
+#include "lancet/cbdg/label.h"
+#include "lancet/cli/cli_params.h"
+#include "lancet/cli/vcf_header_builder.h"
+#include "lancet/core/sample_header_reader.h"
+#include "lancet/core/sample_info.h"
+#include "lancet/hts/bcf_writer.h"
+
+extern "C" {
+#include "htslib/hts.h"
+#include "htslib/kstring.h"
+#include "htslib/vcf.h"
+}
+
+#include "absl/types/span.h"
+#include "catch_amalgamated.hpp"
+#include "lancet_test_config.h"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace lancet::caller::tests {
+
+namespace {
+
+// Widest rounding any FORMAT float gets in text output (RMQ/NPBQ keep one decimal)
+constexpr f64 TEXT_FLOAT_MARGIN = 0.05;
+constexpr usize WINDOW_LENGTH = 1000;
+
+constexpr std::array<char const*, 4> INFO_FLAGS = {"SHARED", "CTRL", "CASE", "MULTIALLELIC"};
+constexpr std::array<char const*, 3> INFO_STRINGS = {"TYPE", "GRAPH_CX", "SEQ_CX"};
+constexpr std::array<char const*, 6> FORMAT_INTS = {"AD", "ADF", "ADR", "DP", "PL", "GQ"};
+constexpr std::array<char const*, 17> FORMAT_FLOATS = {
+    "RMQ",  "NPBQ", "SB",   "SCA",   "FLD",  "RPCD", "BQCD", "MQCD", "ASMD",
+    "SDFC", "PRAD", "PANG", "CMLOD", "FSSE", "AHDD", "HSE",  "PDCV"};
+
+struct BcfHdrFree {
+  void operator()(bcf_hdr_t* hdr) noexcept { bcf_hdr_destroy(hdr); }
+};
+struct Bcf1Free {
+  void operator()(bcf1_t* rec) noexcept { bcf_destroy(rec); }
+};
+struct HtsFileClose {
+  void operator()(htsFile* fptr) noexcept { hts_close(fptr); }
+};
+using HdrPtr = std::unique_ptr<bcf_hdr_t, BcfHdrFree>;
+using RecPtr = std::unique_ptr<bcf1_t, Bcf1Free>;
+using FilePtr = std::unique_ptr<htsFile, HtsFileClose>;
+
+auto MakeVariant(usize const pos1, std::string ref, std::vector<AltAllele> alts) -> RawVariant {
+  RawVariant var;
+  var.mChromIndex = 3;
+  var.mGenomeChromPos1 = pos1;
+  var.mLocalRefStart0Idx = 100;
+  var.mChromName = "chr4";
+  var.mRefAllele = std::move(ref);
+  var.mAlts = std::move(alts);
+  var.mGraphMetrics = {
+      .mGraphEntanglementIndex = 0.42, .mTipToPathCovRatio = 0.1, .mMaxSingleDirDegree = 3};
+  return var;
+}
+
+auto MakeAlt(std::string seq, AlleleType const type, i64 const length) -> AltAllele {
+  AltAllele alt;
+  alt.mSequence = std::move(seq);
+  alt.mType = type;
+  alt.mLength = length;
+  return alt;
+}
+
+// `count` reads for `allele`, alternating strand, with varied qualities and
+// positions so every FORMAT metric has a non-trivial value.
+void AddReads(VariantSupport& support, AlleleIndex const allele, u32 const count,
+              u32 const first_name_hash) {
+  for (u32 idx = 0; idx < count; ++idx) {
+    support.AddEvidence({
+        .mInsertSize = 250 + static_cast<i64>(idx * 7),
+        .mAlignmentStart = 99'800 + static_cast<i64>(idx * 5),
+        .mAlnScore = 140.0 - idx,
+        .mFoldedReadPos = 0.05 * static_cast<f64>(idx % 10),
+        .mRnameHash = first_name_hash + idx,
+        .mRefNm = idx % 3,
+        .mOwnHapNm = idx % 2,
+        .mAssignedHaplotypeId = allele + (idx % 2),
+        .mAllele = allele,
+        .mStrand = idx % 2 == 0 ? Strand::FWD : Strand::REV,
+        .mBaseQual = static_cast<u8>(20 + (idx % 18)),
+        .mMapQual = static_cast<u8>(40 + (idx % 21)),
+        .mIsSoftClipped = idx % 5 == 0,
+        .mIsProperPair = true,
+    });
+  }
+}
+
+auto InfoStr(bcf_hdr_t* hdr, bcf1_t* rec, char const* tag) -> std::string {
+  char* value = nullptr;
+  int capacity = 0;
+  auto const len = bcf_get_info_string(hdr, rec, tag, &value, &capacity);
+  std::string result = len > 0 ? std::string(value, static_cast<usize>(len)) : std::string();
+  std::free(value);  // NOLINT(cppcoreguidelines-no-malloc)
+  return result;
+}
+
+template <typename T, typename Getter>
+auto GetValues(Getter&& getter) -> std::vector<T> {
+  T* values = nullptr;
+  int capacity = 0;
+  auto const count = getter(&values, &capacity);
+  std::vector<T> result;
+  if (count > 0) result.assign(values, values + count);
+  std::free(values);  // NOLINT(cppcoreguidelines-no-malloc)
+  return result;
+}
+
+// Field-by-field comparison of the htslib decodings of one BCF record and
+// the text VCF line written for the same call.
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+void CheckSameRecord(bcf_hdr_t* txt_hdr, bcf1_t* txt_rec, bcf_hdr_t* bin_hdr, bcf1_t* bin_rec) {
+  bcf_unpack(txt_rec, BCF_UN_ALL);
+  bcf_unpack(bin_rec, BCF_UN_ALL);
+
+  CHECK(std::string_view(bcf_seqname_safe(txt_hdr, txt_rec)) ==
+        std::string_view(bcf_seqname_safe(bin_hdr, bin_rec)));
+  CHECK(txt_rec->pos == bin_rec->pos);
+  CHECK(txt_rec->rlen == bin_rec->rlen);
+  CHECK(bin_rec->qual == Catch::Approx(txt_rec->qual).margin(0.005));
+  REQUIRE(txt_rec->n_allele == bin_rec->n_allele);
+  for (u32 idx = 0; idx < txt_rec->n_allele; ++idx) {
+    CHECK(std::string_view(txt_rec->d.allele[idx]) == std::string_view(bin_rec->d.allele[idx]));
+  }
+
+  for (auto const* tag : INFO_FLAGS) {
+    INFO("INFO/" << tag);
+    CHECK(bcf_get_info_flag(txt_hdr, txt_rec, tag, nullptr, nullptr) ==
+          bcf_get_info_flag(bin_hdr, bin_rec, tag, nullptr, nullptr));
+  }
+  for (auto const* tag : INFO_STRINGS) {
+    INFO("INFO/" << tag);
+    CHECK(InfoStr(txt_hdr, txt_rec, tag) == InfoStr(bin_hdr, bin_rec, tag));
+  }
+  auto const info_lengths = [](bcf_hdr_t* hdr, bcf1_t* rec) {
+    return GetValues<i32>([&](i32** dst, int* cap) {
+      return bcf_get_info_int32(hdr, rec, "LENGTH", dst, cap);
+    });
+  };
+  CHECK(info_lengths(txt_hdr, txt_rec) == info_lengths(bin_hdr, bin_rec));
+
+  auto const genotypes = [](bcf_hdr_t* hdr, bcf1_t* rec) {
+    return GetValues<i32>(
+        [&](i32** dst, int* cap) { return bcf_get_genotypes(hdr, rec, dst, cap); });
+  };
+  CHECK(genotypes(txt_hdr, txt_rec) == genotypes(bin_hdr, bin_rec));
+
+  for (auto const* tag : FORMAT_INTS) {
+    INFO("FORMAT/" << tag);
+    auto const ints_of = [tag](bcf_hdr_t* hdr, bcf1_t* rec) {
+      return GetValues<i32>([&](i32** dst, int* cap) {
+        return bcf_get_format_int32(hdr, rec, tag, dst, cap);
+      });
+    };
+    CHECK(ints_of(txt_hdr, txt_rec) == ints_of(bin_hdr, bin_rec));
+  }
+
+  for (auto const* tag : FORMAT_FLOATS) {
+    INFO("FORMAT/" << tag);
+    auto const floats_of = [tag](bcf_hdr_t* hdr, bcf1_t* rec) {
+      return GetValues<f32>([&](f32** dst, int* cap) {
+        return bcf_get_format_float(hdr, rec, tag, dst, cap);
+      });
+    };
+    auto const txt_vals = floats_of(txt_hdr, txt_rec);
+    auto const bin_vals = floats_of(bin_hdr, bin_rec);
+    REQUIRE(txt_vals.size() == bin_vals.size());
+    for (usize idx = 0; idx < txt_vals.size(); ++idx) {
+      INFO("value " << idx);
+      CHECK(bcf_float_is_missing(txt_vals[idx]) == bcf_float_is_missing(bin_vals[idx]));
+      CHECK(bcf_float_is_vector_end(txt_vals[idx]) == bcf_float_is_vector_end(bin_vals[idx]));
+      if (bcf_float_is_missing(txt_vals[idx]) || bcf_float_is_vector_end(txt_vals[idx])) continue;
+      CHECK(bin_vals[idx] == Catch::Approx(txt_vals[idx]).margin(TEXT_FLOAT_MARGIN));
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("BcfRecordEncoder round-trips against the text VCF record",
+          "[lancet][caller][BcfRecordEncoder]") {
+  namespace fs = std::filesystem;
+  cli::CliParams params;
+  auto& rc_params = params.mVariantBuilder.mRdCollParams;
+  rc_params.mRefPath = MakePath(FULL_DATA_DIR, GRCH38_REF_NAME);
+  rc_params.mCasePaths = {MakePath(FULL_DATA_DIR, CASE_BAM_NAME)};
+  rc_params.mCtrlPaths = {MakePath(FULL_DATA_DIR, CTRL_BAM_NAME)};
+  params.mIsCaseCtrlMode = true;
+  REQUIRE(fs::exists(rc_params.mCasePaths[0]));
+
+  auto const header_text = cli::BuildVcfHeader(params);
+  auto samples = core::MakeSampleList(rc_params);
+  REQUIRE(samples.size() == 2);
+  for (auto& sinfo : samples) sinfo.SetNumSampledBases(30 * WINDOW_LENGTH);
+
+  auto const case_idx = samples[0].TagKind() == cbdg::Label::CASE ? samples[0].SampleIndex()
+                                                                   : samples[1].SampleIndex();
+  auto const ctrl_idx = samples[0].TagKind() == cbdg::Label::CASE ? samples[1].SampleIndex()
+                                                                   : samples[0].SampleIndex();
+
+  // A somatic SNV seen in both samples, then a multi-allelic indel site the
+  // control has no reads for, so its FORMAT columns are all missing.
+  std::vector<RawVariant> variants;
+  variants.push_back(MakeVariant(100'000, "A", {MakeAlt("T", AlleleType::SNV, 1)}));
+  variants.push_back(MakeVariant(
+      100'100, "AC", {MakeAlt("A", AlleleType::DEL, 1), MakeAlt("ACT", AlleleType::INS, 1)}));
+
+  VariantCall::SupportsByVariant supports;
+  auto& snv_supports = supports[variants.data()];
+  AddReads(snv_supports.FindOrCreate(case_idx), 0, 14, 1000);
+  AddReads(snv_supports.FindOrCreate(case_idx), 1, 9, 2000);
+  AddReads(snv_supports.FindOrCreate(ctrl_idx), 0, 17, 3000);
+
+  auto& multi_supports = supports[&variants[1]];
+  AddReads(multi_supports.FindOrCreate(case_idx), 0, 11, 4000);
+  AddReads(multi_supports.FindOrCreate(case_idx), 1, 6, 5000);
+  AddReads(multi_supports.FindOrCreate(case_idx), 2, 4, 6000);
+
+  std::vector<VariantCall> calls;
+  for (auto const& var : variants) {
+    calls.emplace_back(&var, supports, absl::MakeConstSpan(samples), WINDOW_LENGTH);
+  }
+
+  auto const bcf_path = fs::temp_directory_path() / "lancet_bcf_record_encoder_test.bcf";
+  {
+    hts::BcfWriter writer;
+    REQUIRE(writer.Open(bcf_path, header_text));
+    BcfRecordEncoder encoder(writer.Header());
+    for (auto const& call : calls) {
+      encoder.Encode(call, writer.NextRecord());
+      writer.WriteRecord();
+    }
+    writer.Close();
+  }
+  REQUIRE(fs::exists(bcf_path.string() + ".csi"));
+
+  // Text side: the same header and each call's VCF line, parsed by htslib
+  HdrPtr const txt_hdr(bcf_hdr_init("r"));
+  std::string header_copy = header_text;
+  REQUIRE(bcf_hdr_parse(txt_hdr.get(), header_copy.data()) == 0);
+
+  FilePtr const bin_file(hts_open(bcf_path.c_str(), "r"));
+  REQUIRE(bin_file != nullptr);
+  HdrPtr const bin_hdr(bcf_hdr_read(bin_file.get()));
+  REQUIRE(bin_hdr != nullptr);
+
+  RecPtr const txt_rec(bcf_init());
+  RecPtr const bin_rec(bcf_init());
+  for (auto const& call : calls) {
+    auto const line = call.AsVcfRecord();
+    INFO(line);
+    kstring_t kline = KS_INITIALIZE;
+    kputsn(line.data(), line.size(), &kline);
+    auto const parsed = vcf_parse(&kline, txt_hdr.get(), txt_rec.get());
+    ks_free(&kline);
+    REQUIRE(parsed == 0);
+
+    REQUIRE(bcf_read(bin_file.get(), bin_hdr.get(), bin_rec.get()) == 0);
+    CheckSameRecord(txt_hdr.get(), txt_rec.get(), bin_hdr.get(), bin_rec.get());
+  }
+  CHECK(bcf_read(bin_file.get(), bin_hdr.get(), bin_rec.get()) == -1);
+
+  fs::remove(bcf_path);
+  fs::remove(bcf_path.string() + ".csi");
+}
+
+}  // namespace lancet::caller::tests
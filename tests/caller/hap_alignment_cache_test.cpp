@@ -0,0 +1,96 @@
+#include "lancet/caller/hap_alignment_cache.h"
+
+#include "lancet/base/types.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <optional>
+
+namespace lancet::caller::tests {
+
+namespace {
+
+[[nodiscard]] auto MakeAlignment(i32 const score) -> Mm2AlnResult {
+  Mm2AlnResult aln;
+  aln.mScore = score;
+  aln.mRefStart = score;
+  aln.mRefEnd = score + 1;
+  return aln;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("HapAlignmentCache memoizes alignments and negative results",
+          "[lancet][caller][HapAlignmentCache]") {
+  HapAlignmentCache cache;
+  HapAlignmentCache::Key const mapped{.mReadSeqHash = 1, .mHapSeqHash = 10};
+  HapAlignmentCache::Key const unmapped{.mReadSeqHash = 1, .mHapSeqHash = 20};
+
+  CHECK(cache.Find(mapped) == nullptr);
+  cache.Insert(mapped, MakeAlignment(42));
+  cache.Insert(unmapped, std::nullopt);
+
+  auto const* hit = cache.Find(mapped);
+  REQUIRE(hit != nullptr);
+  REQUIRE(hit->has_value());
+  CHECK((*hit)->mScore == 42);
+
+  // A cached "does not map" result is a hit, not a miss.
+  auto const* negative = cache.Find(unmapped);
+  REQUIRE(negative != nullptr);
+  CHECK_FALSE(negative->has_value());
+
+  // Swapping read and haplotype hashes is a different pair.
+  CHECK(cache.Find({.mReadSeqHash = 10, .mHapSeqHash = 1}) == nullptr);
+
+  // Same bases under another name: minimap2 may break ties differently.
+  CHECK(cache.Find({.mQnameHash = 7, .mReadSeqHash = 1, .mHapSeqHash = 10}) == nullptr);
+
+  cache.Clear();
+  CHECK(cache.Size() == 0);
+  CHECK(cache.Find(mapped) == nullptr);
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("HapAlignmentCache evicts by generation and promotes reused entries",
+          "[lancet][caller][HapAlignmentCache]") {
+  static constexpr usize CAPACITY = 4;
+  HapAlignmentCache cache(CAPACITY);
+
+  auto const key_of = [](u64 const read) {
+    return HapAlignmentCache::Key{.mReadSeqHash = read, .mHapSeqHash = 0};
+  };
+
+  // Fill generation 1 with reads 0..3.
+  for (u64 read = 0; read < CAPACITY; ++read) {
+    cache.Insert(key_of(read), MakeAlignment(static_cast<i32>(read)));
+  }
+  CHECK(cache.Size() == CAPACITY);
+
+  // Inserting read 4 rotates: reads 0..3 become the previous generation.
+  cache.Insert(key_of(4), MakeAlignment(4));
+  CHECK(cache.Size() == CAPACITY + 1);
+
+  // Touching read 0 promotes it into the current generation.
+  REQUIRE(cache.Find(key_of(0)) != nullptr);
+
+  // Fill the current generation (now {4, 0}) to trigger a second rotation.
+  cache.Insert(key_of(5), MakeAlignment(5));
+  cache.Insert(key_of(6), MakeAlignment(6));
+  cache.Insert(key_of(7), MakeAlignment(7));
+
+  // Untouched reads 1..3 aged out after two rotations; read 0 survived.
+  CHECK(cache.Find(key_of(1)) == nullptr);
+  CHECK(cache.Find(key_of(2)) == nullptr);
+  CHECK(cache.Find(key_of(3)) == nullptr);
+
+  auto const* survivor = cache.Find(key_of(0));
+  REQUIRE(survivor != nullptr);
+  REQUIRE(survivor->has_value());
+  CHECK((*survivor)->mScore == 0);
+
+  CHECK(cache.Size() <= 2 * CAPACITY);
+}
+
+}  // namespace lancet::caller::tests
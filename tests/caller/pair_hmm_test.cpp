@@ -0,0 +1,196 @@
+#include "lancet/caller/pair_hmm.h"
+
+#include "lancet/base/types.h"
+
+#include "absl/random/distributions.h"
+#include "catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <cmath>
+
+namespace lancet::caller::tests {
+
+namespace {
+
+// ============================================================================
+// NaiveLog10Likelihood: full (read_len+1) × (hap_len+1) f64 forward matrices,
+// row-major, written straight from the recurrences in pair_hmm.h. Independent
+// of the anti-diagonal / SIMD evaluation order, so it serves as the oracle.
+// ============================================================================
+[[nodiscard]] auto NaiveLog10Likelihood(std::vector<u8> const& read, std::vector<u8> const& quals,
+                                        std::vector<u8> const& hap) -> f64 {
+  auto const err = [](u8 const qual) -> f64 {
+    return std::pow(10.0, -static_cast<f64>(std::max(qual, PairHmm::MIN_USABLE_BASE_QUAL)) / 10.0);
+  };
+  f64 const delta = std::pow(10.0, -static_cast<f64>(PairHmm::DEFAULT_INDEL_QUAL) / 10.0);
+  f64 const gcp = std::pow(10.0, -static_cast<f64>(PairHmm::DEFAULT_GAP_CONTINUATION_QUAL) / 10.0);
+
+  auto const rows = read.size() + 1;
+  auto const cols = hap.size() + 1;
+  std::vector<f64> mat_m(rows * cols, 0.0);
+  std::vector<f64> mat_i(rows * cols, 0.0);
+  std::vector<f64> mat_d(rows * cols, 0.0);
+  auto const at = [cols](usize row, usize col) { return (row * cols) + col; };
+
+  for (usize col = 0; col < cols; ++col) mat_d[at(0, col)] = 1.0;
+
+  for (usize row = 1; row < rows; ++row) {
+    for (usize col = 1; col < cols; ++col) {
+      auto const rbase = read[row - 1];
+      auto const hbase = hap[col - 1];
+      auto const eps = err(quals[row - 1]);
+      bool const is_match = rbase == hbase || rbase == 4 || hbase == 4;
+      f64 const prior = is_match ? 1.0 - eps : eps / 3.0;
+
+      mat_m[at(row, col)] = prior * ((1.0 - 2.0 * delta) * mat_m[at(row - 1, col - 1)] +
+                                     (1.0 - gcp) * (mat_i[at(row - 1, col - 1)] +
+                                                    mat_d[at(row - 1, col - 1)]));
+      mat_i[at(row, col)] = delta * mat_m[at(row - 1, col)] + gcp * mat_i[at(row - 1, col)];
+      mat_d[at(row, col)] = delta * mat_m[at(row, col - 1)] + gcp * mat_d[at(row, col - 1)];
+    }
+  }
+
+  f64 total = 0.0;
+  for (usize col = 1; col < cols; ++col) {
+    total += mat_m[at(rows - 1, col)] + mat_i[at(rows - 1, col)];
+  }
+  return std::log10(total);
+}
+
+[[nodiscard]] auto RandomBases(std::mt19937_64& generator, usize const length) -> std::vector<u8> {
+  std::vector<u8> bases(length);
+  for (auto& base : bases) base = absl::Uniform<u8>(absl::IntervalClosed, generator, 0, 3);
+  return bases;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("PairHmm matches a full-matrix forward oracle", "[lancet][caller][PairHmm]") {
+  static constexpr u64 BASE_SEED = 0x50'41'49'52'48'4D'4DULL;
+  static constexpr usize NUM_PROPERTY_ITERATIONS = 200;
+
+  // Const-literal seed is the project's documented determinism convention
+  // (see test_style.md / §A.9).
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(BASE_SEED);
+  PairHmm engine;
+
+  for (usize iter = 0; iter < NUM_PROPERTY_ITERATIONS; ++iter) {
+    // Lengths straddle the 8-lane AVX2 width so both the vector body and the
+    // scalar tail of every diagonal are exercised.
+    auto const hap_len = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 180);
+    auto const read_len = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 160);
+
+    std::vector<u8> hap(hap_len);
+    for (auto& base : hap) base = absl::Uniform<u8>(absl::IntervalClosed, generator, 0, 4);
+
+    // Half the reads are a mutated slice of the haplotype, half are random.
+    std::vector<u8> read(read_len);
+    auto const start = absl::Uniform<usize>(absl::IntervalClosed, generator, 0, hap_len - 1);
+    bool const from_hap = absl::Bernoulli(generator, 0.5);
+    for (usize idx = 0; idx < read_len; ++idx) {
+      bool const mutate = absl::Bernoulli(generator, 0.05);
+      read[idx] = from_hap && !mutate ? hap[(start + idx) % hap_len]
+                                      : absl::Uniform<u8>(absl::IntervalClosed, generator, 0, 3);
+    }
+
+    std::vector<u8> quals(read_len);
+    for (auto& qual : quals) qual = absl::Uniform<u8>(absl::IntervalClosed, generator, 2, 41);
+
+    auto const expected = NaiveLog10Likelihood(read, quals, hap);
+    auto const observed = engine.Log10Likelihood(read, quals, hap);
+
+    INFO("iter=" << iter << " read_len=" << read_len << " hap_len=" << hap_len);
+    // f32 accumulates ~1e-7 relative error per cell; on a log10 scale that stays
+    // well inside 1e-3 for the lengths exercised here.
+    CHECK(observed == Catch::Approx(expected).margin(1e-3));
+  }
+}
+
+TEST_CASE("PairHmm ranks the source haplotype above a mismatching one",
+          "[lancet][caller][PairHmm]") {
+  // REF:  ACGTACGTTGCAACGT...   ALT: single substitution in the middle.
+  std::vector<u8> const ref_hap = {0, 1, 2, 3, 0, 1, 2, 3, 3, 2, 1, 0, 0, 1, 2, 3, 1, 1, 2, 0, 3, 3};
+  auto alt_hap = ref_hap;
+  alt_hap[11] = 3;
+
+  std::vector<u8> const read(ref_hap.begin() + 3, ref_hap.end() - 3);
+  std::vector<u8> const high_quals(read.size(), 40);
+  std::vector<u8> const low_quals(read.size(), 10);
+
+  PairHmm engine;
+  auto const ref_high = engine.Log10Likelihood(read, high_quals, ref_hap);
+  auto const alt_high = engine.Log10Likelihood(read, high_quals, alt_hap);
+  auto const ref_low = engine.Log10Likelihood(read, low_quals, ref_hap);
+  auto const alt_low = engine.Log10Likelihood(read, low_quals, alt_hap);
+
+  CHECK(ref_high > alt_high);
+  CHECK(ref_low > alt_low);
+  // Low base quality makes the mismatch cheaper, shrinking the REF-vs-ALT gap.
+  CHECK((ref_high - alt_high) > (ref_low - alt_low));
+
+  // An N in the read matches any haplotype base: both haplotypes explain it equally.
+  auto masked = read;
+  masked[11 - 3] = 4;
+  CHECK(engine.Log10Likelihood(masked, high_quals, ref_hap) ==
+        Catch::Approx(engine.Log10Likelihood(masked, high_quals, alt_hap)).epsilon(1e-6));
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("PairHmm orders REF and ALT on known SNV and indel reads",
+          "[lancet][caller][PairHmm]") {
+  static constexpr u64 HAP_SEED = 0x53'4E'56'49'4E'44ULL;
+  static constexpr usize HAP_LEN = 300;
+  static constexpr usize READ_LEN = 150;
+  static constexpr usize VAR_POS = 160;
+  static constexpr usize READ_START = 90;  // the read covers VAR_POS ± 70
+
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(HAP_SEED);
+  auto const ref_hap = RandomBases(generator, HAP_LEN);
+  std::vector<u8> const quals(READ_LEN, 35);
+
+  auto const read_from = [](std::vector<u8> const& hap, usize const start) -> std::vector<u8> {
+    return {hap.begin() + static_cast<i64>(start),
+            hap.begin() + static_cast<i64>(start + READ_LEN)};
+  };
+
+  PairHmm engine;
+  auto const lik = [&engine, &quals](std::vector<u8> const& read, std::vector<u8> const& hap) {
+    return engine.Log10Likelihood(read, quals, hap);
+  };
+
+  SECTION("SNV") {
+    auto alt_hap = ref_hap;
+    alt_hap[VAR_POS] = (ref_hap[VAR_POS] + 1) % 4;
+
+    auto const alt_read = read_from(alt_hap, READ_START);
+    auto const ref_read = read_from(ref_hap, READ_START);
+    CHECK(lik(alt_read, alt_hap) > lik(alt_read, ref_hap));
+    CHECK(lik(ref_read, ref_hap) > lik(ref_read, alt_hap));
+  }
+
+  SECTION("Insertion and deletion") {
+    // ALT inserts 4 bp after VAR_POS, so it is longer than REF; the deletion
+    // ALT is REF with those 4 bp removed again, i.e. the same pair reversed.
+    auto const inserted = RandomBases(generator, 4);
+    auto ins_hap = ref_hap;
+    ins_hap.insert(ins_hap.begin() + static_cast<i64>(VAR_POS), inserted.begin(), inserted.end());
+
+    auto const ins_read = read_from(ins_hap, READ_START);
+    auto const ref_read = read_from(ref_hap, READ_START);
+    CHECK(lik(ins_read, ins_hap) > lik(ins_read, ref_hap));
+    CHECK(lik(ref_read, ref_hap) > lik(ref_read, ins_hap));
+
+    // A read that never reaches the indel is explained equally by both
+    // haplotypes: the start prior does not depend on haplotype length.
+    auto const flank_read = read_from(ref_hap, 0);
+    CHECK(lik(flank_read, ins_hap) == Catch::Approx(lik(flank_read, ref_hap)).margin(1e-6));
+  }
+}
+
+}  // namespace lancet::caller::tests
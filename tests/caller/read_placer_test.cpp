@@ -0,0 +1,121 @@
+#include "lancet/caller/read_placer.h"
+
+#include "lancet/base/types.h"
+#include "lancet/caller/hap_alignment_cache.h"
+
+#include "absl/random/distributions.h"
+#include "catch_amalgamated.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace lancet::caller::tests {
+
+namespace {
+
+constexpr usize HAP_LEN = 300;
+constexpr usize READ_LEN = 150;
+constexpr usize VAR_POS = 160;
+constexpr usize READ_START = 90;  // reads cover VAR_POS ± 70
+
+[[nodiscard]] auto RandomBases(std::mt19937_64& generator, usize const length) -> std::vector<u8> {
+  std::vector<u8> bases(length);
+  for (auto& base : bases) base = absl::Uniform<u8>(absl::IntervalClosed, generator, 0, 3);
+  return bases;
+}
+
+[[nodiscard]] auto Slice(std::vector<u8> const& seq, usize const start, usize const length)
+    -> std::vector<u8> {
+  return {seq.begin() + static_cast<i64>(start), seq.begin() + static_cast<i64>(start + length)};
+}
+
+[[nodiscard]] auto CigarString(Mm2AlnResult const& aln) -> std::string {
+  std::string result;
+  for (auto const& unit : aln.mCigar) {
+    result += std::to_string(unit.Length());
+    result += static_cast<char>(unit.Operation());
+  }
+  return result;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("ReadPlacer aligns reads inside the seeded band", "[lancet][caller][ReadPlacer]") {
+  static constexpr u64 HAP_SEED = 0x52'45'41'44'50'4CULL;
+
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(HAP_SEED);
+  auto ref_hap = RandomBases(generator, HAP_LEN);
+  // Pin the bases around VAR_POS so neither indel below can shift left.
+  ref_hap[VAR_POS - 1] = (ref_hap[VAR_POS + 2] + 1) % 4;
+
+  auto snv_hap = ref_hap;
+  snv_hap[VAR_POS] = (ref_hap[VAR_POS] + 1) % 4;
+
+  auto del_hap = ref_hap;
+  del_hap.erase(del_hap.begin() + VAR_POS, del_hap.begin() + VAR_POS + 3);
+
+  auto ins_hap = ref_hap;
+  std::vector<u8> const inserted = {static_cast<u8>((ref_hap[VAR_POS - 1] + 1) % 4),
+                                    static_cast<u8>((ref_hap[VAR_POS - 1] + 2) % 4)};
+  ins_hap.insert(ins_hap.begin() + VAR_POS, inserted.begin(), inserted.end());
+
+  std::vector<std::vector<u8>> const haps = {ref_hap, snv_hap, del_hap, ins_hap};
+  ReadPlacer placer;
+  placer.Reset(haps);
+
+  SECTION("An SNV read aligns gapless with one mismatch") {
+    auto const read = Slice(snv_hap, READ_START, READ_LEN);
+    auto const on_ref = placer.Place(read, 0);
+    REQUIRE(on_ref.has_value());
+    CHECK(CigarString(*on_ref) == "150M");
+    CHECK(on_ref->mHapIdx == 0);
+    CHECK(on_ref->mRefStart == static_cast<i32>(READ_START));
+    CHECK(on_ref->mRefEnd == static_cast<i32>(READ_START + READ_LEN));
+    CHECK(on_ref->mIdentity == Catch::Approx(149.0 / 150.0));
+
+    auto const on_alt = placer.Place(read, 1);
+    REQUIRE(on_alt.has_value());
+    CHECK(on_alt->mIdentity == Catch::Approx(1.0));
+    CHECK(on_alt->mScore > on_ref->mScore);
+  }
+
+  SECTION("Indel reads open one gap on the other haplotype") {
+    auto const del_read = Slice(del_hap, READ_START, READ_LEN);
+    auto const del_on_ref = placer.Place(del_read, 0);
+    REQUIRE(del_on_ref.has_value());
+    CHECK(CigarString(*del_on_ref) == "70M3D80M");
+    CHECK(del_on_ref->mRefEnd == static_cast<i32>(READ_START + READ_LEN + 3));
+
+    auto const ins_read = Slice(ins_hap, READ_START, READ_LEN);
+    auto const ins_on_ref = placer.Place(ins_read, 0);
+    REQUIRE(ins_on_ref.has_value());
+    CHECK(CigarString(*ins_on_ref) == "70M2I78M");
+
+    auto const ins_on_alt = placer.Place(ins_read, 3);
+    REQUIRE(ins_on_alt.has_value());
+    CHECK(CigarString(*ins_on_alt) == "150M");
+    CHECK(ins_on_alt->mScore > ins_on_ref->mScore);
+  }
+
+  SECTION("Bases past a haplotype end are soft-clipped") {
+    auto read = RandomBases(generator, 20);
+    auto const head = Slice(ref_hap, 0, READ_LEN - 20);
+    read.insert(read.end(), head.begin(), head.end());
+
+    auto const aln = placer.Place(read, 0);
+    REQUIRE(aln.has_value());
+    CHECK(CigarString(*aln) == "20S130M");
+    CHECK(aln->mRefStart == 0);
+    CHECK(aln->mScore == static_cast<i32>(READ_LEN - 20));
+  }
+
+  SECTION("A read without two seed hits on one diagonal is not placed") {
+    auto const unrelated = RandomBases(generator, READ_LEN);
+    CHECK_FALSE(placer.Place(unrelated, 0).has_value());
+  }
+}
+
+}  // namespace lancet::caller::tests
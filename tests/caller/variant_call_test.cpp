@@ -1,12 +1,81 @@
 #include "lancet/caller/variant_call.h"
 
+#include "lancet/base/types.h"
+#include "lancet/caller/alt_allele.h"
+#include "lancet/caller/raw_variant.h"
 #include "lancet/caller/sample_format_data.h"
+#include "lancet/caller/variant_support.h"
+#include "lancet/cbdg/label.h"
+#include "lancet/core/sample_info.h"
 
 #include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 #include "catch_amalgamated.hpp"
+#include "spdlog/fmt/bundled/format.h"
+
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace lancet::caller::tests {
 
+namespace {
+
+constexpr usize WINDOW_LENGTH = 1000;
+
+// Every FORMAT field missing, as written for a sample without reads at the site
+constexpr auto MISSING_SAMPLE = "./.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.";
+
+auto MakeVariant(usize const pos1, std::string ref, std::vector<AltAllele> alts) -> RawVariant {
+  RawVariant var;
+  var.mChromIndex = 3;
+  var.mGenomeChromPos1 = pos1;
+  var.mLocalRefStart0Idx = 100;
+  var.mChromName = "chr4";
+  var.mRefAllele = std::move(ref);
+  var.mAlts = std::move(alts);
+  var.mGraphMetrics = {
+      .mGraphEntanglementIndex = 0.42, .mTipToPathCovRatio = 0.1, .mMaxSingleDirDegree = 3};
+  return var;
+}
+
+auto MakeAlt(std::string seq, AlleleType const type, i64 const length) -> AltAllele {
+  AltAllele alt;
+  alt.mSequence = std::move(seq);
+  alt.mType = type;
+  alt.mLength = length;
+  return alt;
+}
+
+void AddReads(VariantSupport& support, AlleleIndex const allele, u32 const count) {
+  for (u32 idx = 0; idx < count; ++idx) {
+    support.AddEvidence({
+        .mInsertSize = 300,
+        .mAlignmentStart = 1'900 + static_cast<i64>(idx),
+        .mAlnScore = 140.0,
+        .mFoldedReadPos = 0.25,
+        .mRnameHash = (u32{allele} << 16U) + idx,
+        .mRefNm = allele,
+        .mOwnHapNm = 0,
+        .mAssignedHaplotypeId = allele,
+        .mAllele = allele,
+        .mStrand = idx % 2 == 0 ? Strand::FWD : Strand::REV,
+        .mBaseQual = 30,
+        .mMapQual = 60,
+        .mIsSoftClipped = false,
+        .mIsProperPair = true,
+    });
+  }
+}
+
+[[nodiscard]] auto RecordOf(VariantCall const& call) -> std::string {
+  fmt::memory_buffer buffer;
+  call.AppendVcfRecord(buffer);
+  return fmt::to_string(buffer);
+}
+
+}  // namespace
+
 // FORMAT field order:
 //   GT:AD:ADF:ADR:DP:RMQ:NPBQ:SB:SCA:FLD:RPCD:BQCD:MQCD:ASMD:SDFC:PRAD:PANG:CMLOD:FSSE:AHDD:HSE:PDCV:PL:GQ
 TEST_CASE("SampleFormatData compactly serializes VCF genotype structure strings precisely",
@@ -70,4 +139,64 @@ TEST_CASE("SampleFormatData renders nullopt metrics as VCF missing value dot",
                      ".:.:.:.:0,10,50:0");
 }
 
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("VariantCall::AppendVcfRecord writes exact VCF lines", "[lancet][caller][VariantCall]") {
+  // Two control samples: no case-control state prefix in INFO
+  std::vector<core::SampleInfo> samples;
+  for (usize idx = 0; idx < 2; ++idx) {
+    auto const name = "S" + std::to_string(idx + 1);
+    samples.emplace_back(name, name + ".bam", cbdg::Label::CTRL);
+    samples.back().SetSampleIndex(idx);
+    samples.back().SetNumSampledBases(30 * WINDOW_LENGTH);
+  }
+
+  static constexpr auto INFO_TAIL = "GRAPH_CX=0.42,0.1,3;SEQ_CX=0,0,0,0,0,0,0,0,0,0,0";
+  static constexpr auto FORMAT_KEYS =
+      "GT:AD:ADF:ADR:DP:RMQ:NPBQ:SB:SCA:FLD:RPCD:BQCD:MQCD:ASMD:SDFC:PRAD:PANG:CMLOD:FSSE:AHDD:HSE:"
+      "PDCV:PL:GQ";
+
+  SECTION("Multi-allelic ALT without any reads: missing QUAL and FORMAT") {
+    auto const var = MakeVariant(
+        1'000, "AC", {MakeAlt("A", AlleleType::DEL, 1), MakeAlt("ACT", AlleleType::INS, 1)});
+    VariantCall const call(&var, {}, absl::MakeConstSpan(samples), WINDOW_LENGTH);
+
+    CHECK_FALSE(call.HasQuality());
+    CHECK(RecordOf(call) == fmt::format("chr4\t1000\t.\tAC\tA,ACT\t.\t.\t"
+                                        "MULTIALLELIC;TYPE=DEL,INS;LENGTH=1,1;{}\t{}\t{}\t{}",
+                                        INFO_TAIL, FORMAT_KEYS, MISSING_SAMPLE, MISSING_SAMPLE));
+  }
+
+  SECTION("One sample with reads, one without") {
+    auto const var = MakeVariant(2'000, "A", {MakeAlt("T", AlleleType::SNV, 1)});
+    VariantCall::SupportsByVariant supports;
+    AddReads(supports[&var].FindOrCreate(0), 0, 12);
+    AddReads(supports[&var].FindOrCreate(0), 1, 8);
+    VariantCall const call(&var, supports, absl::MakeConstSpan(samples), WINDOW_LENGTH);
+
+    REQUIRE(call.HasQuality());
+    CHECK(call.Quality() > 0.0);
+    auto const& with_reads = call.SampleGenotypes()[0];
+    CHECK(with_reads.RenderVcfString().find(":12,8:6,4:6,4:20:") != std::string::npos);
+    CHECK(call.SampleGenotypes()[1].RenderVcfString() == MISSING_SAMPLE);
+
+    CHECK(RecordOf(call) == fmt::format("chr4\t2000\t.\tA\tT\t{:.2f}\t.\t"
+                                        "TYPE=SNV;LENGTH=1;{}\t{}\t{}\t{}",
+                                        call.Quality(), INFO_TAIL, FORMAT_KEYS,
+                                        with_reads.RenderVcfString(), MISSING_SAMPLE));
+  }
+
+  SECTION("Records append to a reused buffer without clearing it") {
+    auto const var = MakeVariant(3'000, "G", {MakeAlt("C", AlleleType::SNV, 1)});
+    VariantCall const call(&var, {}, absl::MakeConstSpan(samples), WINDOW_LENGTH);
+
+    fmt::memory_buffer buffer;
+    call.AppendVcfRecord(buffer);
+    buffer.push_back('\n');
+    call.AppendVcfRecord(buffer);
+    auto const line = RecordOf(call);
+    CHECK(fmt::to_string(buffer) == line + "\n" + line);
+    CHECK(call.AsVcfRecord() == line);
+  }
+}
+
 }  // namespace lancet::caller::tests
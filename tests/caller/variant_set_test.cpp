@@ -1,19 +1,44 @@
 #include "lancet/caller/variant_set.h"
 
+#include "lancet/base/types.h"
 #include "lancet/caller/alt_allele.h"
+#include "lancet/caller/msa_builder.h"
+#include "lancet/cbdg/graph.h"
+#include "lancet/cbdg/graph_params.h"
+#include "lancet/cbdg/label.h"
+#include "lancet/cbdg/path.h"
+#include "lancet/cbdg/read.h"
+#include "lancet/cbdg/read_arena.h"
+#include "lancet/cbdg/read_batch.h"
 #include "lancet/core/window.h"
+#include "lancet/hts/extractor.h"
+#include "lancet/hts/reference.h"
 
 #include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/random/distributions.h"
+#include "absl/types/span.h"
 #include "catch_amalgamated.hpp"
+#include "lancet_test_config.h"
+#include "spdlog/fmt/bundled/core.h"
 #include "spoa/alignment_engine.hpp"
 #include "spoa/graph.hpp"
 
 #include <algorithm>
+#include <array>
+#include <filesystem>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <optional>
+#include <random>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include <cstddef>
+
 // =========================================================================================
 // VariantSet constructor — algorithm test suite
 // -----------------------------------------------------------------------------------------
@@ -24,6 +49,74 @@
 
 namespace lancet::caller::tests {
 
+namespace {
+
+// ============================================================================
+// MakeWalk: stand-in for a MaxFlow walk over the compacted de Bruijn graph.
+//
+// Splits `hap` into nodes the way compaction would: a new node starts
+// wherever a k-mer switches between REF and non-REF, or stops following the
+// previous k-mer along REF. The first node contributes all of its bases,
+// every later node only those past its (k − 1)-base overlap.
+// ============================================================================
+[[nodiscard]] auto MakeWalk(std::string_view ref_hap, std::string_view hap, usize kmer_len)
+    -> cbdg::Path {
+  absl::flat_hash_map<std::string_view, usize> ref_kmer_pos;
+  for (usize idx = 0; idx + kmer_len <= ref_hap.size(); ++idx) {
+    ref_kmer_pos.emplace(ref_hap.substr(idx, kmer_len), idx);
+  }
+
+  cbdg::Path walk;
+  walk.AppendSequence(hap);
+
+  usize run_len = 0;
+  bool is_first_node = true;
+  std::optional<usize> prev_pos;
+  auto const close_node = [&] {
+    walk.AddNodeWeight(1, static_cast<u32>(is_first_node ? run_len + kmer_len - 1 : run_len));
+    is_first_node = false;
+    run_len = 0;
+  };
+
+  for (usize idx = 0; idx + kmer_len <= hap.size(); ++idx) {
+    auto const itr = ref_kmer_pos.find(hap.substr(idx, kmer_len));
+    auto const pos = itr == ref_kmer_pos.end() ? std::nullopt : std::optional<usize>(itr->second);
+    bool const extends = (!pos && !prev_pos) || (pos && prev_pos && *pos == *prev_pos + 1);
+    if (run_len > 0 && !extends) close_node();
+    ++run_len;
+    prev_pos = pos;
+  }
+
+  close_node();
+  return walk;
+}
+
+// MsaVariants: the production SPOA path — POA over the clipped core, then the graph sweep.
+[[nodiscard]] auto MsaVariants(MsaBuilder& spoa_state, absl::Span<std::string_view const> haps,
+                               core::Window const& win, usize ref_anchor_start) -> VariantSet {
+  std::vector<cbdg::Path::BaseWeights> weights;
+  for (auto const hap : haps) weights.emplace_back(hap.size(), 1);
+  spoa_state.UpdateSpoaState(haps, absl::MakeConstSpan(weights), MsaFlanks::CLIPPED);
+  auto const clipped = spoa_state.mClippedPrefixLen;
+  return {spoa_state.mGraph, win, ref_anchor_start + clipped, clipped};
+}
+
+void CheckSameVariants(VariantSet const& observed, VariantSet const& expected) {
+  REQUIRE(observed.Count() == expected.Count());
+  for (auto obs_it = observed.begin(), exp_it = expected.begin(); obs_it != observed.end();
+       ++obs_it, ++exp_it) {
+    CHECK(*obs_it == *exp_it);
+    CHECK(obs_it->mLocalRefStart0Idx == exp_it->mLocalRefStart0Idx);
+    REQUIRE(obs_it->mAlts.size() == exp_it->mAlts.size());
+    for (usize idx = 0; idx < exp_it->mAlts.size(); ++idx) {
+      CHECK(obs_it->mAlts[idx].mType == exp_it->mAlts[idx].mType);
+      CHECK(obs_it->mAlts[idx].mLocalHapStart0Idxs == exp_it->mAlts[idx].mLocalHapStart0Idxs);
+    }
+  }
+}
+
+}  // namespace
+
 // Catch2 SECTION fan-out inflates clang-tidy's cognitive-complexity metric beyond the project
 // ceiling.
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
@@ -246,4 +339,602 @@ TEST_CASE("Topological VariantExtractor securely populates Multiallelic Payload
     REQUIRE(found_del == true);
   }
 }
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("VariantSet::FromSimplePair matches the SPOA extraction path",
+          "[lancet][caller][VariantSet]") {
+  static constexpr u64 BASE_SEED = 0x53'49'4D'50'4C'45ULL;
+  static constexpr usize NUM_PROPERTY_ITERATIONS = 500;
+  static constexpr std::string_view BASES = "ACGT";
+
+  // Const-literal seed is the project's documented determinism convention
+  // (see test_style.md / §A.9).
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(BASE_SEED);
+  MsaBuilder spoa_state;
+  usize num_fast_path = 0;
+
+  // Returns whether the fast path took the pair; when it does, its record must be SPOA's.
+  auto const matches_spoa = [&spoa_state](std::string_view ref_hap,
+                                          std::string_view alt_hap) -> bool {
+    std::vector<std::string_view> const haps = {ref_hap, alt_hap};
+    auto const fast = VariantSet::FromSimplePair(absl::MakeConstSpan(haps), core::Window{}, 100);
+    if (!fast.has_value()) return false;
+
+    std::vector<cbdg::Path::BaseWeights> const weights = {
+        cbdg::Path::BaseWeights(ref_hap.size(), 1), cbdg::Path::BaseWeights(alt_hap.size(), 1)};
+    spoa_state.UpdateSpoaState(absl::MakeConstSpan(haps), absl::MakeConstSpan(weights));
+    VariantSet const expected(spoa_state.mGraph, core::Window{}, 100);
+
+    INFO("ref=" << ref_hap << " alt=" << alt_hap);
+    REQUIRE(fast->Count() == 1);
+    REQUIRE(expected.Count() == 1);
+
+    auto const& observed_var = *fast->begin();
+    auto const& expected_var = *expected.begin();
+    CHECK(observed_var == expected_var);
+    CHECK(observed_var.mLocalRefStart0Idx == expected_var.mLocalRefStart0Idx);
+    CHECK(observed_var.mAlts[0].mLocalHapStart0Idxs == expected_var.mAlts[0].mLocalHapStart0Idxs);
+    return true;
+  };
+
+  // Repeat indels, where SPOA's left-most gap placement decides POS.
+  CHECK(matches_spoa("ACGTTTTACG", "ACGTTTACG"));            // homopolymer deletion
+  CHECK(matches_spoa("ACGTTTACG", "ACGTTTTACG"));            // homopolymer insertion
+  CHECK(matches_spoa("GTCACACACTG", "GTCACACTG"));           // dinucleotide unit deleted
+  CHECK(matches_spoa("GTCACACTG", "GTCACACACACTG"));         // two dinucleotide units inserted
+  CHECK(matches_spoa("TGCAGCAGCAGT", "TGCAGCAGT"));          // trinucleotide unit deleted
+  CHECK(matches_spoa("TGCAGCAGT", "TGCAGCAGCAGT"));          // trinucleotide unit inserted
+  CHECK(matches_spoa("CATTGATTGATTGAC", "CATTGATTGAC"));     // tetranucleotide unit deleted
+  CHECK(matches_spoa("ACGTACGTAA", "ACGTACGTA"));            // repeat ending one base early
+  // Edits at the ends and equal-length MNVs never take the shortcut.
+  CHECK_FALSE(matches_spoa("ACGTACGT", "CGTACGT"));
+  CHECK_FALSE(matches_spoa("ACGTACGT", "ACGTACG"));
+  CHECK_FALSE(matches_spoa("ACGTACGT", "GGACGTACGT"));
+  CHECK_FALSE(matches_spoa("ACGTACGT", "ACGTACGTCC"));
+  CHECK_FALSE(matches_spoa("TTTACGTACG", "TTACGTACG"));
+  CHECK_FALSE(matches_spoa("ACGTACGT", "ACTCACGT"));
+  CHECK_FALSE(matches_spoa("ACGTACGT", "ACTGTCGT"));
+  CHECK_FALSE(matches_spoa("ACGTACGTACGT", "ACGAACGAACGT"));
+
+  for (usize iter = 0; iter < NUM_PROPERTY_ITERATIONS; ++iter) {
+    auto const ref_len = absl::Uniform<usize>(absl::IntervalClosed, generator, 8, 120);
+    std::string ref_hap(ref_len, 'A');
+    for (auto& base : ref_hap) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+
+    // One random SNV, insertion or deletion anywhere — including the ends,
+    // where the fast path must decline, and inside repeats, where it must
+    // place the indel left-most as SPOA does.
+    auto alt_hap = ref_hap;
+    auto const pos = absl::Uniform<usize>(generator, 0, ref_len);
+    auto const indel_len = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 6);
+    switch (absl::Uniform<int>(generator, 0, 3)) {
+      case 0:
+        alt_hap[pos] = BASES[(BASES.find(ref_hap[pos]) + 1) % BASES.size()];
+        break;
+      case 1:
+        for (usize idx = 0; idx < indel_len; ++idx) {
+          alt_hap.insert(alt_hap.begin() + static_cast<std::ptrdiff_t>(pos),
+                         BASES[absl::Uniform<usize>(generator, 0, BASES.size())]);
+        }
+        break;
+      default:
+        alt_hap.erase(pos, std::min(indel_len, ref_len - pos - 1));
+        break;
+    }
+
+    INFO("iter=" << iter);
+    if (matches_spoa(ref_hap, alt_hap)) ++num_fast_path;
+  }
+
+  // Most random single edits are interior.
+  CHECK(num_fast_path > NUM_PROPERTY_ITERATIONS / 2);
+}
+
+TEST_CASE("VariantSet::FromSimplePair declines components that need POA",
+          "[lancet][caller][VariantSet]") {
+  auto const from_pair = [](std::string_view ref_hap, std::string_view alt_hap) -> bool {
+    std::vector<std::string_view> const haps = {ref_hap, alt_hap};
+    return VariantSet::FromSimplePair(absl::MakeConstSpan(haps), core::Window{}, 100).has_value();
+  };
+
+  CHECK(from_pair("ACGTACGT", "ACGAACGT"));          // interior SNV
+  CHECK(from_pair("ACGTACGT", "ACGACGT"));           // interior 1bp deletion, unique placement
+  CHECK(from_pair("ACGTACGT", "ACGTGACGT"));         // interior 1bp insertion, unique placement
+  CHECK(from_pair("ACGTTACGT", "ACGTACGT"));         // deletion inside a homopolymer
+  CHECK(from_pair("GACACACT", "GACACT"));            // dinucleotide repeat unit deleted
+  CHECK_FALSE(from_pair("ACGTACGT", "ACGAAGGT"));    // two SNVs
+  CHECK_FALSE(from_pair("ACGTACGT", "ACTCACGT"));    // 2bp MNV, equal lengths
+  CHECK_FALSE(from_pair("ACGTACGT", "ACTGTCGT"));    // 3bp MNV, equal lengths
+  CHECK_FALSE(from_pair("ACGT", "ACGA"));            // edit at the haplotype end
+  CHECK_FALSE(from_pair("ACGTACGT", "CGTACGT"));     // deletion of the first base
+  CHECK_FALSE(from_pair("ACGTACGT", "ACGTACG"));     // deletion of the last base
+  CHECK_FALSE(from_pair("ACGTACGT", "TACGTACGT"));   // insertion before the first base
+  CHECK_FALSE(from_pair("ACGTACGT", "ACGTACGTA"));   // insertion after the last base
+  CHECK_FALSE(from_pair("AAACGTACGT", "AACGTACGT"));  // homopolymer deletion slides to base 0
+  CHECK_FALSE(from_pair("ACGT", "ACGT"));            // no difference
+
+  std::vector<std::string_view> const three = {"ACGTACGT", "ACGAACGT", "ACGCACGT"};
+  CHECK_FALSE(VariantSet::FromSimplePair(absl::MakeConstSpan(three), core::Window{}, 100));
+
+  SECTION("Whole-unit indels inside a tandem repeat take the left-most placement") {
+    static constexpr u64 BASE_SEED = 0x52'45'50'45'41'54ULL;
+    static constexpr usize NUM_REPEAT_ITERATIONS = 500;
+    static constexpr std::string_view BASES = "ACGT";
+
+    // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+    std::mt19937_64 generator(BASE_SEED);
+    for (usize iter = 0; iter < NUM_REPEAT_ITERATIONS; ++iter) {
+      // Random flanks around a 1-4bp unit repeated 3-6 times, then one copy
+      // of the unit inserted or deleted at a random copy boundary.
+      auto const unit_len = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 4);
+      auto const num_copies = absl::Uniform<usize>(absl::IntervalClosed, generator, 3, 6);
+      auto const flank_len = absl::Uniform<usize>(absl::IntervalClosed, generator, 2, 30);
+      std::string unit(unit_len, 'A');
+      for (auto& base : unit) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+
+      std::string ref_hap(flank_len, 'A');
+      for (auto& base : ref_hap) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+      auto const repeat_start =
+          absl::Uniform<usize>(absl::IntervalClosed, generator, 1, flank_len - 1);
+      for (usize copy = 0; copy < num_copies; ++copy) ref_hap.insert(repeat_start, unit);
+
+      auto alt_hap = ref_hap;
+      auto const copy_idx = absl::Uniform<usize>(generator, 0, num_copies);
+      auto const edit_pos = repeat_start + (unit_len * copy_idx);
+      if (absl::Bernoulli(generator, 0.5)) {
+        alt_hap.insert(edit_pos, unit);
+      } else {
+        alt_hap.erase(edit_pos, unit_len);
+      }
+
+      // Independent oracle: the first offset at which the edit reproduces the other haplotype.
+      bool const is_del = alt_hap.size() < ref_hap.size();
+      auto const& longer = is_del ? ref_hap : alt_hap;
+      auto const& shorter = is_del ? alt_hap : ref_hap;
+      usize left_most = 0;
+      while (std::string(longer).erase(left_most, unit_len) != shorter) ++left_most;
+
+      INFO("iter=" << iter << " ref=" << ref_hap << " alt=" << alt_hap);
+      std::vector<std::string_view> const haps = {ref_hap, alt_hap};
+      auto const vset = VariantSet::FromSimplePair(absl::MakeConstSpan(haps), core::Window{}, 100);
+      if (left_most == 0) {
+        CHECK_FALSE(vset.has_value());
+        continue;
+      }
+
+      REQUIRE(vset.has_value());
+      REQUIRE(vset->Count() == 1);
+      auto const& var = *vset->begin();
+      CHECK(var.mGenomeChromPos1 == 100 + left_most - 1);
+      CHECK(var.mLocalRefStart0Idx == left_most - 1);
+      CHECK(var.mRefAllele == ref_hap.substr(left_most - 1, is_del ? unit_len + 1 : 1));
+      CHECK(var.mAlts[0].mSequence == alt_hap.substr(left_most - 1, is_del ? 1 : unit_len + 1));
+    }
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("MsaFlanks::CLIPPED extracts the same variants as full-length POA",
+          "[lancet][caller][VariantSet]") {
+  static constexpr u64 BASE_SEED = 0x46'4C'41'4E'4B'53ULL;
+  static constexpr usize FLANK_LEN = 400;
+  static constexpr usize CORE_LEN = 60;
+  static constexpr std::string_view BASES = "ACGT";
+
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(BASE_SEED);
+  std::string ref_hap(FLANK_LEN + CORE_LEN + FLANK_LEN, 'A');
+  for (auto& base : ref_hap) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+
+  auto const shift = [](char base, usize step) -> char {
+    return BASES[(BASES.find(base) + step) % BASES.size()];
+  };
+
+  // ALT1: SNV + 3bp deletion, ALT2: multiallelic SNV + 4bp insertion, ALT3: MNP.
+  auto alt1 = ref_hap;
+  alt1[FLANK_LEN + 5] = shift(ref_hap[FLANK_LEN + 5], 1);
+  alt1.erase(FLANK_LEN + 30, 3);
+  auto alt2 = ref_hap;
+  alt2[FLANK_LEN + 5] = shift(ref_hap[FLANK_LEN + 5], 2);
+  alt2.insert(FLANK_LEN + 45, "GATC");
+  auto alt3 = ref_hap;
+  alt3[FLANK_LEN + 20] = shift(ref_hap[FLANK_LEN + 20], 2);
+  alt3[FLANK_LEN + 21] = shift(ref_hap[FLANK_LEN + 21], 2);
+
+  std::vector<std::string_view> const haps = {ref_hap, alt1, alt2, alt3};
+  std::vector<cbdg::Path::BaseWeights> weights;
+  for (auto const hap : haps) weights.emplace_back(hap.size(), 1);
+
+  MsaBuilder spoa_state;
+  spoa_state.UpdateSpoaState(absl::MakeConstSpan(haps), absl::MakeConstSpan(weights));
+  REQUIRE(spoa_state.mClippedPrefixLen == 0);
+  VariantSet const full(spoa_state.mGraph, core::Window{}, 100);
+
+  spoa_state.UpdateSpoaState(absl::MakeConstSpan(haps), absl::MakeConstSpan(weights),
+                             MsaFlanks::CLIPPED);
+  auto const clipped_len = spoa_state.mClippedPrefixLen;
+  // The random flank may repeat a few bases into the core; those stay unclipped.
+  CHECK(clipped_len > 0);
+  CHECK(clipped_len <= FLANK_LEN + 5 - MSA_FLANK_PAD);
+  CHECK(spoa_state.mGraph.sequences().size() == haps.size());
+  VariantSet const clipped(spoa_state.mGraph, core::Window{}, 100 + clipped_len, clipped_len);
+
+  REQUIRE(full.Count() > 0);
+  REQUIRE(clipped.Count() == full.Count());
+  for (auto full_it = full.begin(), clip_it = clipped.begin(); full_it != full.end();
+       ++full_it, ++clip_it) {
+    CHECK(*clip_it == *full_it);
+    CHECK(clip_it->mLocalRefStart0Idx == full_it->mLocalRefStart0Idx);
+    REQUIRE(clip_it->mAlts.size() == full_it->mAlts.size());
+    for (usize idx = 0; idx < full_it->mAlts.size(); ++idx) {
+      CHECK(clip_it->mAlts[idx].mLocalHapStart0Idxs == full_it->mAlts[idx].mLocalHapStart0Idxs);
+    }
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("MsaFlanks::CLIPPED keeps repeats that reach into the shared flank",
+          "[lancet][caller][VariantSet]") {
+  static constexpr u64 BASE_SEED = 0x54'52'41'43'54ULL;
+  static constexpr usize FLANK_LEN = 400;
+  static constexpr usize NUM_COPIES = 30;
+  static constexpr std::string_view BASES = "ACGT";
+
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(BASE_SEED);
+  std::string left_flank(FLANK_LEN, 'A');
+  std::string right_flank(FLANK_LEN, 'A');
+  for (auto& base : left_flank) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+  for (auto& base : right_flank) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+  left_flank.back() = 'G';
+  right_flank.front() = 'T';
+
+  // A 60bp (CA)n repeat, twice the pad, ends right where the haplotypes diverge:
+  // ALT1 drops one CA unit and ALT2 adds one, so both indels can slide the full
+  // length of the repeat and deep into the shared prefix.
+  std::string repeat;
+  for (usize idx = 0; idx < NUM_COPIES; ++idx) repeat += "CA";
+  auto const ref_hap = left_flank + repeat + right_flank;
+  auto const alt1 = left_flank + repeat.substr(2) + right_flank;
+  auto const alt2 = left_flank + repeat + "CA" + right_flank;
+
+  std::vector<std::string_view> const haps = {ref_hap, alt1, alt2};
+  std::vector<cbdg::Path::BaseWeights> weights;
+  for (auto const hap : haps) weights.emplace_back(hap.size(), 1);
+
+  MsaBuilder spoa_state;
+  spoa_state.UpdateSpoaState(absl::MakeConstSpan(haps), absl::MakeConstSpan(weights));
+  VariantSet const full(spoa_state.mGraph, core::Window{}, 100);
+
+  spoa_state.UpdateSpoaState(absl::MakeConstSpan(haps), absl::MakeConstSpan(weights),
+                             MsaFlanks::CLIPPED);
+  auto const clipped_len = spoa_state.mClippedPrefixLen;
+  CHECK(clipped_len > 0);
+  CHECK(clipped_len + MSA_FLANK_PAD <= FLANK_LEN);
+  VariantSet const clipped(spoa_state.mGraph, core::Window{}, 100 + clipped_len, clipped_len);
+
+  REQUIRE(full.Count() > 0);
+  REQUIRE(clipped.Count() == full.Count());
+  for (auto full_it = full.begin(), clip_it = clipped.begin(); full_it != full.end();
+       ++full_it, ++clip_it) {
+    CHECK(*clip_it == *full_it);
+    CHECK(clip_it->mLocalRefStart0Idx == full_it->mLocalRefStart0Idx);
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("MsaFlanks::CLIPPED keeps repeat indels that cross the clip boundary",
+          "[lancet][caller][VariantSet]") {
+  static constexpr u64 BASE_SEED = 0x43'52'4F'53'53ULL;
+  static constexpr usize FLANK_LEN = 300;
+  static constexpr usize REPEAT_SPAN = 3 * MSA_FLANK_PAD;
+  static constexpr std::array<usize, 6> UNIT_LENS = {1, 2, 3, 5, 12, 40};
+  static constexpr std::string_view BASES = "ACGT";
+
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(BASE_SEED);
+  MsaBuilder spoa_state;
+
+  // Periods from a homopolymer up to a unit longer than the pad. The repeat runs
+  // REPEAT_SPAN bases past the edit on both sides, so a clip that ignored it would
+  // cut through the repeat and pin the indel at a different placement.
+  for (usize const unit_len : UNIT_LENS) {
+    std::string unit(unit_len, 'A');
+    std::string left_flank(FLANK_LEN, 'A');
+    std::string right_flank(FLANK_LEN, 'A');
+    for (auto& base : unit) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+    for (auto& base : left_flank) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+    for (auto& base : right_flank) base = BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+
+    usize const num_copies = 2 * ((REPEAT_SPAN / unit_len) + 1);
+    std::string repeat;
+    for (usize idx = 0; idx < num_copies; ++idx) repeat += unit;
+
+    auto const ref_hap = left_flank + repeat + right_flank;
+    auto const edit_pos = FLANK_LEN + (unit_len * (num_copies / 2));
+    auto alt_del = ref_hap;
+    alt_del.erase(edit_pos, unit_len);
+    auto alt_ins = ref_hap;
+    alt_ins.insert(edit_pos, unit);
+
+    std::vector<std::string_view> const haps = {ref_hap, alt_del, alt_ins};
+    std::vector<cbdg::Path::BaseWeights> weights;
+    for (auto const hap : haps) weights.emplace_back(hap.size(), 1);
+
+    spoa_state.UpdateSpoaState(absl::MakeConstSpan(haps), absl::MakeConstSpan(weights));
+    VariantSet const full(spoa_state.mGraph, core::Window{}, 100);
+
+    spoa_state.UpdateSpoaState(absl::MakeConstSpan(haps), absl::MakeConstSpan(weights),
+                               MsaFlanks::CLIPPED);
+    auto const clipped_len = spoa_state.mClippedPrefixLen;
+    VariantSet const clipped(spoa_state.mGraph, core::Window{}, 100 + clipped_len, clipped_len);
+
+    INFO("unit=" << unit);
+    // The clip boundary lands before the repeat, never inside it.
+    CHECK(clipped_len > 0);
+    CHECK(clipped_len + MSA_FLANK_PAD <= FLANK_LEN);
+
+    REQUIRE(full.Count() > 0);
+    REQUIRE(clipped.Count() == full.Count());
+    for (auto full_it = full.begin(), clip_it = clipped.begin(); full_it != full.end();
+         ++full_it, ++clip_it) {
+      CHECK(*clip_it == *full_it);
+      CHECK(clip_it->mLocalRefStart0Idx == full_it->mLocalRefStart0Idx);
+      REQUIRE(clip_it->mAlts.size() == full_it->mAlts.size());
+      for (usize idx = 0; idx < full_it->mAlts.size(); ++idx) {
+        CHECK(clip_it->mAlts[idx].mLocalHapStart0Idxs == full_it->mAlts[idx].mLocalHapStart0Idxs);
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("VariantSet::FromWalkBubbles matches the MSA path on multi-bubble components",
+          "[lancet][caller][VariantSet]") {
+  static constexpr u64 BASE_SEED = 0x57'41'4C'4B'53ULL;
+  static constexpr usize NUM_PROPERTY_ITERATIONS = 400;
+  static constexpr usize KMER_LEN = 11;
+  static constexpr usize REF_LEN = 240;
+  // Edits stay clear of the first and last k-mers so every walk shares the source/sink.
+  static constexpr usize EDGE_MARGIN = 2 * KMER_LEN;
+  static constexpr std::string_view BASES = "ACGT";
+
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(BASE_SEED);
+  auto const random_base = [&generator] {
+    return BASES[absl::Uniform<usize>(generator, 0, BASES.size())];
+  };
+
+  MsaBuilder spoa_state;
+  usize num_walk_path = 0;
+  usize num_multi_bubble = 0;
+
+  for (usize iter = 0; iter < NUM_PROPERTY_ITERATIONS; ++iter) {
+    std::string ref_hap(REF_LEN, 'A');
+    for (auto& base : ref_hap) base = random_base();
+
+    // A 1-3bp unit repeated 3-4 times: whole-unit indels in it have several placements.
+    auto const unit_len = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 3);
+    auto const repeat_start = absl::Uniform<usize>(generator, EDGE_MARGIN, REF_LEN / 2);
+    auto const num_copies = absl::Uniform<usize>(absl::IntervalClosed, generator, 3, 4);
+    std::string const unit = ref_hap.substr(repeat_start, unit_len);
+    for (usize copy = 1; copy < num_copies; ++copy) {
+      ref_hap.replace(repeat_start + (copy * unit_len), unit_len, unit);
+    }
+
+    // Every ALT carries 1-3 edits. Positions are fresh, 1-4bp after an earlier edit
+    // (adjacent bubbles), equal to an earlier edit of another ALT (overlapping
+    // bubbles), or a copy boundary of the repeat (repeat-anchored indels).
+    std::vector<usize> edit_positions;
+    std::vector<std::string> alts;
+    auto const num_alts = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 3);
+    for (usize alt_idx = 0; alt_idx < num_alts; ++alt_idx) {
+      std::vector<std::pair<usize, int>> edits;
+      auto const num_edits = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 3);
+      for (usize edit_idx = 0; edit_idx < num_edits; ++edit_idx) {
+        auto const placement = edit_positions.empty() ? 0 : absl::Uniform<int>(generator, 0, 4);
+        auto const earlier = edit_positions.empty()
+                                 ? usize{0}
+                                 : edit_positions[absl::Uniform<usize>(generator, 0,
+                                                                       edit_positions.size())];
+        usize pos = absl::Uniform<usize>(generator, EDGE_MARGIN, REF_LEN - EDGE_MARGIN);
+        int kind = absl::Uniform<int>(generator, 0, 4);
+        if (placement == 1) {
+          pos = earlier + absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 4);
+        }
+        if (placement == 2) pos = earlier;
+        if (placement == 3) {
+          pos = repeat_start + (unit_len * absl::Uniform<usize>(generator, 0, num_copies));
+          kind = 4;
+        }
+        edit_positions.push_back(pos);
+        edits.emplace_back(pos, kind);
+      }
+
+      // Right to left, so an edit never shifts the position of the next one applied.
+      std::ranges::sort(edits, std::greater{});
+      auto alt_hap = ref_hap;
+      for (auto const& [pos, kind] : edits) {
+        auto const len = absl::Uniform<usize>(absl::IntervalClosed, generator, 1, 4);
+        switch (kind) {
+          case 0:  // SNV
+            alt_hap[pos] = BASES[(BASES.find(alt_hap[pos]) + 1) % BASES.size()];
+            break;
+          case 1:  // MNP
+            alt_hap[pos] = BASES[(BASES.find(alt_hap[pos]) + 1) % BASES.size()];
+            alt_hap[pos + 1] = BASES[(BASES.find(alt_hap[pos + 1]) + 2) % BASES.size()];
+            break;
+          case 2:  // insertion
+            for (usize idx = 0; idx < len; ++idx) {
+              alt_hap.insert(alt_hap.begin() + static_cast<std::ptrdiff_t>(pos), random_base());
+            }
+            break;
+          case 3:  // deletion
+            alt_hap.erase(pos, len);
+            break;
+          default:  // one repeat unit gained or lost
+            if (absl::Bernoulli(generator, 0.5)) {
+              alt_hap.insert(pos, unit);
+            } else {
+              alt_hap.erase(pos, unit_len);
+            }
+            break;
+        }
+      }
+      alts.push_back(std::move(alt_hap));
+    }
+
+    // MaxFlow never emits REF twice or the same ALT twice.
+    std::vector<std::string_view> haps = {ref_hap};
+    for (auto const& alt_hap : alts) {
+      if (std::ranges::find(haps, std::string_view(alt_hap)) == haps.end()) {
+        haps.emplace_back(alt_hap);
+      }
+    }
+    if (haps.size() < 2) continue;
+
+    std::vector<cbdg::Path> walks;
+    for (auto const hap : haps) walks.push_back(MakeWalk(ref_hap, hap, KMER_LEN));
+    auto const observed = VariantSet::FromWalkBubbles(walks, KMER_LEN, core::Window{}, 100);
+    if (!observed.has_value()) continue;
+    ++num_walk_path;
+    if (observed->Count() > 1) ++num_multi_bubble;
+
+    std::string context = "iter=" + std::to_string(iter) + " ref=" + ref_hap;
+    for (usize idx = 1; idx < haps.size(); ++idx) context += " alt=" + std::string(haps[idx]);
+    INFO(context);
+    CheckSameVariants(*observed, MsaVariants(spoa_state, haps, core::Window{}, 100));
+  }
+
+  CHECK(num_walk_path > NUM_PROPERTY_ITERATIONS / 2);
+  CHECK(num_multi_bubble > num_walk_path / 2);
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("VariantSet::FromWalkBubbles matches the MSA path on assembled walks",
+          "[lancet][caller][VariantSet]") {
+  auto const ref_path = MakePath(FULL_DATA_DIR, GRCH38_REF_NAME);
+  hts::Reference const ref(ref_path);
+  auto const case_bam_path = MakePath(FULL_DATA_DIR, CASE_BAM_NAME);
+  REQUIRE(std::filesystem::exists(case_bam_path));
+
+  auto const chrom = ref.FindChromByName("chr4");
+  REQUIRE(chrom.ok());
+
+  // 1kb windows over 20kb of chr4 that the fixture covers at full depth.
+  static constexpr u64 FIRST_WINDOW_START = 99'990'001;
+  static constexpr u64 WINDOW_LEN = 1'000;
+  static constexpr usize NUM_WINDOWS = 20;
+
+  MsaBuilder spoa_state;
+  usize num_compared = 0;
+
+  for (usize win_idx = 0; win_idx < NUM_WINDOWS; ++win_idx) {
+    auto const start = FIRST_WINDOW_START + (win_idx * WINDOW_LEN);
+    auto const spec = fmt::format("chr4:{}-{}", start, start + WINDOW_LEN - 1);
+    core::Window const window(ref.ParseRegion(spec.c_str()), *chrom, ref_path);
+
+    cbdg::ReadArena arena(std::make_shared<cbdg::ReadArena::BlockPool>());
+    std::vector<cbdg::Read> reads;
+    hts::Extractor extractor(case_bam_path, ref);
+    extractor.SetRegionToExtract(spec);
+    for (auto const& aln : extractor) reads.emplace_back(aln, arena, cbdg::Label::CASE, 0);
+    if (reads.empty()) continue;
+
+    cbdg::ReadBatch const batch(absl::MakeConstSpan(reads));
+    cbdg::GraphParams params;
+    params.mNumSamples = 1;
+    cbdg::Graph graph(params);
+    auto const components =
+        graph.BuildComponentResults(window.AsRegionPtr(), absl::MakeConstSpan(reads), batch);
+
+    for (auto const& component : components) {
+      if (component.NumAltHaplotypes() == 0) continue;
+
+      auto const anchor_pos1 = window.StartPos1() + component.AnchorStartOffset();
+      auto const observed = VariantSet::FromWalkBubbles(component.Paths(), component.KmerLength(),
+                                                        window, anchor_pos1);
+      if (!observed.has_value()) continue;
+      ++num_compared;
+
+      INFO("window=" << spec << " nhaps=" << component.NumPaths());
+      auto const hap_views = component.HaplotypeSequenceViews();
+      CheckSameVariants(*observed, MsaVariants(spoa_state, hap_views, window, anchor_pos1));
+    }
+  }
+
+  CHECK(num_compared > 0);
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("VariantSet::FromWalkBubbles merges overlapping walk bubbles",
+          "[lancet][caller][VariantSet]") {
+  static constexpr usize KMER_LEN = 11;
+  // Every 11-mer of this REF is unique, and each indel below has a single placement.
+  static constexpr std::string_view REF_HAP =
+      "GCTAAAGACAATTACATAACATACACGTCAGCACGAAACTTGTTGGCCCAGTGTGAATCGCTTAAGGGTTAAGTAAGTGT";
+
+  // ALT1: A→C at 20 + 3bp DEL at 50. ALT2: A→G at 20 + 4bp INS at 45 + C→T at 60.
+  // ALT3: AA→GG MNP at 35.
+  std::string alt1(REF_HAP);
+  alt1[20] = 'C';
+  alt1.erase(50, 3);
+  std::string alt2(REF_HAP);
+  alt2[20] = 'G';
+  alt2.insert(45, "TCCT");
+  alt2[64] = 'T';
+  std::string alt3(REF_HAP);
+  alt3[35] = 'G';
+  alt3[36] = 'G';
+
+  std::vector<cbdg::Path> walks;
+  for (std::string_view const hap : {REF_HAP, std::string_view(alt1), std::string_view(alt2),
+                                     std::string_view(alt3)}) {
+    walks.push_back(MakeWalk(REF_HAP, hap, KMER_LEN));
+  }
+
+  auto const vset = VariantSet::FromWalkBubbles(walks, KMER_LEN, core::Window{}, 100);
+  REQUIRE(vset.has_value());
+  REQUIRE(vset->Count() == 5);
+
+  auto itr = vset->begin();
+  // Both SNVs at 20 share one bubble → one triallelic record.
+  CHECK(itr->mGenomeChromPos1 == 120);
+  CHECK(itr->mRefAllele == "A");
+  REQUIRE(itr->mAlts.size() == 2);
+  CHECK(itr->mAlts[0].mSequence == "C");
+  CHECK(itr->mAlts[1].mSequence == "G");
+
+  ++itr;
+  CHECK(itr->mGenomeChromPos1 == 135);
+  CHECK(itr->mRefAllele == "AA");
+  CHECK(itr->mAlts[0].mSequence == "GG");
+
+  ++itr;
+  CHECK(itr->mGenomeChromPos1 == 144);
+  CHECK(itr->mRefAllele == "G");
+  CHECK(itr->mAlts[0].mSequence == "GTCCT");
+
+  ++itr;
+  CHECK(itr->mGenomeChromPos1 == 149);
+  CHECK(itr->mRefAllele == "AGTG");
+  CHECK(itr->mAlts[0].mSequence == "A");
+  CHECK(itr->mAlts[0].mLocalHapStart0Idxs.at(1) == 49);
+
+  // ALT2's local offset carries its upstream 4bp insertion.
+  ++itr;
+  CHECK(itr->mGenomeChromPos1 == 160);
+  CHECK(itr->mRefAllele == "C");
+  CHECK(itr->mAlts[0].mSequence == "T");
+  CHECK(itr->mAlts[0].mLocalHapStart0Idxs.at(2) == 63);
+
+  // A walk that does not open on the REF source node cannot be anchored.
+  std::string unanchored(REF_HAP);
+  unanchored[2] = 'A';
+  std::vector<cbdg::Path> const bad_walks = {MakeWalk(REF_HAP, REF_HAP, KMER_LEN),
+                                             MakeWalk(REF_HAP, unanchored, KMER_LEN)};
+  CHECK_FALSE(VariantSet::FromWalkBubbles(bad_walks, KMER_LEN, core::Window{}, 100));
+}
+
 }  // namespace lancet::caller::tests
@@ -5,6 +5,7 @@
 
 #include "catch_amalgamated.hpp"
 
+#include <array>
 #include <optional>
 
 namespace lancet::caller::tests {
@@ -236,6 +237,71 @@ TEST_CASE("HSE ignores REF reads — only ALT haplotype IDs contribute",
   REQUIRE_FALSE(support.ComputeHSE(3).has_value());
 }
 
+// ============================================================================
+// Pair-HMM PL Tests
+// ============================================================================
+
+TEST_CASE("PLs follow per-read allele likelihoods when every read carries them",
+          "[lancet][caller][VariantSupport][PL]") {
+  // Both supports see the same assigned alleles (6 REF, 6 ALT), which the DM
+  // counts would call het. Only the likelihoods differ, so the hom-ref call on
+  // the second shows the PLs are driven by them.
+  std::array<f64, 2> const ref_like{-1.0, -5.0};
+  std::array<f64, 2> const alt_like{-5.0, -1.0};
+
+  VariantSupport het_support;
+  VariantSupport hom_ref_support;
+  for (u32 idx = 0; idx < 12; ++idx) {
+    auto evidence = MakeEvidence(static_cast<AlleleIndex>(idx % 2), 1000, 0, 1, 100 + idx);
+    evidence.mAlleleLog10Liks = idx % 2 == 0 ? ref_like : alt_like;
+    het_support.AddEvidence(evidence);
+    evidence.mAlleleLog10Liks = ref_like;
+    hom_ref_support.AddEvidence(evidence);
+  }
+
+  auto const het_pls = het_support.ComputePLs(2);
+  REQUIRE(het_pls.size() == 3);
+  CHECK(het_pls[1] == 0);
+  CHECK(het_pls[0] > 0);
+  CHECK(het_pls[2] > 0);
+
+  // Same assigned alleles, but every read's likelihood favours REF
+  auto const hom_ref_pls = hom_ref_support.ComputePLs(2);
+  REQUIRE(hom_ref_pls.size() == 3);
+  CHECK(hom_ref_pls[0] == 0);
+  CHECK(hom_ref_pls[1] > 0);
+  CHECK(hom_ref_pls[2] > hom_ref_pls[1]);
+}
+
+TEST_CASE("A fragment contributes one likelihood row even when mates split alleles",
+          "[lancet][caller][VariantSupport][PL]") {
+  std::array<f64, 2> const alt_like{-5.0, -1.0};
+  std::array<f64, 2> const ref_like{-1.0, -5.0};
+
+  VariantSupport once;
+  VariantSupport twice;
+  auto first = MakeEvidence(1, 1000, 0, 1, 100);
+  first.mAlleleLog10Liks = alt_like;
+  auto mate = MakeEvidence(0, 1000, 0, 1, 100);
+  mate.mAlleleLog10Liks = ref_like;
+
+  once.AddEvidence(first);
+  twice.AddEvidence(first);
+  twice.AddEvidence(mate);
+  CHECK(once.ComputePLs(2) == twice.ComputePLs(2));
+}
+
+TEST_CASE("PLs fall back to allele counts without per-read likelihoods",
+          "[lancet][caller][VariantSupport][PL]") {
+  VariantSupport support;
+  for (u32 idx = 0; idx < 20; ++idx) support.AddEvidence(MakeEvidence(1, 1000, 0, 1, 100 + idx));
+
+  auto const pls = support.ComputePLs(2);
+  REQUIRE(pls.size() == 3);
+  CHECK(pls[2] == 0);
+  CHECK(pls[0] > pls[1]);
+}
+
 // ============================================================================
 // PDCV — integration testing happens via variant_call_test.cpp since PDCV
 // is computed from Graph::Path metadata, not from VariantSupport directly.
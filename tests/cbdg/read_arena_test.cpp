@@ -0,0 +1,78 @@
+#include "lancet/cbdg/read_arena.h"
+
+#include "lancet/base/types.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using lancet::cbdg::ReadArena;
+
+namespace {
+
+[[nodiscard]] auto StoreString(ReadArena& arena, std::string_view const text) -> std::string_view {
+  auto* const ptr = arena.Allocate(text.size());
+  std::ranges::copy(text, ptr);
+  return {ptr, text.size()};
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("ReadArena keeps stored bytes addressable", "[lancet][cbdg][ReadArena]") {
+  auto const pool = std::make_shared<ReadArena::BlockPool>();
+
+  SECTION("Allocations spanning several blocks keep their contents") {
+    ReadArena arena(pool);
+    static constexpr usize NUM_ALLOCS = 4096;
+    static constexpr std::string_view TEXT = "ACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGT"
+                                             "ACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGT"
+                                             "ACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGTACGT";
+    std::vector<std::string_view> views;
+    for (usize idx = 0; idx < NUM_ALLOCS; ++idx) views.push_back(StoreString(arena, TEXT));
+    CHECK(std::ranges::all_of(views, [](std::string_view view) { return view == TEXT; }));
+  }
+
+  SECTION("Oversized allocations get their own storage") {
+    ReadArena arena(pool);
+    std::string const long_read(ReadArena::BLOCK_SIZE + 17, 'T');
+    auto const small = StoreString(arena, "qname");
+    auto const large = StoreString(arena, long_read);
+    auto const after = StoreString(arena, "next");
+    CHECK(small == "qname");
+    CHECK(large == long_read);
+    CHECK(after == "next");
+  }
+
+  SECTION("Absorbed and moved arenas keep earlier views valid") {
+    ReadArena first(pool);
+    ReadArena second(pool);
+    auto const from_first = StoreString(first, "first");
+    auto const from_second = StoreString(second, "second");
+
+    first.Absorb(std::move(second));
+    // Absorb() leaves its source empty but usable, unlike a plain move.
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    auto const after_absorb = StoreString(second, "reused");
+    ReadArena moved(std::move(first));
+
+    CHECK(from_first == "first");
+    CHECK(from_second == "second");
+    CHECK(after_absorb == "reused");
+  }
+
+  SECTION("Released blocks are handed out again") {
+    char const* first_block = nullptr;
+    {
+      ReadArena arena(pool);
+      first_block = arena.Allocate(1);
+    }
+    ReadArena arena(pool);
+    CHECK(arena.Allocate(1) == first_block);
+  }
+}
@@ -0,0 +1,73 @@
+#include "lancet/cbdg/read_batch.h"
+
+#include "lancet/base/dna_encode.h"
+#include "lancet/base/types.h"
+#include "lancet/cbdg/label.h"
+#include "lancet/cbdg/read.h"
+#include "lancet/cbdg/read_arena.h"
+#include "lancet/hts/alignment.h"
+#include "lancet/hts/extractor.h"
+#include "lancet/hts/phred_quality.h"
+#include "lancet/hts/reference.h"
+
+#include "absl/hash/hash.h"
+#include "absl/types/span.h"
+#include "catch_amalgamated.hpp"
+#include "lancet_test_config.h"
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+using lancet::cbdg::Label;
+using lancet::cbdg::Read;
+using lancet::cbdg::ReadArena;
+using lancet::cbdg::ReadBatch;
+using lancet::hts::Alignment;
+using lancet::hts::Extractor;
+using lancet::hts::Reference;
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("ReadBatch encodes every read once", "[lancet][cbdg][ReadBatch]") {
+  Reference const ref(MakePath(FULL_DATA_DIR, GRCH38_REF_NAME));
+  auto const case_bam_path = MakePath(FULL_DATA_DIR, CASE_BAM_NAME);
+  REQUIRE(std::filesystem::exists(case_bam_path));
+
+  ReadArena arena(std::make_shared<ReadArena::BlockPool>());
+  std::vector<Read> reads;
+  Extractor extractor(case_bam_path, ref, Alignment::Fields::CIGAR_SEQ_QUAL);
+  extractor.SetRegionToExtract("chr4:99990001-99991000");
+  for (auto const& aln : extractor) reads.emplace_back(aln, arena, Label::CASE, 0);
+  REQUIRE(reads.size() > 1);
+
+  ReadBatch const batch(absl::MakeConstSpan(reads));
+  REQUIRE(batch.Size() == reads.size());
+
+  for (usize read_idx = 0; read_idx < reads.size(); ++read_idx) {
+    auto const& read = reads[read_idx];
+    INFO("read_idx=" << read_idx << " qname=" << read.QnameView());
+    CHECK(batch.QnameHash(read_idx) == absl::HashOf(read.QnameView()));
+    CHECK(batch.SeqHash(read_idx) == absl::HashOf(read.SeqView()));
+
+    auto const bases = batch.EncodedBases(read_idx);
+    REQUIRE(bases.size() == read.Length());
+    for (usize pos = 0; pos < bases.size(); ++pos) {
+      CHECK(bases[pos] == lancet::base::DNA_ENCODE_TABLE[static_cast<u8>(read.SeqView()[pos])]);
+    }
+
+    // Length+1 prefix sums: leading zero, then one error probability per base
+    auto const prefix_sums = batch.ErrorPrefixSums(read_idx);
+    REQUIRE(prefix_sums.size() == read.Length() + 1);
+    CHECK(prefix_sums[0] == 0.0);
+    for (usize pos = 0; pos < read.Length(); ++pos) {
+      auto const error_prob = lancet::hts::PhredToErrorProb(read.QualView()[pos]);
+      CHECK(prefix_sums[pos + 1] - prefix_sums[pos] == Catch::Approx(error_prob).margin(1e-12));
+    }
+  }
+
+  SECTION("An empty span gives an empty batch") {
+    ReadBatch const empty(absl::Span<Read const>{});
+    CHECK(empty.IsEmpty());
+    CHECK(empty.Size() == 0);
+  }
+}
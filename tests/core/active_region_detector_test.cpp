@@ -0,0 +1,104 @@
+#include "lancet/core/active_region_detector.h"
+
+#include "lancet/base/types.h"
+
+extern "C" {
+#include "htslib/sam.h"
+}
+
+#include "catch_amalgamated.hpp"
+
+#include <bitset>
+#include <string_view>
+#include <vector>
+
+using lancet::core::detail::VisitMdMismatches;
+
+namespace {
+
+constexpr i64 START0 = 100;
+constexpr usize MAX_SPAN = 32;
+constexpr u8 HIGH_QUAL = 30;
+constexpr u8 LOW_QUAL = 5;
+
+// "5S8M" → raw BAM CIGAR words.
+[[nodiscard]] auto ParseCigar(std::string_view cigar) -> std::vector<u32> {
+  static constexpr std::string_view OPS = BAM_CIGAR_STR;
+  std::vector<u32> result;
+  u32 len = 0;
+  for (auto const character : cigar) {
+    if (character >= '0' && character <= '9') {
+      len = (len * 10) + static_cast<u32>(character - '0');
+      continue;
+    }
+    result.push_back(bam_cigar_gen(len, static_cast<u32>(OPS.find(character))));
+    len = 0;
+  }
+  return result;
+}
+
+// Reported mismatch positions as offsets from START0.
+[[nodiscard]] auto MismatchBits(std::string_view md_val, std::string_view cigar,
+                                std::vector<u8> const& quals) -> std::bitset<MAX_SPAN> {
+  std::bitset<MAX_SPAN> hits;
+  auto const cigar_words = ParseCigar(cigar);
+  auto const stopped = VisitMdMismatches(md_val, cigar_words, quals, START0,
+                                         [&hits](u32 const genome_pos) -> bool {
+                                           hits.set(genome_pos - static_cast<u32>(START0));
+                                           return false;
+                                         });
+  CHECK_FALSE(stopped);
+  return hits;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("VisitMdMismatches places MD mismatches on the reference and the read",
+          "[lancet][core][ActiveRegionDetector]") {
+  struct Row {
+    std::string_view mMd;
+    std::string_view mCigar;
+    usize mReadLen;
+    std::vector<usize> mLowQualOffsets;  // read offsets below the quality cutoff
+    std::string_view mExpected;          // hit bitset, bit 0 = START0
+  };
+
+  std::vector<Row> const rows = {
+      // Mismatch advances by one; the deleted AC are not mismatches.
+      {"10A5^AC3", "16M2D3M", 19, {}, "10000000000"},
+      // Adjacent mismatches separated by zero-length match runs.
+      {"0A0C5", "7M", 7, {}, "11"},
+      // A mismatch right after a deletion.
+      {"2^G0T4", "2M1D5M", 7, {}, "1000"},
+      // Soft clip: ref +3 is read offset 8, not 3.
+      {"3G4", "5S8M", 13, {3}, "1000"},
+      {"3G4", "5S8M", 13, {8}, "0"},
+      // Insertion: ref +4 is read offset 7; hard clips consume nothing.
+      {"4T3", "2H2M3I6M", 11, {4}, "10000"},
+      {"4T3", "2H2M3I6M", 11, {7}, "0"},
+      // Two mismatches on either side of a soft-clipped insertion.
+      {"1A1C1", "3S2M2I3M", 10, {}, "1010"},
+      // Every base low quality: nothing reported.
+      {"1A1C1", "5M", 5, {0, 1, 2, 3, 4}, "0"},
+  };
+
+  for (auto const& row : rows) {
+    INFO("MD=" << row.mMd << " CIGAR=" << row.mCigar);
+    std::vector<u8> quals(row.mReadLen, HIGH_QUAL);
+    for (auto const offset : row.mLowQualOffsets) quals[offset] = LOW_QUAL;
+    CHECK(MismatchBits(row.mMd, row.mCigar, quals) == std::bitset<MAX_SPAN>(row.mExpected.data(),
+                                                                             row.mExpected.size()));
+  }
+
+  SECTION("Stops at the first position the visitor accepts") {
+    auto const cigar_words = ParseCigar("7M");
+    std::vector<u8> const quals(7, HIGH_QUAL);
+    std::vector<u32> visited;
+    CHECK(VisitMdMismatches("0A0C5", cigar_words, quals, START0, [&visited](u32 const pos) -> bool {
+      visited.push_back(pos);
+      return true;
+    }));
+    CHECK(visited == std::vector<u32>{static_cast<u32>(START0)});
+  }
+}
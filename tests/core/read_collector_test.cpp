@@ -0,0 +1,278 @@
+#include "lancet/core/read_collector.h"
+
+#include "lancet/base/types.h"
+#include "lancet/cbdg/label.h"
+#include "lancet/core/sample_info.h"
+#include "lancet/hts/alignment.h"
+#include "lancet/hts/extractor.h"
+#include "lancet/hts/reference.h"
+
+extern "C" {
+#include "htslib/kstring.h"
+#include "htslib/sam.h"
+}
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "catch_amalgamated.hpp"
+#include "lancet_test_config.h"
+#include "spdlog/fmt/bundled/format.h"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using lancet::core::ReadCollector;
+using lancet::core::SampleInfo;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr usize READ_LEN = 100;
+constexpr i64 READ_SPREAD = 1000;  // every read of a contig starts within this many bases
+
+struct ContigReads {
+  std::string mChrom;
+  i64 mStart1 = 0;
+  usize mNumReads = 0;
+};
+
+// Coordinate-sorted BAM with chr4 and chr21 in the header and a BAI beside it.
+// A contig missing from `contigs` has no records, so its index has no pseudo-bin.
+void WriteIndexedBam(fs::path const& path, std::string const& sample_name,
+                     std::vector<ContigReads> const& contigs) {
+  static constexpr u64 SEQ_SEED = 0x49'44'58'44'45'50ULL;
+  static constexpr std::array<char, 4> BASES = {'A', 'C', 'G', 'T'};
+
+  std::string const hdr_text = "@HD\tVN:1.6\tSO:coordinate\n@SQ\tSN:chr4\tLN:190214555\n"
+                               "@SQ\tSN:chr21\tLN:46709983\n@RG\tID:rg1\tSM:" +
+                               sample_name + "\n";
+  samFile* fptr = sam_open(path.c_str(), "wb");
+  REQUIRE(fptr != nullptr);
+  sam_hdr_t* hdr = sam_hdr_parse(hdr_text.size(), hdr_text.c_str());
+  REQUIRE(hdr != nullptr);
+  REQUIRE(sam_hdr_write(fptr, hdr) == 0);
+
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(SEQ_SEED);
+  bam1_t* aln = bam_init1();
+  kstring_t line = KS_INITIALIZE;
+  for (auto const& contig : contigs) {
+    for (usize idx = 0; idx < contig.mNumReads; ++idx) {
+      auto const offset = static_cast<i64>(idx) * READ_SPREAD / static_cast<i64>(contig.mNumReads);
+      auto const pos1 = contig.mStart1 + offset;
+      std::string seq(READ_LEN, 'A');
+      for (auto& base : seq) base = BASES[generator() % BASES.size()];
+
+      auto const record = contig.mChrom + "_" + std::to_string(idx) + "\t0\t" + contig.mChrom +
+                          "\t" + std::to_string(pos1) + "\t60\t" + std::to_string(READ_LEN) +
+                          "M\t*\t0\t0\t" + seq + "\t*\tRG:Z:rg1";
+      line.l = 0;
+      kputsn(record.c_str(), record.size(), &line);
+      REQUIRE(sam_parse1(&line, hdr, aln) >= 0);
+      REQUIRE(sam_write1(fptr, hdr, aln) >= 0);
+    }
+  }
+
+  ks_free(&line);
+  bam_destroy1(aln);
+  sam_hdr_destroy(hdr);
+  REQUIRE(sam_close(fptr) == 0);
+  REQUIRE(sam_index_build(path.c_str(), 0) == 0);
+}
+
+// Identifies one record of a pair: (qname, chrom index, 0-based start)
+using ReadKey = std::tuple<std::string, i32, i64>;
+
+[[nodiscard]] auto SortedReadKeys(ReadCollector::Result const& result) -> std::vector<ReadKey> {
+  std::vector<ReadKey> keys;
+  keys.reserve(result.mSampleReads.size());
+  for (auto const& read : result.mSampleReads) {
+    keys.emplace_back(std::string(read.QnameView()), read.ChromIndex(), read.StartPos0());
+  }
+  std::ranges::sort(keys);
+  return keys;
+}
+
+// Out-of-region mates of `kept` reads, fetched the way RecaptureMates did before
+// it used a region batch: one single-base query per mate location, ascending.
+[[nodiscard]] auto QueryMatesOneByOne(lancet::hts::Extractor& extractor,
+                                      std::string const& region_spec,
+                                      std::vector<ReadKey> const& kept) -> std::vector<ReadKey> {
+  absl::flat_hash_map<std::string, lancet::hts::MateInfo> expected;
+  absl::flat_hash_set<std::string> seen_in_region;
+  extractor.SetRegionToExtract(region_spec);
+  for (auto const& aln : extractor) {
+    auto const bflag = aln.Flag();
+    if (bflag.IsQcFail() || bflag.IsDuplicate() || bflag.IsUnmapped() || aln.MapQual() < 20) {
+      continue;
+    }
+
+    std::string qname(aln.QnameView());
+    if (seen_in_region.contains(qname)) {
+      expected.erase(qname);
+      continue;
+    }
+    seen_in_region.insert(qname);
+    auto const is_discordant = !bflag.IsMappedProperPair();
+    if (bflag.IsMateMapped() && (is_discordant || aln.HasTag("SA"))) {
+      expected.try_emplace(std::move(qname), aln.MateLocation());
+    }
+  }
+
+  absl::flat_hash_set<std::string_view> kept_qnames;
+  for (auto const& key : kept) kept_qnames.insert(std::get<0>(key));
+  absl::erase_if(expected, [&kept_qnames](auto const& entry) -> bool {
+    return !kept_qnames.contains(entry.first);
+  });
+
+  std::vector<lancet::hts::MateInfo> locations;
+  std::ranges::transform(expected, std::back_inserter(locations),
+                         [](auto const& entry) { return entry.second; });
+  std::ranges::sort(locations, {}, [](lancet::hts::MateInfo const& info) {
+    return std::pair(info.mChromIndex, info.mMateStartPos0);
+  });
+
+  std::vector<ReadKey> mates;
+  for (auto const& info : locations) {
+    if (expected.empty()) break;
+    auto const chrom = extractor.ChromName(info.mChromIndex);
+    auto const pos1 = info.mMateStartPos0 + 1;
+    extractor.SetRegionToExtract(chrom.find(':') != std::string::npos
+                                     ? fmt::format("{{{}}}:{}-{}", chrom, pos1, pos1)
+                                     : fmt::format("{}:{}-{}", chrom, pos1, pos1));
+    for (auto const& aln : extractor) {
+      auto const itr = expected.find(aln.QnameView());
+      if (itr == expected.end()) continue;
+      mates.emplace_back(itr->first, aln.ChromIndex(), aln.StartPos0());
+      expected.erase(itr);
+    }
+  }
+
+  std::ranges::sort(mates);
+  return mates;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("ReadCollector::EstimateIndexDepth falls back when a sample's index lacks a contig",
+          "[lancet][core][ReadCollector]") {
+  auto const ref_path = MakePath(FULL_DATA_DIR, GRCH38_REF_NAME);
+  lancet::hts::Reference const ref(ref_path);
+
+  auto const work_dir = fs::temp_directory_path() / "lancet_read_collector_test";
+  fs::remove_all(work_dir);
+  fs::create_directories(work_dir);
+
+  // The case sample piles thousands of reads onto 1 kbp of chr4; the control has
+  // nothing on chr4 at all, only reads on chr21.
+  static constexpr i64 DENSE_START1 = 100'000'001;
+  static constexpr i64 CHR21_START1 = 20'000'001;
+  auto const case_bam = work_dir / "dense_case.bam";
+  auto const ctrl_bam = work_dir / "no_chr4_ctrl.bam";
+  ContigReads const chr21_reads{.mChrom = "chr21", .mStart1 = CHR21_START1, .mNumReads = 1000};
+  ContigReads const dense_reads{.mChrom = "chr4", .mStart1 = DENSE_START1, .mNumReads = 4000};
+  WriteIndexedBam(case_bam, "dense_case", {dense_reads, chr21_reads});
+  WriteIndexedBam(ctrl_bam, "no_chr4_ctrl", {chr21_reads});
+
+  SECTION("Totals skip the contig without a pseudo-bin instead of failing") {
+    using lancet::hts::Alignment;
+    lancet::hts::Extractor const ctrl_extractor(ctrl_bam, ref, Alignment::Fields::CORE_QNAME, {},
+                                                true);
+    auto const totals = ctrl_extractor.QueryIndexTotals();
+    REQUIRE(totals.has_value());
+    CHECK(totals->mMappedRecords == chr21_reads.mNumReads);
+    CHECK(totals->mCompressedBytes > 0);
+
+    auto const chr4_footprint = ctrl_extractor.QueryIndexFootprint("chr4");
+    REQUIRE(chr4_footprint.has_value());
+    CHECK(chr4_footprint->mNumChunks == 0);
+  }
+
+  auto const case_ratio = ReadCollector::CalibrateIndexDepth(case_bam, ref_path);
+  auto const ctrl_ratio = ReadCollector::CalibrateIndexDepth(ctrl_bam, ref_path);
+  REQUIRE(case_ratio.has_value());
+  REQUIRE(ctrl_ratio.has_value());
+  CHECK(*case_ratio > 0.0);
+  CHECK(*ctrl_ratio > 0.0);
+
+  std::vector<SampleInfo> const samples = {
+      SampleInfo("dense_case", case_bam, lancet::cbdg::Label::CASE),
+      SampleInfo("no_chr4_ctrl", ctrl_bam, lancet::cbdg::Label::CTRL)};
+  auto const dense_window = ref.MakeRegion("chr4:100000001-100001000");
+
+  // Roughly 25x over a 16 kbp index tile: extreme only against a tiny coverage cap
+  auto const make_params = [&ref_path](std::vector<f64> bases_per_byte, f64 const max_cov) {
+    ReadCollector::Params params;
+    params.mRefPath = ref_path;
+    params.mBasesPerIndexByte = std::move(bases_per_byte);
+    params.mMaxSampleCov = max_cov;
+    params.mNoCtgCheck = true;
+    params.mSkipExtremeDepth = true;
+    return params;
+  };
+
+  using IndexDepth = ReadCollector::IndexDepth;
+  SECTION("The sample that has the contig still decides the window") {
+    ReadCollector const collector(make_params({*case_ratio, *ctrl_ratio}, 1.0), samples);
+    CHECK(collector.EstimateIndexDepth(dense_window) == IndexDepth::EXTREME);
+
+    ReadCollector const relaxed(make_params({*case_ratio, *ctrl_ratio}, 1000.0), samples);
+    CHECK(relaxed.EstimateIndexDepth(dense_window) == IndexDepth::NORMAL);
+  }
+
+  SECTION("Without a ratio for the dense sample the window is never skipped as extreme") {
+    ReadCollector const collector(make_params({0.0, *ctrl_ratio}, 1.0), samples);
+    CHECK(collector.EstimateIndexDepth(dense_window) == IndexDepth::NORMAL);
+  }
+
+  SECTION("A window only the sample without the contig covers is empty") {
+    std::vector<SampleInfo> const ctrl_only = {samples.back()};
+    ReadCollector const collector(make_params({*ctrl_ratio}, 1.0), ctrl_only);
+    CHECK(collector.EstimateIndexDepth(dense_window) == IndexDepth::EMPTY);
+  }
+
+  fs::remove_all(work_dir);
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("ReadCollector recaptures the same mates as one query per mate",
+          "[lancet][core][ReadCollector]") {
+  auto const ref_path = MakePath(FULL_DATA_DIR, GRCH38_REF_NAME);
+  auto const bam_path = MakePath(FULL_DATA_DIR, CASE_BAM_NAME);
+  lancet::hts::Reference const ref(ref_path);
+  auto const region = ref.MakeRegion("chr4:100000001-100010000");
+  std::vector<SampleInfo> const samples = {
+      SampleInfo("case", bam_path, lancet::cbdg::Label::CASE)};
+
+  auto const collect = [&](bool const extract_pairs) {
+    ReadCollector::Params params;
+    params.mRefPath = ref_path;
+    params.mExtractPairs = extract_pairs;
+    ReadCollector collector(std::move(params), samples);
+    return SortedReadKeys(collector.CollectRegionResult(region));
+  };
+
+  // Pass 3 only appends mates, so the in-region reads are the same either way
+  auto const in_region = collect(false);
+  auto const with_mates = collect(true);
+  REQUIRE(std::ranges::includes(with_mates, in_region));
+  std::vector<ReadKey> recaptured;
+  std::ranges::set_difference(with_mates, in_region, std::back_inserter(recaptured));
+
+  lancet::hts::Extractor extractor(bam_path, ref, lancet::hts::Alignment::Fields::AUX_RGAUX,
+                                   {"SA"}, true);
+  auto const expected = QueryMatesOneByOne(extractor, region.ToSamtoolsRegion(), in_region);
+  REQUIRE_FALSE(expected.empty());
+  CHECK(recaptured.size() == expected.size());
+  CHECK(recaptured == expected);
+}
@@ -0,0 +1,118 @@
+#include "lancet/core/sample_fanout.h"
+
+#include "lancet/base/types.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using lancet::core::SampleFanout;
+
+namespace {
+
+constexpr auto WAIT_TIMEOUT = std::chrono::seconds(10);
+
+// Spins until `flag` is set or WAIT_TIMEOUT passes; returns whether it was set.
+[[nodiscard]] auto WaitFor(std::atomic<bool> const& flag) -> bool {
+  auto const deadline = std::chrono::steady_clock::now() + WAIT_TIMEOUT;
+  while (!flag.load()) {
+    if (std::chrono::steady_clock::now() > deadline) return false;
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("SampleFanout runs every task exactly once", "[lancet][core][SampleFanout]") {
+  static constexpr usize NUM_TASKS = 64;
+  SampleFanout fanout(3);
+
+  // Reused across runs, the way a worker reuses its fanout for every window
+  for (usize run = 0; run < 4; ++run) {
+    std::array<std::atomic<usize>, NUM_TASKS> num_calls{};
+    fanout.Run(NUM_TASKS, [&num_calls](usize const idx) { num_calls[idx].fetch_add(1); });
+    for (auto const& count : num_calls) CHECK(count.load() == 1);
+  }
+
+  fanout.Run(0, [](usize) { FAIL("no task expected"); });
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("SampleFanout caller steals tasks while a helper is busy",
+          "[lancet][core][SampleFanout]") {
+  // One slow sample: the helper's first task blocks until every other task is
+  // done, which only happens if the caller runs them all itself.
+  static constexpr usize NUM_TASKS = 8;
+  SampleFanout fanout(1);
+  auto const caller_id = std::this_thread::get_id();
+
+  std::atomic<bool> helper_started = false;
+  std::atomic<usize> num_fast_done = 0;
+  std::atomic<bool> slow_released = false;
+  std::array<std::thread::id, NUM_TASKS> ran_on{};
+
+  fanout.Run(NUM_TASKS, [&](usize const idx) {
+    ran_on[idx] = std::this_thread::get_id();
+    if (idx == 0) {
+      // Requests are FIFO, so the helper's first task is task 1
+      CHECK(WaitFor(helper_started));
+      return;
+    }
+    if (idx == 1) {
+      helper_started.store(true);
+      auto const deadline = std::chrono::steady_clock::now() + WAIT_TIMEOUT;
+      while (num_fast_done.load() < NUM_TASKS - 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+      }
+      slow_released.store(num_fast_done.load() == NUM_TASKS - 2);
+      return;
+    }
+    num_fast_done.fetch_add(1);
+  });
+
+  CHECK(slow_released.load());
+  CHECK(ran_on[0] == caller_id);
+  CHECK(ran_on[1] != caller_id);
+  for (usize idx = 2; idx < NUM_TASKS; ++idx) {
+    INFO("task " << idx);
+    CHECK(ran_on[idx] == caller_id);
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("SampleFanout rethrows a task's exception and skips unstarted tasks",
+          "[lancet][core][SampleFanout]") {
+  static constexpr usize NUM_TASKS = 200;
+  static constexpr auto TASK_COST = std::chrono::milliseconds(1);
+  SampleFanout fanout(2);
+
+  for (usize const failing_idx : {usize{0}, usize{1}, NUM_TASKS / 2}) {
+    INFO("failing task " << failing_idx);
+    std::atomic<usize> num_started = 0;
+    CHECK_THROWS_WITH(fanout.Run(NUM_TASKS,
+                                 [&num_started, failing_idx](usize const idx) {
+                                   num_started.fetch_add(1);
+                                   if (idx == failing_idx) {
+                                     throw std::runtime_error("task " + std::to_string(idx));
+                                   }
+                                   std::this_thread::sleep_for(TASK_COST);
+                                 }),
+                      "task " + std::to_string(failing_idx));
+
+    // Only tasks already running when the error was raised get to finish
+    CHECK(num_started.load() < failing_idx + (NUM_TASKS / 4));
+  }
+
+  // A failed run does not leak into the next one
+  std::atomic<usize> num_calls = 0;
+  fanout.Run(NUM_TASKS, [&num_calls](usize) { num_calls.fetch_add(1); });
+  CHECK(num_calls.load() == NUM_TASKS);
+}
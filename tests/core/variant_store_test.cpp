@@ -0,0 +1,187 @@
+#include "lancet/core/variant_store.h"
+
+#include "lancet/base/types.h"
+#include "lancet/caller/alt_allele.h"
+#include "lancet/caller/raw_variant.h"
+#include "lancet/caller/variant_call.h"
+#include "lancet/caller/variant_support.h"
+#include "lancet/cbdg/label.h"
+#include "lancet/core/sample_info.h"
+#include "lancet/core/window_builder.h"
+
+#include "absl/types/span.h"
+#include "catch_amalgamated.hpp"
+#include "lancet_test_config.h"
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+using lancet::core::VariantStore;
+
+namespace {
+
+using lancet::caller::AlleleType;
+using lancet::caller::AltAllele;
+using lancet::caller::RawVariant;
+using lancet::caller::Strand;
+using lancet::caller::VariantCall;
+using lancet::caller::VariantSupport;
+
+constexpr usize WINDOW_LENGTH = 1000;
+
+// Builds single-sample SNV calls with a given read split; the RawVariants must
+// outlive the calls.
+class CallFactory {
+ public:
+  CallFactory() {
+    auto& sample = mSamples.emplace_back("S1", "s1.bam", lancet::cbdg::Label::CTRL);
+    sample.SetSampleIndex(0);
+    sample.SetNumSampledBases(30 * WINDOW_LENGTH);
+  }
+
+  [[nodiscard]] auto Make(usize const chrom_idx, usize const pos1, u32 const num_ref,
+                          u32 const num_alt) -> VariantStore::Value {
+    auto& var = mVariants.emplace_back();
+    var.mChromIndex = chrom_idx;
+    var.mChromName = "chr4";
+    var.mGenomeChromPos1 = pos1;
+    var.mLocalRefStart0Idx = 0;
+    var.mRefAllele = "A";
+    AltAllele alt;
+    alt.mSequence = "T";
+    alt.mType = AlleleType::SNV;
+    alt.mLength = 1;
+    var.mAlts.push_back(std::move(alt));
+
+    VariantCall::SupportsByVariant supports;
+    auto& support = supports[&var].FindOrCreate(0);
+    AddReads(support, 0, num_ref);
+    AddReads(support, 1, num_alt);
+    return std::make_unique<VariantCall>(&var, supports, absl::MakeConstSpan(mSamples),
+                                         WINDOW_LENGTH);
+  }
+
+ private:
+  std::vector<lancet::core::SampleInfo> mSamples;
+  std::deque<RawVariant> mVariants;  // stable addresses
+
+  static void AddReads(VariantSupport& support, lancet::caller::AlleleIndex const allele,
+                       u32 const count) {
+    for (u32 idx = 0; idx < count; ++idx) {
+      support.AddEvidence({
+          .mInsertSize = 300,
+          .mAlignmentStart = 1'900 + static_cast<i64>(idx),
+          .mAlnScore = 140.0,
+          .mFoldedReadPos = 0.25,
+          .mRnameHash = (u32{allele} << 16U) + idx,
+          .mRefNm = allele,
+          .mOwnHapNm = 0,
+          .mAssignedHaplotypeId = allele,
+          .mAllele = allele,
+          .mStrand = idx % 2 == 0 ? Strand::FWD : Strand::REV,
+          .mBaseQual = 30,
+          .mMapQual = 60,
+          .mIsSoftClipped = false,
+          .mIsProperPair = true,
+      });
+    }
+  }
+};
+
+struct ExpectedCall {
+  usize mPos1 = 0;
+  usize mCoverage = 0;
+
+  auto operator<=>(ExpectedCall const&) const = default;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("VariantStore flushes out-of-order windows in coordinate order",
+          "[lancet][core][VariantStore]") {
+  // Same lag PipelineExecutor::FlushCompletedVariants keeps behind the last
+  // contiguous done window, scaled down so windows never overlap the flush point.
+  static constexpr usize FLUSH_LAG = 2;
+  static constexpr u64 ORDER_SEED = 0x56'41'52'53'54'4FULL;
+
+  lancet::core::WindowBuilder::Params const params{.mWindowLength = WINDOW_LENGTH,
+                                                   .mRegionPadding = 0};
+  lancet::core::WindowBuilder builder(MakePath(FULL_DATA_DIR, GRCH38_REF_NAME), params);
+  builder.AddRegion("chr4:100000001-100020000");
+  auto const windows = builder.BuildWindows();
+  auto const num_windows = windows.size();
+  REQUIRE(num_windows > 4 * FLUSH_LAG);
+
+  // Every window reports two supported calls of its own and one with reference
+  // reads only. The overlap with the next window holds a call both report; the
+  // next window saw more reads there, so its copy must win either way round.
+  CallFactory factory;
+  std::vector<std::vector<VariantStore::Value>> results(num_windows);
+  std::vector<ExpectedCall> expected;
+  for (usize idx = 0; idx < num_windows; ++idx) {
+    auto const chrom_idx = windows[idx]->ChromIndex();
+    auto const start1 = windows[idx]->StartPos1();
+    for (usize const offset : {100, 700}) {
+      results[idx].push_back(factory.Make(chrom_idx, start1 + offset, 10, 10));
+      expected.push_back({.mPos1 = start1 + offset, .mCoverage = 20});
+    }
+    results[idx].push_back(factory.Make(chrom_idx, start1 + 400, 20, 0));
+
+    if (idx + 1 == num_windows) continue;
+    auto const shared_pos1 = windows[idx + 1]->StartPos1() + 50;
+    REQUIRE(shared_pos1 < windows[idx]->EndPos1());
+    results[idx].push_back(factory.Make(chrom_idx, shared_pos1, 5, 5));
+    results[idx + 1].push_back(factory.Make(chrom_idx, shared_pos1, 15, 15));
+    expected.push_back({.mPos1 = shared_pos1, .mCoverage = 30});
+  }
+  std::ranges::sort(expected);
+
+  // NOLINTNEXTLINE(bugprone-random-generator-seed,cert-msc32-c,cert-msc51-cpp)
+  std::mt19937_64 generator(ORDER_SEED);
+  std::vector<usize> done_order(num_windows);
+  std::iota(done_order.begin(), done_order.end(), 0);
+  std::ranges::shuffle(done_order, generator);
+
+  VariantStore store;
+  std::vector<VariantStore::Value> written;
+  std::vector<bool> done_windows(num_windows, false);
+  usize last_contiguous_done = 0;
+  usize idx_to_flush = 0;
+  for (auto const window_idx : done_order) {
+    store.AddVariants(std::move(results[window_idx]));
+    done_windows[window_idx] = true;
+    while (last_contiguous_done < num_windows && done_windows[last_contiguous_done]) {
+      last_contiguous_done++;
+    }
+
+    if (last_contiguous_done <= FLUSH_LAG || last_contiguous_done - FLUSH_LAG <= idx_to_flush) {
+      continue;
+    }
+    idx_to_flush = last_contiguous_done - FLUSH_LAG;
+    auto batch = store.ExtractVariantsBeforeWindow(*windows[idx_to_flush]);
+    std::ranges::move(batch, std::back_inserter(written));
+  }
+
+  auto remaining = store.ExtractAllVariants();
+  CHECK_FALSE(remaining.empty());
+  std::ranges::move(remaining, std::back_inserter(written));
+
+  // The final flush leaves nothing behind, not even the unsupported calls
+  CHECK(store.ExtractAllVariants().empty());
+  CHECK(store.ExtractVariantsBeforeWindow(*windows.back()).empty());
+
+  std::vector<ExpectedCall> actual;
+  actual.reserve(written.size());
+  for (auto const& call : written) {
+    CHECK(call->ChromIndex() == windows.front()->ChromIndex());
+    actual.push_back({.mPos1 = call->StartPos1(), .mCoverage = call->TotalCoverage()});
+  }
+  CHECK(actual == expected);
+}
@@ -0,0 +1,153 @@
+#include "lancet/core/vcf_writer.h"
+
+#include "lancet/base/types.h"
+#include "lancet/caller/alt_allele.h"
+#include "lancet/caller/raw_variant.h"
+#include "lancet/caller/variant_call.h"
+#include "lancet/cbdg/label.h"
+#include "lancet/core/sample_info.h"
+#include "lancet/hts/bgzf_ostream.h"
+
+extern "C" {
+#include "htslib/bgzf.h"
+#include "htslib/kstring.h"
+}
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using lancet::core::VcfWriter;
+
+namespace {
+
+using lancet::caller::AlleleType;
+using lancet::caller::AltAllele;
+using lancet::caller::RawVariant;
+using lancet::caller::VariantCall;
+
+constexpr usize WINDOW_LENGTH = 1000;
+
+// Builds calls at given positions; the RawVariants must outlive the calls.
+class CallFactory {
+ public:
+  CallFactory() { mSamples.emplace_back("S1", "s1.bam", lancet::cbdg::Label::CASE); }
+
+  [[nodiscard]] auto Make(usize const pos1) -> std::unique_ptr<VariantCall> {
+    auto& var = mVariants.emplace_back();
+    var.mChromIndex = 0;
+    var.mChromName = "chr1";
+    var.mGenomeChromPos1 = pos1;
+    var.mLocalRefStart0Idx = 0;
+    var.mRefAllele = "A";
+    AltAllele alt;
+    alt.mSequence = "T";
+    alt.mType = AlleleType::SNV;
+    alt.mLength = 1;
+    var.mAlts.push_back(std::move(alt));
+    return std::make_unique<VariantCall>(&var, VariantCall::SupportsByVariant{},
+                                         absl::MakeConstSpan(mSamples), WINDOW_LENGTH);
+  }
+
+ private:
+  std::vector<lancet::core::SampleInfo> mSamples;
+  std::deque<RawVariant> mVariants;  // stable addresses
+};
+
+// POS column of every record line in a bgzipped VCF, in file order.
+[[nodiscard]] auto ReadPositions(std::filesystem::path const& path) -> std::vector<usize> {
+  std::vector<usize> result;
+  BGZF* fptr = bgzf_open(path.c_str(), "r");
+  REQUIRE(fptr != nullptr);
+  kstring_t line = KS_INITIALIZE;
+  while (bgzf_getline(fptr, '\n', &line) >= 0) {
+    std::string_view const text(line.s, line.l);
+    if (text.starts_with('#')) continue;
+    std::vector<std::string_view> const fields = absl::StrSplit(text, '\t');
+    REQUIRE(fields.size() > 1);
+    usize pos1 = 0;
+    REQUIRE(absl::SimpleAtoi(fields[1], &pos1));
+    result.push_back(pos1);
+  }
+  ks_free(&line);
+  bgzf_close(fptr);
+  return result;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("VcfWriter writes batches from many threads in submission order",
+          "[lancet][core][VcfWriter]") {
+  namespace fs = std::filesystem;
+  static constexpr usize NUM_THREADS = 4;
+  static constexpr usize BATCHES_PER_THREAD = 6 * VcfWriter::MAX_QUEUED_BATCHES;
+  static constexpr usize POS_STEP = 10;
+
+  auto const vcf_path = fs::temp_directory_path() / "lancet_vcf_writer_test.vcf.gz";
+  CallFactory factory;
+
+  // Batch b holds 1 + b % 4 calls; positions count down, so later batches sort
+  // earlier and only submission order decides where a batch lands in the file.
+  static constexpr usize NUM_BATCHES = NUM_THREADS * BATCHES_PER_THREAD;
+  std::vector<VcfWriter::Batch> batches(NUM_BATCHES);
+  std::vector<std::vector<usize>> batch_positions(NUM_BATCHES);
+  usize next_pos = (NUM_BATCHES * 4 + 1) * POS_STEP;
+  for (usize idx = 0; idx < NUM_BATCHES; ++idx) {
+    for (usize num = 0; num <= idx % 4; ++num) {
+      next_pos -= POS_STEP;
+      batch_positions[idx].push_back(next_pos);
+      batches[idx].push_back(factory.Make(next_pos));
+    }
+  }
+
+  std::vector<usize> expected;
+  {
+    lancet::hts::BgzfOstream output;
+    REQUIRE(output.Open(vcf_path, lancet::hts::BgzfFormat::UNSPECIFIED));
+    output << "##fileformat=VCFv4.3\n#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n";
+    VcfWriter writer(output);
+
+    // Threads interleave: thread t submits batches t, t + NUM_THREADS, ... backwards.
+    // The lock only records the order the writer receives them in.
+    absl::Mutex order_mutex;
+    {
+      std::vector<std::jthread> submitters;
+      for (usize thread_idx = 0; thread_idx < NUM_THREADS; ++thread_idx) {
+        submitters.emplace_back([&, thread_idx] {
+          for (usize step = BATCHES_PER_THREAD; step > 0; --step) {
+            auto const batch_idx = thread_idx + ((step - 1) * NUM_THREADS);
+            absl::MutexLock const lock(order_mutex);
+            auto const& positions = batch_positions[batch_idx];
+            expected.insert(expected.end(), positions.begin(), positions.end());
+            writer.Submit(std::move(batches[batch_idx]));
+          }
+        });
+      }
+    }
+
+    // Empty batches are dropped without taking a queue slot.
+    writer.Submit({});
+    writer.Finish();
+    writer.Finish();
+    output.Close();
+  }
+
+  auto const written = ReadPositions(vcf_path);
+  CHECK(written.size() == expected.size());
+  CHECK(written == expected);
+  CHECK_FALSE(std::ranges::is_sorted(written));
+  fs::remove(vcf_path);
+}
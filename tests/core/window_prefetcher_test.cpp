@@ -0,0 +1,130 @@
+#include "lancet/core/window_prefetcher.h"
+
+#include "lancet/base/types.h"
+#include "lancet/core/variant_builder.h"
+#include "lancet/core/window.h"
+
+#include "catch_amalgamated.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using lancet::core::VariantBuilder;
+using lancet::core::Window;
+using lancet::core::WindowPrefetcher;
+
+namespace {
+
+using StatusCode = VariantBuilder::StatusCode;
+using WindowInput = VariantBuilder::WindowInput;
+
+constexpr usize NUM_STATUS_CODES = 9;
+
+[[nodiscard]] auto MakeWindow(usize const genome_idx) -> lancet::core::WindowPtr {
+  auto window = std::make_shared<Window>();
+  window->SetGenomeIndex(genome_idx);
+  return window;
+}
+
+// Tags each input with its window, so Take() can be matched to Submit().
+[[nodiscard]] auto ExpectedCode(usize const genome_idx) -> StatusCode {
+  return static_cast<StatusCode>(genome_idx % NUM_STATUS_CODES);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("WindowPrefetcher returns each window's input in submission order",
+          "[lancet][core][WindowPrefetcher]") {
+  static constexpr usize NUM_WINDOWS = 50;
+  auto const caller_id = std::this_thread::get_id();
+
+  std::vector<usize> loaded;
+  bool all_on_helper = true;
+  {
+    WindowPrefetcher prefetcher([&](Window const& window) -> WindowInput {
+      all_on_helper = all_on_helper && std::this_thread::get_id() != caller_id;
+      loaded.push_back(window.GenomeIndex());
+      return WindowInput{.mSkipCode = ExpectedCode(window.GenomeIndex())};
+    });
+
+    // Windows arrive out of genome order, the way workers dequeue them
+    for (usize step = 0; step < NUM_WINDOWS; ++step) {
+      auto const genome_idx = (step * 7) % NUM_WINDOWS;
+      prefetcher.Submit(MakeWindow(genome_idx));
+      CHECK(prefetcher.Take().mSkipCode == ExpectedCode(genome_idx));
+    }
+  }
+
+  REQUIRE(loaded.size() == NUM_WINDOWS);
+  for (usize step = 0; step < NUM_WINDOWS; ++step) CHECK(loaded[step] == (step * 7) % NUM_WINDOWS);
+  CHECK(all_on_helper);
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("WindowPrefetcher rethrows load errors from Take and keeps loading",
+          "[lancet][core][WindowPrefetcher]") {
+  static constexpr usize FAILING_IDX = 3;
+  WindowPrefetcher prefetcher([](Window const& window) -> WindowInput {
+    if (window.GenomeIndex() == FAILING_IDX) {
+      throw std::runtime_error("could not read window " + std::to_string(FAILING_IDX));
+    }
+    return WindowInput{.mSkipCode = ExpectedCode(window.GenomeIndex())};
+  });
+
+  for (usize genome_idx = 0; genome_idx < 2 * FAILING_IDX; ++genome_idx) {
+    INFO("window " << genome_idx);
+    prefetcher.Submit(MakeWindow(genome_idx));
+    if (genome_idx == FAILING_IDX) {
+      CHECK_THROWS_WITH(prefetcher.Take(), "could not read window 3");
+    } else {
+      CHECK(prefetcher.Take().mSkipCode == ExpectedCode(genome_idx));
+    }
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("WindowPrefetcher shuts down without waiting for Take",
+          "[lancet][core][WindowPrefetcher]") {
+  static constexpr auto SHUTDOWN_TIMEOUT = std::chrono::seconds(10);
+
+  SECTION("An idle helper stops promptly") {
+    auto prefetcher = std::make_unique<WindowPrefetcher>(
+        [](Window const& window) -> WindowInput {
+          return WindowInput{.mSkipCode = ExpectedCode(window.GenomeIndex())};
+        });
+    auto shutdown = std::async(std::launch::async, [&prefetcher] { prefetcher.reset(); });
+    CHECK(shutdown.wait_for(SHUTDOWN_TIMEOUT) == std::future_status::ready);
+  }
+
+  SECTION("A load in progress finishes and its input is dropped") {
+    std::promise<void> load_started;
+    std::promise<void> release_load;
+    auto release_signal = release_load.get_future().share();
+    std::atomic<usize> num_loads = 0;
+
+    auto prefetcher = std::make_unique<WindowPrefetcher>([&](Window const& window) -> WindowInput {
+      num_loads.fetch_add(1);
+      load_started.set_value();
+      release_signal.wait();
+      return WindowInput{.mSkipCode = ExpectedCode(window.GenomeIndex())};
+    });
+
+    prefetcher->Submit(MakeWindow(1));
+    load_started.get_future().wait();
+    auto shutdown = std::async(std::launch::async, [&prefetcher] { prefetcher.reset(); });
+
+    // Destruction waits for the load the helper is running
+    static constexpr auto HOLD_TIME = std::chrono::milliseconds(100);
+    CHECK(shutdown.wait_for(HOLD_TIME) == std::future_status::timeout);
+    release_load.set_value();
+    CHECK(shutdown.wait_for(SHUTDOWN_TIMEOUT) == std::future_status::ready);
+    CHECK(num_loads.load() == 1);
+  }
+}
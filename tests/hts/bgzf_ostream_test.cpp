@@ -0,0 +1,143 @@
+#include "lancet/hts/bgzf_ostream.h"
+
+#include "lancet/base/types.h"
+
+extern "C" {
+#include "htslib/hts.h"
+#include "htslib/kstring.h"
+#include "htslib/tbx.h"
+}
+
+#include "catch_amalgamated.hpp"
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+using lancet::hts::BgzfFormat;
+using lancet::hts::BgzfOstream;
+
+namespace {
+
+struct TestRecord {
+  std::string mChrom;
+  i64 mPos1 = 0;
+  usize mRefLen = 0;
+  std::string mLine;
+};
+
+// Enough records per contig to fill several 64 KiB BGZF blocks.
+[[nodiscard]] auto MakeRecords() -> std::vector<TestRecord> {
+  static constexpr usize NUM_RECORDS_PER_CHROM = 4000;
+  static constexpr i64 POS_STEP = 7;
+  static constexpr usize MAX_REF_LEN = 12;
+  std::vector<TestRecord> records;
+  for (std::string const chrom : {"chr1", "chr2"}) {
+    for (usize idx = 0; idx < NUM_RECORDS_PER_CHROM; ++idx) {
+      TestRecord rec{.mChrom = chrom,
+                     .mPos1 = 1 + (static_cast<i64>(idx) * POS_STEP),
+                     .mRefLen = 1 + (idx % MAX_REF_LEN)};
+      rec.mLine = chrom + "\t" + std::to_string(rec.mPos1) + "\t.\t" +
+                  std::string(rec.mRefLen, 'A') + "\tC\t50\tPASS\tIDX=" + std::to_string(idx);
+      records.push_back(std::move(rec));
+    }
+  }
+  return records;
+}
+
+// Every line tabix should return for [beg0, end0) on `chrom`, in file order.
+[[nodiscard]] auto ExpectedLines(std::vector<TestRecord> const& records, std::string const& chrom,
+                                 i64 const beg0, i64 const end0) -> std::vector<std::string> {
+  std::vector<std::string> result;
+  for (auto const& rec : records) {
+    auto const rec_beg0 = rec.mPos1 - 1;
+    auto const rec_end0 = rec_beg0 + static_cast<i64>(rec.mRefLen);
+    if (rec.mChrom == chrom && rec_beg0 < end0 && rec_end0 > beg0) result.push_back(rec.mLine);
+  }
+  return result;
+}
+
+[[nodiscard]] auto QueryLines(std::filesystem::path const& path, tbx_t* tbx,
+                              std::string const& chrom, i64 const beg0, i64 const end0)
+    -> std::vector<std::string> {
+  std::vector<std::string> result;
+  htsFile* fptr = hts_open(path.c_str(), "r");
+  REQUIRE(fptr != nullptr);
+  hts_itr_t* itr = tbx_itr_queryi(tbx, tbx_name2id(tbx, chrom.c_str()), beg0, end0);
+  REQUIRE(itr != nullptr);
+
+  kstring_t line = KS_INITIALIZE;
+  while (tbx_itr_next(fptr, tbx, itr, &line) >= 0) result.emplace_back(line.s, line.l);
+  ks_free(&line);
+  tbx_itr_destroy(itr);
+  hts_close(fptr);
+  return result;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("BgzfOstream writes a tabix index that tbx_itr_queryi can read",
+          "[lancet][hts][BgzfOstream]") {
+  namespace fs = std::filesystem;
+  auto const work_dir = fs::temp_directory_path() / "lancet_bgzf_ostream_test";
+  fs::remove_all(work_dir);
+  fs::create_directories(work_dir);
+
+  auto const records = MakeRecords();
+  // One thread indexes through hts_idx_push directly; a pool queues the entries
+  // until each block's final offset is known.
+  for (int const num_threads : {1, 4}) {
+    INFO("num_threads=" << num_threads);
+    auto const vcf_path = work_dir / ("indexed_" + std::to_string(num_threads) + ".vcf.gz");
+
+    {
+      BgzfOstream out;
+      REQUIRE(out.Open(vcf_path, BgzfFormat::VCF, num_threads));
+      out << "##fileformat=VCFv4.3\n"
+          << "##contig=<ID=chr1>\n##contig=<ID=chr2>\n"
+          << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n";
+      out.InitIndex();
+      for (auto const& rec : records) {
+        out << rec.mLine << '\n';
+        out.IndexRecord(rec.mChrom, rec.mPos1 - 1, rec.mPos1 - 1 + static_cast<i64>(rec.mRefLen));
+      }
+      out.Close();
+    }
+
+    REQUIRE(fs::exists(vcf_path.string() + ".tbi"));
+    tbx_t* tbx = tbx_index_load(vcf_path.c_str());
+    REQUIRE(tbx != nullptr);
+
+    int num_names = 0;
+    char const** names = tbx_seqnames(tbx, &num_names);
+    REQUIRE(num_names == 2);
+    CHECK(std::string(names[0]) == "chr1");
+    CHECK(std::string(names[1]) == "chr2");
+    std::free(static_cast<void*>(names));  // NOLINT(cppcoreguidelines-no-malloc)
+
+    // Whole contigs, a range straddling block boundaries, single-base ranges on
+    // both contigs, and a range past the last record.
+    struct Query {
+      std::string mChrom;
+      i64 mBeg0;
+      i64 mEnd0;
+    };
+    std::vector<Query> const queries = {
+        {"chr1", 0, 1'000'000},   {"chr2", 0, 1'000'000}, {"chr1", 9'000, 21'000},
+        {"chr2", 13'999, 14'000}, {"chr1", 3, 4},         {"chr2", 27'994, 28'100},
+        {"chr2", 50'000, 60'000},
+    };
+    for (auto const& query : queries) {
+      INFO(query.mChrom << ":" << query.mBeg0 << "-" << query.mEnd0);
+      CHECK(QueryLines(vcf_path, tbx, query.mChrom, query.mBeg0, query.mEnd0) ==
+            ExpectedLines(records, query.mChrom, query.mBeg0, query.mEnd0));
+    }
+    tbx_destroy(tbx);
+  }
+
+  fs::remove_all(work_dir);
+}
@@ -0,0 +1,120 @@
+#include "lancet/hts/block_cache.h"
+
+#include "lancet/base/types.h"
+
+extern "C" {
+#include "htslib/hfile.h"
+}
+
+#include "catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+
+using lancet::hts::BlockCache;
+
+namespace {
+
+[[nodiscard]] auto ReadAll(hFILE* fptr, usize const num_bytes) -> std::vector<char> {
+  // Odd read sizes so reads straddle chunk boundaries
+  static constexpr usize READ_SIZE = 777'777;
+  std::vector<char> result(num_bytes);
+  usize num_read = 0;
+  while (num_read < num_bytes) {
+    auto const res = hread(fptr, result.data() + num_read,
+                           std::min(READ_SIZE, num_bytes - num_read));
+    if (res <= 0) break;
+    num_read += static_cast<usize>(res);
+  }
+  result.resize(num_read);
+  return result;
+}
+
+[[nodiscard]] auto CountFiles(std::filesystem::path const& dir) -> usize {
+  usize count = 0;
+  for (auto const& entry : std::filesystem::recursive_directory_iterator(dir)) {
+    if (entry.is_regular_file()) count++;
+  }
+  return count;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("BlockCache serves the underlying file's bytes", "[lancet][hts][BlockCache]") {
+  namespace fs = std::filesystem;
+  auto const work_dir = fs::temp_directory_path() / "lancet_block_cache_test";
+  fs::remove_all(work_dir);
+  fs::create_directories(work_dir);
+
+  // 3.5 chunks, so the last chunk is a short one
+  static constexpr usize FILE_SIZE = (BlockCache::CHUNK_SIZE * 7) / 2;
+  std::vector<char> contents(FILE_SIZE);
+  std::mt19937 rng(42);  // NOLINT(cert-msc32-c,cert-msc51-cpp) — fixed seed for reproducibility
+  std::ranges::generate(contents, [&rng] { return static_cast<char>(rng()); });
+
+  auto const input_path = work_dir / "input.bin";
+  {
+    std::ofstream output(input_path, std::ios::binary);
+    output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  }
+
+  auto const cache_dir = work_dir / "cache";
+  static constexpr u64 MAX_CACHE_BYTES = u64{1} << 30;
+  BlockCache::Enable(cache_dir, MAX_CACHE_BYTES);
+  REQUIRE(BlockCache::IsEnabled());
+
+  auto const routed = BlockCache::Route(input_path.string());
+  CHECK(routed == std::string(BlockCache::SCHEME_PREFIX) + input_path.string());
+  CHECK(BlockCache::Route(routed) == routed);
+
+  // Remote objects have no validator to key on, so they bypass the cache by default
+  CHECK(BlockCache::Route("s3://bucket/tumor.bam") == "s3://bucket/tumor.bam");
+  CHECK(BlockCache::Route("https://host/tumor.bam") == "https://host/tumor.bam");
+
+  SECTION("Remote URIs are routed once declared immutable") {
+    BlockCache::Enable(cache_dir, MAX_CACHE_BYTES, true);
+    CHECK(BlockCache::Route("s3://bucket/tumor.bam") ==
+          std::string(BlockCache::SCHEME_PREFIX) + "s3://bucket/tumor.bam");
+    CHECK(BlockCache::Route(routed) == routed);
+
+    BlockCache::Enable(cache_dir, MAX_CACHE_BYTES);
+    CHECK(BlockCache::Route("s3://bucket/tumor.bam") == "s3://bucket/tumor.bam");
+  }
+
+  SECTION("Cold and warm reads return identical bytes") {
+    for (auto pass = 0; pass < 2; ++pass) {
+      hFILE* fptr = hopen(routed.c_str(), "r");  // NOLINT(cppcoreguidelines-pro-type-vararg)
+      REQUIRE(fptr != nullptr);
+      CHECK(ReadAll(fptr, FILE_SIZE + 1) == contents);
+      CHECK(hclose(fptr) == 0);
+    }
+
+    CHECK(CountFiles(cache_dir) == 4);
+  }
+
+  SECTION("Seeks land on the right byte across chunks") {
+    hFILE* fptr = hopen(routed.c_str(), "r");  // NOLINT(cppcoreguidelines-pro-type-vararg)
+    REQUIRE(fptr != nullptr);
+
+    static constexpr off_t OFFSET = static_cast<off_t>(BlockCache::CHUNK_SIZE * 2) + 12345;
+    static constexpr usize SPAN = BlockCache::CHUNK_SIZE;
+    REQUIRE(hseek(fptr, OFFSET, SEEK_SET) == OFFSET);
+    auto const span = ReadAll(fptr, SPAN);
+    auto const expected_begin = contents.begin() + OFFSET;
+    CHECK(std::equal(span.begin(), span.end(), expected_begin,
+                     expected_begin + static_cast<i64>(SPAN)));
+    CHECK(hclose(fptr) == 0);
+  }
+
+  BlockCache::Disable();
+  CHECK_FALSE(BlockCache::IsEnabled());
+  CHECK(BlockCache::Route(input_path.string()) == input_path.string());
+  fs::remove_all(work_dir);
+}
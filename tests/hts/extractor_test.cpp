@@ -6,11 +6,15 @@
 #include "absl/types/span.h"
 #include "catch_amalgamated.hpp"
 #include "lancet_test_config.h"
+#include "spdlog/fmt/bundled/format.h"
 
 #include <filesystem>
 #include <initializer_list>
 #include <iterator>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 using lancet::hts::Alignment;
 using lancet::hts::Extractor;
@@ -126,3 +130,79 @@ TEST_CASE("Extractor::SetFilterExpression(const std::string&)", "[lancet][hts][E
     CHECK_THROWS_AS(std::distance(bam_extractor.begin(), bam_extractor.end()), std::runtime_error);
   }
 }
+
+TEST_CASE("Extractor::QueryIndexTotals()", "[lancet][hts][Extractor]") {
+  Reference const ref(MakePath(FULL_DATA_DIR, GRCH38_REF_NAME));
+  auto const case_cram_path = MakePath(FULL_DATA_DIR, CASE_CRAM_NAME);
+  auto const case_bam_path = MakePath(FULL_DATA_DIR, CASE_BAM_NAME);
+
+  Extractor const cram_extractor(case_cram_path, ref, Alignment::Fields::CORE_QNAME);
+  Extractor const bam_extractor(case_bam_path, ref, Alignment::Fields::CORE_QNAME);
+
+  // CRAM indexes have no bin chunks or per-contig counts
+  CHECK_FALSE(cram_extractor.QueryIndexTotals().has_value());
+
+  auto const totals = bam_extractor.QueryIndexTotals();
+  REQUIRE(totals.has_value());
+  CHECK(totals->mMappedRecords > 0);
+
+  // One contig's footprint is part of the whole-file bytes
+  auto const chr4_footprint = bam_extractor.QueryIndexFootprint("chr4");
+  REQUIRE(chr4_footprint.has_value());
+  CHECK(chr4_footprint->mCompressedBytes > 0);
+  CHECK(chr4_footprint->mCompressedBytes <= totals->mCompressedBytes);
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Extractor::SharesCramReference(const Extractor&)", "[lancet][hts][Extractor]") {
+  Reference const ref(MakePath(FULL_DATA_DIR, GRCH38_REF_NAME));
+  auto const case_cram_path = MakePath(FULL_DATA_DIR, CASE_CRAM_NAME);
+  auto const case_bam_path = MakePath(FULL_DATA_DIR, CASE_BAM_NAME);
+
+  auto const regions = {ref.MakeRegion("chr4:100000000-100000000"),
+                        ref.MakeRegion("chr4:100000-100000")};
+
+  // Name, start and decoded bases of every record in `regions`
+  auto const decode = [&regions](Extractor& extractor) -> std::vector<std::string> {
+    std::vector<std::string> records;
+    extractor.SetRegionBatchToExtract(regions);
+    for (auto const& aln : extractor) {
+      records.push_back(
+          fmt::format("{}:{}:{}", aln.QnameView(), aln.StartPos0(), aln.BuildSequence()));
+    }
+    return records;
+  };
+
+  Extractor bam_extractor(case_bam_path, ref, Alignment::Fields::CIGAR_SEQ_QUAL);
+  auto const expected = decode(bam_extractor);
+  REQUIRE(expected.size() == 170);
+
+  Extractor first_cram(case_cram_path, ref, Alignment::Fields::CIGAR_SEQ_QUAL);
+  Extractor second_cram(case_cram_path, ref, Alignment::Fields::CIGAR_SEQ_QUAL);
+  CHECK(first_cram.SharesCramReference(second_cram));
+  CHECK(second_cram.SharesCramReference(first_cram));
+  CHECK_FALSE(first_cram.SharesCramReference(bam_extractor));
+  CHECK_FALSE(bam_extractor.SharesCramReference(bam_extractor));
+
+  SECTION("Both cram handles decode the same records as the bam one after another") {
+    // A handle closing does not take the shared reference away from the others
+    {
+      Extractor third_cram(case_cram_path, ref, Alignment::Fields::CIGAR_SEQ_QUAL);
+      CHECK(third_cram.SharesCramReference(first_cram));
+      CHECK(decode(third_cram) == expected);
+    }
+    CHECK(decode(first_cram) == expected);
+    CHECK(decode(second_cram) == expected);
+  }
+
+  SECTION("Both cram handles decode the same records as the bam concurrently") {
+    std::vector<std::string> first_records;
+    std::vector<std::string> second_records;
+    {
+      std::jthread const first_thread([&] { first_records = decode(first_cram); });
+      std::jthread const second_thread([&] { second_records = decode(second_cram); });
+    }
+    CHECK(first_records == expected);
+    CHECK(second_records == expected);
+  }
+}
@@ -0,0 +1,227 @@
+#include "lancet/hts/record_stream.h"
+
+#include "lancet/base/types.h"
+#include "lancet/hts/alignment.h"
+#include "lancet/hts/extractor.h"
+#include "lancet/hts/reference.h"
+
+extern "C" {
+#include "htslib/sam.h"
+}
+
+#include "catch_amalgamated.hpp"
+#include "lancet_test_config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using lancet::hts::Alignment;
+using lancet::hts::Extractor;
+using lancet::hts::RecordStream;
+using lancet::hts::Reference;
+
+namespace {
+
+using AlnKey = std::pair<std::string, i64>;
+
+[[nodiscard]] auto CollectKeys(Extractor& extractor, std::string const& region_spec)
+    -> std::vector<AlnKey> {
+  std::vector<AlnKey> result;
+  extractor.SetRegionToExtract(region_spec);
+  for (auto const& aln : extractor) {
+    result.emplace_back(std::string(aln.QnameView()), aln.StartPos0());
+  }
+  return result;
+}
+
+struct WindowResult {
+  // ── 8B Align ──────────────────────────────────────────────────────────
+  std::vector<AlnKey> mKeys;
+  u64 mNumBytes = 0;
+  u64 mMaxRecordBytes = 0;
+  // ── 1B Align ──────────────────────────────────────────────────────────
+  bool mIsCovered = false;
+};
+
+// Reads the window straight from the stream; the records are summarised before
+// returning, so nothing points into the buffer once the window is released.
+[[nodiscard]] auto CollectWindow(RecordStream& stream, i32 const tid, i64 const beg0,
+                                 i64 const end0) -> WindowResult {
+  WindowResult result;
+  std::vector<bam1_t*> records;
+  result.mIsCovered = stream.Collect(tid, beg0, end0, records);
+  for (auto const* aln : records) {
+    auto const num_bytes = sizeof(bam1_t) + static_cast<u64>(aln->m_data);
+    result.mKeys.emplace_back(bam_get_qname(aln), static_cast<i64>(aln->core.pos));
+    result.mNumBytes += num_bytes;
+    result.mMaxRecordBytes = std::max(result.mMaxRecordBytes, num_bytes);
+  }
+  return result;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("RecordStream serves the same records as index queries", "[lancet][hts][RecordStream]") {
+  Reference const ref(MakePath(FULL_DATA_DIR, GRCH38_REF_NAME));
+  auto const case_bam_path = MakePath(FULL_DATA_DIR, CASE_BAM_NAME);
+  REQUIRE(std::filesystem::exists(case_bam_path));
+
+  // Overlapping windows cut from one scan region, the way the pipeline emits them
+  std::vector<std::string> const scan_specs{"chr4:99990001-100010000"};
+  std::vector<std::string> const windows{"chr4:99990001-99991000", "chr4:99990801-99991800",
+                                         "chr4:100009001-100010000"};
+
+  // A tiny cap, so the reader has to pause and resume around the workers
+  static constexpr u64 MAX_BUFFERED_BYTES = u64{1} << 16;
+  auto stream = std::make_shared<RecordStream>(
+      case_bam_path, ref, scan_specs,
+      RecordStream::Params{.mMaxBufferedBytes = MAX_BUFFERED_BYTES, .mDecodeThreads = 2});
+
+  Extractor file_extractor(case_bam_path, ref, Alignment::Fields::CORE_QNAME);
+  Extractor stream_extractor(case_bam_path, ref, Alignment::Fields::CORE_QNAME);
+  stream_extractor.AttachStream(stream);
+
+  for (auto const& window : windows) {
+    auto const expected = CollectKeys(file_extractor, window);
+    CHECK_FALSE(expected.empty());
+    CHECK(CollectKeys(stream_extractor, window) == expected);
+  }
+
+  SECTION("Regions outside the scan regions fall back to the index") {
+    static constexpr auto OUTSIDE = "chr4:100000-101000";
+    CHECK(CollectKeys(stream_extractor, OUTSIDE) == CollectKeys(file_extractor, OUTSIDE));
+  }
+
+  SECTION("Releasing windows frees their records") {
+    auto const before_release = stream->BufferedBytes();
+    stream->ReleaseBefore("chr4", 100009000);
+    CHECK(stream->BufferedBytes() < before_release);
+
+    auto const& last_window = windows.back();
+    CHECK(CollectKeys(stream_extractor, last_window) == CollectKeys(file_extractor, last_window));
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("RecordStream holds later windows at the buffer cap", "[lancet][hts][RecordStream]") {
+  Reference const ref(MakePath(FULL_DATA_DIR, GRCH38_REF_NAME));
+  auto const case_bam_path = MakePath(FULL_DATA_DIR, CASE_BAM_NAME);
+  REQUIRE(std::filesystem::exists(case_bam_path));
+
+  std::vector<std::string> const scan_specs{"chr4:99990001-100010000"};
+  static constexpr auto LAST_WINDOW = "chr4:100009001-100010000";
+  static constexpr u64 MAX_BUFFERED_BYTES = u64{1} << 16;
+  auto stream = std::make_shared<RecordStream>(
+      case_bam_path, ref, scan_specs,
+      RecordStream::Params{.mMaxBufferedBytes = MAX_BUFFERED_BYTES, .mDecodeThreads = 2});
+
+  Extractor file_extractor(case_bam_path, ref, Alignment::Fields::CORE_QNAME);
+  Extractor stream_extractor(case_bam_path, ref, Alignment::Fields::CORE_QNAME);
+  stream_extractor.AttachStream(stream);
+
+  // The first window is the oldest in flight, so a later window must not pull the reader
+  // past the cap: it waits until the windows before it are released
+  stream->ReleaseBefore("chr4", 99990000);
+  auto pending = std::async(std::launch::async, [&stream_extractor] {
+    return CollectKeys(stream_extractor, LAST_WINDOW);
+  });
+
+  static constexpr auto HOLD_TIME = std::chrono::milliseconds(200);
+  CHECK(pending.wait_for(HOLD_TIME) == std::future_status::timeout);
+
+  stream->ReleaseBefore("chr4", 100009000);
+  auto const streamed = pending.get();
+  CHECK_FALSE(streamed.empty());
+  CHECK(streamed == CollectKeys(file_extractor, LAST_WINDOW));
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("RecordStream serves concurrent out-of-order windows within the buffer cap",
+          "[lancet][hts][RecordStream]") {
+  Reference const ref(MakePath(FULL_DATA_DIR, GRCH38_REF_NAME));
+  auto const case_bam_path = MakePath(FULL_DATA_DIR, CASE_BAM_NAME);
+  REQUIRE(std::filesystem::exists(case_bam_path));
+
+  // Overlapping 1 kbp windows tiling the whole scan region, so every streamed record
+  // lands in at least one of them
+  static constexpr i64 SCAN_BEG0 = 99990000;
+  static constexpr i64 SCAN_END0 = 100010000;
+  static constexpr i64 WINDOW_LEN = 1000;
+  static constexpr i64 WINDOW_STEP = 800;
+  std::vector<std::pair<i64, i64>> windows;
+  for (i64 beg0 = SCAN_BEG0; beg0 < SCAN_END0; beg0 += WINDOW_STEP) {
+    windows.emplace_back(beg0, std::min(beg0 + WINDOW_LEN, SCAN_END0));
+  }
+
+  static constexpr u64 MAX_BUFFERED_BYTES = u64{1} << 12;
+  std::vector<std::string> const scan_specs{"chr4:99990001-100010000"};
+  auto stream = std::make_shared<RecordStream>(
+      case_bam_path, ref, scan_specs,
+      RecordStream::Params{.mMaxBufferedBytes = MAX_BUFFERED_BYTES, .mDecodeThreads = 2});
+
+  Extractor file_extractor(case_bam_path, ref, Alignment::Fields::CORE_QNAME);
+  file_extractor.SetRegionToExtract("chr4:99990001-99991000");
+  i32 tid = -1;
+  for (auto const& aln : file_extractor) {
+    tid = aln.ChromIndex();
+    break;
+  }
+  REQUIRE(tid >= 0);
+
+  std::atomic<u64> peak_bytes = 0;
+  std::jthread monitor([&stream, &peak_bytes](std::stop_token const& stop_token) {
+    while (!stop_token.stop_requested()) {
+      auto const current = stream->BufferedBytes();
+      if (current > peak_bytes.load()) peak_bytes.store(current);
+      std::this_thread::yield();
+    }
+  });
+
+  // Every window asks at once, latest first; windows finish and are released in
+  // coordinate order, the way the pipeline retires them
+  stream->ReleaseBefore("chr4", windows.front().first);
+  std::vector<std::future<WindowResult>> pending(windows.size());
+  for (auto idx = windows.size(); idx > 0; --idx) {
+    auto const [beg0, end0] = windows[idx - 1];
+    pending[idx - 1] = std::async(std::launch::async, [&stream, tid, beg0, end0] {
+      return CollectWindow(*stream, tid, beg0, end0);
+    });
+  }
+
+  static constexpr auto DEADLOCK_TIMEOUT = std::chrono::seconds(60);
+  std::vector<WindowResult> results;
+  for (usize idx = 0; idx < windows.size(); ++idx) {
+    INFO("window " << windows[idx].first << "-" << windows[idx].second);
+    REQUIRE(pending[idx].wait_for(DEADLOCK_TIMEOUT) == std::future_status::ready);
+    results.push_back(pending[idx].get());
+    if (idx + 1 < windows.size()) stream->ReleaseBefore("chr4", windows[idx + 1].first);
+  }
+  monitor.request_stop();
+  monitor.join();
+
+  u64 max_window_bytes = 0;
+  u64 max_record_bytes = 0;
+  for (usize idx = 0; idx < windows.size(); ++idx) {
+    auto const [beg0, end0] = windows[idx];
+    auto const region = "chr4:" + std::to_string(beg0 + 1) + "-" + std::to_string(end0);
+    INFO("window " << region);
+    CHECK(results[idx].mIsCovered);
+    CHECK(results[idx].mKeys == CollectKeys(file_extractor, region));
+    max_window_bytes = std::max(max_window_bytes, results[idx].mNumBytes);
+    max_record_bytes = std::max(max_record_bytes, results[idx].mMaxRecordBytes);
+  }
+
+  // Over the cap only the oldest window pulls the reader on, and only until its
+  // end has been read: at most that window's records plus one reader batch
+  auto const read_batch_bytes = RecordStream::READ_BATCH_SIZE * max_record_bytes;
+  CHECK(peak_bytes.load() <= MAX_BUFFERED_BYTES + max_window_bytes + read_batch_bytes);
+}